@@ -131,6 +131,25 @@ namespace Utilities
           partitioner_export_start,
           partitioner_export_end = partitioner_export_start + 200,
 
+          /// 200 tags for the signals of the shared-memory variants of
+          /// Partitioner::export_to_ghosted_array_start and
+          /// Partitioner::import_from_ghosted_array_start that the data is
+          /// ready to be read
+          partitioner_shared_memory_ready_start,
+          partitioner_shared_memory_ready_end =
+            partitioner_shared_memory_ready_start + 200,
+
+          /// 200 tags for the signals of the shared-memory variants of
+          /// Partitioner::export_to_ghosted_array_finish and
+          /// Partitioner::import_from_ghosted_array_finish that the data has
+          /// been read
+          partitioner_shared_memory_done_start,
+          partitioner_shared_memory_done_end =
+            partitioner_shared_memory_done_start + 200,
+
+          /// Partitioner::initialize_shared_memory_access
+          partitioner_initialize_shared_memory_access,
+
           /// NoncontiguousPartitioner::update_values
           noncontiguous_partitioner_update_ghost_values_start,
           noncontiguous_partitioner_update_ghost_values_end =
@@ -27,8 +27,10 @@
 
 #include <deal.II/lac/vector_operation.h>
 
+#include <array>
 #include <limits>
 #include <memory>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -36,6 +38,98 @@ namespace Utilities
 {
   namespace MPI
   {
+    /**
+     * A set of persistent MPI requests, set up with MPI_Recv_init() and
+     * MPI_Send_init(), for the data exchange of a Partitioner object on a
+     * particular set of arrays. Objects of this class are filled by the
+     * overloads of Partitioner::export_to_ghosted_array_start() and
+     * Partitioner::import_from_ghosted_array_start() that take a
+     * PersistentRequests argument: These functions set up the requests the
+     * first time they are called and whenever the partitioner, the arrays or
+     * the communication channel change, and otherwise only re-start the
+     * requests stored here with MPI_Startall(). This avoids the matching
+     * overhead of posting new messages for repeated data exchanges on the same
+     * vector, e.g. in the ghost updates of the vectors in an iterative solver
+     * or a multigrid cycle with small messages on the coarse levels.
+     *
+     * Since the requests refer to the memory of particular arrays, a copy of
+     * an object of this class is empty.
+     */
+    class PersistentRequests
+    {
+    public:
+      /**
+       * Default constructor, creating an empty object.
+       */
+      PersistentRequests() = default;
+
+      /**
+       * Copy constructor. Creates an empty object, see the general
+       * documentation of this class.
+       */
+      PersistentRequests(const PersistentRequests &);
+
+      /**
+       * Move constructor.
+       */
+      PersistentRequests(PersistentRequests &&other) noexcept;
+
+      /**
+       * Destructor. Frees the MPI requests.
+       */
+      ~PersistentRequests();
+
+      /**
+       * Copy assignment. Clears the current object, see the general
+       * documentation of this class.
+       */
+      PersistentRequests &
+      operator=(const PersistentRequests &);
+
+      /**
+       * Move assignment.
+       */
+      PersistentRequests &
+      operator=(PersistentRequests &&other) noexcept;
+
+      /**
+       * Free the MPI requests stored in this object.
+       */
+      void
+      clear();
+
+      /**
+       * Return whether the given list of MPI requests has been started from
+       * the requests stored in this object. In that case, the requests must
+       * not be freed separately.
+       */
+      bool
+      started(const std::vector<MPI_Request> &requests) const;
+
+    private:
+      /**
+       * The persistent requests.
+       */
+      std::vector<MPI_Request> requests;
+
+      /**
+       * The partitioner, communication tag, addresses of the two arrays
+       * involved in the communication, size of the ghost array and size of
+       * the number type the requests have been set up for.
+       */
+      std::tuple<const void *,
+                 unsigned int,
+                 const void *,
+                 const void *,
+                 std::size_t,
+                 std::size_t>
+        setup;
+
+      friend class Partitioner;
+    };
+
+
+
     /**
      * This class defines a model for the partitioning of a vector (or, in
      * fact, any linear data structure) among processors using MPI.
@@ -636,6 +730,225 @@ namespace Utilities
         const ArrayView<Number, MemorySpaceType>       &locally_owned_storage,
         const ArrayView<Number, MemorySpaceType>       &ghost_array,
         std::vector<MPI_Request>                       &requests) const;
+
+      /**
+       * Same as the export_to_ghosted_array_start() function above, but using
+       * the persistent MPI requests stored in @p persistent_requests instead
+       * of posting new messages. The persistent requests are set up in case
+       * they have not been set up for this partitioner, the given arrays and
+       * the given communication channel before. The started requests are
+       * returned in @p requests, to be passed to
+       * export_to_ghosted_array_finish() as usual. The arrays must not be
+       * reallocated between calls using the same @p persistent_requests
+       * object, unless the requests are cleared.
+       *
+       * This function is only implemented for arrays in host memory.
+       */
+      template <typename Number, typename MemorySpaceType = MemorySpace::Host>
+      void
+      export_to_ghosted_array_start(
+        const unsigned int                              communication_channel,
+        const ArrayView<const Number, MemorySpaceType> &locally_owned_array,
+        const ArrayView<Number, MemorySpaceType>       &temporary_storage,
+        const ArrayView<Number, MemorySpaceType>       &ghost_array,
+        PersistentRequests                             &persistent_requests,
+        std::vector<MPI_Request>                       &requests) const;
+
+      /**
+       * Same as the import_from_ghosted_array_start() function above, but
+       * using the persistent MPI requests stored in @p persistent_requests
+       * instead of posting new messages, see the respective variant of
+       * export_to_ghosted_array_start(). The started requests are returned in
+       * @p requests, to be passed to import_from_ghosted_array_finish() as
+       * usual.
+       *
+       * If the size of @p ghost_array is the number of ghost indices in a
+       * larger index set, the data to be sent needs to be rearranged for
+       * each communication partner, and this function falls back to the
+       * non-persistent variant.
+       */
+      template <typename Number, typename MemorySpaceType = MemorySpace::Host>
+      void
+      import_from_ghosted_array_start(
+        const VectorOperation::values             vector_operation,
+        const unsigned int                        communication_channel,
+        const ArrayView<Number, MemorySpaceType> &ghost_array,
+        const ArrayView<Number, MemorySpaceType> &temporary_storage,
+        PersistentRequests                       &persistent_requests,
+        std::vector<MPI_Request>                 &requests) const;
+
+      /**
+       * The data structures for the direct access to the entries of the
+       * processes within a shared-memory communicator, as computed by
+       * create_shared_memory_data(). The ranks and ranges refer to the
+       * entries of ghost_targets() and import_targets() of the partitioner
+       * the object has been created for, so it must only be used together
+       * with that partitioner.
+       */
+      struct SharedMemoryData
+      {
+        /**
+         * The shared-memory communicator.
+         */
+        MPI_Comm communicator_sm;
+
+        /**
+         * The rank within communicator_sm of each entry of ghost_targets(),
+         * or numbers::invalid_unsigned_int if the process does not share
+         * the memory with the calling process.
+         */
+        std::vector<unsigned int> ghost_targets_sm_rank;
+
+        /**
+         * The rank within communicator_sm of each entry of import_targets(),
+         * or numbers::invalid_unsigned_int if the process does not share
+         * the memory with the calling process.
+         */
+        std::vector<unsigned int> import_targets_sm_rank;
+
+        /**
+         * The contiguous ranges of ghost entries to be copied from the
+         * owners in the shared-memory communicator, given as the position in
+         * the ghost array, the position in the array of the owner and the
+         * length. The ranges of ghost target i are stored between
+         * ghost_ranges_ptr[i] and ghost_ranges_ptr[i+1].
+         */
+        std::vector<std::array<unsigned int, 3>> ghost_ranges;
+
+        /**
+         * Pointers into ghost_ranges for each ghost target.
+         */
+        std::vector<unsigned int> ghost_ranges_ptr;
+
+        /**
+         * The contiguous ranges of locally owned entries to be imported
+         * from the ghost entries of the processes in the shared-memory
+         * communicator, given as the position in the locally owned array,
+         * the position in the array of the other process and the length. The
+         * ranges of import target i are stored between import_ranges_ptr[i]
+         * and import_ranges_ptr[i+1].
+         */
+        std::vector<std::array<unsigned int, 3>> import_ranges;
+
+        /**
+         * Pointers into import_ranges for each import target.
+         */
+        std::vector<unsigned int> import_ranges_ptr;
+
+        /**
+         * The number of ghost targets within communicator_sm.
+         */
+        unsigned int n_sm_ghost_targets;
+
+        /**
+         * The number of import targets within communicator_sm.
+         */
+        unsigned int n_sm_import_targets;
+      };
+
+      /**
+       * Compute the data structures for accessing the vector entries of the
+       * processes that share the memory of the calling process, as given by
+       * the communicator @p communicator_sm (typically created by
+       * MPI_Comm_split_type() with MPI_COMM_TYPE_SHARED). The returned object
+       * is needed by the variants of export_to_ghosted_array_start() and
+       * import_from_ghosted_array_start() taking a list of shared arrays,
+       * which read the ghost values owned by processes within @p
+       * communicator_sm directly from the memory of the owner, and the
+       * contributions of these processes directly from their ghost arrays,
+       * rather than sending them through MPI messages.
+       *
+       * This is a collective operation on the communicator of this class.
+       * The partitioner itself is not modified, so the same partitioner can
+       * be used with several shared-memory communicators at the same time.
+       * The caller, typically LinearAlgebra::distributed::Vector, owns the
+       * returned object.
+       */
+      std::shared_ptr<const SharedMemoryData>
+      create_shared_memory_data(const MPI_Comm communicator_sm) const;
+
+      /**
+       * Same as the export_to_ghosted_array_start() function above, but
+       * reading the ghost values owned by processes within the shared-memory
+       * communicator of @p sm_data directly from @p shared_arrays, a list of
+       * the arrays of locally owned and ghost entries of all processes of the
+       * shared-memory communicator, in the layout of
+       * LinearAlgebra::distributed::Vector::shared_vector_data(). Only the
+       * values of the processes outside the shared-memory communicator are
+       * sent through MPI messages. The processes only exchange zero-size
+       * messages that signal when the data in the shared arrays is ready to
+       * be read and when it has been read.
+       *
+       * @p sm_data must have been computed by create_shared_memory_data() of
+       * this partitioner. The size of @p ghost_array must be
+       * n_ghost_indices(). This function is only implemented for arrays in
+       * host memory.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_start(
+        const SharedMemoryData                     &sm_data,
+        const unsigned int                          communication_channel,
+        const ArrayView<const Number>              &locally_owned_array,
+        const std::vector<ArrayView<const Number>> &shared_arrays,
+        const ArrayView<Number>                    &temporary_storage,
+        const ArrayView<Number>                    &ghost_array,
+        std::vector<MPI_Request>                   &requests) const;
+
+      /**
+       * Finish the exportation started by the shared-memory variant of
+       * export_to_ghosted_array_start(). The locally owned arrays of the
+       * processes in the shared-memory communicator must not be modified
+       * until this function returns.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_finish(
+        const SharedMemoryData                     &sm_data,
+        const std::vector<ArrayView<const Number>> &shared_arrays,
+        const ArrayView<Number>                    &ghost_array,
+        std::vector<MPI_Request>                   &requests) const;
+
+      /**
+       * Same as the import_from_ghosted_array_start() function above, but
+       * only sending the ghost values to processes outside the shared-memory
+       * communicator of @p sm_data through MPI messages. The processes within
+       * the shared-memory communicator read their contributions directly from
+       * @p ghost_array in import_from_ghosted_array_finish().
+       *
+       * @p sm_data must have been computed by create_shared_memory_data() of
+       * this partitioner. The size of @p ghost_array must be
+       * n_ghost_indices(). This function is only implemented for arrays in
+       * host memory.
+       */
+      template <typename Number>
+      void
+      import_from_ghosted_array_start(
+        const SharedMemoryData                     &sm_data,
+        const VectorOperation::values               vector_operation,
+        const unsigned int                          communication_channel,
+        const std::vector<ArrayView<const Number>> &shared_arrays,
+        const ArrayView<Number>                    &ghost_array,
+        const ArrayView<Number>                    &temporary_storage,
+        std::vector<MPI_Request>                   &requests) const;
+
+      /**
+       * Finish the importation started by the shared-memory variant of
+       * import_from_ghosted_array_start(), reading the contributions of the
+       * processes within the shared-memory communicator from their entries
+       * in @p shared_arrays. As in the regular variant, the entries of @p
+       * ghost_array are zeroed out on return.
+       */
+      template <typename Number>
+      void
+      import_from_ghosted_array_finish(
+        const SharedMemoryData                     &sm_data,
+        const VectorOperation::values               vector_operation,
+        const std::vector<ArrayView<const Number>> &shared_arrays,
+        const ArrayView<const Number>              &temporary_storage,
+        const ArrayView<Number>                    &locally_owned_storage,
+        const ArrayView<Number>                    &ghost_array,
+        std::vector<MPI_Request>                   &requests) const;
 #endif
 
       /**
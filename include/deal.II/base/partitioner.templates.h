@@ -179,6 +179,126 @@ namespace Utilities
 
 
 
+    template <typename Number, typename MemorySpaceType>
+    void
+    Partitioner::export_to_ghosted_array_start(
+      const unsigned int                              communication_channel,
+      const ArrayView<const Number, MemorySpaceType> &locally_owned_array,
+      const ArrayView<Number, MemorySpaceType>       &temporary_storage,
+      const ArrayView<Number, MemorySpaceType>       &ghost_array,
+      PersistentRequests                             &persistent_requests,
+      std::vector<MPI_Request>                       &requests) const
+    {
+      static_assert(std::is_same_v<MemorySpaceType, MemorySpace::Host>,
+                    "Persistent requests are only implemented for arrays in "
+                    "host memory.");
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertIndexRange(communication_channel, 200);
+      Assert(ghost_array.size() == n_ghost_indices() ||
+               ghost_array.size() == n_ghost_indices_in_larger_set,
+             ExcGhostIndexArrayHasWrongSize(ghost_array.size(),
+                                            n_ghost_indices(),
+                                            n_ghost_indices_in_larger_set));
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets  = ghost_targets_data.size();
+
+      if (n_import_targets > 0)
+        AssertDimension(locally_owned_array.size(), locally_owned_size());
+
+      Assert(requests.empty(),
+             ExcMessage("Another operation seems to still be running. "
+                        "Call update_ghost_values_finish() first."));
+
+      const unsigned int mpi_tag =
+        Utilities::MPI::internal::Tags::partitioner_export_start +
+        communication_channel;
+      Assert(mpi_tag <= Utilities::MPI::internal::Tags::partitioner_export_end,
+             ExcInternalError());
+
+      const auto setup = std::make_tuple(static_cast<const void *>(this),
+                                         mpi_tag,
+                                         static_cast<const void *>(
+                                           temporary_storage.data()),
+                                         static_cast<const void *>(
+                                           ghost_array.data()),
+                                         ghost_array.size(),
+                                         sizeof(Number));
+      if (persistent_requests.requests.empty() ||
+          persistent_requests.setup != setup)
+        {
+          persistent_requests.clear();
+          persistent_requests.requests.resize(n_ghost_targets +
+                                              n_import_targets);
+
+          // same layout of the data as in the non-persistent variant above
+          AssertIndexRange(n_ghost_indices(),
+                           n_ghost_indices_in_larger_set + 1);
+          const bool use_larger_set =
+            (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+             ghost_array.size() == n_ghost_indices_in_larger_set);
+          Number *ghost_array_ptr =
+            use_larger_set ? ghost_array.data() +
+                               n_ghost_indices_in_larger_set -
+                               n_ghost_indices() :
+                             ghost_array.data();
+          for (unsigned int i = 0; i < n_ghost_targets; ++i)
+            {
+              const int ierr =
+                MPI_Recv_init(ghost_array_ptr,
+                              ghost_targets_data[i].second * sizeof(Number),
+                              MPI_BYTE,
+                              ghost_targets_data[i].first,
+                              mpi_tag,
+                              communicator,
+                              &persistent_requests.requests[i]);
+              AssertThrowMPI(ierr);
+              ghost_array_ptr += ghost_targets_data[i].second;
+            }
+
+          Number *temp_array_ptr = temporary_storage.data();
+          for (unsigned int i = 0; i < n_import_targets; ++i)
+            {
+              const int ierr = MPI_Send_init(
+                temp_array_ptr,
+                import_targets_data[i].second * sizeof(Number),
+                MPI_BYTE,
+                import_targets_data[i].first,
+                mpi_tag,
+                communicator,
+                &persistent_requests.requests[n_ghost_targets + i]);
+              AssertThrowMPI(ierr);
+              temp_array_ptr += import_targets_data[i].second;
+            }
+          persistent_requests.setup = setup;
+        }
+
+      // the data to all processes is packed before starting any of the
+      // requests, with the import ranges sorted by the receiving process
+      Number *temp_array_ptr = temporary_storage.data();
+      for (const auto &import_range : import_indices_data)
+        {
+          const unsigned int chunk_size =
+            import_range.second - import_range.first;
+          std::memcpy(temp_array_ptr,
+                      locally_owned_array.data() + import_range.first,
+                      chunk_size * sizeof(Number));
+          temp_array_ptr += chunk_size;
+        }
+      AssertDimension(temp_array_ptr - temporary_storage.data(),
+                      n_import_indices());
+
+      if (persistent_requests.requests.size() > 0)
+        {
+          const int ierr = MPI_Startall(persistent_requests.requests.size(),
+                                        persistent_requests.requests.data());
+          AssertThrowMPI(ierr);
+        }
+      requests = persistent_requests.requests;
+    }
+
+
+
     template <typename Number, typename MemorySpaceType>
     void
     Partitioner::export_to_ghosted_array_finish(
@@ -466,6 +586,138 @@ namespace Utilities
 
 
 
+    template <typename Number, typename MemorySpaceType>
+    void
+    Partitioner::import_from_ghosted_array_start(
+      const VectorOperation::values             vector_operation,
+      const unsigned int                        communication_channel,
+      const ArrayView<Number, MemorySpaceType> &ghost_array,
+      const ArrayView<Number, MemorySpaceType> &temporary_storage,
+      PersistentRequests                       &persistent_requests,
+      std::vector<MPI_Request>                 &requests) const
+    {
+      static_assert(std::is_same_v<MemorySpaceType, MemorySpace::Host>,
+                    "Persistent requests are only implemented for arrays in "
+                    "host memory.");
+
+      // the entries to be sent to a process are not contiguous in the larger
+      // ghost array, so they need to be moved before each send operation
+      if (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+          ghost_array.size() == n_ghost_indices_in_larger_set)
+        {
+          import_from_ghosted_array_start(vector_operation,
+                                          communication_channel,
+                                          ghost_array,
+                                          temporary_storage,
+                                          requests);
+          return;
+        }
+
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertIndexRange(communication_channel, 200);
+      AssertDimension(ghost_array.size(), n_ghost_indices());
+
+      (void)vector_operation;
+
+      // nothing to do for insert in optimized mode, see the non-persistent
+      // variant above
+#    ifndef DEBUG
+      if (vector_operation == VectorOperation::insert)
+        return;
+#    endif
+
+      // nothing to do when we neither have import
+      // nor ghost indices.
+      if (n_ghost_indices() == 0 && n_import_indices() == 0)
+        return;
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets  = ghost_targets_data.size();
+
+      Assert(requests.empty(),
+             ExcMessage("Another compress operation seems to still be running. "
+                        "Call compress_finish() first."));
+
+      const unsigned int mpi_tag =
+        Utilities::MPI::internal::Tags::partitioner_import_start +
+        communication_channel;
+      Assert(mpi_tag <= Utilities::MPI::internal::Tags::partitioner_import_end,
+             ExcInternalError());
+
+      const auto setup = std::make_tuple(static_cast<const void *>(this),
+                                         mpi_tag,
+                                         static_cast<const void *>(
+                                           ghost_array.data()),
+                                         static_cast<const void *>(
+                                           temporary_storage.data()),
+                                         ghost_array.size(),
+                                         sizeof(Number));
+      if (persistent_requests.requests.empty() ||
+          persistent_requests.setup != setup)
+        {
+          persistent_requests.clear();
+          persistent_requests.requests.resize(n_import_targets +
+                                              n_ghost_targets);
+
+          Number *temp_array_ptr = temporary_storage.data();
+          for (unsigned int i = 0; i < n_import_targets; ++i)
+            {
+              AssertThrow(
+                static_cast<std::size_t>(import_targets_data[i].second) *
+                    sizeof(Number) <
+                  static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                ExcMessage("Index overflow: Maximum message size in MPI is "
+                           "2GB. The number of ghost entries times the size "
+                           "of 'Number' exceeds this value. This is not "
+                           "supported."));
+              const int ierr =
+                MPI_Recv_init(temp_array_ptr,
+                              import_targets_data[i].second * sizeof(Number),
+                              MPI_BYTE,
+                              import_targets_data[i].first,
+                              mpi_tag,
+                              communicator,
+                              &persistent_requests.requests[i]);
+              AssertThrowMPI(ierr);
+              temp_array_ptr += import_targets_data[i].second;
+            }
+
+          Number *ghost_array_ptr = ghost_array.data();
+          for (unsigned int i = 0; i < n_ghost_targets; ++i)
+            {
+              AssertThrow(
+                static_cast<std::size_t>(ghost_targets_data[i].second) *
+                    sizeof(Number) <
+                  static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                ExcMessage("Index overflow: Maximum message size in MPI is "
+                           "2GB. The number of ghost entries times the size "
+                           "of 'Number' exceeds this value. This is not "
+                           "supported."));
+              const int ierr = MPI_Send_init(
+                ghost_array_ptr,
+                ghost_targets_data[i].second * sizeof(Number),
+                MPI_BYTE,
+                ghost_targets_data[i].first,
+                mpi_tag,
+                communicator,
+                &persistent_requests.requests[n_import_targets + i]);
+              AssertThrowMPI(ierr);
+              ghost_array_ptr += ghost_targets_data[i].second;
+            }
+          persistent_requests.setup = setup;
+        }
+
+      if (persistent_requests.requests.size() > 0)
+        {
+          const int ierr = MPI_Startall(persistent_requests.requests.size(),
+                                        persistent_requests.requests.data());
+          AssertThrowMPI(ierr);
+        }
+      requests = persistent_requests.requests;
+    }
+
+
+
     namespace internal
     {
       // In the import_from_ghosted_array_finish we need to invoke abs() also
@@ -696,10 +948,19 @@ namespace Utilities
               // matches with the ones already present
               if (vector_operation == VectorOperation::add)
                 for (const auto &import_range : import_indices_data)
-                  for (unsigned int j = import_range.first;
-                       j < import_range.second;
-                       j++)
-                    locally_owned_array[j] += *read_position++;
+                  {
+                    // the entries within a range are contiguous, which allows
+                    // the compiler to vectorize the loop
+                    Number *DEAL_II_RESTRICT owned_ptr =
+                      locally_owned_array.data() + import_range.first;
+                    const Number *DEAL_II_RESTRICT read_ptr = read_position;
+                    const unsigned int             chunk_size =
+                      import_range.second - import_range.first;
+                    DEAL_II_OPENMP_SIMD_PRAGMA
+                    for (unsigned int j = 0; j < chunk_size; ++j)
+                      owned_ptr[j] += read_ptr[j];
+                    read_position += chunk_size;
+                  }
               else if (vector_operation == VectorOperation::min)
                 for (const auto &import_range : import_indices_data)
                   for (unsigned int j = import_range.first;
@@ -801,6 +1062,550 @@ namespace Utilities
     }
 
 
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_start(
+      const SharedMemoryData                     &sm_data,
+      const unsigned int                          communication_channel,
+      const ArrayView<const Number>              &locally_owned_array,
+      const std::vector<ArrayView<const Number>> &shared_arrays,
+      const ArrayView<Number>                    &temporary_storage,
+      const ArrayView<Number>                    &ghost_array,
+      std::vector<MPI_Request>                   &requests) const
+    {
+      AssertDimension(shared_arrays.size(),
+                      Utilities::MPI::n_mpi_processes(sm_data.communicator_sm));
+      AssertDimension(sm_data.ghost_targets_sm_rank.size(),
+                      ghost_targets_data.size());
+      AssertDimension(sm_data.import_targets_sm_rank.size(),
+                      import_targets_data.size());
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertDimension(ghost_array.size(), n_ghost_indices());
+      AssertIndexRange(communication_channel, 200);
+      (void)shared_arrays;
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets  = ghost_targets_data.size();
+
+      if (n_import_targets > 0)
+        AssertDimension(locally_owned_array.size(), locally_owned_size());
+
+      Assert(requests.empty(),
+             ExcMessage("Another operation seems to still be running. "
+                        "Call update_ghost_values_finish() first."));
+
+      const unsigned int mpi_tag =
+        Utilities::MPI::internal::Tags::partitioner_export_start +
+        communication_channel;
+      const unsigned int ready_tag =
+        Utilities::MPI::internal::Tags::partitioner_shared_memory_ready_start +
+        communication_channel;
+      const unsigned int done_tag =
+        Utilities::MPI::internal::Tags::partitioner_shared_memory_done_start +
+        communication_channel;
+
+      // The requests are ordered as follows: the receives from remote owners
+      // of ghost entries and the sends to remote importers as in the regular
+      // variant (null requests for the processes sharing the memory),
+      // followed by the signals from the owners in the shared-memory
+      // communicator that their data is ready, the signals to the importers
+      // in the shared-memory communicator that the data of this process is
+      // ready, the signals from these importers that they have read the data,
+      // and the inactive persistent signals to the owners that the data has
+      // been read, which are started in export_to_ghosted_array_finish().
+      requests.resize(n_import_targets + n_ghost_targets +
+                        2 * (sm_data.n_sm_ghost_targets +
+                             sm_data.n_sm_import_targets),
+                      MPI_REQUEST_NULL);
+      unsigned int n_requests = n_import_targets + n_ghost_targets;
+
+      Number *ghost_array_ptr = ghost_array.data();
+      for (unsigned int i = 0; i < n_ghost_targets; ++i)
+        {
+          if (sm_data.ghost_targets_sm_rank[i] == numbers::invalid_unsigned_int)
+            {
+              const int ierr =
+                MPI_Irecv(ghost_array_ptr,
+                          ghost_targets_data[i].second * sizeof(Number),
+                          MPI_BYTE,
+                          ghost_targets_data[i].first,
+                          mpi_tag,
+                          communicator,
+                          &requests[i]);
+              AssertThrowMPI(ierr);
+            }
+          ghost_array_ptr += ghost_targets_data[i].second;
+        }
+
+      for (const unsigned int sm_rank : sm_data.ghost_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Irecv(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       ready_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.import_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Isend(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       ready_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.import_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Irecv(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       done_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.ghost_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Send_init(nullptr,
+                                           0,
+                                           MPI_BYTE,
+                                           sm_rank,
+                                           done_tag,
+                                           sm_data.communicator_sm,
+                                           &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+      AssertDimension(n_requests, requests.size());
+
+      Number *temp_array_ptr = temporary_storage.data();
+      for (unsigned int i = 0; i < n_import_targets; ++i)
+        {
+          if (sm_data.import_targets_sm_rank[i] !=
+              numbers::invalid_unsigned_int)
+            continue;
+
+          // copy the data to be sent to the import_data field
+          unsigned int index = 0;
+          for (unsigned int j = import_indices_chunks_by_rank_data[i];
+               j < import_indices_chunks_by_rank_data[i + 1];
+               ++j)
+            {
+              const unsigned int chunk_size =
+                import_indices_data[j].second - import_indices_data[j].first;
+              std::memcpy(temp_array_ptr + index,
+                          locally_owned_array.data() +
+                            import_indices_data[j].first,
+                          chunk_size * sizeof(Number));
+              index += chunk_size;
+            }
+          AssertDimension(index, import_targets_data[i].second);
+
+          const int ierr =
+            MPI_Isend(temp_array_ptr,
+                      import_targets_data[i].second * sizeof(Number),
+                      MPI_BYTE,
+                      import_targets_data[i].first,
+                      mpi_tag,
+                      communicator,
+                      &requests[n_ghost_targets + i]);
+          AssertThrowMPI(ierr);
+          temp_array_ptr += import_targets_data[i].second;
+        }
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_finish(
+      const SharedMemoryData                     &sm_data,
+      const std::vector<ArrayView<const Number>> &shared_arrays,
+      const ArrayView<Number>                    &ghost_array,
+      std::vector<MPI_Request>                   &requests) const
+    {
+      AssertDimension(ghost_array.size(), n_ghost_indices());
+
+      if (requests.empty())
+        return;
+
+      const unsigned int n_targets =
+        import_targets_data.size() + ghost_targets_data.size();
+      AssertDimension(requests.size(),
+                      n_targets + 2 * (sm_data.n_sm_ghost_targets +
+                                       sm_data.n_sm_import_targets));
+
+      // wait for the owners in the shared-memory communicator to signal that
+      // their data is ready and copy it into the ghost array
+      if (sm_data.n_sm_ghost_targets > 0)
+        {
+          int ierr = MPI_Waitall(sm_data.n_sm_ghost_targets,
+                                 &requests[n_targets],
+                                 MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+
+          for (unsigned int i = 0; i < ghost_targets_data.size(); ++i)
+            {
+              const unsigned int sm_rank = sm_data.ghost_targets_sm_rank[i];
+              if (sm_rank == numbers::invalid_unsigned_int)
+                continue;
+
+              for (unsigned int j = sm_data.ghost_ranges_ptr[i];
+                   j < sm_data.ghost_ranges_ptr[i + 1];
+                   ++j)
+                {
+                  const std::array<unsigned int, 3> &range =
+                    sm_data.ghost_ranges[j];
+                  AssertIndexRange(range[1] + range[2],
+                                   shared_arrays[sm_rank].size() + 1);
+                  std::memcpy(ghost_array.data() + range[0],
+                              shared_arrays[sm_rank].data() + range[1],
+                              range[2] * sizeof(Number));
+                }
+            }
+
+          // signal to the owners that their data has been read
+          ierr = MPI_Startall(sm_data.n_sm_ghost_targets,
+                              &requests[requests.size() -
+                                        sm_data.n_sm_ghost_targets]);
+          AssertThrowMPI(ierr);
+        }
+
+      // wait for the remote messages and for the importers in the
+      // shared-memory communicator to finish reading the locally owned data
+      int ierr =
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+
+      for (unsigned int i = requests.size() - sm_data.n_sm_ghost_targets;
+           i < requests.size();
+           ++i)
+        {
+          ierr = MPI_Request_free(&requests[i]);
+          AssertThrowMPI(ierr);
+        }
+      requests.resize(0);
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::import_from_ghosted_array_start(
+      const SharedMemoryData                     &sm_data,
+      const VectorOperation::values               vector_operation,
+      const unsigned int                          communication_channel,
+      const std::vector<ArrayView<const Number>> &shared_arrays,
+      const ArrayView<Number>                    &ghost_array,
+      const ArrayView<Number>                    &temporary_storage,
+      std::vector<MPI_Request>                   &requests) const
+    {
+      AssertDimension(shared_arrays.size(),
+                      Utilities::MPI::n_mpi_processes(sm_data.communicator_sm));
+      AssertDimension(sm_data.ghost_targets_sm_rank.size(),
+                      ghost_targets_data.size());
+      AssertDimension(sm_data.import_targets_sm_rank.size(),
+                      import_targets_data.size());
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertDimension(ghost_array.size(), n_ghost_indices());
+      AssertIndexRange(communication_channel, 200);
+      (void)shared_arrays;
+
+      // as in the regular variant, nothing to do for insert in optimized mode
+#    ifndef DEBUG
+      if (vector_operation == VectorOperation::insert)
+        return;
+#    endif
+      (void)vector_operation;
+
+      if (n_ghost_indices() == 0 && n_import_indices() == 0)
+        return;
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets  = ghost_targets_data.size();
+
+      Assert(requests.empty(),
+             ExcMessage("Another compress operation seems to still be running. "
+                        "Call compress_finish() first."));
+
+      const unsigned int mpi_tag =
+        Utilities::MPI::internal::Tags::partitioner_import_start +
+        communication_channel;
+      const unsigned int ready_tag =
+        Utilities::MPI::internal::Tags::partitioner_shared_memory_ready_start +
+        communication_channel;
+      const unsigned int done_tag =
+        Utilities::MPI::internal::Tags::partitioner_shared_memory_done_start +
+        communication_channel;
+
+      // The same layout as in export_to_ghosted_array_start(), with the
+      // roles of ghost and import targets exchanged
+      requests.resize(n_import_targets + n_ghost_targets +
+                        2 * (sm_data.n_sm_ghost_targets +
+                             sm_data.n_sm_import_targets),
+                      MPI_REQUEST_NULL);
+      unsigned int n_requests = n_import_targets + n_ghost_targets;
+
+      Number *temp_array_ptr = temporary_storage.data();
+      for (unsigned int i = 0; i < n_import_targets; ++i)
+        {
+          if (sm_data.import_targets_sm_rank[i] ==
+              numbers::invalid_unsigned_int)
+            {
+              const int ierr =
+                MPI_Irecv(temp_array_ptr,
+                          import_targets_data[i].second * sizeof(Number),
+                          MPI_BYTE,
+                          import_targets_data[i].first,
+                          mpi_tag,
+                          communicator,
+                          &requests[i]);
+              AssertThrowMPI(ierr);
+            }
+          temp_array_ptr += import_targets_data[i].second;
+        }
+
+      for (const unsigned int sm_rank : sm_data.import_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Irecv(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       ready_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.ghost_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Isend(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       ready_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.ghost_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Irecv(nullptr,
+                                       0,
+                                       MPI_BYTE,
+                                       sm_rank,
+                                       done_tag,
+                                       sm_data.communicator_sm,
+                                       &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+
+      for (const unsigned int sm_rank : sm_data.import_targets_sm_rank)
+        if (sm_rank != numbers::invalid_unsigned_int)
+          {
+            const int ierr = MPI_Send_init(nullptr,
+                                           0,
+                                           MPI_BYTE,
+                                           sm_rank,
+                                           done_tag,
+                                           sm_data.communicator_sm,
+                                           &requests[n_requests++]);
+            AssertThrowMPI(ierr);
+          }
+      AssertDimension(n_requests, requests.size());
+
+      Number *ghost_array_ptr = ghost_array.data();
+      for (unsigned int i = 0; i < n_ghost_targets; ++i)
+        {
+          if (sm_data.ghost_targets_sm_rank[i] == numbers::invalid_unsigned_int)
+            {
+              const int ierr =
+                MPI_Isend(ghost_array_ptr,
+                          ghost_targets_data[i].second * sizeof(Number),
+                          MPI_BYTE,
+                          ghost_targets_data[i].first,
+                          mpi_tag,
+                          communicator,
+                          &requests[n_import_targets + i]);
+              AssertThrowMPI(ierr);
+            }
+          ghost_array_ptr += ghost_targets_data[i].second;
+        }
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::import_from_ghosted_array_finish(
+      const SharedMemoryData                     &sm_data,
+      const VectorOperation::values               vector_operation,
+      const std::vector<ArrayView<const Number>> &shared_arrays,
+      const ArrayView<const Number>              &temporary_storage,
+      const ArrayView<Number>                    &locally_owned_array,
+      const ArrayView<Number>                    &ghost_array,
+      std::vector<MPI_Request>                   &requests) const
+    {
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      AssertDimension(ghost_array.size(), n_ghost_indices());
+
+      const auto clear_ghost_array = [&]() {
+        if constexpr (std::is_trivial_v<Number>)
+          {
+            if (ghost_array.size() > 0)
+              std::memset(ghost_array.data(),
+                          0,
+                          sizeof(Number) * ghost_array.size());
+          }
+        else
+          std::fill(ghost_array.begin(), ghost_array.end(), Number());
+      };
+
+#    ifndef DEBUG
+      if (vector_operation == VectorOperation::insert)
+        {
+          Assert(requests.empty(), ExcInternalError());
+          clear_ghost_array();
+          return;
+        }
+#    endif
+
+      if (requests.empty())
+        {
+          clear_ghost_array();
+          return;
+        }
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_targets =
+        n_import_targets + ghost_targets_data.size();
+      AssertDimension(requests.size(),
+                      n_targets + 2 * (sm_data.n_sm_ghost_targets +
+                                       sm_data.n_sm_import_targets));
+
+      // wait for the remote data and for the signals of the processes in the
+      // shared-memory communicator that their ghost arrays are ready
+      int ierr = MPI_Waitall(n_import_targets,
+                             requests.data(),
+                             MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Waitall(sm_data.n_sm_import_targets,
+                         requests.data() + n_targets,
+                         MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+
+      // combine the contributions, either from the temporary storage or
+      // directly from the ghost arrays of the processes sharing the memory
+      const Number *temp_array_ptr = temporary_storage.data();
+      for (unsigned int i = 0; i < n_import_targets; ++i)
+        {
+          const unsigned int sm_rank = sm_data.import_targets_sm_rank[i];
+
+          const auto combine = [&](Number *DEAL_II_RESTRICT owned_ptr,
+                                   const Number *DEAL_II_RESTRICT read_ptr,
+                                   const unsigned int             chunk_size) {
+            if (vector_operation == VectorOperation::add)
+              {
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int j = 0; j < chunk_size; ++j)
+                  owned_ptr[j] += read_ptr[j];
+              }
+            else if (vector_operation == VectorOperation::min)
+              for (unsigned int j = 0; j < chunk_size; ++j)
+                owned_ptr[j] = internal::get_min(read_ptr[j], owned_ptr[j]);
+            else if (vector_operation == VectorOperation::max)
+              for (unsigned int j = 0; j < chunk_size; ++j)
+                owned_ptr[j] = internal::get_max(read_ptr[j], owned_ptr[j]);
+            else
+              for (unsigned int j = 0; j < chunk_size; ++j)
+                // see the regular variant of this function for the tolerance
+                Assert(read_ptr[j] == Number() ||
+                         internal::get_abs(owned_ptr[j] - read_ptr[j]) <=
+                           internal::get_abs(owned_ptr[j] + read_ptr[j]) *
+                             100000. *
+                             std::numeric_limits<typename numbers::NumberTraits<
+                               Number>::real_type>::epsilon(),
+                       typename dealii::LinearAlgebra::distributed::Vector<
+                         Number>::ExcNonMatchingElements(read_ptr[j],
+                                                         owned_ptr[j],
+                                                         my_pid));
+          };
+
+          if (sm_rank == numbers::invalid_unsigned_int)
+            for (unsigned int j = import_indices_chunks_by_rank_data[i];
+                 j < import_indices_chunks_by_rank_data[i + 1];
+                 ++j)
+              {
+                const unsigned int chunk_size =
+                  import_indices_data[j].second - import_indices_data[j].first;
+                combine(locally_owned_array.data() +
+                          import_indices_data[j].first,
+                        temp_array_ptr,
+                        chunk_size);
+                temp_array_ptr += chunk_size;
+              }
+          else
+            {
+              for (unsigned int j = sm_data.import_ranges_ptr[i];
+                   j < sm_data.import_ranges_ptr[i + 1];
+                   ++j)
+                {
+                  const std::array<unsigned int, 3> &range =
+                    sm_data.import_ranges[j];
+                  AssertIndexRange(range[1] + range[2],
+                                   shared_arrays[sm_rank].size() + 1);
+                  combine(locally_owned_array.data() + range[0],
+                          shared_arrays[sm_rank].data() + range[1],
+                          range[2]);
+                }
+              temp_array_ptr += import_targets_data[i].second;
+            }
+        }
+
+      // signal to the processes sharing the memory that their ghost arrays
+      // have been read, and wait for the others to read the ghost array of
+      // this process before clearing it
+      if (sm_data.n_sm_import_targets > 0)
+        {
+          ierr = MPI_Startall(sm_data.n_sm_import_targets,
+                              &requests[requests.size() -
+                                        sm_data.n_sm_import_targets]);
+          AssertThrowMPI(ierr);
+        }
+
+      ierr =
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+
+      for (unsigned int i = requests.size() - sm_data.n_sm_import_targets;
+           i < requests.size();
+           ++i)
+        {
+          ierr = MPI_Request_free(&requests[i]);
+          AssertThrowMPI(ierr);
+        }
+      requests.resize(0);
+
+      clear_ghost_array();
+    }
+
+
 #  endif // ifdef DEAL_II_WITH_MPI
 #endif   // ifndef DOXYGEN
 
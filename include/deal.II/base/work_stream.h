@@ -1261,6 +1261,97 @@ namespace WorkStream
 
 
 
+  /**
+   * A variant of the run() functions above without the copier stage. The
+   * @p worker is called with an iterator and a ScratchData object, i.e., it
+   * has the signature
+   * @code
+   *   void worker(const Iterator &cell, ScratchData &scratch_data);
+   * @endcode
+   * and is responsible for writing its results into the global objects
+   * itself. The worker is run on all elements of the range in parallel and in
+   * no particular order, so this is only correct if the worker either writes
+   * into disjoint parts of the global objects or uses operations that are
+   * safe to be called concurrently, such as
+   * AffineConstraints::distribute_local_to_global_concurrently() for adding
+   * local matrices into a SparseMatrix.
+   *
+   * For matrix assembly on many threads, the copier of the run() functions
+   * above can become the bottleneck since only one copier is run at a time.
+   * This function avoids this limitation, at the price of results that
+   * depend on the order in which the threads add their contributions and are
+   * therefore not reproducible in the last digits.
+   *
+   * The @p chunk_size argument has the same meaning as for the functions
+   * above.
+   */
+  template <typename Worker, typename Iterator, typename ScratchData>
+  void
+  run_without_copier(const Iterator                             &begin,
+                     const std_cxx20::type_identity_t<Iterator> &end,
+                     Worker                                      worker,
+                     const ScratchData &sample_scratch_data,
+                     const unsigned int chunk_size = 8)
+  {
+    // defer to the version of run() without copier, passing an empty
+    // CopyData object that the worker does not see
+    struct NoCopyData
+    {};
+    run(
+      begin,
+      end,
+      [&worker](const Iterator &iterator, ScratchData &scratch_data,
+                NoCopyData &) { worker(iterator, scratch_data); },
+      std::function<void(const NoCopyData &)>(),
+      sample_scratch_data,
+      NoCopyData(),
+      2 * MultithreadInfo::n_threads(),
+      chunk_size);
+  }
+
+
+
+  /**
+   * Same as the function above, but for iterator ranges and C-style arrays.
+   */
+  template <typename Worker,
+            typename IteratorRangeType,
+            typename ScratchData,
+            typename = std::enable_if_t<has_begin_and_end<IteratorRangeType>>>
+  void
+  run_without_copier(IteratorRangeType  iterator_range,
+                     Worker             worker,
+                     const ScratchData &sample_scratch_data,
+                     const unsigned int chunk_size = 8)
+  {
+    run_without_copier(iterator_range.begin(),
+                       iterator_range.end(),
+                       worker,
+                       sample_scratch_data,
+                       chunk_size);
+  }
+
+
+
+  /**
+   * Same as the function above, but for deal.II's IteratorRange.
+   */
+  template <typename Worker, typename Iterator, typename ScratchData>
+  void
+  run_without_copier(const IteratorRange<Iterator> &iterator_range,
+                     Worker                         worker,
+                     const ScratchData             &sample_scratch_data,
+                     const unsigned int             chunk_size = 8)
+  {
+    run_without_copier(iterator_range.begin(),
+                       iterator_range.end(),
+                       worker,
+                       sample_scratch_data,
+                       chunk_size);
+  }
+
+
+
   template <typename Worker,
             typename Copier,
             typename Iterator,
@@ -1367,6 +1367,69 @@ namespace DoFRenumbering
     const AffineConstraints<Number> &constraints,
     const AdditionalDataType        &matrix_free_additional_data);
 
+  /**
+   * Renumber the locally owned degrees of freedom along a space-filling
+   * curve through the locally owned cells, grouped into blocks that fit into
+   * a cache of the given size, and with the unknowns exchanged with other MPI
+   * processes sorted into contiguous ranges.
+   *
+   * The algorithm proceeds in three steps:
+   * - The locally owned active cells are traversed in Z order, like in
+   *   hierarchical(). For a parallel::distributed::Triangulation, this is
+   *   the space-filling curve p4est uses to partition the mesh.
+   * - The sequence of cells is split into blocks of consecutive cells such
+   *   that each block touches at most
+   *   <tt>block_size_in_bytes/bytes_per_dof</tt> different unknowns,
+   *   including ghost unknowns. For a loop over the cells that works on
+   *   vectors with a total of @p bytes_per_dof bytes per unknown, for
+   *   example 16 bytes for the source and destination vectors of a
+   *   matrix-free operator evaluation in double precision, the data of a
+   *   block then fits into a cache of size @p block_size_in_bytes.
+   * - The locally owned unknowns that are not ghosts on any other process
+   *   are numbered first, ordered by the first block that touches them.
+   *   Within the range of a block, the unknowns only touched by this block
+   *   come first and the ones also touched by later blocks last, such that
+   *   the next block finds them adjacent to its own range. The unknowns that
+   *   are ghosts on other processes are numbered last, grouped by the set of
+   *   processes that import them, and in the order of the space-filling
+   *   curve within each group.
+   *
+   * In contrast to the locally owned unknowns spread over the whole local
+   * range by hierarchical(), the last step results in one contiguous range
+   * of the locally owned indices for each group of importing processes.
+   * This reduces the number of index ranges stored for the import data of
+   * Utilities::MPI::Partitioner, and thus the packing and unpacking of the
+   * send and receive buffers of the ghost exchange in
+   * LinearAlgebra::distributed::Vector, as well as the number of intervals
+   * in the set of ghost indices on the importing processes. The function
+   * does not need a MatrixFree object, as opposed to
+   * matrix_free_data_locality(), and works for all finite elements.
+   *
+   * The set of indices owned by each process does not change.
+   *
+   * @note This function only renumbers the unknowns of the active cells, not
+   * the ones of the multigrid levels.
+   */
+  template <int dim, int spacedim>
+  void
+  space_filling_curve_blocks(DoFHandler<dim, spacedim> &dof_handler,
+                             const std::size_t block_size_in_bytes = 512 * 1024,
+                             const unsigned int bytes_per_dof = 2 *
+                                                                sizeof(double));
+
+  /**
+   * Compute the renumbering vector needed by the space_filling_curve_blocks()
+   * function. Does not perform the renumbering on the @p DoFHandler dofs but
+   * returns the renumbering vector.
+   */
+  template <int dim, int spacedim>
+  void
+  compute_space_filling_curve_blocks(
+    std::vector<types::global_dof_index> &new_dof_indices,
+    const DoFHandler<dim, spacedim>      &dof_handler,
+    const std::size_t                     block_size_in_bytes = 512 * 1024,
+    const unsigned int                    bytes_per_dof = 2 * sizeof(double));
+
   /**
    * @}
    */
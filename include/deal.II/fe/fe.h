@@ -2832,6 +2832,40 @@ protected:
                                                                        spacedim>
       &output_data) const;
 
+  /**
+   * Return whether the objects returned by get_data() are not modified by
+   * fill_fe_values() and can therefore be shared between several FEValues
+   * objects, possibly used on different threads. This is the case for
+   * elements whose InternalData only stores information precomputed on the
+   * reference cell, such as the values and derivatives of the shape
+   * functions, but not for elements that use their InternalData as scratch
+   * space when visiting a cell.
+   *
+   * The default implementation returns @p false.
+   */
+  virtual bool
+  internal_data_is_shareable() const;
+
+  /**
+   * Like get_data(), but return an object that may be shared with other
+   * callers. If internal_data_is_shareable() returns @p true, the data for a
+   * given combination of update flags, mapping, and quadrature formula is
+   * only computed once and then handed out to all FEValues objects that ask
+   * for the same combination while the first object is still alive, e.g.,
+   * the copies of the scratch data in a WorkStream::run() loop. The
+   * information that get_data() writes into @p output_data is copied from
+   * the object of the first caller. Otherwise, this function simply calls
+   * get_data().
+   */
+  std::shared_ptr<const InternalDataBase>
+  get_shared_data(
+    const UpdateFlags             update_flags,
+    const Mapping<dim, spacedim> &mapping,
+    const Quadrature<dim>        &quadrature,
+    dealii::internal::FEValuesImplementation::FiniteElementRelatedData<dim,
+                                                                       spacedim>
+      &output_data) const;
+
   /**
    * Compute information about the shape functions on the cell denoted by the
    * first argument. Derived classes will have to implement this function
@@ -476,7 +476,7 @@ protected:
      * Give read-access to the pointer to a @p InternalData of the @p
      * <code>base_no</code>th base element of FESystem's data.
      */
-    typename FiniteElement<dim, spacedim>::InternalDataBase &
+    const typename FiniteElement<dim, spacedim>::InternalDataBase &
     get_fe_data(const unsigned int base_no) const;
 
     /**
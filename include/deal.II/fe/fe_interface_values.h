@@ -1489,6 +1489,44 @@ public:
          const unsigned int      mapping_index = numbers::invalid_unsigned_int,
          const unsigned int      fe_index      = numbers::invalid_unsigned_int);
 
+  /**
+   * Enable or disable the reuse of the data of the FEFaceValues and
+   * FESubfaceValues objects between calls to reinit(). If enabled, reinit()
+   * only recomputes the shape functions, quadrature points, normal vectors,
+   * etc. on those sides of the interface that were not already computed in
+   * the previous call. This is the case if an interface is visited from both
+   * sides in succession, i.e., if reinit() is called with the two cells
+   * exchanged, as happens in loops that compute the contributions of each
+   * side of an interface separately, or if reinit() is called for the same
+   * interface repeatedly. In the former case, the data of the two sides is
+   * exchanged only if both sides use the same quadrature formula, i.e., if
+   * this object was created with a single Quadrature object or an
+   * hp::QCollection with one element. The indices of the degrees of freedom
+   * on the interface are always recomputed.
+   *
+   * The data of a face is discarded automatically only in the cases in which
+   * the FEFaceValues objects forget their present cell, i.e., when the
+   * triangulation is refined or coarsened and when its vertices are moved by
+   * GridTools::transform() or the functions based on it, such as
+   * GridTools::shift() and GridTools::scale(). The internal objects are then
+   * created anew, such that the data the mapping keeps for a cell, like the
+   * support points of MappingQ, is recomputed as well. Other modifications of
+   * the geometry are not noticed, and the data computed before is then
+   * silently reused: vertices moved directly through
+   * <code>cell->vertex(v)</code> or by GridTools::distort_random(), manifolds
+   * attached or changed with Triangulation::set_manifold(), and a
+   * triangulation that is cleared and created anew. In these cases, call this
+   * function again after the modification, which discards the data of all
+   * faces. For the same reason, the reuse must not be enabled for mappings
+   * whose geometry changes without notification by the triangulation, such as
+   * MappingQEulerian or MappingFEField with a changing displacement vector.
+   *
+   * This function is only available if this object does not have
+   * hp-capabilities. The reuse is disabled by default.
+   */
+  void
+  enable_face_data_reuse(const bool enable = true);
+
   /**
    * Return a reference to the FEFaceValues or FESubfaceValues object
    * of the specified cell of the interface.
@@ -2066,6 +2104,61 @@ private:
    */
   std::vector<std::array<unsigned int, 2>> dofmap;
 
+  /**
+   * Scratch arrays for the DoF indices of the two cells and their sorted
+   * list together with the local index, which are used to set up
+   * interface_dof_indices and dofmap in reinit(). The local indices on the
+   * neighboring cell are stored with an offset of the number of DoFs on the
+   * first cell. The arrays are kept between calls to avoid repeated memory
+   * allocation.
+   */
+  std::vector<types::global_dof_index> dof_indices_cell;
+  std::vector<types::global_dof_index> dof_indices_neighbor;
+  std::vector<std::pair<types::global_dof_index, unsigned int>>
+    sorted_dof_indices;
+
+  /**
+   * Whether the data of the FEFaceValues and FESubfaceValues objects is
+   * reused between calls to reinit(), see enable_face_data_reuse().
+   */
+  bool reuse_face_data;
+
+  /**
+   * Whether all FEFaceValues and FESubfaceValues objects of this object use
+   * the same quadrature formula, such that the objects of the two sides of
+   * an interface can be exchanged.
+   */
+  bool sides_are_exchangeable;
+
+  /**
+   * The subface numbers for which internal_fe_subface_values and
+   * internal_fe_subface_values_neighbor were last reinitialized.
+   */
+  std::array<unsigned int, 2> present_sub_face_numbers;
+
+  /**
+   * Return whether @p fe_face_values holds the data of the face @p face_no,
+   * or its subface @p sub_face_no, of @p cell, given the subface number
+   * @p present_sub_face_no of its last initialization.
+   */
+  template <typename CellIteratorType>
+  bool
+  holds_face_data(const FEFaceValuesBase<dim, spacedim> &fe_face_values,
+                  const unsigned int                     present_sub_face_no,
+                  const CellIteratorType                &cell,
+                  const unsigned int                     face_no,
+                  const unsigned int                     sub_face_no) const;
+
+  /**
+   * Create those of the internal FEFaceValues and FESubfaceValues objects
+   * anew that have been initialized before, which discards the data of their
+   * face together with the data the mapping keeps for their cell, like the
+   * support points of MappingQ. If @p only_invalidated is set, only the
+   * objects that have forgotten their present cell are created anew.
+   */
+  void
+  discard_face_data(const bool only_invalidated);
+
   /**
    * Pointer to internal_fe_face_values or internal_fe_subface_values,
    * respectively as determined in reinit().
@@ -2184,6 +2277,10 @@ FEInterfaceValues<dim, spacedim>::FEInterfaceValues(
   const Quadrature<dim - 1>          &quadrature,
   const UpdateFlags                   update_flags)
   : n_quadrature_points(quadrature.size())
+  , reuse_face_data(false)
+  , sides_are_exchangeable(true)
+  , present_sub_face_numbers{
+      {numbers::invalid_unsigned_int, numbers::invalid_unsigned_int}}
   , fe_face_values(nullptr)
   , fe_face_values_neighbor(nullptr)
   , internal_fe_face_values(
@@ -2231,6 +2328,10 @@ FEInterfaceValues<dim, spacedim>::FEInterfaceValues(
   const hp::QCollection<dim - 1>     &quadrature,
   const UpdateFlags                   update_flags)
   : n_quadrature_points(quadrature.max_n_quadrature_points())
+  , reuse_face_data(false)
+  , sides_are_exchangeable(quadrature.size() == 1)
+  , present_sub_face_numbers{
+      {numbers::invalid_unsigned_int, numbers::invalid_unsigned_int}}
   , fe_face_values(nullptr)
   , fe_face_values_neighbor(nullptr)
   , internal_fe_face_values(
@@ -2264,6 +2365,10 @@ FEInterfaceValues<dim, spacedim>::FEInterfaceValues(
   const hp::QCollection<dim - 1>             &quadrature_collection,
   const UpdateFlags                           update_flags)
   : n_quadrature_points(quadrature_collection.max_n_quadrature_points())
+  , reuse_face_data(false)
+  , sides_are_exchangeable(false)
+  , present_sub_face_numbers{
+      {numbers::invalid_unsigned_int, numbers::invalid_unsigned_int}}
   , fe_face_values(nullptr)
   , fe_face_values_neighbor(nullptr)
   , internal_hp_fe_face_values(
@@ -2326,28 +2431,98 @@ FEInterfaceValues<dim, spacedim>::reinit(
 
   if (internal_fe_face_values)
     {
-      if (sub_face_no == numbers::invalid_unsigned_int)
+      const unsigned int invalid = numbers::invalid_unsigned_int;
+
+      // An object that has forgotten its present cell because the mesh was
+      // changed must not take any data from the mapping either, which might
+      // still describe the old geometry if it is reinitialized on the same
+      // cell, so create it anew
+      if (reuse_face_data)
+        discard_face_data(true);
+
+      // If the interface was visited from the other side in the previous
+      // call, the data of the two sides is already available in the objects
+      // of the respective other side, so exchange them.
+      if (reuse_face_data && sides_are_exchangeable)
         {
-          internal_fe_face_values->reinit(cell, face_no);
-          fe_face_values = internal_fe_face_values.get();
+          if (holds_face_data(*internal_fe_face_values_neighbor,
+                              invalid,
+                              cell,
+                              face_no,
+                              sub_face_no) ||
+              holds_face_data(*internal_fe_face_values,
+                              invalid,
+                              cell_neighbor,
+                              face_no_neighbor,
+                              sub_face_no_neighbor))
+            std::swap(internal_fe_face_values,
+                      internal_fe_face_values_neighbor);
+
+          if (holds_face_data(*internal_fe_subface_values_neighbor,
+                              present_sub_face_numbers[1],
+                              cell,
+                              face_no,
+                              sub_face_no) ||
+              holds_face_data(*internal_fe_subface_values,
+                              present_sub_face_numbers[0],
+                              cell_neighbor,
+                              face_no_neighbor,
+                              sub_face_no_neighbor))
+            {
+              std::swap(internal_fe_subface_values,
+                        internal_fe_subface_values_neighbor);
+              std::swap(present_sub_face_numbers[0],
+                        present_sub_face_numbers[1]);
+            }
         }
+
+      if (sub_face_no == invalid)
+        fe_face_values = internal_fe_face_values.get();
+      else
+        fe_face_values = internal_fe_subface_values.get();
+      if (sub_face_no_neighbor == invalid)
+        fe_face_values_neighbor = internal_fe_face_values_neighbor.get();
+      else
+        fe_face_values_neighbor = internal_fe_subface_values_neighbor.get();
+
+      // If the data is still valid, only update the cell iterator, which
+      // might be of a different type than in the previous call (e.g., a
+      // level cell instead of an active cell, or one of another DoFHandler)
+      if (reuse_face_data &&
+          holds_face_data(*fe_face_values,
+                          (sub_face_no == invalid ?
+                             invalid :
+                             present_sub_face_numbers[0]),
+                          cell,
+                          face_no,
+                          sub_face_no))
+        fe_face_values->set_present_cell_keeping_data(cell);
+      else if (sub_face_no == invalid)
+        internal_fe_face_values->reinit(cell, face_no);
       else
         {
           internal_fe_subface_values->reinit(cell, face_no, sub_face_no);
-          fe_face_values = internal_fe_subface_values.get();
-        }
-      if (sub_face_no_neighbor == numbers::invalid_unsigned_int)
-        {
-          internal_fe_face_values_neighbor->reinit(cell_neighbor,
-                                                   face_no_neighbor);
-          fe_face_values_neighbor = internal_fe_face_values_neighbor.get();
+          present_sub_face_numbers[0] = sub_face_no;
         }
+
+      if (reuse_face_data &&
+          holds_face_data(*fe_face_values_neighbor,
+                          (sub_face_no_neighbor == invalid ?
+                             invalid :
+                             present_sub_face_numbers[1]),
+                          cell_neighbor,
+                          face_no_neighbor,
+                          sub_face_no_neighbor))
+        fe_face_values_neighbor->set_present_cell_keeping_data(cell_neighbor);
+      else if (sub_face_no_neighbor == invalid)
+        internal_fe_face_values_neighbor->reinit(cell_neighbor,
+                                                 face_no_neighbor);
       else
         {
           internal_fe_subface_values_neighbor->reinit(cell_neighbor,
                                                       face_no_neighbor,
                                                       sub_face_no_neighbor);
-          fe_face_values_neighbor = internal_fe_subface_values_neighbor.get();
+          present_sub_face_numbers[1] = sub_face_no_neighbor;
         }
 
       AssertDimension(fe_face_values->n_quadrature_points,
@@ -2466,45 +2641,72 @@ FEInterfaceValues<dim, spacedim>::reinit(
   // Set up dof mapping and remove duplicates (for continuous elements).
   {
     // Get dof indices first:
-    std::vector<types::global_dof_index> v(
-      fe_face_values->get_fe().n_dofs_per_cell());
-    cell->get_active_or_mg_dof_indices(v);
-    std::vector<types::global_dof_index> v2(
-      fe_face_values_neighbor->get_fe().n_dofs_per_cell());
-    cell_neighbor->get_active_or_mg_dof_indices(v2);
-
-    // Fill a map from the global dof index to the left and right
-    // local index.
-    std::map<types::global_dof_index, std::pair<unsigned int, unsigned int>>
-                                          tempmap;
-    std::pair<unsigned int, unsigned int> invalid_entry(
-      numbers::invalid_unsigned_int, numbers::invalid_unsigned_int);
-
-    for (unsigned int i = 0; i < v.size(); ++i)
+    const unsigned int n_dofs_cell = fe_face_values->get_fe().n_dofs_per_cell();
+    const unsigned int n_dofs_neighbor =
+      fe_face_values_neighbor->get_fe().n_dofs_per_cell();
+    dof_indices_cell.resize(n_dofs_cell);
+    cell->get_active_or_mg_dof_indices(dof_indices_cell);
+    dof_indices_neighbor.resize(n_dofs_neighbor);
+    cell_neighbor->get_active_or_mg_dof_indices(dof_indices_neighbor);
+
+    // Sort the global dof indices of both cells together with their local
+    // index, where the local indices of the neighbor are shifted by the
+    // number of dofs on the first cell, and merge the entries with the same
+    // global index. This results in the same sorted list of interface dofs
+    // as a map from the global index to the left and right local index, but
+    // does not need to allocate memory once the arrays have been sized.
+    sorted_dof_indices.resize(n_dofs_cell + n_dofs_neighbor);
+    for (unsigned int i = 0; i < n_dofs_cell; ++i)
+      sorted_dof_indices[i] = {dof_indices_cell[i], i};
+    for (unsigned int i = 0; i < n_dofs_neighbor; ++i)
+      sorted_dof_indices[n_dofs_cell + i] = {dof_indices_neighbor[i],
+                                             n_dofs_cell + i};
+    std::sort(sorted_dof_indices.begin(), sorted_dof_indices.end());
+
+    interface_dof_indices.clear();
+    dofmap.clear();
+    for (const auto &[dof_index, i] : sorted_dof_indices)
       {
-        // If not already existing, add an invalid entry:
-        auto result = tempmap.insert(std::make_pair(v[i], invalid_entry));
-        result.first->second.first = i;
+        if (interface_dof_indices.empty() ||
+            interface_dof_indices.back() != dof_index)
+          {
+            interface_dof_indices.push_back(dof_index);
+            dofmap.push_back(
+              {{numbers::invalid_unsigned_int, numbers::invalid_unsigned_int}});
+          }
+        if (i < n_dofs_cell)
+          dofmap.back()[0] = i;
+        else
+          dofmap.back()[1] = i - n_dofs_cell;
       }
+  }
+}
 
-    for (unsigned int i = 0; i < v2.size(); ++i)
-      {
-        // If not already existing, add an invalid entry:
-        auto result = tempmap.insert(std::make_pair(v2[i], invalid_entry));
-        result.first->second.second = i;
-      }
 
-    // Transfer from the map to the sorted std::vectors.
-    dofmap.resize(tempmap.size());
-    interface_dof_indices.resize(tempmap.size());
-    unsigned int idx = 0;
-    for (auto &x : tempmap)
-      {
-        interface_dof_indices[idx] = x.first;
-        dofmap[idx]                = {{x.second.first, x.second.second}};
-        ++idx;
-      }
-  }
+
+template <int dim, int spacedim>
+template <typename CellIteratorType>
+inline bool
+FEInterfaceValues<dim, spacedim>::holds_face_data(
+  const FEFaceValuesBase<dim, spacedim> &fe_face_values,
+  const unsigned int                     present_sub_face_no,
+  const CellIteratorType                &cell,
+  const unsigned int                     face_no,
+  const unsigned int                     sub_face_no) const
+{
+  // The present cell is reset by FEValuesBase if the triangulation is
+  // changed or its vertices are moved, which invalidates the data.
+  if (!fe_face_values.has_present_cell() ||
+      fe_face_values.get_face_number() != face_no ||
+      present_sub_face_no != sub_face_no)
+    return false;
+
+  const typename Triangulation<dim, spacedim>::cell_iterator
+    present_tria_cell = fe_face_values.get_cell();
+  return &present_tria_cell->get_triangulation() ==
+           &cell->get_triangulation() &&
+         present_tria_cell ==
+           typename Triangulation<dim, spacedim>::cell_iterator(cell);
 }
 
 
@@ -2551,6 +2753,54 @@ FEInterfaceValues<dim, spacedim>::reinit(const CellIteratorType &cell,
 
 
 
+template <int dim, int spacedim>
+inline void
+FEInterfaceValues<dim, spacedim>::enable_face_data_reuse(const bool enable)
+{
+  Assert(internal_fe_face_values, ExcOnlyAvailableWithoutHP());
+  reuse_face_data = enable;
+
+  // forget the faces the internal objects were initialized for, such that
+  // the next call to reinit() computes the data of both sides anew
+  discard_face_data(false);
+}
+
+
+
+template <int dim, int spacedim>
+inline void
+FEInterfaceValues<dim, spacedim>::discard_face_data(const bool only_invalidated)
+{
+  const auto discard = [only_invalidated](auto &fe_values) {
+    using FEValuesType = std::remove_reference_t<decltype(*fe_values)>;
+    if (fe_values->get_face_index() == numbers::invalid_unsigned_int ||
+        (only_invalidated && fe_values->has_present_cell()))
+      return false;
+
+    fe_values = std::make_unique<FEValuesType>(fe_values->get_mapping(),
+                                               fe_values->get_fe(),
+                                               fe_values->quadrature,
+                                               fe_values->get_update_flags());
+    return true;
+  };
+
+  bool discarded = false;
+  discarded |= discard(internal_fe_face_values);
+  discarded |= discard(internal_fe_subface_values);
+  discarded |= discard(internal_fe_face_values_neighbor);
+  discarded |= discard(internal_fe_subface_values_neighbor);
+
+  // the objects selected in the last call to reinit() might have been
+  // created anew
+  if (discarded)
+    {
+      fe_face_values          = nullptr;
+      fe_face_values_neighbor = nullptr;
+    }
+}
+
+
+
 template <int dim, int spacedim>
 inline double
 FEInterfaceValues<dim, spacedim>::JxW(const unsigned int q) const
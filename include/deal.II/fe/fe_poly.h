@@ -373,6 +373,15 @@ protected:
     return data_ptr;
   }
 
+  /**
+   * Return @p true, since the InternalData of this class only stores the
+   * values and derivatives of the shape functions on the reference cell,
+   * which fill_fe_values() and friends only read. Derived classes that store
+   * scratch data in their InternalData need to override this function.
+   */
+  virtual bool
+  internal_data_is_shareable() const override;
+
   virtual void
   fill_fe_values(
     const typename Triangulation<dim, spacedim>::cell_iterator &cell,
@@ -213,6 +213,15 @@ FE_Poly<dim, spacedim>::requires_update_flags(const UpdateFlags flags) const
 
 
 
+template <int dim, int spacedim>
+bool
+FE_Poly<dim, spacedim>::internal_data_is_shareable() const
+{
+  return true;
+}
+
+
+
 //---------------------------------------------------------------------------
 // Fill data of FEValues
 //---------------------------------------------------------------------------
@@ -1286,13 +1286,14 @@ private:
     void
     set_fe_data(
       const unsigned int base_no,
-      std::unique_ptr<typename FiniteElement<dim, spacedim>::InternalDataBase>);
+      std::shared_ptr<
+        const typename FiniteElement<dim, spacedim>::InternalDataBase>);
 
     /**
      * Give read-access to the pointer to a @p InternalData of the @p
      * base_noth base element.
      */
-    typename FiniteElement<dim, spacedim>::InternalDataBase &
+    const typename FiniteElement<dim, spacedim>::InternalDataBase &
     get_fe_data(const unsigned int base_no) const;
 
     /**
@@ -1312,10 +1313,12 @@ private:
      * InternalData constructor.  It is filled by the @p get_data function.
      * Note that since the data for each instance of a base class is
      * necessarily the same, we only need as many of these objects as there
-     * are base elements, irrespective of their multiplicity.
+     * are base elements, irrespective of their multiplicity. The objects may
+     * be shared with other FEValues objects if the base element allows it,
+     * see FiniteElement::internal_data_is_shareable().
      */
-    typename std::vector<
-      std::unique_ptr<typename FiniteElement<dim, spacedim>::InternalDataBase>>
+    typename std::vector<std::shared_ptr<
+      const typename FiniteElement<dim, spacedim>::InternalDataBase>>
       base_fe_datas;
 
     /**
@@ -142,6 +142,57 @@ public:
   const Quadrature<dim> &
   get_quadrature() const;
 
+  /**
+   * Let get_function_values() and get_function_gradients() evaluate finite
+   * element functions with sum factorization instead of summing over the
+   * tabulated values and gradients of all shape functions. For elements of
+   * polynomial degree $p$, this reduces the cost of these functions from
+   * ${\cal O}(p^{2d})$ to ${\cal O}(d p^{d+1})$ operations per cell, which
+   * dominates the evaluation of nonlinear residuals with higher-degree
+   * elements. The shape function data returned by shape_value(),
+   * shape_grad(), etc. is not affected.
+   *
+   * The one-dimensional shape data are set up with the
+   * internal::MatrixFreeFunctions::ShapeInfo class also used by
+   * FEEvaluation. Sum factorization is used if all of the following
+   * conditions are met, and the function silently keeps the usual
+   * evaluation otherwise, see uses_sum_factorization():
+   * - The element is a tensor-product element on hypercube cells as
+   *   supported by FEEvaluation, like FE_Q, FE_DGQ, and their variants, or
+   *   an FESystem with several copies of one such element. Elements whose
+   *   shape functions are rescaled on each cell, like FE_Hermite, are not
+   *   supported.
+   * - The quadrature formula is the tensor product of the same
+   *   one-dimensional formula in all coordinate directions, like QGauss.
+   * - The space dimension of the mesh equals the dimension of the cells,
+   *   i.e., <tt>dim == spacedim</tt>.
+   * - The number type of the finite element function is <tt>double</tt> or
+   *   <tt>std::complex<double></tt>.
+   *
+   * The fast path is used by all get_function_values() and
+   * get_function_gradients() variants, for scalar and vector-valued
+   * elements, that are called without an index argument or with exactly
+   * one index per degree of freedom of the cell. Calls with several indices
+   * per degree of freedom use the usual evaluation. Since the
+   * gradients in real space are computed from the inverse Jacobians of the
+   * mapping, update_inverse_jacobians is added to the update flags of the
+   * object if update_gradients is set.
+   *
+   * This function needs to be called before the first call to reinit().
+   * The setting is not transferred to FEValues objects that are created
+   * from the same arguments, such as the copies of MeshWorker::ScratchData
+   * in a parallel loop.
+   */
+  void
+  enable_sum_factorization(const bool enable = true);
+
+  /**
+   * Return whether get_function_values() and get_function_gradients() use
+   * sum factorization, see enable_sum_factorization().
+   */
+  bool
+  uses_sum_factorization() const;
+
   /**
    * Determine an estimate for the memory consumption (in bytes) of this
    * object.
@@ -301,6 +352,12 @@ protected:
    * Store a copy of the quadrature formula here.
    */
   const hp::QCollection<dim - 1> quadrature;
+
+  // FEInterfaceValues creates its FEFaceValues objects anew with the same
+  // quadrature formulas to discard their data, see
+  // FEInterfaceValues::enable_face_data_reuse().
+  template <int, int>
+  friend class FEInterfaceValues;
 };
 
 
@@ -50,6 +50,21 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+// Forward declaration
+#ifndef DOXYGEN
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    template <typename Number>
+    struct ShapeInfo;
+  }
+} // namespace internal
+
+template <int dim, int spacedim>
+class FEInterfaceValues;
+#endif
+
 /**
  * FEValues, FEFaceValues and FESubfaceValues objects are interfaces to finite
  * element and mapping classes on the one hand side, to cells and quadrature
@@ -1481,6 +1496,34 @@ public:
   CellSimilarity::Similarity
   get_cell_similarity() const;
 
+  /**
+   * Return whether this object has been initialized for a cell by a call to
+   * reinit() whose data is still valid. This is no longer the case after
+   * the triangulation of that cell has been refined or coarsened, or its
+   * vertices have been moved.
+   */
+  bool
+  has_present_cell() const;
+
+  /**
+   * Set the current cell to @p cell without recomputing any data. The cell
+   * iterator may be of a different type than the one passed to the last
+   * call of reinit(), e.g., a level cell instead of an active cell, or a
+   * cell of another DoFHandler, but it needs to point to the same cell of the
+   * triangulation as the one this object was last initialized for.
+   *
+   * Like reinit(), this function updates the connections to the
+   * triangulation and the similarity to the previous cell.
+   *
+   * @note This function is meant for classes that build on FEValues objects
+   * and know that the data computed by them is still valid, such as
+   * FEInterfaceValues with FEInterfaceValues::enable_face_data_reuse(). User
+   * codes should call reinit() instead.
+   */
+  template <typename CellIteratorType>
+  void
+  set_present_cell_keeping_data(const CellIteratorType &cell);
+
   /**
    * Determine an estimate for the memory consumption (in bytes) of this
    * object.
@@ -1679,6 +1722,13 @@ protected:
   maybe_invalidate_previous_present_cell(
     const typename Triangulation<dim, spacedim>::cell_iterator &cell);
 
+  /**
+   * The implementation of set_present_cell_keeping_data() once the cell
+   * iterator has been wrapped into a CellIteratorContainer.
+   */
+  void
+  do_set_present_cell_keeping_data(const CellIteratorContainer &cell);
+
   /**
    * A pointer to the mapping object associated with this FEValues object.
    */
@@ -1710,10 +1760,13 @@ protected:
 
   /**
    * A pointer to the internal data object of finite element, obtained from
-   * FiniteElement::get_data(), Mapping::get_face_data(), or
-   * FiniteElement::get_subface_data().
+   * FiniteElement::get_shared_data(), Mapping::get_face_data(), or
+   * FiniteElement::get_subface_data(). The object may be shared with other
+   * FEValues objects for the same finite element, mapping, quadrature
+   * formula, and update flags, see
+   * FiniteElement::internal_data_is_shareable().
    */
-  std::unique_ptr<typename FiniteElement<dim, spacedim>::InternalDataBase>
+  std::shared_ptr<const typename FiniteElement<dim, spacedim>::InternalDataBase>
     fe_data;
 
   /**
@@ -1724,6 +1777,16 @@ protected:
                                                                      spacedim>
     finite_element_output;
 
+  /**
+   * The univariate shape data of a tensor-product element, which
+   * get_function_values() and get_function_gradients() use to evaluate
+   * finite element functions with sum factorization. Only set if
+   * FEValues::enable_sum_factorization() has been called for an element and
+   * quadrature formula that allow for it, and a null pointer otherwise.
+   */
+  std::shared_ptr<const internal::MatrixFreeFunctions::ShapeInfo<double>>
+    tensor_product_shape_info;
+
 
   /**
    * Original update flags handed to the constructor of FEValues.
@@ -1797,6 +1860,17 @@ inline FEValuesBase<dim, spacedim>::CellIteratorContainer::
 
 
 
+template <int dim, int spacedim>
+template <typename CellIteratorType>
+inline void
+FEValuesBase<dim, spacedim>::set_present_cell_keeping_data(
+  const CellIteratorType &cell)
+{
+  do_set_present_cell_keeping_data(CellIteratorContainer(cell));
+}
+
+
+
 template <int dim, int spacedim>
 inline const FEValuesViews::Scalar<dim, spacedim> &
 FEValuesBase<dim, spacedim>::operator[](
@@ -0,0 +1,535 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_values_batch_h
+#define dealii_fe_values_batch_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/std_cxx20/iota_view.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/fe_values_base.h>
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <array>
+
+DEAL_II_NAMESPACE_OPEN
+
+// Forward declaration
+#ifndef DOXYGEN
+template <int dim, int spacedim>
+class MappingQ;
+#endif
+
+/**
+ * Finite element evaluated in quadrature points of several cells at once.
+ *
+ * This class provides a subset of the functionality of FEValues, namely the
+ * values and gradients of the shape functions, the quadrature points, the
+ * Jacobians of the mapping, and the product of the Jacobian determinant with
+ * the quadrature weight, for up to VectorizedArray::size() cells at once. All
+ * cell-dependent quantities are returned as VectorizedArray numbers whose
+ * lanes hold the data of the individual cells, which allows to write the
+ * inner loops of matrix-based assembly in terms of SIMD instructions, as in
+ * the following example for the Laplace matrix:
+ * @code
+ * FEValuesBatch<dim> fe_batch(mapping, fe, quadrature,
+ *                             update_gradients | update_JxW_values);
+ * std::vector<typename DoFHandler<dim>::active_cell_iterator> cells = ...;
+ *
+ * fe_batch.reinit(make_array_view(cells));
+ *
+ * Table<2, VectorizedArray<double>> cell_matrix(dofs_per_cell,
+ *                                               dofs_per_cell);
+ * for (const unsigned int q : fe_batch.quadrature_point_indices())
+ *   for (const unsigned int i : fe_batch.dof_indices())
+ *     {
+ *       const auto grad_i_JxW =
+ *         fe_batch.shape_grad(i, q) * fe_batch.JxW(q);
+ *       for (const unsigned int j : fe_batch.dof_indices())
+ *         cell_matrix(i, j) += grad_i_JxW * fe_batch.shape_grad(j, q);
+ *     }
+ *
+ * for (unsigned int lane = 0; lane < fe_batch.n_active_lanes(); ++lane)
+ *   // copy entry [lane] of the matrix to the global matrix using the
+ *   // DoF indices of cells[lane]
+ * @endcode
+ * The function MeshWorker::mesh_loop_batched() hands groups of cells of the
+ * right size to the cell worker and can be used to run the assembly in
+ * parallel.
+ *
+ * As opposed to FEValues, the class does not go through the
+ * Mapping::fill_fe_values() and FiniteElement::fill_fe_values() interfaces.
+ * Instead, the reference-cell values and gradients of the shape functions
+ * and of the polynomial mapping are tabulated once in the constructor, and
+ * reinit() only collects the support points of the mapping on each cell,
+ * evaluates the Jacobians as the sum over the mapping support points, and
+ * applies the inverse Jacobians to the reference gradients. All of these
+ * operations work on the VectorizedArray data of all cells in the batch.
+ *
+ * The class has the following restrictions:
+ * - The mapping needs to be a MappingQ (or a class derived from it like
+ *   MappingQ1 or MappingQCache), since the geometry is described by the
+ *   support points of the polynomial mapping.
+ * - The finite element needs to be primitive and defined on hypercube cells,
+ *   with shape functions that are defined on the reference cell and
+ *   transformed by composition with the mapping, like FE_Q, FE_DGQ, or an
+ *   FESystem of these elements. For primitive elements with several vector
+ *   components, shape_value() and shape_grad() return the value and gradient
+ *   of the only nonzero component, just like FEValues::shape_value().
+ * - Only cell data in the same space dimension as the mesh is supported,
+ *   i.e., <tt>spacedim==dim</tt>.
+ * - All cells in a batch need to use the same finite element.
+ *
+ * If fewer cells than VectorizedArray::size() are passed to reinit(), the
+ * remaining lanes are filled with the data of the last cell, so that all
+ * lanes contain valid numbers. Only the first n_active_lanes() lanes should
+ * be used when writing the results into global data structures.
+ *
+ * @ingroup feaccess
+ */
+template <int dim, typename Number = double>
+class FEValuesBatch : public Subscriptor
+{
+public:
+  /**
+   * The type of the cell-dependent data, with one lane per cell of the
+   * batch.
+   */
+  using VectorizedArrayType = VectorizedArray<Number>;
+
+  /**
+   * The number of cells that are processed at once.
+   */
+  static constexpr unsigned int n_lanes = VectorizedArrayType::size();
+
+  /**
+   * Constructor. Tabulates the shape functions of @p fe and of the mapping
+   * on the given quadrature formula, for the data requested by
+   * @p update_flags. The flags update_values, update_gradients,
+   * update_quadrature_points, update_jacobians, update_inverse_jacobians,
+   * and update_JxW_values are supported.
+   */
+  FEValuesBatch(const Mapping<dim, dim>       &mapping,
+                const FiniteElement<dim, dim> &fe,
+                const Quadrature<dim>         &quadrature,
+                const UpdateFlags              update_flags);
+
+  /**
+   * Constructor. Like the function above, but uses the default linear
+   * mapping of the reference cell, i.e., MappingQ1.
+   */
+  FEValuesBatch(const FiniteElement<dim, dim> &fe,
+                const Quadrature<dim>         &quadrature,
+                const UpdateFlags              update_flags);
+
+  /**
+   * Reinitialize the data for the given cells, with at most
+   * VectorizedArray::size() entries. The type of the iterators can be any
+   * cell iterator that is convertible to a Triangulation::cell_iterator,
+   * e.g., a DoFHandler::active_cell_iterator.
+   */
+  template <typename CellIteratorType>
+  void
+  reinit(const ArrayView<CellIteratorType> &cells);
+
+  /**
+   * Return the number of cells passed to the last call to reinit().
+   */
+  unsigned int
+  n_active_lanes() const;
+
+  /**
+   * Return the cell in the given lane of the batch passed to the last call
+   * to reinit().
+   */
+  const typename Triangulation<dim>::cell_iterator &
+  get_cell(const unsigned int lane) const;
+
+  /**
+   * Value of shape function @p i at quadrature point @p q. Since the values
+   * do not depend on the cell, all lanes contain the same number.
+   */
+  VectorizedArrayType
+  shape_value(const unsigned int i, const unsigned int q) const;
+
+  /**
+   * Gradient of shape function @p i at quadrature point @p q on the cells
+   * of the batch.
+   */
+  const Tensor<1, dim, VectorizedArrayType> &
+  shape_grad(const unsigned int i, const unsigned int q) const;
+
+  /**
+   * Mapped quadrature weight at quadrature point @p q, i.e., the product of
+   * the determinant of the Jacobian with the weight of the quadrature
+   * formula.
+   */
+  const VectorizedArrayType &
+  JxW(const unsigned int q) const;
+
+  /**
+   * Position of quadrature point @p q in real space.
+   */
+  const Point<dim, VectorizedArrayType> &
+  quadrature_point(const unsigned int q) const;
+
+  /**
+   * Jacobian of the mapping at quadrature point @p q, with entry
+   * <tt>[d][e]</tt> holding the derivative of the real coordinate @p d with
+   * respect to the reference coordinate @p e.
+   */
+  const Tensor<2, dim, VectorizedArrayType> &
+  jacobian(const unsigned int q) const;
+
+  /**
+   * Inverse of the Jacobian of the mapping at quadrature point @p q.
+   */
+  const Tensor<2, dim, VectorizedArrayType> &
+  inverse_jacobian(const unsigned int q) const;
+
+  /**
+   * Return an object that can be thought of as an array containing all
+   * indices from zero to `dofs_per_cell`, see FEValuesBase::dof_indices().
+   */
+  std_cxx20::ranges::iota_view<unsigned int, unsigned int>
+  dof_indices() const;
+
+  /**
+   * Return an object that can be thought of as an array containing all
+   * indices from zero to `n_quadrature_points`, see
+   * FEValuesBase::quadrature_point_indices().
+   */
+  std_cxx20::ranges::iota_view<unsigned int, unsigned int>
+  quadrature_point_indices() const;
+
+  /**
+   * Return a reference to the finite element.
+   */
+  const FiniteElement<dim, dim> &
+  get_fe() const;
+
+  /**
+   * Return a reference to the quadrature formula.
+   */
+  const Quadrature<dim> &
+  get_quadrature() const;
+
+  /**
+   * Return the update flags set by the constructor.
+   */
+  UpdateFlags
+  get_update_flags() const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * Number of quadrature points.
+   */
+  const unsigned int n_quadrature_points;
+
+  /**
+   * Number of shape functions per cell.
+   */
+  const unsigned int dofs_per_cell;
+
+private:
+  /**
+   * Compute the data of the cells stored in the #cells field.
+   */
+  void
+  do_reinit();
+
+  /**
+   * The mapping, cast to MappingQ.
+   */
+  SmartPointer<const MappingQ<dim, dim>, FEValuesBatch<dim, Number>> mapping;
+
+  /**
+   * The finite element.
+   */
+  SmartPointer<const FiniteElement<dim, dim>, FEValuesBatch<dim, Number>> fe;
+
+  /**
+   * The quadrature formula.
+   */
+  const Quadrature<dim> quadrature;
+
+  /**
+   * The update flags, including the flags needed internally.
+   */
+  const UpdateFlags update_flags;
+
+  /**
+   * Values of the shape functions (or of their only nonzero component) on
+   * the reference cell, indexed by shape function and quadrature point.
+   */
+  Table<2, Number> shape_values;
+
+  /**
+   * Gradients of the shape functions on the reference cell, indexed by
+   * shape function and quadrature point.
+   */
+  Table<2, Tensor<1, dim, Number>> unit_shape_gradients;
+
+  /**
+   * Values of the shape functions of the mapping, indexed by quadrature
+   * point and mapping support point in the order returned by
+   * MappingQ::compute_mapping_support_points().
+   */
+  Table<2, Number> mapping_shape_values;
+
+  /**
+   * Reference-cell gradients of the shape functions of the mapping, indexed
+   * by quadrature point and mapping support point.
+   */
+  Table<2, Tensor<1, dim, Number>> mapping_shape_gradients;
+
+  /**
+   * The cells of the current batch.
+   */
+  std::array<typename Triangulation<dim>::cell_iterator, n_lanes> cells;
+
+  /**
+   * The number of cells passed to reinit().
+   */
+  unsigned int n_filled_lanes;
+
+  /**
+   * Support points of the mapping on the cells of the current batch.
+   */
+  AlignedVector<Point<dim, VectorizedArrayType>> mapping_support_points;
+
+  /**
+   * Quadrature points in real space.
+   */
+  AlignedVector<Point<dim, VectorizedArrayType>> quadrature_points;
+
+  /**
+   * Jacobians at the quadrature points.
+   */
+  AlignedVector<Tensor<2, dim, VectorizedArrayType>> jacobians;
+
+  /**
+   * Inverse Jacobians at the quadrature points.
+   */
+  AlignedVector<Tensor<2, dim, VectorizedArrayType>> inverse_jacobians;
+
+  /**
+   * Mapped quadrature weights.
+   */
+  AlignedVector<VectorizedArrayType> JxW_values;
+
+  /**
+   * Gradients of the shape functions in real space, indexed by shape
+   * function and quadrature point.
+   */
+  Table<2, Tensor<1, dim, VectorizedArrayType>> shape_gradients;
+};
+
+
+#ifndef DOXYGEN
+
+/*---------------------- Inline functions -----------------------------------*/
+
+
+template <int dim, typename Number>
+template <typename CellIteratorType>
+inline void
+FEValuesBatch<dim, Number>::reinit(const ArrayView<CellIteratorType> &cells)
+{
+  Assert(cells.size() > 0 && cells.size() <= n_lanes,
+         ExcIndexRange(cells.size(), 1, n_lanes + 1));
+
+  n_filled_lanes = cells.size();
+  for (unsigned int lane = 0; lane < n_lanes; ++lane)
+    this->cells[lane] = typename Triangulation<dim>::cell_iterator(
+      cells[std::min(lane, n_filled_lanes - 1)]);
+
+  do_reinit();
+}
+
+
+
+template <int dim, typename Number>
+inline unsigned int
+FEValuesBatch<dim, Number>::n_active_lanes() const
+{
+  return n_filled_lanes;
+}
+
+
+
+template <int dim, typename Number>
+inline const typename Triangulation<dim>::cell_iterator &
+FEValuesBatch<dim, Number>::get_cell(const unsigned int lane) const
+{
+  AssertIndexRange(lane, n_filled_lanes);
+  return cells[lane];
+}
+
+
+
+template <int dim, typename Number>
+inline typename FEValuesBatch<dim, Number>::VectorizedArrayType
+FEValuesBatch<dim, Number>::shape_value(const unsigned int i,
+                                        const unsigned int q) const
+{
+  AssertIndexRange(i, dofs_per_cell);
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_values,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_values"));
+  return VectorizedArrayType(shape_values(i, q));
+}
+
+
+
+template <int dim, typename Number>
+inline const Tensor<1, dim, VectorizedArray<Number>> &
+FEValuesBatch<dim, Number>::shape_grad(const unsigned int i,
+                                       const unsigned int q) const
+{
+  AssertIndexRange(i, dofs_per_cell);
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_gradients,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_gradients"));
+  return shape_gradients(i, q);
+}
+
+
+
+template <int dim, typename Number>
+inline const VectorizedArray<Number> &
+FEValuesBatch<dim, Number>::JxW(const unsigned int q) const
+{
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_JxW_values,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_JxW_values"));
+  return JxW_values[q];
+}
+
+
+
+template <int dim, typename Number>
+inline const Point<dim, VectorizedArray<Number>> &
+FEValuesBatch<dim, Number>::quadrature_point(const unsigned int q) const
+{
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_quadrature_points,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_quadrature_points"));
+  return quadrature_points[q];
+}
+
+
+
+template <int dim, typename Number>
+inline const Tensor<2, dim, VectorizedArray<Number>> &
+FEValuesBatch<dim, Number>::jacobian(const unsigned int q) const
+{
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_jacobians,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_jacobians"));
+  return jacobians[q];
+}
+
+
+
+template <int dim, typename Number>
+inline const Tensor<2, dim, VectorizedArray<Number>> &
+FEValuesBatch<dim, Number>::inverse_jacobian(const unsigned int q) const
+{
+  AssertIndexRange(q, n_quadrature_points);
+  Assert(update_flags & update_inverse_jacobians,
+         typename FEValuesBase<dim>::ExcAccessToUninitializedField(
+           "update_inverse_jacobians"));
+  return inverse_jacobians[q];
+}
+
+
+
+template <int dim, typename Number>
+inline std_cxx20::ranges::iota_view<unsigned int, unsigned int>
+FEValuesBatch<dim, Number>::dof_indices() const
+{
+  return {0U, dofs_per_cell};
+}
+
+
+
+template <int dim, typename Number>
+inline std_cxx20::ranges::iota_view<unsigned int, unsigned int>
+FEValuesBatch<dim, Number>::quadrature_point_indices() const
+{
+  return {0U, n_quadrature_points};
+}
+
+
+
+template <int dim, typename Number>
+inline const FiniteElement<dim, dim> &
+FEValuesBatch<dim, Number>::get_fe() const
+{
+  return *fe;
+}
+
+
+
+template <int dim, typename Number>
+inline const Quadrature<dim> &
+FEValuesBatch<dim, Number>::get_quadrature() const
+{
+  return quadrature;
+}
+
+
+
+template <int dim, typename Number>
+inline UpdateFlags
+FEValuesBatch<dim, Number>::get_update_flags() const
+{
+  return update_flags;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
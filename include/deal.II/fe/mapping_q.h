@@ -27,18 +27,23 @@
 
 #include <deal.II/fe/mapping.h>
 
+#include <deal.II/grid/cell_id.h>
+#include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
 
 #include <deal.II/matrix_free/shape_info.h>
 
 #include <array>
 #include <cmath>
+#include <map>
 
 DEAL_II_NAMESPACE_OPEN
 
 #ifndef DOXYGEN
 template <int, int>
 class MappingQCache;
+template <int, typename>
+class FEValuesBatch;
 #endif
 
 /**
@@ -157,6 +162,73 @@ public:
   virtual bool
   is_compatible_with(const ReferenceCell &reference_cell) const override;
 
+  /**
+   * Enable or disable the caching of the geometry data computed by
+   * fill_fe_values(), i.e., the quadrature points, Jacobians, inverse
+   * Jacobians, and volume elements, between calls for the same cell. The
+   * cache is stored in the internal data of each FEValues object created
+   * after this call and is keyed by the CellId, so repeated sweeps over the
+   * mesh, e.g. in a nonlinear or time-dependent solver that reassembles a
+   * matrix on an unchanged mesh, skip the computation of the support points
+   * and the evaluation of the mapping on cells that have been visited
+   * before. If the evaluation on affine cells has been enabled by
+   * enable_affine_fast_path(), only one Jacobian is stored per affine cell.
+   *
+   * The cache is cleared automatically only when the triangulation signals
+   * a change through Triangulation::Signals::any_change, i.e., when it is
+   * refined, coarsened, cleared, or created, and when its vertices are
+   * moved by GridTools::transform() or the functions based on it, such as
+   * GridTools::shift(), GridTools::rotate(), and GridTools::scale(). Other
+   * modifications of the geometry are not noticed, and the cached data of
+   * the cells visited before is then silently reused: vertices moved
+   * directly through <code>cell->vertex(v)</code> or by
+   * GridTools::distort_random(), and manifolds attached or changed with
+   * Triangulation::set_manifold(). In these cases, call
+   * clear_cell_data_cache() after the modification.
+   *
+   * The cache is not used when derivatives of the Jacobian are requested.
+   * Since it keys on the cell only, it must not be enabled for derived
+   * classes whose support points change without notification by the
+   * triangulation, such as MappingQEulerian with a changing displacement
+   * vector. MappingQCache clears the cache in each call to
+   * MappingQCache::initialize(), as the support points are computed anew
+   * there.
+   *
+   * The caching is disabled by default. Calling this function also clears
+   * the cached data, see clear_cell_data_cache().
+   */
+  void
+  enable_cell_data_cache(const bool enable = true);
+
+  /**
+   * Enable or disable a shortcut in fill_fe_values() for cells on which the
+   * mapping is affine, i.e., on which the support points of the mapping are
+   * the image of the reference support points under an affine map. On such
+   * cells, the constant Jacobian is read off from the support points, and
+   * the quadrature points, Jacobians, inverse Jacobians, and volume elements
+   * are computed from it directly rather than by evaluating the polynomial
+   * mapping in every quadrature point. This is considerably cheaper for
+   * matrix-based assembly on meshes that consist mostly of parallelograms
+   * or parallelepipeds.
+   *
+   * The results agree with the general evaluation up to roundoff, but not
+   * bit by bit, which is why the shortcut is disabled by default. It is only
+   * used for <code>dim == spacedim</code> and when no derivatives of the
+   * Jacobian are requested. Calling this function also clears the cached
+   * data, see clear_cell_data_cache().
+   */
+  void
+  enable_affine_fast_path(const bool enable = true);
+
+  /**
+   * Clear the geometry data cached by the FEValues objects that use this
+   * mapping, see enable_cell_data_cache(). The data is recomputed when the
+   * cells are visited the next time. This function must not be called
+   * concurrently with the reinitialization of these FEValues objects.
+   */
+  void
+  clear_cell_data_cache();
+
   /**
    * @name Mapping points between reference and real cells
    * @{
@@ -310,6 +382,12 @@ public:
      */
     InternalData(const unsigned int polynomial_degree);
 
+    /**
+     * Destructor. Disconnects the signal of the triangulation used by the
+     * cell data cache.
+     */
+    virtual ~InternalData() override;
+
     /**
      * Initialize the object's member variables related to cell data based on
      * the given arguments.
@@ -450,6 +528,78 @@ public:
      */
     mutable AlignedVector<double> volume_elements;
 
+    /**
+     * Data of a cell stored by the cache enabled through
+     * MappingQ::enable_cell_data_cache(). For affine cells, only the first
+     * support point and the constant Jacobian are stored, from which all
+     * other quantities are recomputed cheaply.
+     */
+    struct CachedCellData
+    {
+      /**
+       * Whether the mapping is affine on the cell.
+       */
+      bool is_affine;
+
+      /**
+       * The quadrature points, or the image of the origin of the reference
+       * cell on affine cells.
+       */
+      std::vector<Point<spacedim>> quadrature_points;
+
+      /**
+       * The Jacobians in the quadrature points, or the single Jacobian on
+       * affine cells.
+       */
+      std::vector<DerivativeForm<1, dim, spacedim>> jacobians;
+
+      /**
+       * The inverse Jacobians in the quadrature points. Empty on affine
+       * cells.
+       */
+      std::vector<DerivativeForm<1, spacedim, dim>> inverse_jacobians;
+
+      /**
+       * The volume elements in the quadrature points. Empty on affine cells.
+       */
+      std::vector<double> volume_elements;
+    };
+
+    /**
+     * Whether fill_fe_values() stores the computed data in #cell_data_cache.
+     */
+    bool cache_cell_data;
+
+    /**
+     * Whether fill_fe_values() uses the shortcut for affine cells, see
+     * MappingQ::enable_affine_fast_path().
+     */
+    bool use_affine_fast_path;
+
+    /**
+     * The cached data of the cells visited by fill_fe_values(), if
+     * #cache_cell_data is set.
+     */
+    mutable std::map<CellId, CachedCellData> cell_data_cache;
+
+    /**
+     * The triangulation the cells in #cell_data_cache belong to.
+     */
+    mutable const Triangulation<dim, spacedim> *cell_data_cache_triangulation;
+
+    /**
+     * The value of MappingQ::cell_data_cache_generation for which
+     * #cell_data_cache was filled. If the two differ, the cache has been
+     * cleared through MappingQ::clear_cell_data_cache() in the meantime.
+     */
+    mutable unsigned int cell_data_cache_generation;
+
+    /**
+     * A signal connection that clears #cell_data_cache whenever the
+     * triangulation is changed, which includes the movement of its vertices.
+     */
+    mutable boost::signals2::connection cell_data_cache_signal;
+
     /**
      * Pointer to the mapping output data that holds most of the arrays,
      * including the Jacobians representing the covariant and contravariant
@@ -604,6 +754,25 @@ protected:
    */
   const Table<2, double> support_point_weights_cell;
 
+  /**
+   * Whether the InternalData objects created by get_data() cache the
+   * geometry data of the cells, see enable_cell_data_cache().
+   */
+  bool cache_cell_data;
+
+  /**
+   * Whether the InternalData objects created by get_data() use the shortcut
+   * for affine cells, see enable_affine_fast_path().
+   */
+  bool use_affine_fast_path;
+
+  /**
+   * A counter that is incremented by clear_cell_data_cache(), which lets the
+   * InternalData objects created by get_data() detect that their cached
+   * data has become invalid.
+   */
+  unsigned int cell_data_cache_generation;
+
   /**
    * Return the locations of support points for the mapping. For example, for
    * $Q_1$ mappings these are the vertices, and for higher order polynomial
@@ -688,6 +857,12 @@ protected:
   // compute_mapping_support_points() function.
   template <int, int>
   friend class MappingQCache;
+
+  // Make FEValuesBatch a friend since it evaluates the mapping from the
+  // support points returned by compute_mapping_support_points() and the
+  // polynomials_1d field.
+  template <int, typename>
+  friend class FEValuesBatch;
 };
 
 
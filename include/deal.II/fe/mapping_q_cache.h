@@ -90,6 +90,10 @@ public:
    *
    * @note The cache is invalidated upon the signal
    * Triangulation::Signals::any_change of the underlying triangulation.
+   *
+   * @note This function and all other variants of initialize() also clear
+   * the geometry data cached by the FEValues objects using this mapping, see
+   * MappingQ::enable_cell_data_cache().
    */
   void
   initialize(const Mapping<dim, spacedim>       &mapping,
@@ -40,6 +40,7 @@
 #include <deal.II/matrix_free/shape_info.h>
 #include <deal.II/matrix_free/tensor_product_kernels.h>
 
+#include <algorithm>
 #include <array>
 #include <limits>
 
@@ -1268,6 +1269,99 @@ namespace internal
 
 
 
+    /**
+     * Check whether the mapping described by the given support points
+     * (in hierarchical numbering) is affine, i.e., whether all support points
+     * are the image of the respective unit support points under the affine
+     * map defined by the first vertex and the edges emanating from it. If
+     * this is the case, return true and the constant Jacobian of the mapping
+     * in @p jacobian.
+     */
+    template <int dim, int spacedim>
+    inline bool
+    compute_affine_jacobian(const std::vector<Point<spacedim>> &support_points,
+                            const std::vector<Point<dim>> &unit_support_points,
+                            DerivativeForm<1, dim, spacedim> &jacobian)
+    {
+      AssertDimension(support_points.size(), unit_support_points.size());
+
+      // vertices 1, 2, and 4 are the neighbors of vertex 0 along the
+      // coordinate directions of the reference cell
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          const Tensor<1, spacedim> edge =
+            support_points[1U << d] - support_points[0];
+          for (unsigned int e = 0; e < spacedim; ++e)
+            jacobian[e][d] = edge[e];
+        }
+
+      const double tolerance = 1e-12 * jacobian.norm();
+      for (unsigned int i = 0; i < support_points.size(); ++i)
+        {
+          const Tensor<1, spacedim> deviation =
+            (support_points[i] - support_points[0]) -
+            apply_transformation(jacobian, unit_support_points[i]);
+          if (deviation.norm_square() > tolerance * tolerance)
+            return false;
+        }
+      return true;
+    }
+
+
+
+    /**
+     * Fill the quadrature points, Jacobians, inverse Jacobians, and volume
+     * elements requested by the update flags of @p data on an affine cell,
+     * given the image @p origin of the origin of the reference cell and the
+     * constant Jacobian @p jacobian. This is a replacement for
+     * maybe_update_q_points_Jacobians_and_grads_tensor() and
+     * maybe_update_q_points_Jacobians_generic() that does not need to
+     * evaluate the polynomial mapping in the quadrature points.
+     */
+    template <int dim, int spacedim>
+    inline void
+    update_q_points_Jacobians_affine(
+      const typename dealii::MappingQ<dim, spacedim>::InternalData &data,
+      const Point<spacedim>                                        &origin,
+      const DerivativeForm<1, dim, spacedim>                       &jacobian,
+      const ArrayView<const Point<dim>>                            &unit_points,
+      std::vector<Point<spacedim>>                  &quadrature_points,
+      std::vector<DerivativeForm<1, dim, spacedim>> &jacobians,
+      std::vector<DerivativeForm<1, spacedim, dim>> &inverse_jacobians)
+    {
+      const UpdateFlags  update_flags = data.update_each;
+      const unsigned int n_q_points   = unit_points.size();
+
+      if (update_flags & update_quadrature_points)
+        {
+          AssertDimension(quadrature_points.size(), n_q_points);
+          for (unsigned int point = 0; point < n_q_points; ++point)
+            quadrature_points[point] =
+              origin + apply_transformation(jacobian, unit_points[point]);
+        }
+
+      if (update_flags & update_contravariant_transformation)
+        {
+          jacobians.resize(n_q_points);
+          std::fill(jacobians.begin(), jacobians.end(), jacobian);
+        }
+
+      if (update_flags & update_covariant_transformation)
+        {
+          inverse_jacobians.resize(n_q_points);
+          std::fill(inverse_jacobians.begin(),
+                    inverse_jacobians.end(),
+                    jacobian.covariant_form().transpose());
+        }
+
+      if (update_flags & update_volume_elements)
+        std::fill(data.volume_elements.begin(),
+                  data.volume_elements.end(),
+                  jacobian.determinant());
+    }
+
+
+
     template <int dim, int spacedim>
     inline void
     maybe_update_q_points_Jacobians_generic(
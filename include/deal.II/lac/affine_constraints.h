@@ -950,7 +950,19 @@ public:
    * \frac{u_3}{2} + \frac{u_2}{4} + \frac{u_4}{4}$. Note, however, that
    * cycles in this graph of constraints are not allowed, i.e., for example
    * $u_4$ may not itself be constrained, directly or indirectly, to $u_{13}$
-   * again.
+   * again. Such a cycle is detected in all build modes and results in an
+   * exception of type ExcMessage being thrown (in previous versions, it was
+   * only checked by an assertion in debug mode).
+   *
+   * The chains are resolved by first computing the depth of each line in
+   * the graph of constraints and then expanding all lines of the same depth
+   * concurrently (in chunks of 100 lines), one depth after another. Each line
+   * is always expanded by a single thread in an order that does not depend on
+   * the number of threads, so the result is reproducible. However, the
+   * entries of a line are accumulated in a different order than in previous
+   * versions, which repeatedly swept over all lines, and the resolved weights
+   * and inhomogeneities may therefore differ from those of previous versions
+   * in the last digits.
    */
   void
   close();
@@ -1701,6 +1713,46 @@ public:
                              VectorType                   &global_vector,
                              bool use_inhomogeneities_for_rhs = false) const;
 
+  /**
+   * Same as the distribute_local_to_global() function above for a
+   * SparseMatrix, but the entries are added to the global matrix and vector
+   * with atomic operations. In contrast to the function above, this function
+   * may therefore be called by several threads at the same time also when the
+   * local contributions touch the same global rows, e.g. for neighboring
+   * cells. This allows to write the local contributions into the global
+   * objects directly from the worker function of an assembly loop, without
+   * the serial copier stage of WorkStream::run() that limits the parallel
+   * speedup of the assembly for many threads, see
+   * WorkStream::run_without_copier().
+   *
+   * The global vector can be of any type whose <tt>operator()</tt> returns a
+   * reference to the vector entry of the given global index, such as Vector
+   * and LinearAlgebra::distributed::Vector.
+   *
+   * @note Since the order in which the contributions of different threads
+   * are summed up is not deterministic, the result may differ in the last
+   * digits from one run to the next, unlike the assembly through the copier
+   * of WorkStream::run().
+   */
+  template <typename VectorType>
+  void
+  distribute_local_to_global_concurrently(
+    const FullMatrix<number>     &local_matrix,
+    const Vector<number>         &local_vector,
+    const std::vector<size_type> &local_dof_indices,
+    SparseMatrix<number>         &global_matrix,
+    VectorType                   &global_vector,
+    bool                          use_inhomogeneities_for_rhs = false) const;
+
+  /**
+   * Same as the function above, but only for the matrix.
+   */
+  void
+  distribute_local_to_global_concurrently(
+    const FullMatrix<number>     &local_matrix,
+    const std::vector<size_type> &local_dof_indices,
+    SparseMatrix<number>         &global_matrix) const;
+
   /**
    * Do a similar operation as the distribute_local_to_global() function that
    * distributes writing entries into a matrix for constrained degrees of
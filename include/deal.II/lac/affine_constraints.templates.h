@@ -58,6 +58,7 @@
 #include <numeric>
 #include <ostream>
 #include <set>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -347,40 +348,94 @@ namespace internal
     constrained_indices.add_indices(constrained_indices_temp.begin(),
                                     constrained_indices_temp.end());
 
-    // step 1: identify owners of constraints
-    std::vector<unsigned int> constrained_indices_owners(
-      constrained_indices.n_elements());
+    IndexSet locally_relevant_dofs_non_local = locally_relevant_dofs;
+    locally_relevant_dofs_non_local.subtract_set(locally_owned_dofs);
+
+    // step 1: identify the owners of the constrained indices and of the
+    // locally relevant dofs in a single lookup. the owners learn from which
+    // ranks they will receive constraints in step 2 and to which ranks they
+    // need to send their constraints in step 3, so that the following two
+    // steps are point-to-point exchanges with known partners and do not
+    // need to run a consensus algorithm again
+    IndexSet indices_to_look_up = constrained_indices;
+    indices_to_look_up.add_indices(locally_relevant_dofs_non_local);
+
+    std::vector<unsigned int> owners(indices_to_look_up.n_elements());
     Utilities::MPI::internal::ComputeIndexOwner::ConsensusAlgorithmsPayload
-      constrained_indices_process(locally_owned_dofs,
-                                  constrained_indices,
-                                  mpi_communicator,
-                                  constrained_indices_owners,
-                                  true);
+      index_owner_process(locally_owned_dofs,
+                          indices_to_look_up,
+                          mpi_communicator,
+                          owners,
+                          true);
 
     Utilities::MPI::ConsensusAlgorithms::Selector<
       std::vector<std::pair<types::global_dof_index, types::global_dof_index>>,
       std::vector<unsigned int>>
       consensus_algorithm;
-    consensus_algorithm.run(constrained_indices_process, mpi_communicator);
+    consensus_algorithm.run(index_owner_process, mpi_communicator);
+
+    // the ranks that requested indices from the current rank, which are
+    // exactly the ranks the current rank receives data from in step 2 and
+    // sends data to in step 3
+    std::map<unsigned int, IndexSet> requesters =
+      index_owner_process.get_requesters();
+    requesters.erase(my_rank);
+
+    // the ranks that own indices looked up by the current rank, which are
+    // exactly the ranks the current rank sends data to in step 2 and
+    // receives data from in step 3
+    std::set<unsigned int> owner_ranks(owners.begin(), owners.end());
+    owner_ranks.erase(my_rank);
+
+    // helper function to receive the constraints sent with the given tag
+    // from n_ranks ranks
+    const auto receive_constraints = [&](const unsigned int tag,
+                                         const std::size_t  n_ranks) {
+      std::vector<ConstraintType> received;
+      for (std::size_t counter = 0; counter < n_ranks; ++counter)
+        {
+          MPI_Status status;
+          int ierr = MPI_Probe(MPI_ANY_SOURCE, tag, mpi_communicator, &status);
+          AssertThrowMPI(ierr);
 
-    // step 2: collect all locally owned constraints
-    const auto constrained_indices_by_ranks =
-      constrained_indices_process.get_requesters();
+          int message_length;
+          ierr = MPI_Get_count(&status, MPI_CHAR, &message_length);
+          AssertThrowMPI(ierr);
+
+          std::vector<char> buffer(message_length);
 
+          ierr = MPI_Recv(buffer.data(),
+                          buffer.size(),
+                          MPI_CHAR,
+                          status.MPI_SOURCE,
+                          tag,
+                          mpi_communicator,
+                          MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+
+          const auto data =
+            Utilities::unpack<std::vector<ConstraintType>>(buffer, false);
+          received.insert(received.end(), data.begin(), data.end());
+        }
+      return received;
+    };
+
+    // step 2: collect all locally owned constraints
     {
       const unsigned int tag = Utilities::MPI::internal::Tags::
         affine_constraints_make_consistent_in_parallel_0;
 
-      // ... collect data and sort according to owner
+      // ... collect data and sort according to owner. every owner gets a
+      // message, possibly an empty one, since it expects one from each
+      // requester
       std::map<unsigned int, std::vector<ConstraintType>> send_data_temp;
+      for (const unsigned int rank : owner_ranks)
+        send_data_temp[rank];
 
-      for (unsigned int i = 0; i < constrained_indices_owners.size(); ++i)
+      for (const auto index : constrained_indices)
         {
           ConstraintType entry;
 
-          const types::global_dof_index index =
-            constrained_indices.nth_index_in_set(i);
-
           entry.index = index;
 
           if (constraints_in.is_inhomogeneously_constrained(index))
@@ -390,10 +445,12 @@ namespace internal
                 constraints_in.get_constraint_entries(index))
             entry.entries = *constraints;
 
-          if (constrained_indices_owners[i] == my_rank)
+          const unsigned int owner =
+            owners[indices_to_look_up.index_within_set(index)];
+          if (owner == my_rank)
             locally_relevant_constraints.push_back(entry);
           else
-            send_data_temp[constrained_indices_owners[i]].push_back(entry);
+            send_data_temp[owner].push_back(entry);
         }
 
       std::map<unsigned int, std::vector<char>> send_data;
@@ -407,9 +464,6 @@ namespace internal
       // ... send data
       for (const auto &i : send_data)
         {
-          if (i.first == my_rank)
-            continue;
-
           requests.push_back({});
 
           const int ierr = MPI_Isend(i.second.data(),
@@ -423,39 +477,11 @@ namespace internal
         }
 
       // ... receive data
-      unsigned int n_rec_ranks = 0;
-
-      for (const auto &i : constrained_indices_by_ranks)
-        if (i.first != my_rank)
-          n_rec_ranks++;
-
-      for (unsigned int i = 0; i < n_rec_ranks; ++i)
-        {
-          MPI_Status status;
-          int ierr = MPI_Probe(MPI_ANY_SOURCE, tag, mpi_communicator, &status);
-          AssertThrowMPI(ierr);
-
-          int message_length;
-          ierr = MPI_Get_count(&status, MPI_CHAR, &message_length);
-          AssertThrowMPI(ierr);
-
-          std::vector<char> buffer(message_length);
-
-          ierr = MPI_Recv(buffer.data(),
-                          buffer.size(),
-                          MPI_CHAR,
-                          status.MPI_SOURCE,
-                          tag,
-                          mpi_communicator,
-                          MPI_STATUS_IGNORE);
-          AssertThrowMPI(ierr);
-
-          const auto data =
-            Utilities::unpack<std::vector<ConstraintType>>(buffer, false);
-
-          for (const auto &i : data)
-            locally_relevant_constraints.push_back(i);
-        }
+      const std::vector<ConstraintType> received =
+        receive_constraints(tag, requesters.size());
+      locally_relevant_constraints.insert(locally_relevant_constraints.end(),
+                                          received.begin(),
+                                          received.end());
 
       const int ierr =
         MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
@@ -470,52 +496,30 @@ namespace internal
       const unsigned int tag = Utilities::MPI::internal::Tags::
         affine_constraints_make_consistent_in_parallel_1;
 
-      // ... determine owners of locally relevant dofs
-      IndexSet locally_relevant_dofs_non_local = locally_relevant_dofs;
-      locally_relevant_dofs_non_local.subtract_set(locally_owned_dofs);
-
-      std::vector<unsigned int> locally_relevant_dofs_owners(
-        locally_relevant_dofs_non_local.n_elements());
-      Utilities::MPI::internal::ComputeIndexOwner::ConsensusAlgorithmsPayload
-        locally_relevant_dofs_process(locally_owned_dofs,
-                                      locally_relevant_dofs_non_local,
-                                      mpi_communicator,
-                                      locally_relevant_dofs_owners,
-                                      true);
-
-      Utilities::MPI::ConsensusAlgorithms::Selector<
-        std::vector<
-          std::pair<types::global_dof_index, types::global_dof_index>>,
-        std::vector<unsigned int>>
-        consensus_algorithm;
-      consensus_algorithm.run(locally_relevant_dofs_process, mpi_communicator);
-
-      const auto locally_relevant_dofs_by_ranks =
-        locally_relevant_dofs_process.get_requesters();
-
       std::map<unsigned int, std::vector<char>> send_data;
 
       std::vector<MPI_Request> requests;
-      requests.reserve(send_data.size());
+      requests.reserve(requesters.size());
 
       // ... send data
-      for (const auto &rank_and_indices : locally_relevant_dofs_by_ranks)
+      for (const auto &rank_and_indices : requesters)
         {
-          Assert(rank_and_indices.first != my_rank, ExcInternalError());
-
           std::vector<ConstraintType> data;
 
+          // note: at this stage locally_relevant_constraints still contains
+          // only locally owned constraints, sorted by their index
           for (const auto index : rank_and_indices.second)
             {
-              // note: at this stage locally_relevant_constraints still
-              // contains only locally owned constraints
               const auto ptr =
-                std::find_if(locally_relevant_constraints.begin(),
-                             locally_relevant_constraints.end(),
-                             [index](const auto &a) {
-                               return a.index == index;
-                             });
-              if (ptr != locally_relevant_constraints.end())
+                std::lower_bound(locally_relevant_constraints.begin(),
+                                 locally_relevant_constraints.end(),
+                                 index,
+                                 [](const ConstraintType         &a,
+                                    const types::global_dof_index b) {
+                                   return a.index < b;
+                                 });
+              if (ptr != locally_relevant_constraints.end() &&
+                  ptr->index == index)
                 data.push_back(*ptr);
             }
 
@@ -533,49 +537,12 @@ namespace internal
           AssertThrowMPI(ierr);
         }
 
-      // ... receive data
-      const unsigned int n_rec_ranks = [&]() {
-        // count number of ranks from where data will be received from
-        // by looping locally_relevant_dofs_owners and identifying unique
-        // rank (ignoring the current rank)
-
-        std::set<unsigned int> rec_ranks;
-
-        for (const unsigned int rank : locally_relevant_dofs_owners)
-          if (rank != my_rank)
-            rec_ranks.insert(rank);
-
-        return rec_ranks.size();
-      }();
-
-      for (unsigned int counter = 0; counter < n_rec_ranks; ++counter)
-        {
-          MPI_Status status;
-          int ierr = MPI_Probe(MPI_ANY_SOURCE, tag, mpi_communicator, &status);
-          AssertThrowMPI(ierr);
-
-          int message_length;
-          ierr = MPI_Get_count(&status, MPI_CHAR, &message_length);
-          AssertThrowMPI(ierr);
-
-          std::vector<char> buffer(message_length);
-
-          ierr = MPI_Recv(buffer.data(),
-                          buffer.size(),
-                          MPI_CHAR,
-                          status.MPI_SOURCE,
-                          tag,
-                          mpi_communicator,
-                          MPI_STATUS_IGNORE);
-          AssertThrowMPI(ierr);
-
-          const auto received_locally_relevant_constrain =
-            Utilities::unpack<std::vector<ConstraintType>>(buffer, false);
-
-          for (const auto &locally_relevant_constrain :
-               received_locally_relevant_constrain)
-            locally_relevant_constraints.push_back(locally_relevant_constrain);
-        }
+      // ... receive data. the owners send the constraints of all indices
+      // looked up in step 1, of which we only keep the locally relevant ones
+      for (const ConstraintType &line :
+           receive_constraints(tag, owner_ranks.size()))
+        if (locally_relevant_dofs_non_local.is_element(line.index))
+          locally_relevant_constraints.push_back(line);
 
       const int ierr =
         MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
@@ -791,173 +758,159 @@ AffineConstraints<number>::close()
 
 
 
-#ifdef DEBUG
-  // In debug mode we are computing an estimate for the maximum number
-  // of constraints so that we can bail out if there is a cycle in the
-  // constraints (which is easier than searching for cycles in the graph).
+  // replace references to dofs that are themselves constrained. note that
+  // because we may replace references to other dofs that may themselves be
+  // constrained to third ones, we have to resolve the whole chain of
+  // constraints
   //
-  // Let us figure out the largest dof index. This is an upper bound for the
-  // number of constraints because it is an approximation for the number of dofs
-  // in our system.
-  size_type largest_idx = 0;
-  for (const ConstraintLine &line : lines)
-    for (const std::pair<size_type, number> &entry : line.entries)
-      largest_idx = std::max(largest_idx, entry.first);
-#endif
+  // the replacement substitutes references to constrained degrees of freedom
+  // by their expansion. for example if x3=x0/2+x2/2 and x2=x0/2+x1/2, then
+  // the new list will be x3=x0/2+x0/4+x1/4. note that x0 appear twice. we
+  // will throw this duplicate out in the following step, where we sort the
+  // list so that throwing out duplicates becomes much more efficient.
+  //
+  // rather than iterating over all lines until no chains are left, we first
+  // compute the depth of each line in the graph of constraints: a line whose
+  // entries are not constrained has depth zero, and all other lines have one
+  // more than the largest depth of the constrained entries they refer to. a
+  // line is then resolved by a single substitution of the lines of smaller
+  // depth, provided these have been resolved before. all lines of the same
+  // depth are independent of each other and can be resolved in parallel.
+  const auto get_line_position = [this](const size_type dof) {
+    const size_type dof_index = calculate_line_index(dof);
+    return dof_index < lines_cache.size() ? lines_cache[dof_index] :
+                                            numbers::invalid_size_type;
+  };
 
-      // replace references to dofs that are themselves constrained. note that
-      // because we may replace references to other dofs that may themselves be
-      // constrained to third ones, we have to iterate over all this until we
-      // replace no chains of constraints any more
-      //
-      // the iteration replaces references to constrained degrees of freedom by
-      // second-order references. for example if x3=x0/2+x2/2 and x2=x0/2+x1/2,
-      // then the new list will be x3=x0/2+x0/4+x1/4. note that x0 appear
-      // twice. we will throw this duplicate out in the following step, where
-      // we sort the list so that throwing out duplicates becomes much more
-      // efficient. also, we have to do it only once, rather than in each
-      // iteration
-#ifdef DEBUG
-  size_type iteration = 0;
-#endif
-  bool              chained_constraint_replaced = false;
-  std::vector<bool> line_finalized(lines.size(), false);
-  do
-    {
-      chained_constraint_replaced = false;
-      for (unsigned int line_index = 0; line_index < lines.size(); ++line_index)
-        if (line_finalized[line_index] == false)
+  // compute the depths by a depth-first search through the graph of
+  // constraints, which also detects cycles. each entry of the stack holds
+  // the position of a line, the next entry of the line to look at, and the
+  // depth of the line computed from the entries looked at so far
+  constexpr unsigned int depth_in_progress = numbers::invalid_unsigned_int - 1;
+  std::vector<unsigned int> depth(lines.size(), numbers::invalid_unsigned_int);
+  std::vector<std::tuple<size_type, size_type, unsigned int>> stack;
+  unsigned int                                                max_depth = 0;
+  for (size_type start = 0; start < lines.size(); ++start)
+    if (depth[start] == numbers::invalid_unsigned_int)
+      {
+        depth[start] = depth_in_progress;
+        stack.emplace_back(start, 0, 0);
+        while (stack.empty() == false)
           {
-            ConstraintLine &line = lines[line_index];
-
-#ifdef DEBUG
-            // we need to keep track of how many replacements we do in this
-            // line, because we can end up in a cycle A->B->C->A without the
-            // number of entries growing.
-            size_type n_replacements = 0;
-#endif
-
-            // loop over all entries of this line (including ones that we
-            // have appended in this go around) and see whether they are
-            // further constrained. ignore elements that we don't store on
-            // the current processor.
-            const unsigned int n_original_entries  = line.entries.size();
-            bool               has_sub_constraints = false;
-            const size_type    lines_cache_size    = lines_cache.size();
-            for (unsigned int entry = 0; entry < n_original_entries; ++entry)
+            auto &[line_position, entry, line_depth] = stack.back();
+            const typename ConstraintLine::Entries &entries =
+              lines[line_position].entries;
+            if (entry < entries.size())
               {
-                const size_type dof_index =
-                  calculate_line_index(line.entries[entry].first);
-
-                if (dof_index < lines_cache_size &&
-                    lines_cache[dof_index] != numbers::invalid_size_type)
+                const size_type other_position =
+                  get_line_position(entries[entry].first);
+                ++entry;
+                if (other_position != numbers::invalid_size_type)
                   {
-                    // Now we found an index that is further constrained, so
-                    // we need to resolve the entries.  We may replace some of
-                    // them, and we may add some, but we only walk through the
-                    // original entries (and also don't touch the
-                    // replacements) even though in principle we could also do
-                    // the ones we have added or replaced. There is no harm in
-                    // doing so: we will simply treat those in the next round
-                    // around of the outer iteration.
-                    has_sub_constraints = true;
-
-                    const number weight = line.entries[entry].second;
-                    Assert(line.entries[entry].first != line.index,
-                           ExcMessage("Cycle in constraints detected!"));
-
-                    const ConstraintLine &constrained_line =
-                      lines[lines_cache[dof_index]];
-                    Assert(constrained_line.index == line.entries[entry].first,
-                           ExcInternalError());
-
-                    // now we have to replace an entry by its expansion. we do
-                    // that by overwriting the entry by the first entry of the
-                    // expansion and adding the remaining ones to the end,
-                    // where we will later process them once more
-                    //
-                    // we can of course only do that if the DoF that we are
-                    // currently handling is constrained by a linear combination
-                    // of other dofs:
-                    if (constrained_line.entries.size() > 0)
+                    AssertThrow(depth[other_position] != depth_in_progress,
+                                ExcMessage("Cycle in constraints detected!"));
+                    if (depth[other_position] == numbers::invalid_unsigned_int)
                       {
-                        for (size_type i = 0;
-                             i < constrained_line.entries.size();
-                             ++i)
-                          Assert(line.entries[entry].first !=
-                                   constrained_line.entries[i].first,
-                                 ExcMessage("Cycle in constraints detected!"));
-
-                        // replace first entry, then tack the rest to the end
-                        // of the list
-                        line.entries[entry] = std::pair<size_type, number>(
-                          constrained_line.entries[0].first,
-                          constrained_line.entries[0].second * weight);
-
-                        for (size_type i = 1;
-                             i < constrained_line.entries.size();
-                             ++i)
-                          line.entries.emplace_back(
-                            constrained_line.entries[i].first,
-                            constrained_line.entries[i].second * weight);
-
-#ifdef DEBUG
-                        // keep track of how many entries we replace in this
-                        // line. If we do more than there are constraints or
-                        // dofs in our system, we must have a cycle.
-                        ++n_replacements;
-                        Assert(n_replacements / 2 < largest_idx,
-                               ExcMessage("Cycle in constraints detected!"));
-#endif
+                        depth[other_position] = depth_in_progress;
+                        stack.emplace_back(other_position, 0, 0);
                       }
                     else
-                      // the DoF that we encountered is not constrained by a
-                      // linear combination of other dofs but is equal to just
-                      // the inhomogeneity (i.e. its chain of entries is
-                      // empty). in that case, we can't just overwrite the
-                      // current entry, but we have to actually eliminate
-                      // it. we do not want to change the loop length above we
-                      // do so by setting the 'first' entry to
-                      // invalid_size_type here to finally remove entries in a
-                      // second loop
-                      {
-                        line.entries[entry].first = numbers::invalid_size_type;
-                      }
-
-                    line.inhomogeneity +=
-                      constrained_line.inhomogeneity * weight;
+                      line_depth =
+                        std::max(line_depth, depth[other_position] + 1);
                   }
               }
-
-            // If none of the entries in the current line refer to DoFs that are
-            // themselves constrained, then we can move on:
-            if (has_sub_constraints == false)
-              line_finalized[line_index] = true;
             else
               {
-                chained_constraint_replaced = true;
-
-                // Now delete the elements we have marked for deletion.
-                auto remaining_entries = line.entries.begin();
-                for (const auto &entry : line.entries)
-                  if (entry.first != numbers::invalid_size_type)
-                    {
-                      *remaining_entries = entry;
-                      ++remaining_entries;
-                    }
-                line.entries.erase(remaining_entries, line.entries.end());
+                const unsigned int final_depth = line_depth;
+                depth[line_position]           = final_depth;
+                max_depth = std::max(max_depth, final_depth);
+                stack.pop_back();
+                if (stack.empty() == false)
+                  std::get<2>(stack.back()) =
+                    std::max(std::get<2>(stack.back()), final_depth + 1);
               }
           }
+      }
 
-#ifdef DEBUG
-      // increase iteration count. note that we should not iterate more
-      // times than there are constraints, since this puts a natural upper
-      // bound on the length of constraint chains
-      ++iteration;
-      Assert(iteration <= lines.size() + 1, ExcInternalError());
-#endif
-    }
-  while (chained_constraint_replaced == true);
+  // sort the positions of the lines by their depth
+  std::vector<size_type> depth_offsets(max_depth + 2, 0);
+  for (const unsigned int line_depth : depth)
+    ++depth_offsets[line_depth + 1];
+  for (unsigned int d = 0; d <= max_depth; ++d)
+    depth_offsets[d + 1] += depth_offsets[d];
+  std::vector<size_type> lines_by_depth(lines.size());
+  {
+    std::vector<size_type> next_position(depth_offsets.begin(),
+                                         depth_offsets.end() - 1);
+    for (size_type i = 0; i < lines.size(); ++i)
+      lines_by_depth[next_position[depth[i]]++] = i;
+  }
+
+  // resolve the lines with depth one and larger, one depth after another
+  for (unsigned int d = 1; d <= max_depth; ++d)
+    parallel::apply_to_subranges(
+      lines_by_depth.begin() + depth_offsets[d],
+      lines_by_depth.begin() + depth_offsets[d + 1],
+      [&](const std::vector<size_type>::iterator &begin,
+          const std::vector<size_type>::iterator &end) {
+        for (const size_type line_position :
+             boost::iterator_range<std::vector<size_type>::iterator>(begin,
+                                                                     end))
+          {
+            ConstraintLine &line = lines[line_position];
+
+            // we only walk through the original entries: the entries
+            // appended below come from resolved lines and are not
+            // constrained
+            const size_type n_original_entries = line.entries.size();
+            for (size_type entry = 0; entry < n_original_entries; ++entry)
+              {
+                const size_type other_position =
+                  get_line_position(line.entries[entry].first);
+                if (other_position == numbers::invalid_size_type)
+                  continue;
+
+                Assert(depth[other_position] < d, ExcInternalError());
+                const ConstraintLine &constrained_line = lines[other_position];
+                const number          weight = line.entries[entry].second;
+
+                // now we have to replace an entry by its expansion. we do
+                // that by overwriting the entry by the first entry of the
+                // expansion and adding the remaining ones to the end.
+                //
+                // if the DoF is not constrained by a linear combination of
+                // other dofs but equal to just the inhomogeneity, we have to
+                // eliminate the entry. we do not want to change the loop
+                // length and mark it by invalid_size_type to remove it below
+                if (constrained_line.entries.size() > 0)
+                  {
+                    line.entries[entry] = std::pair<size_type, number>(
+                      constrained_line.entries[0].first,
+                      constrained_line.entries[0].second * weight);
+
+                    for (size_type i = 1; i < constrained_line.entries.size();
+                         ++i)
+                      line.entries.emplace_back(
+                        constrained_line.entries[i].first,
+                        constrained_line.entries[i].second * weight);
+                  }
+                else
+                  line.entries[entry].first = numbers::invalid_size_type;
+
+                line.inhomogeneity += constrained_line.inhomogeneity * weight;
+              }
+
+            // now delete the elements we have marked for deletion
+            line.entries.erase(
+              std::remove_if(line.entries.begin(),
+                             line.entries.end(),
+                             [](const std::pair<size_type, number> &p) {
+                               return p.first == numbers::invalid_size_type;
+                             }),
+              line.entries.end());
+          }
+      },
+      /* grainsize = */ 100);
 
   // Finally sort the entries and re-scale them if necessary. in this step,
   // we also throw out duplicates as mentioned above. moreover, as some
@@ -4003,6 +3956,109 @@ namespace internal
         }
     }
 
+    // add a value to an entry of a matrix or vector with an atomic operation
+    // for distribute_local_to_global_concurrently()
+    template <typename number>
+    inline void
+    atomic_add(number &destination, const number value)
+    {
+      Kokkos::atomic_add(&destination, value);
+    }
+
+    // std::complex<T> is guaranteed to have the layout of an array of two T,
+    // so add the real and imaginary parts separately. Each of the two parts
+    // is updated atomically, which is all we need for a sum.
+    template <typename number>
+    inline void
+    atomic_add(std::complex<number> &destination,
+               const std::complex<number> value)
+    {
+      number *parts = reinterpret_cast<number *>(&destination);
+      Kokkos::atomic_add(parts, value.real());
+      Kokkos::atomic_add(parts + 1, value.imag());
+    }
+
+    // add the entries of a row given by column indices sorted in ascending
+    // order to a square SparseMatrix with atomic operations. Like in
+    // resolve_matrix_row() above, we can walk through the row along with the
+    // column indices, except for the diagonal that is stored first in the
+    // row of a square matrix. This also gives us the address of the values of
+    // the row.
+    template <typename number>
+    inline void
+    atomic_add_to_matrix_row(const size_type       row,
+                             const size_type       n_values,
+                             const size_type      *column_indices,
+                             const number         *values,
+                             SparseMatrix<number> &sparse_matrix)
+    {
+      const SparsityPattern &sparsity = sparse_matrix.get_sparsity_pattern();
+      Assert(sparsity.n_rows() == sparsity.n_cols(), ExcNotQuadratic());
+
+      number *const      row_values = &sparse_matrix.diag_element(row);
+      const unsigned int row_length = sparsity.row_length(row);
+
+      unsigned int k = 1;
+      for (size_type j = 0; j < n_values; ++j)
+        {
+          const size_type column = column_indices[j];
+          if (values[j] == number())
+            continue;
+          if (column == row)
+            {
+              atomic_add(row_values[0], values[j]);
+              continue;
+            }
+
+          while (k < row_length && sparsity.column_number(row, k) < column)
+            ++k;
+          Assert(k < row_length && sparsity.column_number(row, k) == column,
+                 typename SparseMatrix<number>::ExcInvalidIndex(row, column));
+          atomic_add(row_values[k], values[j]);
+        }
+    }
+
+    // wrapper around a SparseMatrix that forwards the additions to the
+    // diagonal in set_matrix_diagonals() to atomic_add()
+    template <typename number>
+    struct AtomicDiagonalAccess
+    {
+      void
+      add(const size_type row, const size_type column, const number value)
+      {
+        (void)column;
+        AssertDimension(row, column);
+        atomic_add(sparse_matrix.diag_element(row), value);
+      }
+
+      SparseMatrix<number> &sparse_matrix;
+    };
+
+    // wrapper around a vector that forwards the additions in
+    // set_matrix_diagonals() to atomic_add()
+    template <typename VectorType>
+    struct AtomicVectorAccess
+    {
+      struct EntryReference
+      {
+        void
+        operator+=(const typename VectorType::value_type value)
+        {
+          atomic_add(entry, value);
+        }
+
+        typename VectorType::value_type &entry;
+      };
+
+      EntryReference
+      operator()(const size_type index)
+      {
+        return EntryReference{vector(index)};
+      }
+
+      VectorType &vector;
+    };
+
   } // end of namespace AffineConstraints
 } // end of namespace internal
 
@@ -4344,6 +4400,117 @@ AffineConstraints<number>::distribute_local_to_global(
 
 
 
+// similar function as above, but adding into the global matrix and vector
+// with atomic operations such that several threads can call this function at
+// the same time. See the other function for additional comments.
+template <typename number>
+template <typename VectorType>
+void
+AffineConstraints<number>::distribute_local_to_global_concurrently(
+  const FullMatrix<number>     &local_matrix,
+  const Vector<number>         &local_vector,
+  const std::vector<size_type> &local_dof_indices,
+  SparseMatrix<number>         &global_matrix,
+  VectorType                   &global_vector,
+  const bool                    use_inhomogeneities_for_rhs) const
+{
+  const bool use_vectors =
+    (local_vector.size() == 0 && global_vector.size() == 0) ? false : true;
+
+  AssertDimension(local_matrix.n(), local_dof_indices.size());
+  AssertDimension(local_matrix.m(), local_dof_indices.size());
+  Assert(global_matrix.m() == global_matrix.n(), ExcNotQuadratic());
+  if (use_vectors == true)
+    {
+      AssertDimension(local_matrix.m(), local_vector.size());
+      AssertDimension(global_matrix.m(), global_vector.size());
+    }
+  Assert(lines.empty() || sorted == true, ExcMatrixNotClosed());
+
+  if (global_matrix.get_sparsity_pattern().n_nonzero_elements() == 0)
+    return;
+
+  const size_type n_local_dofs = local_dof_indices.size();
+
+  typename internal::AffineConstraints::ScratchDataAccessor<number>
+    scratch_data(this->scratch_data);
+
+  internal::AffineConstraints::GlobalRowsFromLocal<number> &global_rows =
+    scratch_data->global_rows;
+  global_rows.reinit(n_local_dofs);
+  make_sorted_row_list(local_dof_indices, global_rows);
+
+  const size_type n_actual_dofs = global_rows.size();
+
+  // resolve the rows into the scratch arrays first and then add the whole
+  // row, rather than the in-place shortcut for SparseMatrix used by the
+  // other function, to keep the atomic operations apart from the
+  // resolution of the constraints
+  std::vector<size_type> &cols = scratch_data->columns;
+  std::vector<number>    &vals = scratch_data->values;
+  cols.resize(n_actual_dofs);
+  vals.resize(n_actual_dofs);
+
+  for (size_type i = 0; i < n_actual_dofs; ++i)
+    {
+      const size_type row = global_rows.global_row(i);
+
+      size_type *col_ptr = cols.data();
+      number    *val_ptr = vals.data();
+      internal::AffineConstraints::resolve_matrix_row(global_rows,
+                                                      global_rows,
+                                                      i,
+                                                      0,
+                                                      n_actual_dofs,
+                                                      local_matrix,
+                                                      col_ptr,
+                                                      val_ptr);
+      const size_type n_values = col_ptr - cols.data();
+      if (n_values > 0)
+        internal::AffineConstraints::atomic_add_to_matrix_row(
+          row, n_values, cols.data(), vals.data(), global_matrix);
+
+      if (use_vectors == true)
+        {
+          const typename VectorType::value_type val = resolve_vector_entry(
+            i, global_rows, local_vector, local_dof_indices, local_matrix);
+          AssertIsFinite(val);
+
+          if (val != typename VectorType::value_type())
+            internal::AffineConstraints::atomic_add(global_vector(row), val);
+        }
+    }
+
+  internal::AffineConstraints::AtomicDiagonalAccess<number> matrix_access{
+    global_matrix};
+  internal::AffineConstraints::AtomicVectorAccess<VectorType> vector_access{
+    global_vector};
+  internal::AffineConstraints::set_matrix_diagonals(
+    global_rows,
+    local_dof_indices,
+    local_matrix,
+    *this,
+    matrix_access,
+    vector_access,
+    use_inhomogeneities_for_rhs);
+}
+
+
+
+template <typename number>
+void
+AffineConstraints<number>::distribute_local_to_global_concurrently(
+  const FullMatrix<number>     &local_matrix,
+  const std::vector<size_type> &local_dof_indices,
+  SparseMatrix<number>         &global_matrix) const
+{
+  Vector<number> dummy(0);
+  distribute_local_to_global_concurrently(
+    local_matrix, dummy, local_dof_indices, global_matrix, dummy, false);
+}
+
+
+
 // similar function as above, but now specialized for block matrices. See the
 // other function for additional comments.
 template <typename number>
@@ -439,6 +439,21 @@ DEAL_II_NAMESPACE_OPEN
  *
  * The use of this class is demonstrated in step-51.
  *
+ * A natural application of this class are vector-valued problems discretized
+ * with an FESystem of the same base element for all components, like
+ * elasticity with <tt>dim</tt> or Stokes flow with equal-order elements and
+ * <tt>dim+1</tt> components. With the numbering of degrees of freedom by
+ * DoFHandler::distribute_dofs(), the components of a node are numbered
+ * consecutively, so a ChunkSparsityPattern with a chunk size equal to the
+ * number of components, created with ChunkSparsityPattern::copy_from() from
+ * the DynamicSparsityPattern filled by DoFTools::make_sparsity_pattern(),
+ * stores exactly the nodal blocks, and the matrix can be assembled with
+ * AffineConstraints::distribute_local_to_global(). Compared to SparseMatrix,
+ * this stores only one column index per block. For chunk sizes of two to
+ * four, the matrix-vector products with Vector objects of the same number
+ * type as the matrix use explicitly vectorized kernels based on
+ * VectorizedArray.
+ *
  * @note Instantiations for this template are provided for <tt>@<float@> and
  * @<double@></tt>; others can be generated in application programs (see the
  * section on
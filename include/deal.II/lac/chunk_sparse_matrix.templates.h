@@ -21,6 +21,7 @@
 
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/template_constraints.h>
+#include <deal.II/base/vectorization.h>
 
 #include <deal.II/lac/chunk_sparse_matrix.h>
 #include <deal.II/lac/full_matrix.h>
@@ -32,6 +33,7 @@
 #include <iomanip>
 #include <numeric>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -39,10 +41,11 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace internal
 {
-  // TODO: the goal of the ChunkSparseMatrix class is to stream data and use
-  // the vectorization features of modern processors. to make this happen,
-  // we will have to vectorize the functions in the following namespace, either
-  // by hand or by using, for example, optimized BLAS versions for them.
+  // the goal of the ChunkSparseMatrix class is to stream data and use the
+  // vectorization features of modern processors. for the small chunk sizes
+  // that appear for the nodal blocks of vector-valued problems, the
+  // matrix-vector products are vectorized by hand with VectorizedArray in the
+  // functions below; other chunk sizes use the generic loops.
   namespace ChunkSparseMatrixImplementation
   {
     /**
@@ -132,6 +135,127 @@ namespace internal
     }
 
 
+    /**
+     * Return the number of lanes of VectorizedArray<Number> used for the
+     * vectorized operations on chunks of size @p chunk_size, i.e., the
+     * largest width supported by the hardware that does not exceed the chunk
+     * size. If only widths below 128 bits fit, no vectorization is used.
+     */
+    template <typename Number>
+    constexpr unsigned int
+    chunk_vectorization_width(const unsigned int chunk_size)
+    {
+      unsigned int width = VectorizedArray<Number>::size();
+      while (width > chunk_size)
+        width /= 2;
+      return (width * sizeof(Number) >= 16) ? width : 1;
+    }
+
+
+
+    /**
+     * Add the result of multiplying all chunks of a chunk row, starting at
+     * @p val_ptr and ending at @p val_end_of_row, by the respective
+     * fragments of the source vector @p src to the destination vector
+     * fragment @p dst. The rows of the chunks are contiguous in memory, so
+     * the products are computed with VectorizedArray along the rows and
+     * only reduced to a scalar once for the whole chunk row.
+     */
+    template <int chunk_size, typename Number>
+    inline void
+    chunk_row_vmult_add_vectorized(const Number    *val_ptr,
+                                   const Number    *val_end_of_row,
+                                   const size_type *colnum_ptr,
+                                   const Number    *src,
+                                   Number          *dst)
+    {
+      constexpr unsigned int n_lanes =
+        chunk_vectorization_width<Number>(chunk_size);
+      constexpr unsigned int n_vectors    = chunk_size / n_lanes;
+      constexpr unsigned int n_vectorized = n_vectors * n_lanes;
+      using VectorType                    = VectorizedArray<Number, n_lanes>;
+
+      VectorType sums[chunk_size][n_vectors];
+      Number     remainder_sums[chunk_size];
+      for (unsigned int i = 0; i < chunk_size; ++i)
+        {
+          for (unsigned int v = 0; v < n_vectors; ++v)
+            sums[i][v] = Number();
+          remainder_sums[i] = Number();
+        }
+
+      for (; val_ptr != val_end_of_row;
+           val_ptr += chunk_size * chunk_size, ++colnum_ptr)
+        {
+          const Number *src_chunk = src + *colnum_ptr * chunk_size;
+          VectorType    src_values[n_vectors];
+          for (unsigned int v = 0; v < n_vectors; ++v)
+            src_values[v].load(src_chunk + v * n_lanes);
+
+          for (unsigned int i = 0; i < chunk_size; ++i)
+            {
+              for (unsigned int v = 0; v < n_vectors; ++v)
+                {
+                  VectorType matrix_values;
+                  matrix_values.load(val_ptr + i * chunk_size + v * n_lanes);
+                  sums[i][v] += matrix_values * src_values[v];
+                }
+              for (unsigned int j = n_vectorized; j < chunk_size; ++j)
+                remainder_sums[i] += val_ptr[i * chunk_size + j] * src_chunk[j];
+            }
+        }
+
+      for (unsigned int i = 0; i < chunk_size; ++i)
+        {
+          Number sum = remainder_sums[i];
+          for (unsigned int v = 0; v < n_vectors; ++v)
+            sum += sums[i][v].sum();
+          dst[i] += sum;
+        }
+    }
+
+
+
+    /**
+     * Same as chunk_Tvmult_add(), but with a chunk size known at compile
+     * time and the updates of the destination vector fragment vectorized
+     * with VectorizedArray along the rows of the chunk.
+     */
+    template <int chunk_size, typename Number>
+    inline void
+    chunk_Tvmult_add_vectorized(const Number *matrix,
+                                const Number *src,
+                                Number       *dst)
+    {
+      constexpr unsigned int n_lanes =
+        chunk_vectorization_width<Number>(chunk_size);
+      constexpr unsigned int n_vectors    = chunk_size / n_lanes;
+      constexpr unsigned int n_vectorized = n_vectors * n_lanes;
+      using VectorType                    = VectorizedArray<Number, n_lanes>;
+
+      VectorType dst_values[n_vectors];
+      for (unsigned int v = 0; v < n_vectors; ++v)
+        dst_values[v].load(dst + v * n_lanes);
+
+      for (unsigned int i = 0; i < chunk_size; ++i)
+        {
+          const VectorType src_value = src[i];
+          for (unsigned int v = 0; v < n_vectors; ++v)
+            {
+              VectorType matrix_values;
+              matrix_values.load(matrix + i * chunk_size + v * n_lanes);
+              dst_values[v] += matrix_values * src_value;
+            }
+          for (unsigned int j = n_vectorized; j < chunk_size; ++j)
+            dst[j] += matrix[i * chunk_size + j] * src[i];
+        }
+
+      for (unsigned int v = 0; v < n_vectors; ++v)
+        dst_values[v].store(dst + v * n_lanes);
+    }
+
+
+
     /**
      * Produce the result of the matrix scalar product $u^TMv$ for an
      * individual chunk.
@@ -204,11 +328,40 @@ namespace internal
       const number *val_ptr =
         &values[rowstart[begin_row] * chunk_size * chunk_size];
       const size_type *colnum_ptr = &colnums[rowstart[begin_row]];
+
+      // the vectorized kernels need contiguous vectors of the same number
+      // type as the matrix and no padding in the chunk columns
+      constexpr bool vectors_allow_vectorization =
+        std::is_same_v<InVector, Vector<number>> &&
+        std::is_same_v<OutVector, Vector<number>>;
+      void (*vectorized_kernel)(const number *,
+                                const number *,
+                                const size_type *,
+                                const number *,
+                                number *) = nullptr;
+      if (vectors_allow_vectorization && n_filled_last_cols == 0)
+        {
+          if (chunk_size == 2)
+            vectorized_kernel = &chunk_row_vmult_add_vectorized<2, number>;
+          else if (chunk_size == 3)
+            vectorized_kernel = &chunk_row_vmult_add_vectorized<3, number>;
+          else if (chunk_size == 4)
+            vectorized_kernel = &chunk_row_vmult_add_vectorized<4, number>;
+        }
+
       for (unsigned int chunk_row = begin_row; chunk_row < last_regular_row;
            ++chunk_row)
         {
           const number *const val_end_of_row =
             &values[rowstart[chunk_row + 1] * chunk_size * chunk_size];
+          if (vectorized_kernel != nullptr)
+            {
+              if constexpr (vectors_allow_vectorization)
+                vectorized_kernel(
+                  val_ptr, val_end_of_row, colnum_ptr, src.begin(), dst_ptr);
+              colnum_ptr += rowstart[chunk_row + 1] - rowstart[chunk_row];
+              val_ptr = val_end_of_row;
+            }
           while (val_ptr != val_end_of_row)
             {
               if (*colnum_ptr != irregular_col)
@@ -751,6 +904,24 @@ ChunkSparseMatrix<number>::Tvmult_add(OutVector &dst, const InVector &src) const
   const number    *val_ptr    = val.get();
   const size_type *colnum_ptr = cols->sparsity_pattern.colnums.get();
 
+  // select a vectorized kernel for the chunks if the chunk size and the
+  // vector types allow it, see vmult_add()
+  constexpr bool vectors_allow_vectorization =
+    std::is_same_v<InVector, Vector<number>> &&
+    std::is_same_v<OutVector, Vector<number>>;
+  void (*vectorized_kernel)(const number *, const number *, number *) =
+    nullptr;
+  if (vectors_allow_vectorization)
+    {
+      using namespace internal::ChunkSparseMatrixImplementation;
+      if (cols->chunk_size == 2)
+        vectorized_kernel = &chunk_Tvmult_add_vectorized<2, number>;
+      else if (cols->chunk_size == 3)
+        vectorized_kernel = &chunk_Tvmult_add_vectorized<3, number>;
+      else if (cols->chunk_size == 4)
+        vectorized_kernel = &chunk_Tvmult_add_vectorized<4, number>;
+    }
+
   for (size_type chunk_row = 0; chunk_row < n_regular_chunk_rows; ++chunk_row)
     {
       const number *const val_end_of_row =
@@ -760,11 +931,23 @@ ChunkSparseMatrix<number>::Tvmult_add(OutVector &dst, const InVector &src) const
         {
           if ((cols_have_padding == false) ||
               (*colnum_ptr != cols->sparsity_pattern.n_cols() - 1))
-            internal::ChunkSparseMatrixImplementation::chunk_Tvmult_add(
-              cols->chunk_size,
-              val_ptr,
-              src.begin() + chunk_row * cols->chunk_size,
-              dst.begin() + *colnum_ptr * cols->chunk_size);
+            {
+              if (vectorized_kernel != nullptr)
+                {
+                  if constexpr (vectors_allow_vectorization)
+                    vectorized_kernel(val_ptr,
+                                      src.begin() +
+                                        chunk_row * cols->chunk_size,
+                                      dst.begin() +
+                                        *colnum_ptr * cols->chunk_size);
+                }
+              else
+                internal::ChunkSparseMatrixImplementation::chunk_Tvmult_add(
+                  cols->chunk_size,
+                  val_ptr,
+                  src.begin() + chunk_row * cols->chunk_size,
+                  dst.begin() + *colnum_ptr * cols->chunk_size);
+            }
           else
             // we're at a chunk column that has padding
             for (size_type r = 0; r < cols->chunk_size; ++r)
@@ -1210,10 +1393,8 @@ template <typename somenumber>
 void
 ChunkSparseMatrix<number>::precondition_Jacobi(Vector<somenumber>       &dst,
                                                const Vector<somenumber> &src,
-                                               const number /*om*/) const
+                                               const number omega) const
 {
-  (void)dst;
-  (void)src;
   Assert(cols != nullptr, ExcNeedsSparsityPattern());
   Assert(val != nullptr, ExcNotInitialized());
   Assert(m() == n(),
@@ -1222,7 +1403,29 @@ ChunkSparseMatrix<number>::precondition_Jacobi(Vector<somenumber>       &dst,
   Assert(dst.size() == n(), ExcDimensionMismatch(dst.size(), n()));
   Assert(src.size() == n(), ExcDimensionMismatch(src.size(), n()));
 
-  Assert(false, ExcNotImplemented());
+  const size_type    chunk_size   = cols->chunk_size;
+  const size_type    n_chunk_rows = cols->sparsity_pattern.n_rows();
+  const std::size_t *rowstart     = cols->sparsity_pattern.rowstart.get();
+
+  // for square matrices, the diagonal chunk is the first one in each chunk
+  // row, and the diagonal entries sit on the diagonal of that chunk
+  for (size_type chunk_row = 0; chunk_row < n_chunk_rows; ++chunk_row)
+    {
+      Assert(cols->sparsity_pattern.colnums[rowstart[chunk_row]] == chunk_row,
+             ExcInternalError());
+      const number *diagonal_chunk =
+        &val[rowstart[chunk_row] * chunk_size * chunk_size];
+      const size_type first_row = chunk_row * chunk_size;
+      const size_type n_rows_in_chunk =
+        std::min(chunk_size, static_cast<size_type>(m() - first_row));
+      for (size_type r = 0; r < n_rows_in_chunk; ++r)
+        {
+          const number diagonal = diagonal_chunk[r * chunk_size + r];
+          Assert(diagonal != number(), ExcDivideByZero());
+          dst(first_row + r) =
+            somenumber(omega) * src(first_row + r) / somenumber(diagonal);
+        }
+    }
 }
 
 
@@ -245,6 +245,23 @@ namespace LinearAlgebra
      *   MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
      *                       &comm_sm);
      * @endcode
+     *
+     * With such a communicator, update_ghost_values() and compress() do not
+     * send the entries shared with processes in @p comm_sm through MPI
+     * messages. Instead, the ghost values are copied directly from the memory
+     * of the owning process, and compress() reads the contributions directly
+     * from the ghost entries of the other processes, see
+     * Utilities::MPI::Partitioner::create_shared_memory_data(). The
+     * processes only exchange zero-size messages to signal when the data is
+     * ready and when it has been read. This benefits all code using these
+     * vectors, e.g., operators based on SparseMatrix, DataOut, or
+     * VectorTools::interpolate(), not only MatrixFree. The data structures
+     * for this exchange are stored in the vector, not in the partitioner, so
+     * vectors with and without a shared-memory communicator can use the same
+     * partitioner. Copies of a vector made by the copy constructor,
+     * reinit(const Vector<Number2, MemorySpace> &, const bool), and the
+     * assignment operator take over the shared-memory communicator of the
+     * source vector.
      */
     template <typename Number, typename MemorySpace = MemorySpace::Host>
     class Vector : public ::dealii::ReadVector<Number>, public Subscriptor
@@ -347,7 +364,8 @@ namespace LinearAlgebra
       /**
        * Uses the parallel layout of the input vector @p in_vector and
        * allocates memory for this vector. Recommended initialization function
-       * when several vectors with the same layout should be created.
+       * when several vectors with the same layout should be created. The
+       * shared-memory communicator of @p in_vector is taken over as well.
        *
        * If the flag @p omit_zeroing_entries is set to false, the memory will
        * be initialized with zero, otherwise the memory will be untouched (and
@@ -474,6 +492,10 @@ namespace LinearAlgebra
        * in write mode. If the input vector does not have any ghost elements
        * at all, the vector will also update its ghost values in analogy to
        * the respective setting the Trilinos and PETSc vectors.
+       *
+       * The calling vector also takes over the shared-memory communicator of
+       * @p in_vector. If it differs from the current one, the memory is
+       * allocated anew and shared with the processes of the new communicator.
        */
       Vector<Number, MemorySpace> &
       operator=(const Vector<Number, MemorySpace> &in_vector);
@@ -488,6 +510,10 @@ namespace LinearAlgebra
        * in write mode. If the input vector does not have any ghost elements
        * at all, the vector will also update its ghost values in analogy to
        * the respective setting the Trilinos and PETSc vectors.
+       *
+       * The calling vector also takes over the shared-memory communicator of
+       * @p in_vector. If it differs from the current one, the memory is
+       * allocated anew and shared with the processes of the new communicator.
        */
       template <typename Number2>
       Vector<Number, MemorySpace> &
@@ -1391,7 +1417,8 @@ namespace LinearAlgebra
 #ifdef DEAL_II_WITH_MPI
       /**
        * A vector that collects all requests from compress() operations.
-       * This class uses persistent MPI communicators, i.e., the communication
+       * For vectors in host memory, these are started from the persistent MPI
+       * requests in persistent_compress_requests, i.e., the communication
        * channels are stored during successive calls to a given function. This
        * reduces the overhead involved with setting up the MPI machinery, but
        * it does not remove the need for a receive operation to be posted
@@ -1401,9 +1428,34 @@ namespace LinearAlgebra
 
       /**
        * A vector that collects all requests from update_ghost_values()
-       * operations. This class uses persistent MPI communicators.
+       * operations. For vectors in host memory, these are started from the
+       * persistent MPI requests in persistent_update_ghost_values_requests.
        */
       mutable std::vector<MPI_Request> update_ghost_values_requests;
+
+      /**
+       * The persistent MPI requests for compress() operations, set up upon
+       * the first call for the current memory of the vector and
+       * communication channel.
+       */
+      Utilities::MPI::PersistentRequests persistent_compress_requests;
+
+      /**
+       * The persistent MPI requests for update_ghost_values() operations.
+       */
+      mutable Utilities::MPI::PersistentRequests
+        persistent_update_ghost_values_requests;
+
+      /**
+       * The data structures for the direct access to the entries of the
+       * processes in the shared-memory communicator `comm_sm`, as computed by
+       * Utilities::MPI::Partitioner::create_shared_memory_data() for the
+       * current partitioner, or a null pointer if update_ghost_values() and
+       * compress() only use MPI messages. The object is immutable and shared
+       * between copies of the vector.
+       */
+      std::shared_ptr<const Utilities::MPI::Partitioner::SharedMemoryData>
+        shared_memory_data;
 #endif
 
       /**
@@ -1427,6 +1479,23 @@ namespace LinearAlgebra
       void
       clear_mpi_requests();
 
+      /**
+       * A helper function that sets up shared_memory_data for the current
+       * partitioner in case the vector is in host memory and a shared-memory
+       * communicator has been given, and clears it otherwise. Used in
+       * reinit() functions when the partitioner or the shared-memory
+       * communicator has changed.
+       */
+      void
+      initialize_shared_memory_access();
+
+      /**
+       * Return whether update_ghost_values() and compress() access the
+       * entries of the processes in the shared-memory communicator directly.
+       */
+      bool
+      uses_shared_memory_access() const;
+
       /**
        * A helper function that is used to resize the val array.
        */
@@ -499,18 +499,54 @@ namespace LinearAlgebra
     Vector<Number, MemorySpaceType>::clear_mpi_requests()
     {
 #ifdef DEAL_II_WITH_MPI
-      for (auto &compress_request : compress_requests)
-        {
-          const int ierr = MPI_Request_free(&compress_request);
-          AssertThrowMPI(ierr);
-        }
+      // requests started from persistent requests are freed together with the
+      // latter
+      if (persistent_compress_requests.started(compress_requests) == false)
+        for (auto &compress_request : compress_requests)
+          if (compress_request != MPI_REQUEST_NULL)
+            {
+              const int ierr = MPI_Request_free(&compress_request);
+              AssertThrowMPI(ierr);
+            }
       compress_requests.clear();
-      for (auto &update_ghost_values_request : update_ghost_values_requests)
-        {
-          const int ierr = MPI_Request_free(&update_ghost_values_request);
-          AssertThrowMPI(ierr);
-        }
+      persistent_compress_requests.clear();
+      if (persistent_update_ghost_values_requests.started(
+            update_ghost_values_requests) == false)
+        for (auto &update_ghost_values_request : update_ghost_values_requests)
+          if (update_ghost_values_request != MPI_REQUEST_NULL)
+            {
+              const int ierr = MPI_Request_free(&update_ghost_values_request);
+              AssertThrowMPI(ierr);
+            }
       update_ghost_values_requests.clear();
+      persistent_update_ghost_values_requests.clear();
+#endif
+    }
+
+
+
+    template <typename Number, typename MemorySpaceType>
+    void
+    Vector<Number, MemorySpaceType>::initialize_shared_memory_access()
+    {
+#ifdef DEAL_II_WITH_MPI
+      shared_memory_data.reset();
+      if constexpr (std::is_same_v<MemorySpaceType, MemorySpace::Host>)
+        if (comm_sm != MPI_COMM_SELF)
+          shared_memory_data = partitioner->create_shared_memory_data(comm_sm);
+#endif
+    }
+
+
+
+    template <typename Number, typename MemorySpaceType>
+    bool
+    Vector<Number, MemorySpaceType>::uses_shared_memory_access() const
+    {
+#ifdef DEAL_II_WITH_MPI
+      return shared_memory_data != nullptr;
+#else
+      return false;
 #endif
     }
 
@@ -550,6 +586,9 @@ namespace LinearAlgebra
 
       // set partitioner to serial version
       partitioner = std::make_shared<Utilities::MPI::Partitioner>(size);
+#ifdef DEAL_II_WITH_MPI
+      shared_memory_data.reset();
+#endif
 
       // set entries to zero if so requested
       if (omit_zeroing_entries == false)
@@ -583,6 +622,7 @@ namespace LinearAlgebra
       partitioner = std::make_shared<Utilities::MPI::Partitioner>(local_size,
                                                                   ghost_size,
                                                                   comm);
+      initialize_shared_memory_access();
 
       this->operator=(Number());
     }
@@ -599,13 +639,17 @@ namespace LinearAlgebra
       clear_mpi_requests();
       Assert(v.partitioner.get() != nullptr, ExcNotInitialized());
 
-      this->comm_sm = v.comm_sm;
-
       // check whether the partitioners are
       // different (check only if the are allocated
       // differently, not if the actual data is
-      // different)
-      if (partitioner.get() != v.partitioner.get())
+      // different), or whether the memory needs to be
+      // shared with different processes
+      const bool reallocate =
+        partitioner.get() != v.partitioner.get() || this->comm_sm != v.comm_sm;
+
+      this->comm_sm = v.comm_sm;
+
+      if (reallocate)
         {
           partitioner = v.partitioner;
           const size_type new_allocated_size =
@@ -613,6 +657,12 @@ namespace LinearAlgebra
           resize_val(new_allocated_size, this->comm_sm);
         }
 
+      // the shared-memory data only depends on the partitioner and comm_sm,
+      // so it can be taken over from v without communication
+#ifdef DEAL_II_WITH_MPI
+      shared_memory_data = v.shared_memory_data;
+#endif
+
       if (omit_zeroing_entries == false)
         this->operator=(Number());
       else
@@ -666,15 +716,19 @@ namespace LinearAlgebra
     {
       clear_mpi_requests();
 
+      // set vector size and allocate memory
+      const bool reallocate = partitioner.get() != partitioner_in.get() ||
+                              this->comm_sm != comm_sm;
+
       this->comm_sm = comm_sm;
 
-      // set vector size and allocate memory
-      if (partitioner.get() != partitioner_in.get())
+      if (reallocate)
         {
           partitioner = partitioner_in;
           const size_type new_allocated_size =
             partitioner->locally_owned_size() + partitioner->n_ghost_indices();
           resize_val(new_allocated_size, comm_sm);
+          initialize_shared_memory_access();
         }
 
       // initialize to zero
@@ -832,8 +886,6 @@ namespace LinearAlgebra
       // the same local range but different ghost layout
       bool must_update_ghost_values = c.vector_is_ghosted;
 
-      this->comm_sm = c.comm_sm;
-
       // check whether the two vectors use the same parallel partitioner. if
       // not, check if all local ranges are the same (that way, we can
       // exchange data between different parallel layouts). One variant which
@@ -842,7 +894,9 @@ namespace LinearAlgebra
       // c does not have any ghosts (constructed without ghost elements given)
       // but the current vector does: In that case, we need to exchange data
       // also when none of the two vector had updated its ghost values before.
-      if (partitioner.get() == nullptr)
+      // The vector also takes over the shared-memory communicator of c,
+      // which requires to allocate the memory anew if it is different.
+      if (partitioner.get() == nullptr || comm_sm != c.comm_sm)
         reinit(c, true);
       else if (partitioner.get() != c.partitioner.get())
         {
@@ -1023,15 +1077,44 @@ namespace LinearAlgebra
       else
 #  endif
         {
-          partitioner->import_from_ghosted_array_start(
-            operation,
-            communication_channel,
-            ArrayView<Number, MemorySpaceType>(
-              data.values.data() + partitioner->locally_owned_size(),
-              partitioner->n_ghost_indices()),
-            ArrayView<Number, MemorySpaceType>(import_data.values.data(),
-                                               partitioner->n_import_indices()),
-            compress_requests);
+          // use direct access to the shared memory or persistent MPI
+          // requests for vectors in host memory
+          if constexpr (std::is_same_v<MemorySpaceType, MemorySpace::Host>)
+            {
+              if (uses_shared_memory_access())
+                partitioner->import_from_ghosted_array_start(
+                  *shared_memory_data,
+                  operation,
+                  communication_channel,
+                  data.values_sm,
+                  ArrayView<Number>(data.values.data() +
+                                      partitioner->locally_owned_size(),
+                                    partitioner->n_ghost_indices()),
+                  ArrayView<Number>(import_data.values.data(),
+                                    partitioner->n_import_indices()),
+                  compress_requests);
+              else
+                partitioner->import_from_ghosted_array_start(
+                  operation,
+                  communication_channel,
+                  ArrayView<Number, MemorySpaceType>(
+                    data.values.data() + partitioner->locally_owned_size(),
+                    partitioner->n_ghost_indices()),
+                  ArrayView<Number, MemorySpaceType>(
+                    import_data.values.data(), partitioner->n_import_indices()),
+                  persistent_compress_requests,
+                  compress_requests);
+            }
+          else
+            partitioner->import_from_ghosted_array_start(
+              operation,
+              communication_channel,
+              ArrayView<Number, MemorySpaceType>(
+                data.values.data() + partitioner->locally_owned_size(),
+                partitioner->n_ghost_indices()),
+              ArrayView<Number, MemorySpaceType>(
+                import_data.values.data(), partitioner->n_import_indices()),
+              compress_requests);
         }
 #else
       (void)communication_channel;
@@ -1088,6 +1171,24 @@ namespace LinearAlgebra
           Assert(partitioner->n_import_indices() == 0 ||
                    import_data.values.size() != 0,
                  ExcNotInitialized());
+          if constexpr (std::is_same_v<MemorySpaceType, MemorySpace::Host>)
+            if (uses_shared_memory_access())
+              {
+                partitioner->import_from_ghosted_array_finish(
+                  *shared_memory_data,
+                  operation,
+                  data.values_sm,
+                  ArrayView<const Number>(import_data.values.data(),
+                                          partitioner->n_import_indices()),
+                  ArrayView<Number>(data.values.data(),
+                                    partitioner->locally_owned_size()),
+                  ArrayView<Number>(data.values.data() +
+                                      partitioner->locally_owned_size(),
+                                    partitioner->n_ghost_indices()),
+                  compress_requests);
+                return;
+              }
+
           partitioner
             ->import_from_ghosted_array_finish<Number, MemorySpaceType>(
               operation,
@@ -1174,16 +1275,49 @@ namespace LinearAlgebra
       else
 #  endif
         {
-          partitioner->export_to_ghosted_array_start<Number, MemorySpaceType>(
-            communication_channel,
-            ArrayView<const Number, MemorySpaceType>(
-              data.values.data(), partitioner->locally_owned_size()),
-            ArrayView<Number, MemorySpaceType>(import_data.values.data(),
-                                               partitioner->n_import_indices()),
-            ArrayView<Number, MemorySpaceType>(
-              data.values.data() + partitioner->locally_owned_size(),
-              partitioner->n_ghost_indices()),
-            update_ghost_values_requests);
+          // use direct access to the shared memory or persistent MPI
+          // requests for vectors in host memory
+          if constexpr (std::is_same_v<MemorySpaceType, MemorySpace::Host>)
+            {
+              if (uses_shared_memory_access())
+                partitioner->export_to_ghosted_array_start(
+                  *shared_memory_data,
+                  communication_channel,
+                  ArrayView<const Number>(data.values.data(),
+                                          partitioner->locally_owned_size()),
+                  data.values_sm,
+                  ArrayView<Number>(import_data.values.data(),
+                                    partitioner->n_import_indices()),
+                  ArrayView<Number>(data.values.data() +
+                                      partitioner->locally_owned_size(),
+                                    partitioner->n_ghost_indices()),
+                  update_ghost_values_requests);
+              else
+                partitioner
+                  ->export_to_ghosted_array_start<Number, MemorySpaceType>(
+                    communication_channel,
+                    ArrayView<const Number, MemorySpaceType>(
+                      data.values.data(), partitioner->locally_owned_size()),
+                    ArrayView<Number, MemorySpaceType>(
+                      import_data.values.data(),
+                      partitioner->n_import_indices()),
+                    ArrayView<Number, MemorySpaceType>(
+                      data.values.data() + partitioner->locally_owned_size(),
+                      partitioner->n_ghost_indices()),
+                    persistent_update_ghost_values_requests,
+                    update_ghost_values_requests);
+            }
+          else
+            partitioner->export_to_ghosted_array_start<Number, MemorySpaceType>(
+              communication_channel,
+              ArrayView<const Number, MemorySpaceType>(
+                data.values.data(), partitioner->locally_owned_size()),
+              ArrayView<Number, MemorySpaceType>(
+                import_data.values.data(), partitioner->n_import_indices()),
+              ArrayView<Number, MemorySpaceType>(
+                data.values.data() + partitioner->locally_owned_size(),
+                partitioner->n_ghost_indices()),
+              update_ghost_values_requests);
         }
 
 #else
@@ -1200,9 +1334,11 @@ namespace LinearAlgebra
 #ifdef DEAL_II_WITH_MPI
       // wait for both sends and receives to complete, even though only
       // receives are really necessary. this gives (much) better performance
-      AssertDimension(partitioner->ghost_targets().size() +
-                        partitioner->import_targets().size(),
-                      update_ghost_values_requests.size());
+      Assert(uses_shared_memory_access() ||
+               partitioner->ghost_targets().size() +
+                   partitioner->import_targets().size() ==
+                 update_ghost_values_requests.size(),
+             ExcInternalError());
       if (update_ghost_values_requests.size() > 0)
         {
           // make this function thread safe
@@ -1232,6 +1368,20 @@ namespace LinearAlgebra
           else
 #  endif
             {
+              if constexpr (std::is_same_v<MemorySpaceType, MemorySpace::Host>)
+                if (uses_shared_memory_access())
+                  {
+                    partitioner->export_to_ghosted_array_finish(
+                      *shared_memory_data,
+                      data.values_sm,
+                      ArrayView<Number>(data.values.data() +
+                                          partitioner->locally_owned_size(),
+                                        partitioner->n_ghost_indices()),
+                      update_ghost_values_requests);
+                    vector_is_ghosted = true;
+                    return;
+                  }
+
               partitioner->export_to_ghosted_array_finish(
                 ArrayView<Number, MemorySpaceType>(
                   data.values.data() + partitioner->locally_owned_size(),
@@ -1373,7 +1523,11 @@ namespace LinearAlgebra
 
       std::swap(compress_requests, v.compress_requests);
       std::swap(update_ghost_values_requests, v.update_ghost_values_requests);
+      std::swap(persistent_compress_requests, v.persistent_compress_requests);
+      std::swap(persistent_update_ghost_values_requests,
+                v.persistent_update_ghost_values_requests);
       std::swap(comm_sm, v.comm_sm);
+      std::swap(shared_memory_data, v.shared_memory_data);
 #endif
 
       std::swap(partitioner, v.partitioner);
@@ -39,6 +39,13 @@ namespace LinearAlgebra
      * is more efficient than the modified Gram-Schmidt algorithm. However, it
      * is less stable in terms of roundoff error propagation, requiring
      * additional re-orthogonalization steps more frequently.
+     *
+     * For LinearAlgebra::distributed::Vector and
+     * LinearAlgebra::distributed::BlockVector, the scalar products with all
+     * basis vectors and the norm of the new vector are computed in a single
+     * pass through memory and combined into a single global reduction per
+     * Arnoldi step, and the subtraction of the projection is done in a
+     * second, vectorized pass.
      */
     classical_gram_schmidt
   };
@@ -844,75 +844,108 @@ namespace internal
 
 
 
+    // Compute the local contributions to the scalar products of @p vv with
+    // the first @p dim vectors of @p orthogonal_vectors, as well as to the
+    // scalar product of @p vv with itself, in a single pass through the
+    // vector. The results are added into the first dim+1 entries of @p
+    // local_sums. In order to keep the accumulators in registers and the
+    // working set in caches, the basis vectors are processed in groups of at
+    // most 128 vectors.
     template <typename VectorType,
               std::enable_if_t<
                 is_dealii_compatible_distributed_vector<VectorType>::value,
                 VectorType> * = nullptr>
     void
-    Tvmult_add(const unsigned int dim,
-               const VectorType  &vv,
-               const internal::SolverGMRESImplementation::TmpVectors<VectorType>
-                              &orthogonal_vectors,
-               Vector<double> &h)
+    local_Tvmult_and_norm_sqr(
+      const unsigned int dim,
+      const VectorType  &vv,
+      const internal::SolverGMRESImplementation::TmpVectors<VectorType>
+             &orthogonal_vectors,
+      double *local_sums)
     {
+      static constexpr unsigned int n_lanes = VectorizedArray<double>::size();
+      static constexpr unsigned int max_group_size = 128;
+
       for (unsigned int b = 0; b < n_blocks(vv); ++b)
         {
-          unsigned int j = 0;
+          const unsigned int local_size = block(vv, b).locally_owned_size();
+          const double      *vv_ptr     = block(vv, b).begin();
 
-          if (dim <= 128)
+          for (unsigned int group_start = 0; group_start < dim;
+               group_start += max_group_size)
             {
-              // optimized path
-              static constexpr unsigned int n_lanes =
-                VectorizedArray<double>::size();
+              const unsigned int group_size =
+                std::min(max_group_size, dim - group_start);
 
-              VectorizedArray<double> hs[128];
-              for (unsigned int d = 0; d < dim; ++d)
-                hs[d] = 0.0;
+              // the norm of vv is computed along with the first group
+              const bool compute_norm = (group_start == 0);
 
-              unsigned int c = 0;
+              VectorizedArray<double> hs[max_group_size];
+              for (unsigned int i = 0; i < group_size; ++i)
+                hs[i] = 0.0;
+              VectorizedArray<double> norm_sqr = 0.0;
 
-              for (; c < block(vv, b).locally_owned_size() / n_lanes / 4;
-                   ++c, j += n_lanes * 4)
-                for (unsigned int i = 0; i < dim; ++i)
-                  {
-                    VectorizedArray<double> vvec[4];
-                    for (unsigned int k = 0; k < 4; ++k)
-                      vvec[k].load(block(vv, b).begin() + j + k * n_lanes);
-
-                    for (unsigned int k = 0; k < 4; ++k)
-                      {
-                        VectorizedArray<double> temp;
-                        temp.load(block(orthogonal_vectors[i], b).begin() + j +
-                                  k * n_lanes);
-                        hs[i] += temp * vvec[k];
-                      }
-                  }
-
-              c *= 4;
-              for (; c < block(vv, b).locally_owned_size() / n_lanes;
-                   ++c, j += n_lanes)
-                for (unsigned int i = 0; i < dim; ++i)
-                  {
-                    VectorizedArray<double> vvec, temp;
-                    vvec.load(block(vv, b).begin() + j);
-                    temp.load(block(orthogonal_vectors[i], b).begin() + j);
-                    hs[i] += temp * vvec;
-                  }
+              unsigned int j = 0;
+              for (; j + 4 * n_lanes <= local_size; j += 4 * n_lanes)
+                {
+                  VectorizedArray<double> vvec[4];
+                  for (unsigned int k = 0; k < 4; ++k)
+                    vvec[k].load(vv_ptr + j + k * n_lanes);
 
-              for (unsigned int i = 0; i < dim; ++i)
-                for (unsigned int v = 0; v < n_lanes; ++v)
-                  h(i) += hs[i][v];
-            }
+                  if (compute_norm)
+                    norm_sqr += (vvec[0] * vvec[0] + vvec[1] * vvec[1]) +
+                                (vvec[2] * vvec[2] + vvec[3] * vvec[3]);
 
-          // remainder loop of optimized path or non-optimized path (if
-          // dim>128)
-          for (; j < block(vv, b).locally_owned_size(); ++j)
-            for (unsigned int i = 0; i < dim; ++i)
-              h(i) += block(orthogonal_vectors[i], b).local_element(j) *
-                      block(vv, b).local_element(j);
-        }
+                  for (unsigned int i = 0; i < group_size; ++i)
+                    {
+                      const double *orth_ptr =
+                        block(orthogonal_vectors[group_start + i], b).begin() +
+                        j;
+                      for (unsigned int k = 0; k < 4; ++k)
+                        {
+                          VectorizedArray<double> temp;
+                          temp.load(orth_ptr + k * n_lanes);
+                          hs[i] += temp * vvec[k];
+                        }
+                    }
+                }
+
+              for (; j + n_lanes <= local_size; j += n_lanes)
+                {
+                  VectorizedArray<double> vvec;
+                  vvec.load(vv_ptr + j);
+
+                  if (compute_norm)
+                    norm_sqr += vvec * vvec;
 
-      Utilities::MPI::sum(h, block(vv, 0).get_mpi_communicator(), h);
+                  for (unsigned int i = 0; i < group_size; ++i)
+                    {
+                      VectorizedArray<double> temp;
+                      temp.load(
+                        block(orthogonal_vectors[group_start + i], b).begin() +
+                        j);
+                      hs[i] += temp * vvec;
+                    }
+                }
+
+              for (unsigned int i = 0; i < group_size; ++i)
+                local_sums[group_start + i] += hs[i].sum();
+              if (compute_norm)
+                local_sums[dim] += norm_sqr.sum();
+
+              // remainder loop
+              for (; j < local_size; ++j)
+                {
+                  if (compute_norm)
+                    local_sums[dim] += vv_ptr[j] * vv_ptr[j];
+                  for (unsigned int i = 0; i < group_size; ++i)
+                    local_sums[group_start + i] +=
+                      block(orthogonal_vectors[group_start + i], b)
+                        .local_element(j) *
+                      vv_ptr[j];
+                }
+            }
+        }
     }
 
 
@@ -931,20 +964,24 @@ namespace internal
     {
       Assert(dim > 0, ExcInternalError());
 
-      for (unsigned int i = 0; i < dim; ++i)
+      for (unsigned int i = 0; i < dim - 1; ++i)
         vv.add(-h(i), orthogonal_vectors[i]);
 
-      return std::sqrt(vv.add_and_dot(-h(dim), orthogonal_vectors[dim], vv));
+      return std::sqrt(
+        vv.add_and_dot(-h(dim - 1), orthogonal_vectors[dim - 1], vv));
     }
 
 
 
+    // Subtract the projection onto the first @p dim orthogonal vectors with
+    // coefficients @p h from @p vv, and return the local contribution to
+    // the squared norm of the result, without any global communication.
     template <typename VectorType,
               std::enable_if_t<
                 is_dealii_compatible_distributed_vector<VectorType>::value,
                 VectorType> * = nullptr>
     double
-    subtract_and_norm(
+    subtract_and_local_norm_sqr(
       const unsigned int dim,
       const internal::SolverGMRESImplementation::TmpVectors<VectorType>
                            &orthogonal_vectors,
@@ -1022,8 +1059,80 @@ namespace internal
             }
         }
 
-      return std::sqrt(
-        Utilities::MPI::sum(norm_vv_temp, block(vv, 0).get_mpi_communicator()));
+      return norm_vv_temp;
+    }
+
+
+
+    // Run one pass of the classical Gram-Schmidt algorithm, i.e., compute the
+    // projection coefficients of @p vv onto the first @p dim vectors of @p
+    // orthogonal_vectors, store them in the first dim entries of @p h,
+    // subtract the projection from @p vv and return the norm of the result.
+    template <typename VectorType,
+              std::enable_if_t<
+                !is_dealii_compatible_distributed_vector<VectorType>::value,
+                VectorType> * = nullptr>
+    double
+    classical_gram_schmidt(
+      const unsigned int dim,
+      const internal::SolverGMRESImplementation::TmpVectors<VectorType>
+                     &orthogonal_vectors,
+      VectorType     &vv,
+      Vector<double> &h)
+    {
+      for (unsigned int i = 0; i < dim; ++i)
+        h(i) = 0.;
+
+      Tvmult_add(dim, vv, orthogonal_vectors, h);
+      return subtract_and_norm(dim, orthogonal_vectors, h, vv);
+    }
+
+
+
+    // Same as above for deal.II's own distributed vectors. Here, the scalar
+    // products with the basis vectors and the norm of @p vv are computed in
+    // the same pass through the vectors and combined into a single global
+    // reduction. Since the basis is orthonormal, the norm of @p vv after
+    // subtracting the projection is then given by Pythagoras' theorem, which
+    // avoids a second global reduction per Arnoldi step. This formula is
+    // subject to cancellation if the new vector is almost contained in the
+    // span of the previous vectors, in which case we compute the norm
+    // explicitly from the orthogonalized vector.
+    template <typename VectorType,
+              std::enable_if_t<
+                is_dealii_compatible_distributed_vector<VectorType>::value,
+                VectorType> * = nullptr>
+    double
+    classical_gram_schmidt(
+      const unsigned int dim,
+      const internal::SolverGMRESImplementation::TmpVectors<VectorType>
+                     &orthogonal_vectors,
+      VectorType     &vv,
+      Vector<double> &h)
+    {
+      Assert(dim > 0, ExcInternalError());
+
+      std::vector<double> sums(dim + 1, 0.);
+      local_Tvmult_and_norm_sqr(dim, vv, orthogonal_vectors, sums.data());
+      Utilities::MPI::sum(sums, block(vv, 0).get_mpi_communicator(), sums);
+
+      double projection_norm_sqr = 0.;
+      for (unsigned int i = 0; i < dim; ++i)
+        {
+          h(i) = sums[i];
+          projection_norm_sqr += sums[i] * sums[i];
+        }
+
+      const double local_norm_sqr =
+        subtract_and_local_norm_sqr(dim, orthogonal_vectors, h, vv);
+
+      const double norm_vv_sqr = sums[dim];
+      if (norm_vv_sqr - projection_norm_sqr > 1e-2 * norm_vv_sqr)
+        return std::sqrt(norm_vv_sqr - projection_norm_sqr);
+      else
+        return std::sqrt(
+          Utilities::MPI::sum(local_norm_sqr,
+                              block(vv, 0).get_mpi_communicator()));
     }
 
 
@@ -1106,14 +1215,36 @@ namespace internal
                   &tmp_vectors,
         const bool zero_out)
     {
+      static constexpr unsigned int n_lanes = VectorizedArray<double>::size();
+
       for (unsigned int b = 0; b < n_blocks(p); ++b)
-        for (unsigned int j = 0; j < block(p, b).locally_owned_size(); ++j)
-          {
-            double temp = zero_out ? 0 : block(p, b).local_element(j);
-            for (unsigned int i = 0; i < dim; ++i)
-              temp += block(tmp_vectors[i], b).local_element(j) * h(i);
-            block(p, b).local_element(j) = temp;
-          }
+        {
+          const unsigned int local_size = block(p, b).locally_owned_size();
+          double            *p_ptr      = block(p, b).begin();
+
+          unsigned int j = 0;
+          for (; j + n_lanes <= local_size; j += n_lanes)
+            {
+              VectorizedArray<double> temp = 0.0;
+              if (!zero_out)
+                temp.load(p_ptr + j);
+              for (unsigned int i = 0; i < dim; ++i)
+                {
+                  VectorizedArray<double> vec;
+                  vec.load(block(tmp_vectors[i], b).begin() + j);
+                  temp += vec * h(i);
+                }
+              temp.store(p_ptr + j);
+            }
+
+          for (; j < local_size; ++j)
+            {
+              double temp = zero_out ? 0 : p_ptr[j];
+              for (unsigned int i = 0; i < dim; ++i)
+                temp += block(tmp_vectors[i], b).local_element(j) * h(i);
+              p_ptr[j] = temp;
+            }
+        }
     }
 
 
@@ -1182,8 +1313,22 @@ namespace internal
                    LinearAlgebra::OrthogonalizationStrategy::
                      classical_gram_schmidt)
             {
-              Tvmult_add(dim, vv, orthogonal_vectors, h);
-              norm_vv = subtract_and_norm(dim, orthogonal_vectors, h, vv);
+              if (c == 0)
+                norm_vv =
+                  classical_gram_schmidt(dim, orthogonal_vectors, vv, h);
+              else
+                {
+                  // the second pass computes corrections to the coefficients
+                  // of the first pass, so we must only subtract the
+                  // projection onto the corrections here
+                  Vector<double> h_correction(dim);
+                  norm_vv = classical_gram_schmidt(dim,
+                                                   orthogonal_vectors,
+                                                   vv,
+                                                   h_correction);
+                  for (unsigned int i = 0; i < dim; ++i)
+                    h(i) += h_correction(i);
+                }
             }
           else
             {
@@ -1810,8 +1955,8 @@ SolverFGMRES<VectorType>::solve(const MatrixType         &A,
         }
 
       // Update solution vector
-      for (unsigned int j = 0; j < y.size(); ++j)
-        x.add(y(j), z[j]);
+      if (y.size() > 0)
+        internal::SolverGMRESImplementation::add(x, y.size(), y, z, false);
     }
   while (iteration_state == SolverControl::iterate);
 
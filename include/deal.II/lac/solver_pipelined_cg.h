@@ -0,0 +1,694 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_pipelined_cg_h
+#define dealii_solver_pipelined_cg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <array>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declaration
+#ifndef DOXYGEN
+class PreconditionIdentity;
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename, typename>
+    class Vector;
+  }
+} // namespace LinearAlgebra
+#endif
+
+
+/** @addtogroup Solvers */
+/** @{ */
+
+/**
+ * This class implements the pipelined preconditioned conjugate gradient
+ * method of Ghysels and Vanroose (P. Ghysels, W. Vanroose, "Hiding global
+ * synchronization latency in the preconditioned Conjugate Gradient
+ * algorithm", Parallel Computing 40(7):224--238, 2014). Mathematically, the
+ * method produces the same iterates as SolverCG for a symmetric positive
+ * definite matrix and a symmetric preconditioner. The difference lies in the
+ * way the algorithm is organized: The classical CG method needs two global
+ * reductions per iteration (one for the step length $\alpha_k$ and one for
+ * the new residual-preconditioner product that determines $\beta_k$), both of
+ * which block the progress of the algorithm. On large parallel machines,
+ * the latency of these reductions can exceed the cost of the matrix-vector
+ * product itself. The pipelined variant reformulates the recurrences with
+ * additional auxiliary vectors such that all three scalar products needed in
+ * one iteration, $(\mathbf{r}_k, \mathbf{u}_k)$, $(\mathbf{w}_k,
+ * \mathbf{u}_k)$ and $(\mathbf{r}_k, \mathbf{r}_k)$ with $\mathbf{u}_k =
+ * P^{-1}\mathbf{r}_k$ and $\mathbf{w}_k = A \mathbf{u}_k$, are combined into
+ * a single reduction. Furthermore, that reduction is independent of the
+ * application of the preconditioner and of the matrix-vector product in the
+ * same iteration, so it can be started before and completed after those
+ * operations.
+ *
+ * The price to pay is a larger number of vectors (nine auxiliary vectors
+ * rather than four in SolverCG) and more vector updates per iteration, as
+ * well as a somewhat reduced attainable accuracy due to the longer
+ * recurrences that propagate round-off errors. The method is hence most
+ * useful when the global reductions are the limiting factor, i.e., on many
+ * MPI ranks with relatively cheap operators and preconditioners, like
+ * matrix-free operators in combination with point-Jacobi or Chebyshev
+ * preconditioners.
+ *
+ * <h3>Optimized operations with LinearAlgebra::distributed::Vector</h3>
+ *
+ * For generic vector types, the solver uses the usual vector operations
+ * `sadd`, `add` and `operator*` and hence performs blocking reductions. If
+ * `VectorType` is LinearAlgebra::distributed::Vector with a floating point
+ * number type on the host, all eight vector updates of an iteration are
+ * merged into a single loop over the locally owned entries, which also
+ * computes the local contributions to the three scalar products needed in
+ * the next iteration. The global sum is then computed with a single
+ * non-blocking `MPI_Iallreduce` call that is posted before the
+ * preconditioner and the matrix-vector product are applied and that is
+ * waited for only once the scalars are needed. Since most MPI
+ * implementations progress non-blocking collectives during other MPI calls,
+ * the ghost exchange inside a (matrix-free) matrix-vector product helps to
+ * complete the reduction in the background.
+ *
+ * @note Since the scalar products of the current iteration are completed
+ * only after the preconditioner and the matrix-vector product of the same
+ * iteration have been started, the convergence check is done once these
+ * operations have been applied. As a consequence, the solver applies the
+ * preconditioner and the matrix one more time than SolverCG before
+ * terminating.
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence. This mechanism can also be used
+ * to observe the progress of the iteration. The residual norm reported to the
+ * SolverControl is the norm of the recursively updated residual
+ * $\mathbf{r}_k$.
+ */
+template <typename VectorType = Vector<double>>
+class SolverPipelinedCG : public SolverBase<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   * Here, it does not store anything but just exists for consistency
+   * with the other solver classes.
+   */
+  struct AdditionalData
+  {};
+
+  /**
+   * Constructor.
+   */
+  SolverPipelinedCG(SolverControl            &cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipelinedCG(SolverControl        &cn,
+                    const AdditionalData &data = AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverPipelinedCG() override = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType         &A,
+        VectorType               &x,
+        const VectorType         &b,
+        const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Interface for derived class. This function gets the current iteration
+   * vector, the residual and the update vector in each step. It can be used
+   * for graphical output of the convergence history.
+   */
+  virtual void
+  print_vectors(const unsigned int step,
+                const VectorType  &x,
+                const VectorType  &r,
+                const VectorType  &p) const;
+
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/** @} */
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG(
+  SolverControl            &cn,
+  VectorMemory<VectorType> &mem,
+  const AdditionalData     &data)
+  : SolverBase<VectorType>(cn, mem)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverPipelinedCG<VectorType>::SolverPipelinedCG(SolverControl        &cn,
+                                                 const AdditionalData &data)
+  : SolverBase<VectorType>(cn)
+  , additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+void
+SolverPipelinedCG<VectorType>::print_vectors(const unsigned int,
+                                             const VectorType &,
+                                             const VectorType &,
+                                             const VectorType &) const
+{}
+
+
+
+namespace internal
+{
+  namespace SolverPipelinedCG
+  {
+    // This base class holds the vectors and scalars of the pipelined
+    // conjugate gradient method. The naming of the vectors follows
+    // Algorithm 4 in the paper by Ghysels and Vanroose: 'r' is the residual,
+    // 'u' the preconditioned residual, 'w' = A*u, 'm' = P^{-1}*w, 'n' = A*m,
+    // 'p' the search direction, and 's', 'q', 'z' are the auxiliary vectors
+    // representing A*p, P^{-1}*A*p and A*P^{-1}*A*p, respectively.
+    template <typename VectorType,
+              typename MatrixType,
+              typename PreconditionerType>
+    struct IterationWorkerBase
+    {
+      using Number = typename VectorType::value_type;
+
+      const MatrixType         &A;
+      const PreconditionerType &preconditioner;
+      VectorType               &x;
+
+      typename VectorMemory<VectorType>::Pointer r_pointer;
+      typename VectorMemory<VectorType>::Pointer u_pointer;
+      typename VectorMemory<VectorType>::Pointer w_pointer;
+      typename VectorMemory<VectorType>::Pointer m_pointer;
+      typename VectorMemory<VectorType>::Pointer n_pointer;
+      typename VectorMemory<VectorType>::Pointer p_pointer;
+      typename VectorMemory<VectorType>::Pointer s_pointer;
+      typename VectorMemory<VectorType>::Pointer q_pointer;
+      typename VectorMemory<VectorType>::Pointer z_pointer;
+
+      VectorType &r;
+      VectorType &u;
+      VectorType &w;
+      VectorType &m;
+      VectorType &n;
+      VectorType &p;
+      VectorType &s;
+      VectorType &q;
+      VectorType &z;
+
+      // The three scalar products (r,u), (w,u), and (r,r) of the current
+      // iteration
+      std::array<Number, 3> sums;
+
+      Number alpha;
+      Number gamma;
+      double residual_norm;
+
+      IterationWorkerBase(const MatrixType         &A,
+                          const PreconditionerType &preconditioner,
+                          VectorMemory<VectorType> &memory,
+                          VectorType               &x)
+        : A(A)
+        , preconditioner(preconditioner)
+        , x(x)
+        , r_pointer(memory)
+        , u_pointer(memory)
+        , w_pointer(memory)
+        , m_pointer(memory)
+        , n_pointer(memory)
+        , p_pointer(memory)
+        , s_pointer(memory)
+        , q_pointer(memory)
+        , z_pointer(memory)
+        , r(*r_pointer)
+        , u(*u_pointer)
+        , w(*w_pointer)
+        , m(*m_pointer)
+        , n(*n_pointer)
+        , p(*p_pointer)
+        , s(*s_pointer)
+        , q(*q_pointer)
+        , z(*z_pointer)
+        , sums{}
+        , alpha(Number())
+        , gamma(Number())
+        , residual_norm(0.0)
+      {}
+
+      // Compute the initial residual and the vectors u = P^{-1} r and w = A u
+      // that start the pipeline.
+      void
+      initialize_vectors(const VectorType &b)
+      {
+        // Initialize without setting the vector entries for those vectors
+        // that get overwritten before they are read, and with zero entries
+        // for the vectors that enter the first update with a factor beta=0
+        r.reinit(x, true);
+        u.reinit(x, true);
+        w.reinit(x, true);
+        m.reinit(x, true);
+        n.reinit(x, true);
+        p.reinit(x);
+        s.reinit(x);
+        q.reinit(x);
+        z.reinit(x);
+
+        // compute residual. if vector is zero, then short-circuit the full
+        // computation
+        if (!x.all_zero())
+          {
+            A.vmult(r, x);
+            r.sadd(-1., 1., b);
+          }
+        else
+          r.equ(1., b);
+
+        preconditioner.vmult(u, r);
+        A.vmult(w, u);
+      }
+
+      // Apply the preconditioner and the matrix to the vector w. This is the
+      // part of the iteration that overlaps with the global reduction.
+      void
+      apply_operators()
+      {
+        preconditioner.vmult(m, w);
+        A.vmult(n, m);
+      }
+
+      // Compute the coefficients alpha and beta of the current iteration
+      // from the result of the reduction and the previous values of gamma
+      // and alpha. Returns beta.
+      Number
+      compute_coefficients(const unsigned int iteration_index)
+      {
+        const Number previous_gamma = gamma;
+        gamma                       = sums[0];
+        const Number delta          = sums[1];
+
+        Number beta = Number();
+        if (iteration_index > 0)
+          {
+            Assert(std::abs(previous_gamma) != 0., ExcDivideByZero());
+            beta = gamma / previous_gamma;
+            Assert(std::abs(alpha) != 0., ExcDivideByZero());
+            const Number denominator = delta - beta * gamma / alpha;
+            Assert(std::abs(denominator) != 0., ExcDivideByZero());
+            alpha = gamma / denominator;
+          }
+        else
+          {
+            Assert(std::abs(delta) != 0., ExcDivideByZero());
+            alpha = gamma / delta;
+          }
+        return beta;
+      }
+    };
+
+
+
+    // Implementation of the pipelined conjugate gradient method for generic
+    // vectors, using the vector operations provided by all vector
+    // classes. Since those do not support non-blocking reductions, the
+    // scalar products are computed when the result is requested.
+    template <typename VectorType,
+              typename MatrixType,
+              typename PreconditionerType,
+              typename = int>
+    struct IterationWorker
+      : public IterationWorkerBase<VectorType, MatrixType, PreconditionerType>
+    {
+      using BaseClass =
+        IterationWorkerBase<VectorType, MatrixType, PreconditionerType>;
+
+      IterationWorker(const MatrixType         &A,
+                      const PreconditionerType &preconditioner,
+                      VectorMemory<VectorType> &memory,
+                      VectorType               &x)
+        : BaseClass(A, preconditioner, memory, x)
+      {}
+
+      using BaseClass::m;
+      using BaseClass::n;
+      using BaseClass::p;
+      using BaseClass::q;
+      using BaseClass::r;
+      using BaseClass::s;
+      using BaseClass::sums;
+      using BaseClass::u;
+      using BaseClass::w;
+      using BaseClass::x;
+      using BaseClass::z;
+
+      void
+      startup(const VectorType &b)
+      {
+        this->initialize_vectors(b);
+      }
+
+      void
+      finish_reduction()
+      {
+        sums[0] = r * u;
+        sums[1] = w * u;
+        sums[2] = r * r;
+
+        // Round-off errors near zero might yield negative values, so take
+        // the absolute value
+        this->residual_norm = std::sqrt(std::abs(sums[2]));
+      }
+
+      void
+      do_iteration(const unsigned int iteration_index)
+      {
+        const auto beta  = this->compute_coefficients(iteration_index);
+        const auto alpha = this->alpha;
+
+        z.sadd(beta, 1., n);
+        q.sadd(beta, 1., m);
+        s.sadd(beta, 1., w);
+        p.sadd(beta, 1., u);
+
+        x.add(alpha, p);
+        r.add(-alpha, s);
+        u.add(-alpha, q);
+        w.add(-alpha, z);
+      }
+    };
+
+
+
+    // Specialization of the above class for LinearAlgebra::distributed::Vector
+    // where we merge all vector updates into a single loop and compute the
+    // scalar products with a non-blocking MPI_Iallreduce.
+    template <typename VectorType,
+              typename MatrixType,
+              typename PreconditionerType>
+    struct IterationWorker<
+      VectorType,
+      MatrixType,
+      PreconditionerType,
+      std::enable_if_t<
+        std::is_same_v<VectorType,
+                       LinearAlgebra::distributed::Vector<
+                         typename VectorType::value_type,
+                         MemorySpace::Host>> &&
+          std::is_floating_point_v<typename VectorType::value_type>,
+        int>>
+      : public IterationWorkerBase<VectorType, MatrixType, PreconditionerType>
+    {
+      using BaseClass =
+        IterationWorkerBase<VectorType, MatrixType, PreconditionerType>;
+      using Number = typename VectorType::value_type;
+
+#  ifdef DEAL_II_WITH_MPI
+      MPI_Request request;
+#  endif
+
+      IterationWorker(const MatrixType         &A,
+                      const PreconditionerType &preconditioner,
+                      VectorMemory<VectorType> &memory,
+                      VectorType               &x)
+        : BaseClass(A, preconditioner, memory, x)
+#  ifdef DEAL_II_WITH_MPI
+        , request(MPI_REQUEST_NULL)
+#  endif
+      {}
+
+      ~IterationWorker()
+      {
+        // In case an exception was thrown while a reduction was in flight,
+        // make sure that MPI does not write into the array after it has been
+        // destroyed.
+#  ifdef DEAL_II_WITH_MPI
+        if (request != MPI_REQUEST_NULL)
+          MPI_Wait(&request, MPI_STATUS_IGNORE);
+#  endif
+      }
+
+      void
+      startup(const VectorType &b)
+      {
+        this->initialize_vectors(b);
+
+        const unsigned int local_size = this->x.locally_owned_size();
+        const Number      *r          = this->r.begin();
+        const Number      *u          = this->u.begin();
+        const Number      *w          = this->w.begin();
+
+        std::array<VectorizedArray<Number>, 3> my_sums = {};
+        constexpr unsigned int n_lanes = VectorizedArray<Number>::size();
+        const unsigned int end_regular = local_size / n_lanes * n_lanes;
+        for (unsigned int j = 0; j < end_regular; j += n_lanes)
+          {
+            VectorizedArray<Number> rj, uj, wj;
+            rj.load(r + j);
+            uj.load(u + j);
+            wj.load(w + j);
+            my_sums[0] += rj * uj;
+            my_sums[1] += wj * uj;
+            my_sums[2] += rj * rj;
+          }
+        for (unsigned int j = end_regular; j < local_size; ++j)
+          {
+            my_sums[0][0] += r[j] * u[j];
+            my_sums[1][0] += w[j] * u[j];
+            my_sums[2][0] += r[j] * r[j];
+          }
+        start_reduction(my_sums);
+      }
+
+      void
+      finish_reduction()
+      {
+#  ifdef DEAL_II_WITH_MPI
+        if (request != MPI_REQUEST_NULL)
+          {
+            const int ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+          }
+#  endif
+
+        // Round-off errors near zero might yield negative values, so take
+        // the absolute value
+        this->residual_norm = std::sqrt(std::abs(this->sums[2]));
+      }
+
+      void
+      do_iteration(const unsigned int iteration_index)
+      {
+        const Number beta  = this->compute_coefficients(iteration_index);
+        const Number alpha = this->alpha;
+
+        const unsigned int local_size = this->x.locally_owned_size();
+        Number            *x          = this->x.begin();
+        Number            *r          = this->r.begin();
+        Number            *u          = this->u.begin();
+        Number            *w          = this->w.begin();
+        const Number      *m          = this->m.begin();
+        const Number      *n          = this->n.begin();
+        Number            *p          = this->p.begin();
+        Number            *s          = this->s.begin();
+        Number            *q          = this->q.begin();
+        Number            *z          = this->z.begin();
+
+        // Vectorize by hand since compilers are often pretty bad at doing
+        // these steps automatically even with DEAL_II_OPENMP_SIMD_PRAGMA
+        std::array<VectorizedArray<Number>, 3> my_sums = {};
+        constexpr unsigned int n_lanes = VectorizedArray<Number>::size();
+        const unsigned int end_regular = local_size / n_lanes * n_lanes;
+        for (unsigned int j = 0; j < end_regular; j += n_lanes)
+          {
+            VectorizedArray<Number> zj, qj, sj, pj, tmp;
+            zj.load(z + j);
+            tmp.load(n + j);
+            zj = beta * zj + tmp;
+            zj.store(z + j);
+            qj.load(q + j);
+            tmp.load(m + j);
+            qj = beta * qj + tmp;
+            qj.store(q + j);
+
+            VectorizedArray<Number> wj, uj, rj;
+            wj.load(w + j);
+            sj.load(s + j);
+            sj = beta * sj + wj;
+            sj.store(s + j);
+            uj.load(u + j);
+            pj.load(p + j);
+            pj = beta * pj + uj;
+            pj.store(p + j);
+
+            tmp.load(x + j);
+            tmp += alpha * pj;
+            tmp.store(x + j);
+            rj.load(r + j);
+            rj -= alpha * sj;
+            rj.store(r + j);
+            uj -= alpha * qj;
+            uj.store(u + j);
+            wj -= alpha * zj;
+            wj.store(w + j);
+
+            my_sums[0] += rj * uj;
+            my_sums[1] += wj * uj;
+            my_sums[2] += rj * rj;
+          }
+        for (unsigned int j = end_regular; j < local_size; ++j)
+          {
+            z[j] = beta * z[j] + n[j];
+            q[j] = beta * q[j] + m[j];
+            s[j] = beta * s[j] + w[j];
+            p[j] = beta * p[j] + u[j];
+            x[j] += alpha * p[j];
+            r[j] -= alpha * s[j];
+            u[j] -= alpha * q[j];
+            w[j] -= alpha * z[j];
+
+            my_sums[0][0] += r[j] * u[j];
+            my_sums[1][0] += w[j] * u[j];
+            my_sums[2][0] += r[j] * r[j];
+          }
+        start_reduction(my_sums);
+      }
+
+    private:
+      // Sum up the lanes of the vectorized local sums and start the global
+      // reduction.
+      void
+      start_reduction(const std::array<VectorizedArray<Number>, 3> &my_sums)
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+          this->sums[i] = my_sums[i].sum();
+
+#  ifdef DEAL_II_WITH_MPI
+        if (Utilities::MPI::job_supports_mpi() &&
+            Utilities::MPI::n_mpi_processes(this->x.get_mpi_communicator()) >
+              1)
+          {
+            Assert(request == MPI_REQUEST_NULL, ExcInternalError());
+            const int ierr =
+              MPI_Iallreduce(MPI_IN_PLACE,
+                             this->sums.data(),
+                             3,
+                             Utilities::MPI::mpi_type_id_for_type<Number>,
+                             MPI_SUM,
+                             this->x.get_mpi_communicator(),
+                             &request);
+            AssertThrowMPI(ierr);
+          }
+#  endif
+      }
+    };
+  } // namespace SolverPipelinedCG
+} // namespace internal
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipelinedCG<VectorType>::solve(const MatrixType         &A,
+                                     VectorType               &x,
+                                     const VectorType         &b,
+                                     const PreconditionerType &preconditioner)
+{
+  SolverControl::State solver_state = SolverControl::iterate;
+
+  LogStream::Prefix prefix("pipelined_cg");
+
+  internal::SolverPipelinedCG::
+    IterationWorker<VectorType, MatrixType, PreconditionerType>
+      worker(A, preconditioner, this->memory, x);
+
+  worker.startup(b);
+
+  unsigned int it = 0;
+  while (true)
+    {
+      // Apply the preconditioner and the matrix while the reduction of the
+      // scalar products started at the end of the previous iteration is in
+      // flight, and only then wait for its completion.
+      worker.apply_operators();
+      worker.finish_reduction();
+
+      solver_state = this->iteration_status(it, worker.residual_norm, x);
+      if (solver_state != SolverControl::iterate)
+        break;
+
+      worker.do_iteration(it);
+
+      ++it;
+      print_vectors(it, x, worker.r, worker.p);
+    }
+
+  AssertThrow(solver_state == SolverControl::success,
+              SolverControl::NoConvergence(it, worker.residual_norm));
+}
+
+
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,352 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_amg_h
+#define dealii_sparse_amg_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * @addtogroup Preconditioners
+ * @{
+ */
+
+/**
+ * An algebraic multigrid preconditioner for symmetric positive definite
+ * matrices of type SparseMatrix, based on smoothed aggregation as described
+ * in P. Vaněk, J. Mandel, M. Brezina: "Algebraic multigrid by smoothed
+ * aggregation for second and fourth order elliptic problems", Computing 56
+ * (1996), pp. 179-196. As opposed to TrilinosWrappers::PreconditionAMG and
+ * PETScWrappers::PreconditionBoomerAMG, this class does not depend on
+ * external libraries. It is meant for scalar elliptic problems of moderate
+ * size, e.g. as the solver on the coarse level of a geometric multigrid
+ * method via MGCoarseGridAMG, or as a preconditioner for the conjugate
+ * gradient method on small to medium-size problems.
+ *
+ * <h3>Setup</h3>
+ *
+ * The hierarchy of coarser matrices is built by the following steps,
+ * starting from the given matrix $A_0$:
+ * <ol>
+ * <li> Two unknowns $i \neq j$ are considered strongly connected if
+ * $|a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|}$, where $\theta$ is the
+ * AdditionalData::aggregation_threshold. Unknowns without strong
+ * connections, like rows that only contain a diagonal entry as created by
+ * constrained degrees of freedom, are not aggregated and only treated by
+ * the smoother.
+ * <li> The remaining unknowns are grouped into aggregates of strongly
+ * connected unknowns by the usual greedy three-phase algorithm: First,
+ * unknowns whose strong neighbors are all unaggregated form an aggregate
+ * together with those neighbors. Then, the remaining unknowns are attached
+ * to the aggregate of the neighbor they are most strongly connected to,
+ * and finally, left-over unknowns form new aggregates with their
+ * unaggregated neighbors.
+ * <li> The tentative prolongator $P_0$ interpolates the constant vector,
+ * i.e., it has a unit entry in the column of the aggregate of each
+ * aggregated unknown. It is smoothed by one step of damped Jacobi,
+ * $P = (I - \omega D^{-1} A) P_0$ with $\omega =
+ * \omega_0/\lambda_\text{max}(D^{-1}A)$, where $\omega_0$ is
+ * AdditionalData::prolongator_damping.
+ * <li> The coarse matrix is the Galerkin product $A_1 = P^T A_0 P$, and the
+ * restriction $R = P^T$ is stored explicitly.
+ * </ol>
+ * These steps are repeated until the matrix has at most
+ * AdditionalData::max_coarse_size rows, the number of levels reaches
+ * AdditionalData::max_levels, or no further coarsening is possible. The
+ * matrix on the coarsest level is inverted by a dense Gauss-Jordan
+ * elimination, which requires it to be invertible. If the coarsening stopped
+ * with more than AdditionalData::max_coarse_size rows, the coarsest level is
+ * only treated by the smoother instead.
+ *
+ * The smoothers on each level are PreconditionChebyshev objects around the
+ * point-Jacobi method. The largest eigenvalue of $D^{-1}A$ estimated by the
+ * smoothers is also used for the damping of the prolongator. The rows of the
+ * matrix products and the Jacobi smoothing of the prolongator are computed
+ * in parallel with the threads of the task scheduler, as are the
+ * matrix-vector products and vector updates during the V-cycle.
+ *
+ * <h3>Usage</h3>
+ *
+ * @code
+ * SparseAMG<double> amg;
+ * amg.initialize(system_matrix);
+ *
+ * SolverControl           solver_control(1000, 1e-12);
+ * SolverCG<Vector<double>> cg(solver_control);
+ * cg.solve(system_matrix, solution, system_rhs, amg);
+ * @endcode
+ *
+ * The preconditioner applies one symmetric V-cycle. Since the matrix on the
+ * finest level is not copied, it needs to remain unchanged and alive as
+ * long as the preconditioner is used.
+ *
+ * @note The aggregation only uses the constant vector as near null space,
+ * which is appropriate for scalar problems like the Laplace equation, but
+ * not for systems like linear elasticity.
+ *
+ * @note Instantiations for this template are provided for <tt>@<float@> and
+ * @<double@></tt>; others can be generated in application programs (see the
+ * section on
+ * @ref Instantiations
+ * in the manual).
+ */
+template <typename number>
+class SparseAMG : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Parameters of the setup of the multigrid hierarchy and the smoothers.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData(const double       aggregation_threshold    = 1e-4,
+                   const double       prolongator_damping      = 4. / 3.,
+                   const unsigned int smoother_degree          = 2,
+                   const double       smoother_smoothing_range = 20.,
+                   const size_type    max_coarse_size          = 500,
+                   const unsigned int max_levels               = 20);
+
+    /**
+     * Threshold $\theta$ relative to the geometric mean of the two diagonal
+     * entries above which an off-diagonal entry is considered a strong
+     * connection. Larger values lead to smaller aggregates and a slower
+     * coarsening.
+     */
+    double aggregation_threshold;
+
+    /**
+     * Damping factor $\omega_0$ of the Jacobi step that smooths the
+     * tentative prolongator, relative to the inverse of the largest
+     * eigenvalue of $D^{-1}A$. The value 4/3 minimizes the energy of the
+     * prolongated coarse functions for model problems.
+     */
+    double prolongator_damping;
+
+    /**
+     * Degree of the Chebyshev polynomial used for pre- and post-smoothing on
+     * each level, see PreconditionChebyshev::AdditionalData::degree.
+     */
+    unsigned int smoother_degree;
+
+    /**
+     * Ratio between the largest eigenvalue of $D^{-1}A$ and the lower end of
+     * the eigenvalue range damped by the smoother, see
+     * PreconditionChebyshev::AdditionalData::smoothing_range.
+     */
+    double smoother_smoothing_range;
+
+    /**
+     * Number of rows below which a matrix is not coarsened any further and
+     * instead inverted by a direct solver.
+     */
+    size_type max_coarse_size;
+
+    /**
+     * Maximal number of levels in the hierarchy, including the finest one.
+     */
+    unsigned int max_levels;
+  };
+
+  /**
+   * Constructor. Does nothing.
+   *
+   * Call the initialize() function before using this object as
+   * preconditioner.
+   */
+  SparseAMG() = default;
+
+  /**
+   * Build the multigrid hierarchy for the given matrix.
+   *
+   * The matrix needs to be symmetric, have positive diagonal entries and
+   * remain alive and unchanged as long as this object is used.
+   */
+  void
+  initialize(const SparseMatrix<number> &matrix,
+             const AdditionalData       &additional_data = AdditionalData());
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Apply one V-cycle with a zero initial guess to @p src and write the
+   * result into @p dst.
+   */
+  void
+  vmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Apply the transpose of the preconditioner. Since the V-cycle is
+   * symmetric, this is the same as vmult().
+   */
+  void
+  Tvmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Perform one V-cycle of the iterative method for the system $Ax=b$, with
+   * $b$ given by @p src, using @p dst as the initial guess and writing the
+   * improved approximation back into @p dst.
+   */
+  void
+  step(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Same as step(), since the V-cycle is symmetric.
+   */
+  void
+  Tstep(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Return the number of rows of the matrix on the finest level.
+   */
+  size_type
+  m() const;
+
+  /**
+   * Return the number of columns of the matrix on the finest level.
+   */
+  size_type
+  n() const;
+
+  /**
+   * Return the number of levels of the hierarchy, including the finest
+   * one.
+   */
+  unsigned int
+  n_levels() const;
+
+  /**
+   * Return the matrix on the given level, with level zero being the matrix
+   * passed to initialize().
+   */
+  const SparseMatrix<number> &
+  get_level_matrix(const unsigned int level) const;
+
+  /**
+   * Return the operator complexity of the hierarchy, i.e., the sum of the
+   * number of nonzero entries of the matrices on all levels divided by the
+   * number of nonzero entries of the matrix on the finest level.
+   */
+  double
+  operator_complexity() const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object, excluding the matrix on the finest level.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclException1(ExcNonPositiveDiagonal,
+                 size_type,
+                 << "The diagonal entry in row " << arg1
+                 << " is not positive, but the smoothed aggregation method "
+                    "requires a symmetric positive definite matrix.");
+  /** @} */
+
+private:
+  /**
+   * The data on one level of the hierarchy. The prolongation and
+   * restriction matrices connect the level with the next coarser one.
+   */
+  struct Level
+  {
+    SparsityPattern      sparsity;
+    SparseMatrix<number> matrix;
+
+    SparsityPattern      prolongation_sparsity;
+    SparseMatrix<number> prolongation;
+
+    SparsityPattern      restriction_sparsity;
+    SparseMatrix<number> restriction;
+
+    PreconditionChebyshev<SparseMatrix<number>, Vector<number>> smoother;
+
+    mutable Vector<number> solution;
+    mutable Vector<number> rhs;
+    mutable Vector<number> residual;
+  };
+
+  /**
+   * Apply one V-cycle on the given level to the initial guess @p dst.
+   * If @p zero_initial_guess is set, the content of @p dst is ignored.
+   */
+  void
+  v_cycle(const unsigned int    level,
+          Vector<number>       &dst,
+          const Vector<number> &src,
+          const bool            zero_initial_guess) const;
+
+  /**
+   * Pointer to the matrix on the finest level.
+   */
+  SmartPointer<const SparseMatrix<number>, SparseAMG<number>> matrix;
+
+  /**
+   * The levels of the hierarchy. The matrix of the first level is not
+   * filled, as it is the one pointed to by the matrix member variable.
+   */
+  std::vector<std::unique_ptr<Level>> levels;
+
+  /**
+   * Inverse of the matrix on the coarsest level.
+   */
+  FullMatrix<number> coarse_inverse;
+};
+
+/** @} */
+//---------------------------------------------------------------------------
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // dealii_sparse_amg_h
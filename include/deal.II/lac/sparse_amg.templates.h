@@ -0,0 +1,663 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_amg_templates_h
+#define dealii_sparse_amg_templates_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_local_storage.h>
+
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace SparseAMGImplementation
+  {
+    using size_type = types::global_dof_index;
+
+    /**
+     * Compute the product $C = AB$ of two sparse matrices, creating the
+     * sparsity pattern of @p C. The rows of the product are computed in
+     * parallel, once to determine the sparsity pattern and once to compute
+     * the entries, with a dense marker and accumulation array of the length
+     * of a row of the product per thread.
+     */
+    template <typename number>
+    void
+    multiply(const SparseMatrix<number> &A,
+             const SparseMatrix<number> &B,
+             SparsityPattern            &sparsity_C,
+             SparseMatrix<number>       &C)
+    {
+      Assert(A.n() == B.m(), ExcDimensionMismatch(A.n(), B.m()));
+
+      const size_type n_rows = A.m();
+      const size_type n_cols = B.n();
+
+      std::vector<std::vector<size_type>> row_entries(n_rows);
+      Threads::ThreadLocalStorage<std::vector<size_type>> marker_storage;
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_rows,
+        [&](const size_type begin_row, const size_type end_row) {
+          std::vector<size_type> &marker = marker_storage.get();
+          if (marker.size() != n_cols)
+            marker.assign(n_cols, numbers::invalid_size_type);
+          for (size_type row = begin_row; row < end_row; ++row)
+            {
+              std::vector<size_type> &entries = row_entries[row];
+              for (auto a = A.begin(row); a != A.end(row); ++a)
+                for (auto b = B.begin(a->column()); b != B.end(a->column());
+                     ++b)
+                  if (marker[b->column()] != row)
+                    {
+                      marker[b->column()] = row;
+                      entries.push_back(b->column());
+                    }
+              std::sort(entries.begin(), entries.end());
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+
+      std::vector<unsigned int> row_lengths(n_rows);
+      for (size_type row = 0; row < n_rows; ++row)
+        row_lengths[row] = row_entries[row].size();
+      sparsity_C.reinit(n_rows, n_cols, row_lengths);
+      for (size_type row = 0; row < n_rows; ++row)
+        {
+          sparsity_C.add_entries(row,
+                                 row_entries[row].begin(),
+                                 row_entries[row].end(),
+                                 true);
+          std::vector<size_type>().swap(row_entries[row]);
+        }
+      sparsity_C.compress();
+      C.reinit(sparsity_C);
+
+      Threads::ThreadLocalStorage<std::vector<number>> values_storage;
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_rows,
+        [&](const size_type begin_row, const size_type end_row) {
+          std::vector<number> &values = values_storage.get();
+          if (values.size() != n_cols)
+            values.assign(n_cols, number());
+          for (size_type row = begin_row; row < end_row; ++row)
+            {
+              for (auto a = A.begin(row); a != A.end(row); ++a)
+                for (auto b = B.begin(a->column()); b != B.end(a->column());
+                     ++b)
+                  values[b->column()] += a->value() * b->value();
+              for (auto c = C.begin(row); c != C.end(row); ++c)
+                {
+                  c->value()          = values[c->column()];
+                  values[c->column()] = number();
+                }
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+
+
+
+    /**
+     * Compute the transpose of the matrix @p A, creating the sparsity pattern
+     * of @p A_T.
+     */
+    template <typename number>
+    void
+    transpose(const SparseMatrix<number> &A,
+              SparsityPattern            &sparsity_A_T,
+              SparseMatrix<number>       &A_T)
+    {
+      // as the rows of A are traversed in ascending order, the column
+      // indices of each row of the transpose are collected in ascending
+      // order as well
+      std::vector<std::size_t> rowstart(A.n() + 1);
+      for (size_type row = 0; row < A.m(); ++row)
+        for (auto a = A.begin(row); a != A.end(row); ++a)
+          ++rowstart[a->column() + 1];
+      std::partial_sum(rowstart.begin(), rowstart.end(), rowstart.begin());
+
+      std::vector<size_type> colnums(rowstart.back());
+      std::vector<number>    values(rowstart.back());
+      std::vector<std::size_t> next(rowstart.begin(), rowstart.end() - 1);
+      for (size_type row = 0; row < A.m(); ++row)
+        for (auto a = A.begin(row); a != A.end(row); ++a)
+          {
+            const std::size_t index = next[a->column()]++;
+            colnums[index]          = row;
+            values[index]           = a->value();
+          }
+
+      std::vector<unsigned int> row_lengths(A.n());
+      for (size_type row = 0; row < A.n(); ++row)
+        row_lengths[row] = rowstart[row + 1] - rowstart[row];
+      sparsity_A_T.reinit(A.n(), A.m(), row_lengths);
+      for (size_type row = 0; row < A.n(); ++row)
+        sparsity_A_T.add_entries(row,
+                                 colnums.begin() + rowstart[row],
+                                 colnums.begin() + rowstart[row + 1],
+                                 true);
+      sparsity_A_T.compress();
+      A_T.reinit(sparsity_A_T);
+
+      parallel::apply_to_subranges(
+        size_type(0),
+        A.n(),
+        [&](const size_type begin_row, const size_type end_row) {
+          for (size_type row = begin_row; row < end_row; ++row)
+            A_T.set(row,
+                    row_lengths[row],
+                    colnums.data() + rowstart[row],
+                    values.data() + rowstart[row],
+                    false);
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+
+
+
+    /**
+     * Group the unknowns of the matrix @p A into aggregates of strongly
+     * connected unknowns, using the three phases described in the
+     * documentation of the SparseAMG class. Return the number of aggregates
+     * and fill @p aggregate with the aggregate index of each unknown, or
+     * numbers::invalid_size_type for unknowns without strong connections.
+     */
+    template <typename number>
+    size_type
+    compute_aggregates(const SparseMatrix<number> &A,
+                       const double                threshold,
+                       std::vector<size_type>     &aggregate)
+    {
+      const size_type n = A.m();
+
+      std::vector<double> diagonal(n);
+      for (size_type i = 0; i < n; ++i)
+        diagonal[i] = std::abs(A.diag_element(i));
+
+      const auto is_strong = [&](const size_type i, const auto &entry) {
+        const size_type j = entry.column();
+        return j != i && std::abs(entry.value()) >=
+                           threshold * std::sqrt(diagonal[i] * diagonal[j]);
+      };
+
+      const size_type unaggregated = numbers::invalid_size_type;
+      aggregate.assign(n, unaggregated);
+      std::vector<bool> has_strong_connection(n, false);
+      size_type         n_aggregates = 0;
+
+      // phase 1: unknowns whose strong neighbors are all free form a new
+      // aggregate with these neighbors
+      for (size_type i = 0; i < n; ++i)
+        {
+          bool all_free = true;
+          for (auto a = A.begin(i); a != A.end(i); ++a)
+            if (is_strong(i, *a))
+              {
+                has_strong_connection[i] = true;
+                if (aggregate[a->column()] != unaggregated)
+                  {
+                    all_free = false;
+                    break;
+                  }
+              }
+          if (has_strong_connection[i] == false || all_free == false)
+            continue;
+
+          aggregate[i] = n_aggregates;
+          for (auto a = A.begin(i); a != A.end(i); ++a)
+            if (is_strong(i, *a))
+              aggregate[a->column()] = n_aggregates;
+          ++n_aggregates;
+        }
+
+      // the loop above stopped early for some unknowns, so complete the
+      // information on strong connections
+      for (size_type i = 0; i < n; ++i)
+        if (has_strong_connection[i] == false)
+          for (auto a = A.begin(i); a != A.end(i); ++a)
+            if (is_strong(i, *a))
+              {
+                has_strong_connection[i] = true;
+                break;
+              }
+
+      // phase 2: attach the remaining unknowns to the aggregate from phase 1
+      // of their most strongly connected neighbor
+      const std::vector<size_type> aggregate_phase_1 = aggregate;
+      for (size_type i = 0; i < n; ++i)
+        if (aggregate[i] == unaggregated && has_strong_connection[i])
+          {
+            double strongest = 0.;
+            for (auto a = A.begin(i); a != A.end(i); ++a)
+              if (is_strong(i, *a) &&
+                  aggregate_phase_1[a->column()] != unaggregated &&
+                  std::abs(a->value()) > strongest)
+                {
+                  strongest    = std::abs(a->value());
+                  aggregate[i] = aggregate_phase_1[a->column()];
+                }
+          }
+
+      // phase 3: the unknowns still left form new aggregates with their
+      // free strong neighbors
+      for (size_type i = 0; i < n; ++i)
+        if (aggregate[i] == unaggregated && has_strong_connection[i])
+          {
+            aggregate[i] = n_aggregates;
+            for (auto a = A.begin(i); a != A.end(i); ++a)
+              if (is_strong(i, *a) && aggregate[a->column()] == unaggregated)
+                aggregate[a->column()] = n_aggregates;
+            ++n_aggregates;
+          }
+
+      return n_aggregates;
+    }
+
+
+
+    /**
+     * Compute the smoothed prolongator $P = (I - \omega D^{-1} A) P_0$ for
+     * the tentative prolongator $P_0$ given by the aggregates, creating the
+     * sparsity pattern of @p P. The rows are computed in parallel.
+     */
+    template <typename number>
+    void
+    smooth_prolongator(const SparseMatrix<number>   &A,
+                       const std::vector<size_type> &aggregate,
+                       const size_type               n_aggregates,
+                       const double                  omega,
+                       SparsityPattern              &sparsity_P,
+                       SparseMatrix<number>         &P)
+    {
+      const size_type n_rows = A.m();
+
+      std::vector<std::vector<size_type>> row_entries(n_rows);
+      Threads::ThreadLocalStorage<std::vector<size_type>> marker_storage;
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_rows,
+        [&](const size_type begin_row, const size_type end_row) {
+          std::vector<size_type> &marker = marker_storage.get();
+          if (marker.size() != n_aggregates)
+            marker.assign(n_aggregates, numbers::invalid_size_type);
+          for (size_type row = begin_row; row < end_row; ++row)
+            {
+              std::vector<size_type> &entries = row_entries[row];
+              for (auto a = A.begin(row); a != A.end(row); ++a)
+                {
+                  const size_type agg = aggregate[a->column()];
+                  if (agg != numbers::invalid_size_type && marker[agg] != row)
+                    {
+                      marker[agg] = row;
+                      entries.push_back(agg);
+                    }
+                }
+              std::sort(entries.begin(), entries.end());
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+
+      std::vector<unsigned int> row_lengths(n_rows);
+      for (size_type row = 0; row < n_rows; ++row)
+        row_lengths[row] = row_entries[row].size();
+      sparsity_P.reinit(n_rows, n_aggregates, row_lengths);
+      for (size_type row = 0; row < n_rows; ++row)
+        {
+          sparsity_P.add_entries(row,
+                                 row_entries[row].begin(),
+                                 row_entries[row].end(),
+                                 true);
+          std::vector<size_type>().swap(row_entries[row]);
+        }
+      sparsity_P.compress();
+      P.reinit(sparsity_P);
+
+      Threads::ThreadLocalStorage<std::vector<number>> values_storage;
+      parallel::apply_to_subranges(
+        size_type(0),
+        n_rows,
+        [&](const size_type begin_row, const size_type end_row) {
+          std::vector<number> &values = values_storage.get();
+          if (values.size() != n_aggregates)
+            values.assign(n_aggregates, number());
+          for (size_type row = begin_row; row < end_row; ++row)
+            {
+              const number factor = -omega / A.diag_element(row);
+              for (auto a = A.begin(row); a != A.end(row); ++a)
+                {
+                  const size_type agg = aggregate[a->column()];
+                  if (agg != numbers::invalid_size_type)
+                    values[agg] += factor * a->value();
+                }
+              if (aggregate[row] != numbers::invalid_size_type)
+                values[aggregate[row]] += number(1.);
+
+              for (auto p = P.begin(row); p != P.end(row); ++p)
+                {
+                  p->value()          = values[p->column()];
+                  values[p->column()] = number();
+                }
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+  } // namespace SparseAMGImplementation
+} // namespace internal
+
+
+
+template <typename number>
+SparseAMG<number>::AdditionalData::AdditionalData(
+  const double       aggregation_threshold,
+  const double       prolongator_damping,
+  const unsigned int smoother_degree,
+  const double       smoother_smoothing_range,
+  const size_type    max_coarse_size,
+  const unsigned int max_levels)
+  : aggregation_threshold(aggregation_threshold)
+  , prolongator_damping(prolongator_damping)
+  , smoother_degree(smoother_degree)
+  , smoother_smoothing_range(smoother_smoothing_range)
+  , max_coarse_size(max_coarse_size)
+  , max_levels(max_levels)
+{}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::initialize(const SparseMatrix<number> &matrix,
+                              const AdditionalData       &additional_data)
+{
+  Assert(matrix.m() == matrix.n(), ExcNotQuadratic());
+  Assert(additional_data.max_levels > 0,
+         ExcMessage("The hierarchy needs at least one level."));
+
+  clear();
+  this->matrix = &matrix;
+
+  levels.push_back(std::make_unique<Level>());
+  for (unsigned int level = 0;; ++level)
+    {
+      Level                      &data = *levels[level];
+      const SparseMatrix<number> &A    = get_level_matrix(level);
+      const size_type             n    = A.m();
+
+      data.solution.reinit(n);
+      data.rhs.reinit(n);
+      data.residual.reinit(n);
+
+      using SmootherType =
+        PreconditionChebyshev<SparseMatrix<number>, Vector<number>>;
+      typename SmootherType::AdditionalData smoother_data;
+      smoother_data.degree          = additional_data.smoother_degree;
+      smoother_data.smoothing_range = additional_data.smoother_smoothing_range;
+      smoother_data.preconditioner =
+        std::make_shared<DiagonalMatrix<Vector<number>>>();
+      Vector<number> &inverse_diagonal =
+        smoother_data.preconditioner->get_vector();
+      inverse_diagonal.reinit(n);
+      for (size_type i = 0; i < n; ++i)
+        {
+          Assert(A.diag_element(i) > number(), ExcNonPositiveDiagonal(i));
+          inverse_diagonal(i) = number(1.) / A.diag_element(i);
+        }
+      data.smoother.initialize(A, smoother_data);
+
+      if (n <= additional_data.max_coarse_size ||
+          level + 1 == additional_data.max_levels)
+        break;
+
+      std::vector<size_type> aggregate;
+      const size_type        n_aggregates =
+        internal::SparseAMGImplementation::compute_aggregates(
+          A, additional_data.aggregation_threshold, aggregate);
+      if (n_aggregates == 0 || n_aggregates == n)
+        break;
+
+      // the largest eigenvalue of the Jacobi-preconditioned matrix is also
+      // needed by the smoother, so let the smoother estimate it right away
+      const double max_eigenvalue =
+        data.smoother.estimate_eigenvalues(data.rhs).max_eigenvalue_estimate;
+
+      internal::SparseAMGImplementation::smooth_prolongator(
+        A,
+        aggregate,
+        n_aggregates,
+        additional_data.prolongator_damping / max_eigenvalue,
+        data.prolongation_sparsity,
+        data.prolongation);
+      internal::SparseAMGImplementation::transpose(data.prolongation,
+                                                   data.restriction_sparsity,
+                                                   data.restriction);
+
+      // compute the coarse matrix as R (A P)
+      SparsityPattern      sparsity_AP;
+      SparseMatrix<number> AP;
+      internal::SparseAMGImplementation::multiply(A,
+                                                  data.prolongation,
+                                                  sparsity_AP,
+                                                  AP);
+
+      auto coarse = std::make_unique<Level>();
+      internal::SparseAMGImplementation::multiply(data.restriction,
+                                                  AP,
+                                                  coarse->sparsity,
+                                                  coarse->matrix);
+      levels.push_back(std::move(coarse));
+    }
+
+  // invert the matrix on the coarsest level if it is small enough,
+  // otherwise the coarsest level is only treated by the smoother
+  const SparseMatrix<number> &coarse_matrix = get_level_matrix(n_levels() - 1);
+  if (coarse_matrix.m() <= additional_data.max_coarse_size)
+    {
+      coarse_inverse.reinit(coarse_matrix.m(), coarse_matrix.n());
+      coarse_inverse.copy_from(coarse_matrix);
+      if (coarse_inverse.m() > 0)
+        coarse_inverse.gauss_jordan();
+    }
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::clear()
+{
+  coarse_inverse.reinit(0, 0);
+  levels.clear();
+  matrix = nullptr;
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::vmult(Vector<number> &dst, const Vector<number> &src) const
+{
+  Assert(matrix != nullptr, ExcNotInitialized());
+  v_cycle(0, dst, src, true);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::Tvmult(Vector<number> &dst, const Vector<number> &src) const
+{
+  vmult(dst, src);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::step(Vector<number> &dst, const Vector<number> &src) const
+{
+  Assert(matrix != nullptr, ExcNotInitialized());
+  v_cycle(0, dst, src, false);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::Tstep(Vector<number> &dst, const Vector<number> &src) const
+{
+  step(dst, src);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::v_cycle(const unsigned int    level,
+                           Vector<number>       &dst,
+                           const Vector<number> &src,
+                           const bool            zero_initial_guess) const
+{
+  const Level                &data = *levels[level];
+  const SparseMatrix<number> &A    = get_level_matrix(level);
+
+  if (level + 1 == n_levels() && coarse_inverse.m() == A.m())
+    {
+      if (zero_initial_guess)
+        coarse_inverse.vmult(dst, src);
+      else
+        {
+          A.residual(data.residual, dst, src);
+          coarse_inverse.vmult(dst, data.residual, true);
+        }
+      return;
+    }
+
+  // pre-smoothing
+  if (zero_initial_guess)
+    data.smoother.vmult(dst, src);
+  else
+    data.smoother.step(dst, src);
+
+  // coarse-grid correction
+  if (level + 1 < n_levels())
+    {
+      const Level &coarse = *levels[level + 1];
+      A.residual(data.residual, dst, src);
+      data.restriction.vmult(coarse.rhs, data.residual);
+      v_cycle(level + 1, coarse.solution, coarse.rhs, true);
+      data.prolongation.vmult_add(dst, coarse.solution);
+    }
+
+  // post-smoothing
+  data.smoother.step(dst, src);
+}
+
+
+
+template <typename number>
+inline typename SparseAMG<number>::size_type
+SparseAMG<number>::m() const
+{
+  Assert(matrix != nullptr, ExcNotInitialized());
+  return matrix->m();
+}
+
+
+
+template <typename number>
+inline typename SparseAMG<number>::size_type
+SparseAMG<number>::n() const
+{
+  Assert(matrix != nullptr, ExcNotInitialized());
+  return matrix->n();
+}
+
+
+
+template <typename number>
+unsigned int
+SparseAMG<number>::n_levels() const
+{
+  return levels.size();
+}
+
+
+
+template <typename number>
+const SparseMatrix<number> &
+SparseAMG<number>::get_level_matrix(const unsigned int level) const
+{
+  AssertIndexRange(level, n_levels());
+  if (level == 0)
+    return *matrix;
+  else
+    return levels[level]->matrix;
+}
+
+
+
+template <typename number>
+double
+SparseAMG<number>::operator_complexity() const
+{
+  Assert(matrix != nullptr, ExcNotInitialized());
+
+  std::size_t n_nonzero_elements = 0;
+  for (unsigned int level = 0; level < n_levels(); ++level)
+    n_nonzero_elements += get_level_matrix(level).n_nonzero_elements();
+  return static_cast<double>(n_nonzero_elements) /
+         matrix->n_nonzero_elements();
+}
+
+
+
+template <typename number>
+std::size_t
+SparseAMG<number>::memory_consumption() const
+{
+  std::size_t memory = sizeof(*this) + coarse_inverse.memory_consumption();
+  for (const auto &level : levels)
+    memory += sizeof(Level) + level->sparsity.memory_consumption() +
+              level->matrix.memory_consumption() +
+              level->prolongation_sparsity.memory_consumption() +
+              level->prolongation.memory_consumption() +
+              level->restriction_sparsity.memory_consumption() +
+              level->restriction.memory_consumption() +
+              level->solution.memory_consumption() +
+              level->rhs.memory_consumption() +
+              level->residual.memory_consumption();
+  return memory;
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // dealii_sparse_amg_templates_h
@@ -196,34 +196,19 @@ SparseMatrix<number>::operator=(const double d)
   Assert(cols->compressed || cols->empty(),
          SparsityPattern::ExcNotCompressed());
 
-  // do initial zeroing of elements in parallel. Try to achieve a similar
-  // layout as when doing matrix-vector products, as on some NUMA systems, a
-  // memory block is assigned to memory banks where the first access is
-  // generated. For sparse matrices, the first operations is usually the
-  // operator=. The grain size is chosen to reflect the number of rows in
-  // minimum_parallel_grain_size, weighted by the number of nonzero entries
-  // per row on average.
-  const std::size_t matrix_size = cols->n_nonzero_elements();
-  const size_type   grain_size =
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size *
-    (cols->n_nonzero_elements() + m()) / m();
-  if (matrix_size > grain_size)
-    parallel::apply_to_subranges(
-      0U,
-      matrix_size,
-      [this](const size_type begin, const size_type end) {
-        internal::SparseMatrixImplementation::zero_subrange(begin,
-                                                            end,
-                                                            val.get());
-      },
-      grain_size);
-  else if (matrix_size > 0)
-    {
-      if constexpr (std::is_trivial_v<number>)
-        std::memset(val.get(), 0, matrix_size * sizeof(number));
-      else
-        std::fill(val.get(), val.get() + matrix_size, 0);
-    }
+  if (cols->n_nonzero_elements() == 0)
+    return *this;
+
+  // do initial zeroing of elements in parallel. Use the same layout as
+  // when doing matrix-vector products, as on NUMA systems, a memory block is
+  // assigned to memory banks where the first access is generated. For sparse
+  // matrices, the first operation is usually the operator= called from
+  // reinit(), which does not touch the memory it allocates.
+  cols->apply_to_row_subranges(
+    [this](const size_type begin_row, const size_type end_row) {
+      internal::SparseMatrixImplementation::zero_subrange(
+        cols->rowstart[begin_row], cols->rowstart[end_row], val.get());
+    });
 
   return *this;
 }
@@ -265,7 +250,9 @@ SparseMatrix<number>::reinit(const SparsityPattern &sparsity)
   const std::size_t N = cols->n_nonzero_elements();
   if (N > max_len || max_len == 0)
     {
-      val     = std::make_unique<number[]>(N);
+      // leave the memory uninitialized, it is zeroed by the operator=
+      // below in the same partition of the rows as used by vmult()
+      val     = std::unique_ptr<number[]>(new number[N]);
       max_len = N;
     }
 
@@ -779,9 +766,7 @@ SparseMatrix<number>::vmult(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
-  parallel::apply_to_subranges(
-    0U,
-    m(),
+  cols->apply_to_row_subranges(
     [this, &src, &dst](const size_type begin_row, const size_type end_row) {
       internal::SparseMatrixImplementation::vmult_on_subrange(
         begin_row,
@@ -792,8 +777,7 @@ SparseMatrix<number>::vmult(OutVector &dst, const InVector &src) const
         src,
         dst,
         false);
-    },
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    });
 }
 
 
@@ -837,9 +821,7 @@ SparseMatrix<number>::vmult_add(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
-  parallel::apply_to_subranges(
-    0U,
-    m(),
+  cols->apply_to_row_subranges(
     [this, &src, &dst](const size_type begin_row, const size_type end_row) {
       internal::SparseMatrixImplementation::vmult_on_subrange(
         begin_row,
@@ -850,8 +832,7 @@ SparseMatrix<number>::vmult_add(OutVector &dst, const InVector &src) const
         src,
         dst,
         true);
-    },
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    });
 }
 
 
@@ -0,0 +1,338 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_h
+#define dealii_sparse_matrix_sell_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+// Forward declarations
+#ifndef DOXYGEN
+template <typename number>
+class Vector;
+template <typename number>
+class SparseMatrix;
+#endif
+
+/**
+ * @addtogroup Matrix1
+ * @{
+ */
+
+/**
+ * A read-only copy of a SparseMatrix in the sliced ELLPACK format, also
+ * called SELL-C-$\sigma$, which is set up once the assembly of the
+ * SparseMatrix is finished and provides matrix-vector products that make use
+ * of the SIMD instructions of the processor through VectorizedArray.
+ *
+ * The compressed row storage of SparseMatrix works on one row at a time. For
+ * the short rows of low-order finite element discretizations, e.g. 27 entries
+ * of a trilinear element in 3d, this leaves little room for vectorization.
+ * This class instead groups $C$ consecutive rows into a slice, where $C$ is
+ * the number of lanes of VectorizedArray<number>, and stores the $j$-th entry
+ * of all rows in the slice next to each other. The matrix-vector product then
+ * processes the $C$ rows of a slice simultaneously, loading the matrix
+ * entries with one instruction and gathering the entries of the source
+ * vector with the column indices. Rows in a slice that are shorter than the
+ * longest one are padded with zeros. In order to keep the amount of padding
+ * small, the rows are sorted by their length within windows of $\sigma$ rows
+ * (the @p sorting_scope argument of reinit()) before they are grouped into
+ * slices. The sorting is only internal to this class: the vectors passed to
+ * vmult() and related functions are in the numbering of the original matrix.
+ *
+ * Since the class provides the functions m(), n(), el(), vmult(), Tvmult()
+ * and residual(), it can be used as the matrix argument of the solver
+ * classes such as SolverCG and of PreconditionChebyshev, for example as
+ * @code
+ *   SparseMatrixSELL<double> sell_matrix(system_matrix);
+ *
+ *   PreconditionChebyshev<SparseMatrixSELL<double>, Vector<double>>
+ *     preconditioner;
+ *   preconditioner.initialize(sell_matrix);
+ *
+ *   SolverCG<Vector<double>> solver(solver_control);
+ *   solver.solve(sell_matrix, solution, system_rhs, preconditioner);
+ * @endcode
+ * The object holds a copy of the entries, so changes to the original matrix
+ * after the call to reinit() are not reflected in this class.
+ */
+template <typename number>
+class SparseMatrixSELL : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Type of the matrix entries.
+   */
+  using value_type = number;
+
+  /**
+   * The number of rows that are grouped into one slice, which is the number
+   * of lanes in the SIMD instructions used by the matrix-vector product.
+   */
+  static constexpr unsigned int slice_size = VectorizedArray<number>::size();
+
+  /**
+   * Constructor. Set up an empty matrix.
+   */
+  SparseMatrixSELL();
+
+  /**
+   * Constructor. Calls reinit() with the given arguments.
+   */
+  explicit SparseMatrixSELL(const SparseMatrix<number> &matrix,
+                            const unsigned int sorting_scope = 32 * slice_size);
+
+  /**
+   * Copy the entries of @p matrix into the sliced ELLPACK format. The rows
+   * are sorted by their length within groups of @p sorting_scope rows, which
+   * must be a multiple of slice_size. Setting @p sorting_scope to slice_size
+   * only sorts within the slices, which keeps the rows close to their
+   * original position but may need more padding; a value of at least the
+   * number of rows sorts all rows.
+   */
+  void
+  reinit(const SparseMatrix<number> &matrix,
+         const unsigned int          sorting_scope = 32 * slice_size);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return the number of rows of this matrix.
+   */
+  size_type
+  m() const;
+
+  /**
+   * Return the number of columns of this matrix.
+   */
+  size_type
+  n() const;
+
+  /**
+   * Return the number of entries of the original matrix stored in this
+   * object.
+   */
+  std::size_t
+  n_nonzero_elements() const;
+
+  /**
+   * Return the number of entries stored in this object, including the zeros
+   * used for padding the slices. The ratio of this number and
+   * n_nonzero_elements() describes the overhead of the format compared to
+   * the compressed row storage.
+   */
+  std::size_t
+  n_stored_elements() const;
+
+  /**
+   * Return the value of the entry (i,j), or zero if the entry is not stored
+   * in the matrix. This function searches through row @p i and is therefore
+   * slow.
+   */
+  number
+  el(const size_type i, const size_type j) const;
+
+  /**
+   * Return the diagonal entry of row @p i, or zero if it is not stored.
+   */
+  number
+  diag_element(const size_type i) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i>
+   * being this matrix.
+   */
+  void
+  vmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication: add <i>M*src</i> to <i>dst</i>
+   * with <i>M</i> being this matrix.
+   */
+  void
+  vmult_add(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M<sup>T</sup>*src</i> with
+   * <i>M</i> being this matrix.
+   */
+  void
+  Tvmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication: add <i>M<sup>T</sup>*src</i> to
+   * <i>dst</i> with <i>M</i> being this matrix.
+   */
+  void
+  Tvmult_add(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Compute the residual of an equation <i>Mx=b</i>, where the residual is
+   * defined to be <i>r=b-Mx</i>. Write the residual into <tt>dst</tt>. The
+   * <i>l<sub>2</sub></i> norm of the residual vector is returned.
+   *
+   * Source <i>x</i> and destination <i>dst</i> must not be the same vector.
+   */
+  number
+  residual(Vector<number>       &dst,
+           const Vector<number> &x,
+           const Vector<number> &b) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcSourceEqualsDestination,
+                   "You are attempting an operation on two vectors that "
+                   "are the same object, but the operation requires that the "
+                   "two objects are in fact different.");
+  /** @} */
+
+private:
+  /**
+   * Compute the matrix-vector product for the slices in the range
+   * <tt>[begin_slice, end_slice)</tt> and pass the result of each row
+   * together with the row index to @p operation.
+   */
+  template <typename Operation>
+  void
+  vmult_on_subrange(const unsigned int    begin_slice,
+                    const unsigned int    end_slice,
+                    const Vector<number> &src,
+                    const Operation      &operation) const;
+
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * The index of the first entry of each slice in units of slice_size
+   * entries, i.e., the entries of slice @p s are stored in #values between
+   * <tt>slice_start[s]*slice_size</tt> and
+   * <tt>slice_start[s+1]*slice_size</tt>. The difference between two
+   * consecutive entries is the length of the longest row in the slice.
+   */
+  std::vector<std::size_t> slice_start;
+
+  /**
+   * The row of the original matrix stored at each position of the slices,
+   * or numbers::invalid_unsigned_int for positions of the last slice beyond
+   * the number of rows.
+   */
+  std::vector<unsigned int> row_indices;
+
+  /**
+   * The position in the slices at which each row of the original matrix is
+   * stored, i.e., the inverse of #row_indices.
+   */
+  std::vector<unsigned int> row_positions;
+
+  /**
+   * The number of entries of the original matrix in each position of the
+   * slices, excluding the padding.
+   */
+  std::vector<unsigned int> row_lengths;
+
+  /**
+   * The entries of the matrix. The $j$-th entry of the row at position
+   * $p$ of slice $s$ is stored at index <tt>(slice_start[s]+j)*slice_size +
+   * p</tt>.
+   */
+  AlignedVector<number> values;
+
+  /**
+   * The column indices of the entries, in the same layout as #values.
+   * Padding entries point to the last column of the row (or column zero for
+   * empty rows) such that the gather operation in the matrix-vector product
+   * does not access additional cache lines.
+   */
+  AlignedVector<unsigned int> column_indices;
+};
+
+/** @} */
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+
+template <typename number>
+inline typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::m() const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n() const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline std::size_t
+SparseMatrixSELL<number>::n_stored_elements() const
+{
+  return values.size();
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,368 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_templates_h
+#define dealii_sparse_matrix_sell_templates_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename number>
+SparseMatrixSELL<number>::SparseMatrixSELL()
+  : n_rows(0)
+  , n_cols(0)
+  , slice_start(1, 0)
+{}
+
+
+
+template <typename number>
+SparseMatrixSELL<number>::SparseMatrixSELL(const SparseMatrix<number> &matrix,
+                                           const unsigned int sorting_scope)
+  : SparseMatrixSELL()
+{
+  reinit(matrix, sorting_scope);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::reinit(const SparseMatrix<number> &matrix,
+                                 const unsigned int          sorting_scope)
+{
+  Assert(sorting_scope > 0 && sorting_scope % slice_size == 0,
+         ExcMessage("The sorting scope must be a positive multiple of the "
+                    "slice size " +
+                    std::to_string(slice_size) + "."));
+  AssertThrow(matrix.m() < std::numeric_limits<unsigned int>::max() &&
+                matrix.n() < std::numeric_limits<unsigned int>::max(),
+              ExcMessage("SparseMatrixSELL stores the row and column indices "
+                         "as unsigned int and can therefore not represent "
+                         "matrices of this size."));
+
+  clear();
+  n_rows = matrix.m();
+  n_cols = matrix.n();
+
+  const unsigned int n_slices = (n_rows + slice_size - 1) / slice_size;
+  row_indices.resize(n_slices * slice_size, numbers::invalid_unsigned_int);
+  row_positions.resize(n_rows);
+  row_lengths.resize(n_slices * slice_size, 0);
+
+  // sort the rows by decreasing length within each window of sorting_scope
+  // rows, keeping the original order for rows of equal length
+  const SparsityPattern &sparsity = matrix.get_sparsity_pattern();
+  std::iota(row_indices.begin(), row_indices.begin() + n_rows, 0U);
+  for (unsigned int start = 0; start < n_rows; start += sorting_scope)
+    std::stable_sort(row_indices.begin() + start,
+                     row_indices.begin() +
+                       std::min<std::size_t>(start + sorting_scope, n_rows),
+                     [&sparsity](const unsigned int a, const unsigned int b) {
+                       return sparsity.row_length(a) > sparsity.row_length(b);
+                     });
+  for (unsigned int p = 0; p < n_rows; ++p)
+    {
+      row_positions[row_indices[p]] = p;
+      row_lengths[p]                = sparsity.row_length(row_indices[p]);
+    }
+
+  // the length of a slice is the length of its longest row
+  slice_start.resize(n_slices + 1);
+  for (unsigned int s = 0; s < n_slices; ++s)
+    slice_start[s + 1] =
+      slice_start[s] +
+      *std::max_element(row_lengths.begin() + s * slice_size,
+                        row_lengths.begin() + (s + 1) * slice_size);
+
+  values.resize_fast(slice_start[n_slices] * slice_size);
+  column_indices.resize_fast(slice_start[n_slices] * slice_size);
+
+  // copy the entries slice by slice, padding the rows with zeros
+  parallel::apply_to_subranges(
+    0U,
+    n_slices,
+    [&](const unsigned int begin_slice, const unsigned int end_slice) {
+      for (unsigned int s = begin_slice; s < end_slice; ++s)
+        for (unsigned int v = 0; v < slice_size; ++v)
+          {
+            const unsigned int row   = row_indices[s * slice_size + v];
+            std::size_t        index = slice_start[s] * slice_size + v;
+            unsigned int       last_column = 0;
+            if (row != numbers::invalid_unsigned_int)
+              for (auto entry = matrix.begin(row); entry != matrix.end(row);
+                   ++entry, index += slice_size)
+                {
+                  values[index]         = entry->value();
+                  column_indices[index] = entry->column();
+                  last_column           = entry->column();
+                }
+            for (; index < slice_start[s + 1] * slice_size;
+                 index += slice_size)
+              {
+                values[index]         = number();
+                column_indices[index] = last_column;
+              }
+          }
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+      slice_size);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::clear()
+{
+  n_rows = 0;
+  n_cols = 0;
+  slice_start.assign(1, 0);
+  row_indices.clear();
+  row_positions.clear();
+  row_lengths.clear();
+  values.clear();
+  column_indices.clear();
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::n_nonzero_elements() const
+{
+  return std::accumulate(row_lengths.begin(),
+                         row_lengths.end(),
+                         static_cast<std::size_t>(0));
+}
+
+
+
+template <typename number>
+number
+SparseMatrixSELL<number>::el(const size_type i, const size_type j) const
+{
+  AssertIndexRange(i, m());
+  AssertIndexRange(j, n());
+
+  const unsigned int position = row_positions[i];
+  const unsigned int slice    = position / slice_size;
+  for (unsigned int k = 0; k < row_lengths[position]; ++k)
+    {
+      const std::size_t index =
+        (slice_start[slice] + k) * slice_size + position % slice_size;
+      if (column_indices[index] == j)
+        return values[index];
+    }
+  return number();
+}
+
+
+
+template <typename number>
+number
+SparseMatrixSELL<number>::diag_element(const size_type i) const
+{
+  return el(i, i);
+}
+
+
+
+template <typename number>
+template <typename Operation>
+void
+SparseMatrixSELL<number>::vmult_on_subrange(const unsigned int    begin_slice,
+                                            const unsigned int    end_slice,
+                                            const Vector<number> &src,
+                                            const Operation &operation) const
+{
+  for (unsigned int s = begin_slice; s < end_slice; ++s)
+    {
+      const number *value_ptr = values.data() + slice_start[s] * slice_size;
+      const number *const value_end =
+        values.data() + slice_start[s + 1] * slice_size;
+      const unsigned int *column_ptr =
+        column_indices.data() + slice_start[s] * slice_size;
+
+      VectorizedArray<number> sum = number();
+      for (; value_ptr != value_end;
+           value_ptr += slice_size, column_ptr += slice_size)
+        {
+          VectorizedArray<number> matrix_values, source_values;
+          matrix_values.load(value_ptr);
+          source_values.gather(src.begin(), column_ptr);
+          sum += matrix_values * source_values;
+        }
+
+      const unsigned int *rows = row_indices.data() + s * slice_size;
+      for (unsigned int v = 0; v < slice_size; ++v)
+        if (rows[v] != numbers::invalid_unsigned_int)
+          operation(rows[v], sum[v]);
+    }
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::vmult(Vector<number>       &dst,
+                                const Vector<number> &src) const
+{
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(), dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(), src.size()));
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    static_cast<unsigned int>(slice_start.size()) - 1,
+    [this, &src, &dst](const unsigned int begin, const unsigned int end) {
+      vmult_on_subrange(begin,
+                        end,
+                        src,
+                        [&dst](const unsigned int row, const number result) {
+                          dst(row) = result;
+                        });
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+      slice_size);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::vmult_add(Vector<number>       &dst,
+                                    const Vector<number> &src) const
+{
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(), dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(), src.size()));
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    static_cast<unsigned int>(slice_start.size()) - 1,
+    [this, &src, &dst](const unsigned int begin, const unsigned int end) {
+      vmult_on_subrange(begin,
+                        end,
+                        src,
+                        [&dst](const unsigned int row, const number result) {
+                          dst(row) += result;
+                        });
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+      slice_size);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::Tvmult(Vector<number>       &dst,
+                                 const Vector<number> &src) const
+{
+  dst = number();
+  Tvmult_add(dst, src);
+}
+
+
+
+template <typename number>
+void
+SparseMatrixSELL<number>::Tvmult_add(Vector<number>       &dst,
+                                     const Vector<number> &src) const
+{
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(), dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(), src.size()));
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  // different rows write into the same entries of dst, so this loop is not
+  // parallelized, like SparseMatrix::Tvmult_add()
+  for (unsigned int position = 0; position < n_rows; ++position)
+    {
+      const number       source_value = src(row_indices[position]);
+      const unsigned int slice        = position / slice_size;
+      for (unsigned int k = 0; k < row_lengths[position]; ++k)
+        {
+          const std::size_t index =
+            (slice_start[slice] + k) * slice_size + position % slice_size;
+          dst(column_indices[index]) += values[index] * source_value;
+        }
+    }
+}
+
+
+
+template <typename number>
+number
+SparseMatrixSELL<number>::residual(Vector<number>       &dst,
+                                   const Vector<number> &x,
+                                   const Vector<number> &b) const
+{
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(), dst.size()));
+  Assert(m() == b.size(), ExcDimensionMismatch(m(), b.size()));
+  Assert(n() == x.size(), ExcDimensionMismatch(n(), x.size()));
+  Assert(&x != &dst, ExcSourceEqualsDestination());
+
+  return std::sqrt(parallel::accumulate_from_subranges<number>(
+    [this, &x, &b, &dst](const unsigned int begin, const unsigned int end) {
+      number norm_sqr = number();
+      vmult_on_subrange(
+        begin,
+        end,
+        x,
+        [&](const unsigned int row, const number result) {
+          dst(row) = b(row) - result;
+          norm_sqr += dst(row) * dst(row);
+        });
+      return norm_sqr;
+    },
+    0U,
+    static_cast<unsigned int>(slice_start.size()) - 1,
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+      slice_size));
+}
+
+
+
+template <typename number>
+std::size_t
+SparseMatrixSELL<number>::memory_consumption() const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(slice_start) +
+         MemoryConsumption::memory_consumption(row_indices) +
+         MemoryConsumption::memory_consumption(row_positions) +
+         MemoryConsumption::memory_consumption(row_lengths) +
+         values.memory_consumption() + column_indices.memory_consumption();
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -37,6 +37,7 @@
 #include <boost/serialization/split_member.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -61,6 +62,14 @@ namespace ChunkSparsityPatternIterators
 {
   class Accessor;
 }
+
+namespace parallel
+{
+  namespace internal
+  {
+    class TBBPartitioner;
+  }
+} // namespace parallel
 #endif
 
 /**
@@ -1151,6 +1160,27 @@ private:
    */
   bool compressed;
 
+  /**
+   * The affinity partitioner used by apply_to_row_subranges() to assign the
+   * same ranges of rows to the same threads in all loops over this object.
+   */
+  std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner;
+
+  /**
+   * Call @p f with contiguous ranges of rows <tt>[begin_row, end_row)</tt>
+   * that together cover all rows of this object, in parallel if the object
+   * is large enough. The rows are split into ranges with approximately the
+   * same number of entries, which are handed to the threads through
+   * #thread_loop_partitioner. As the operating system places memory pages in
+   * the NUMA domain of the thread that writes to them first, running the
+   * initialization of #colnums and of the values of a SparseMatrix as well
+   * as the matrix-vector products through this function keeps the memory
+   * accesses of each thread local on systems with several sockets.
+   */
+  void
+  apply_to_row_subranges(
+    const std::function<void(const size_type, const size_type)> &f) const;
+
   // Make all sparse matrices friends of this class.
   template <typename number>
   friend class SparseMatrix;
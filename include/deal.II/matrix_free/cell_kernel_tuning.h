@@ -0,0 +1,235 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_cell_kernel_tuning_h
+#define dealii_matrix_free_cell_kernel_tuning_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/matrix_free/evaluation_flags.h>
+#include <deal.II/matrix_free/evaluation_template_factory.h>
+#include <deal.II/matrix_free/fe_evaluation_data.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+
+#include <chrono>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Return the model name of the CPU the program runs on as reported by
+     * the operating system, or "unknown" if the information is not
+     * available.
+     */
+    std::string
+    get_cpu_model_name();
+
+
+
+    /**
+     * A cache of the sum-factorization kernel variants selected by
+     * tune_cell_kernel_variant(), which can be stored on disk between
+     * program runs. Each line of the file contains a key describing the
+     * hardware and the element, followed by a tab character and the
+     * numeric value of the CellKernelVariant. New entries are appended to
+     * the file, so several programs can add entries to the same file, and
+     * the existing lines are never rewritten. If a key appears in several
+     * lines, the last one is used.
+     */
+    class CellKernelVariantCache
+    {
+    public:
+      /**
+       * Constructor. Reads the entries of the file @p filename, if it
+       * exists. An empty file name gives a cache that only lives in memory.
+       */
+      explicit CellKernelVariantCache(const std::string &filename = "");
+
+      /**
+       * Look up the entry for @p key and, if present, set @p variant to the
+       * stored value and return true. Otherwise, return false.
+       */
+      bool
+      find(const std::string &key, CellKernelVariant &variant) const;
+
+      /**
+       * Add or overwrite the entry for @p key.
+       */
+      void
+      insert(const std::string &key, const CellKernelVariant variant);
+
+      /**
+       * Append the entries added by insert() since the file has been read or
+       * since the last call to this function to the file given to the
+       * constructor.
+       */
+      void
+      write();
+
+    private:
+      /**
+       * The name of the file on disk.
+       */
+      std::string filename;
+
+      /**
+       * The entries of the cache.
+       */
+      std::map<std::string, CellKernelVariant> entries;
+
+      /**
+       * The entries added by insert() that have not been written to the file
+       * yet, in the order of insertion.
+       */
+      std::vector<std::pair<std::string, CellKernelVariant>> new_entries;
+    };
+
+
+
+    /**
+     * Return the key under which the kernel variant for the given shape
+     * information and number of components is stored in a
+     * CellKernelVariantCache.
+     */
+    template <int dim, typename VectorizedArrayType>
+    std::string
+    cell_kernel_variant_key(const ShapeInfo<VectorizedArrayType> &shape_info,
+                            const unsigned int                    n_components)
+    {
+      using Number = typename VectorizedArrayType::value_type;
+      return get_cpu_model_name() + " dim=" + std::to_string(dim) +
+             " degree=" + std::to_string(shape_info.data[0].fe_degree) +
+             " n_q_points_1d=" +
+             std::to_string(shape_info.data[0].n_q_points_1d) +
+             " n_components=" + std::to_string(n_components) +
+             " element_type=" +
+             std::to_string(static_cast<int>(shape_info.element_type)) +
+             " number=" + (std::is_same_v<Number, float> ? "float" : "double") +
+             " width=" + std::to_string(VectorizedArrayType::size());
+    }
+
+
+
+    /**
+     * Measure the run time of the evaluation and integration of values and
+     * gradients on a cell with the different sum-factorization kernels that
+     * are applicable to the element described by @p shape_info and return
+     * the fastest variant. For elements where there is no choice, e.g. for
+     * collocation between nodes and quadrature points or elements without
+     * symmetric shape functions, CellKernelVariant::heuristic is returned.
+     * The variant stored in @p shape_info is left unchanged.
+     */
+    template <int dim, typename VectorizedArrayType>
+    CellKernelVariant
+    tune_cell_kernel_variant(ShapeInfo<VectorizedArrayType> &shape_info,
+                             const unsigned int              n_components)
+    {
+      if (shape_info.data.size() != 1 ||
+          shape_info.element_type == tensor_symmetric_collocation ||
+          shape_info.element_type > tensor_symmetric_no_collocation)
+        return CellKernelVariant::heuristic;
+
+      std::vector<CellKernelVariant> candidates;
+      if (shape_info.element_type <= tensor_symmetric &&
+          use_collocation_evaluation(shape_info.data[0].fe_degree,
+                                     shape_info.data[0].n_q_points_1d))
+        candidates.push_back(CellKernelVariant::transform_to_collocation);
+      candidates.push_back(CellKernelVariant::even_odd);
+      candidates.push_back(CellKernelVariant::general);
+
+      const unsigned int n_dofs =
+        shape_info.dofs_per_component_on_cell * n_components;
+      AlignedVector<VectorizedArrayType> dofs_in(n_dofs), dofs_out(n_dofs);
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        dofs_in[i] = 0.1 * (i % 17) - 0.8;
+
+      AlignedVector<VectorizedArrayType>                 scratch_data;
+      FEEvaluationData<dim, VectorizedArrayType, false> eval(shape_info);
+      eval.set_data_pointers(&scratch_data, n_components);
+
+      // choose the number of repetitions such that one measurement takes
+      // roughly a millisecond, according to the arithmetic work of sum
+      // factorization
+      const unsigned int n_points_1d = std::max(
+        shape_info.data[0].fe_degree + 1, shape_info.data[0].n_q_points_1d);
+      const double work_per_cell = 4. * dim * (dim + 1) * n_components *
+                                   shape_info.n_q_points * n_points_1d *
+                                   VectorizedArrayType::size();
+      const unsigned int n_repetitions =
+        std::max(1U, static_cast<unsigned int>(2e6 / work_per_cell));
+      const unsigned int n_measurements = 5;
+      const auto         flags =
+        EvaluationFlags::values | EvaluationFlags::gradients;
+
+      const CellKernelVariant original_variant = shape_info.cell_kernel_variant;
+      CellKernelVariant       best_variant     = CellKernelVariant::heuristic;
+      double best_time = std::numeric_limits<double>::max();
+      for (const CellKernelVariant variant : candidates)
+        {
+          shape_info.cell_kernel_variant = variant;
+
+          double min_time = std::numeric_limits<double>::max();
+          // the first measurement warms up the caches and is not counted
+          for (unsigned int m = 0; m <= n_measurements; ++m)
+            {
+              const auto start = std::chrono::steady_clock::now();
+              for (unsigned int r = 0; r < n_repetitions; ++r)
+                {
+                  FEEvaluationFactory<dim, VectorizedArrayType>::evaluate(
+                    n_components, flags, dofs_in.data(), eval);
+                  FEEvaluationFactory<dim, VectorizedArrayType>::integrate(
+                    n_components, flags, dofs_out.data(), eval, false);
+                }
+              const double time =
+                std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+              if (m > 0)
+                min_time = std::min(min_time, time);
+            }
+
+          if (min_time < best_time)
+            {
+              best_time    = min_time;
+              best_variant = variant;
+            }
+        }
+      shape_info.cell_kernel_variant = original_variant;
+
+      return best_variant;
+    }
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1986,6 +1986,9 @@ namespace internal
 
       const auto element_type = fe_eval.get_shape_info().element_type;
       using ElementType       = MatrixFreeFunctions::ElementType;
+      using KernelVariant     = MatrixFreeFunctions::CellKernelVariant;
+      const KernelVariant kernel_variant =
+        fe_eval.get_shape_info().cell_kernel_variant;
 
       Assert(fe_eval.get_shape_info().data.size() == 1 ||
                (fe_eval.get_shape_info().data.size() == dim &&
@@ -2034,7 +2037,9 @@ namespace internal
       // shape_info.h for more details
       else if (fe_degree >= 0 &&
                use_collocation_evaluation(fe_degree, n_q_points_1d) &&
-               element_type <= ElementType::tensor_symmetric)
+               element_type <= ElementType::tensor_symmetric &&
+               (kernel_variant == KernelVariant::heuristic ||
+                kernel_variant == KernelVariant::transform_to_collocation))
         {
           evaluate_or_integrate<
             FEEvaluationImplTransformToCollocation<dim,
@@ -2048,7 +2053,8 @@ namespace internal
             sum_into_values_array);
         }
       else if (fe_degree >= 0 &&
-               element_type <= ElementType::tensor_symmetric_no_collocation)
+               element_type <= ElementType::tensor_symmetric_no_collocation &&
+               kernel_variant != KernelVariant::general)
         {
           evaluate_or_integrate<FEEvaluationImpl<ElementType::tensor_symmetric,
                                                  dim,
@@ -2997,6 +2997,14 @@ inline FEEvaluationBase<dim,
       this->quadrature_points =
         this->mapped_geometry->get_data_storage().quadrature_points.begin();
     }
+  else
+    {
+      // the geometry computed on the fly or converted from single precision
+      // in reinit() is stored in mapped_geometry. Do not share that storage
+      // with the other object, which might be used on another thread, but
+      // let reinit() create a new one
+      this->mapped_geometry.reset();
+    }
 
   this->set_data_pointers(scratch_data_array, n_components_);
 }
@@ -3068,6 +3076,10 @@ operator=(const FEEvaluationBase<dim,
   else
     {
       scratch_data_array = matrix_free->acquire_scratch_data();
+
+      // do not share the storage of the geometry computed in reinit() with
+      // the other object, see the copy constructor
+      this->mapped_geometry.reset();
     }
 
   this->set_data_pointers(scratch_data_array, n_components_);
@@ -7475,8 +7487,51 @@ FEEvaluation<dim,
 
   const unsigned int offsets =
     this->mapping_data->data_index_offsets[cell_index];
-  this->jacobian = &this->mapping_data->jacobians[0][offsets];
-  this->J_value  = &this->mapping_data->JxW_values[offsets];
+  const auto &mapping_info = this->matrix_free->get_mapping_info();
+  if (mapping_info.geometry_on_the_fly &&
+      this->cell_type == internal::MatrixFreeFunctions::general)
+    {
+      // compute the geometry from the mapping support points into the
+      // internal data storage
+      if (this->mapped_geometry == nullptr)
+        this->mapped_geometry =
+          std::make_shared<internal::MatrixFreeFunctions::
+                             MappingDataOnTheFly<dim, VectorizedArrayType>>();
+      auto &mapping_storage = this->mapped_geometry->get_data_storage();
+
+      AlignedVector<VectorizedArrayType> *scratch_data =
+        this->matrix_free->acquire_scratch_data();
+      mapping_info.compute_cell_geometry_on_the_fly(cell_index,
+                                                    this->quad_no,
+                                                    mapping_storage,
+                                                    *scratch_data);
+      this->matrix_free->release_scratch_data(scratch_data);
+
+      this->jacobian = mapping_storage.jacobians[0].data();
+      this->J_value  = mapping_storage.JxW_values.data();
+    }
+  else if (mapping_info.single_precision_cell_data)
+    {
+      // convert the geometry stored in single precision into the internal
+      // data storage
+      if (this->mapped_geometry == nullptr)
+        this->mapped_geometry =
+          std::make_shared<internal::MatrixFreeFunctions::
+                             MappingDataOnTheFly<dim, VectorizedArrayType>>();
+      auto &mapping_storage = this->mapped_geometry->get_data_storage();
+      mapping_info.convert_cell_data_from_float(cell_index,
+                                                this->quad_no,
+                                                this->n_quadrature_points,
+                                                mapping_storage);
+
+      this->jacobian = mapping_storage.jacobians[0].data();
+      this->J_value  = mapping_storage.JxW_values.data();
+    }
+  else
+    {
+      this->jacobian = &this->mapping_data->jacobians[0][offsets];
+      this->J_value  = &this->mapping_data->JxW_values[offsets];
+    }
   if (!this->mapping_data->jacobian_gradients[0].empty())
     {
       this->jacobian_gradients =
@@ -7535,6 +7590,16 @@ FEEvaluation<dim,
   Assert(this->dof_info != nullptr, ExcNotInitialized());
   Assert(this->mapping_data != nullptr, ExcNotInitialized());
 
+  Assert(this->matrix_free->get_mapping_info().geometry_on_the_fly == false,
+         ExcMessage("Initializing FEEvaluation with an array of cell indices "
+                    "is not supported when the geometry is computed on the "
+                    "fly."));
+  Assert(this->matrix_free->get_mapping_info().single_precision_cell_data ==
+           false,
+         ExcMessage("Initializing FEEvaluation with an array of cell indices "
+                    "is not supported when the geometry is stored in single "
+                    "precision."));
+
   this->cell     = numbers::invalid_unsigned_int;
   this->cell_ids = cell_ids;
 
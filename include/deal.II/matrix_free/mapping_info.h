@@ -34,6 +34,7 @@
 
 #include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/mapping_info_storage.h>
+#include <deal.II/matrix_free/shape_info.h>
 
 #include <memory>
 
@@ -60,7 +61,17 @@ namespace internal
        * CellIterator::level() and CellIterator::index(), in order to allow
        * for different kinds of iterators, e.g. standard DoFHandler,
        * multigrid, etc.)  on a fixed Triangulation. In addition, a mapping
-       * and several 1d quadrature formulas are given.
+       * and several 1d quadrature formulas are given. The last argument
+       * controls the relative tolerance by which the Jacobian may vary
+       * within a cell for the cell to be still treated as affine, see
+       * MatrixFree::AdditionalData::affine_jacobian_tolerance, and
+       * @p compute_geometry_on_the_fly selects whether the Jacobians of
+       * general cells should be computed in FEEvaluation::reinit() rather
+       * than stored, see
+       * MatrixFree::AdditionalData::compute_geometry_on_the_fly. Finally,
+       * @p store_mapping_data_in_float selects whether the inverse Jacobians
+       * and JxW values on cells are kept in single precision, see
+       * MatrixFree::AdditionalData::store_mapping_data_in_float.
        */
       void
       initialize(
@@ -74,7 +85,10 @@ namespace internal
         const UpdateFlags update_flags_boundary_faces,
         const UpdateFlags update_flags_inner_faces,
         const UpdateFlags update_flags_faces_by_cells,
-        const bool        piola_transform);
+        const bool        piola_transform,
+        const double      affine_jacobian_tolerance   = 0.,
+        const bool        compute_geometry_on_the_fly = false,
+        const bool        store_mapping_data_in_float = false);
 
       /**
        * Update the information in the given cells and faces that is the
@@ -96,6 +110,45 @@ namespace internal
       GeometryType
       get_cell_type(const unsigned int cell_chunk_no) const;
 
+      /**
+       * Compute the inverse Jacobians and the JxW values on the cell batch
+       * @p cell_chunk_no for the quadrature formula with index @p quad_no
+       * from the mapping support points stored in cell_support_points,
+       * using the sum-factorization kernels of the matrix-free framework.
+       * The result is placed into the fields `jacobians[0]` and
+       * `JxW_values` of @p data, which are resized to the number of
+       * quadrature points as necessary, using the layout of a general cell.
+       * The array @p scratch_data is used for temporary storage.
+       *
+       * This function may only be called if geometry_on_the_fly is set and
+       * the given cell batch is of type general.
+       */
+      void
+      compute_cell_geometry_on_the_fly(
+        const unsigned int                                 cell_chunk_no,
+        const unsigned int                                 quad_no,
+        MappingInfoStorage<dim, dim, VectorizedArrayType> &data,
+        AlignedVector<VectorizedArrayType>                &scratch_data) const;
+
+      /**
+       * Convert the inverse Jacobians and the JxW values on the cell batch
+       * @p cell_chunk_no for the quadrature formula with index @p quad_no
+       * from the single-precision storage into the fields `jacobians[0]`
+       * and `JxW_values` of @p data, which are resized as necessary. The
+       * layout of the stored data is kept, i.e., two entries are filled for
+       * Cartesian and affine cells, and @p n_q_points entries for general
+       * cells.
+       *
+       * This function may only be called if single_precision_cell_data is
+       * set.
+       */
+      void
+      convert_cell_data_from_float(
+        const unsigned int                                 cell_chunk_no,
+        const unsigned int                                 quad_no,
+        const unsigned int                                 n_q_points,
+        MappingInfoStorage<dim, dim, VectorizedArrayType> &data) const;
+
       /**
        * Clear all data fields in this class.
        */
@@ -140,6 +193,72 @@ namespace internal
        */
       UpdateFlags update_flags_faces_by_cells;
 
+      /**
+       * The relative tolerance for the variation of the Jacobian within a
+       * cell below which the cell is treated as affine.
+       */
+      double affine_jacobian_tolerance = 0.;
+
+      /**
+       * Stores whether the Jacobians and JxW values on cells of type general
+       * are computed on the fly from the mapping support points rather than
+       * being stored for all quadrature points. This is only the case if
+       * requested by MatrixFree::AdditionalData, if the mapping is a MappingQ
+       * without hp-capabilities, and if no Jacobian gradients are requested.
+       * Cartesian and affine cells always use the stored data.
+       */
+      bool geometry_on_the_fly = false;
+
+      /**
+       * In case the geometry is computed on the fly, this field stores the
+       * offset into cell_support_points for each cell batch, or
+       * numbers::invalid_unsigned_int for Cartesian and affine cells. Cell
+       * batches that are translations of a previous cell batch share the
+       * support points of the latter.
+       */
+      std::vector<unsigned int> cell_support_point_offsets;
+
+      /**
+       * In case the geometry is computed on the fly, this field stores the
+       * support points of the mapping on the cell batches of type general,
+       * with the @p dim components of a cell batch following each other.
+       */
+      AlignedVector<VectorizedArrayType> cell_support_points;
+
+      /**
+       * In case the geometry is computed on the fly, this field stores the
+       * interpolation matrices from the mapping support points to the
+       * quadrature points of each quadrature formula.
+       */
+      std::vector<ShapeInfo<VectorizedArrayType>> mapping_shape_info;
+
+      /**
+       * Stores whether the inverse Jacobians and JxW values on cells are
+       * kept in single precision in the fields single_precision_JxW_values
+       * and single_precision_jacobians, rather than in the fields
+       * `JxW_values` and `jacobians[0]` of cell_data, which are empty in
+       * that case. This is only the case if requested by
+       * MatrixFree::AdditionalData and if the number type is `double`.
+       */
+      bool single_precision_cell_data = false;
+
+      /**
+       * In case the cell data is kept in single precision, this field stores
+       * the JxW values for each quadrature formula, with the lanes of a
+       * vectorized entry following each other and indexed by the
+       * `data_index_offsets` of cell_data.
+       */
+      std::vector<AlignedVector<float>> single_precision_JxW_values;
+
+      /**
+       * In case the cell data is kept in single precision, this field stores
+       * the inverse Jacobians (and the Jacobians of Cartesian and affine
+       * cells) for each quadrature formula, with the lanes of each of the
+       * `dim*dim` components following each other and indexed by the
+       * `data_index_offsets` of cell_data.
+       */
+      std::vector<AlignedVector<float>> single_precision_jacobians;
+
       /**
        * Stores whether a cell is Cartesian (cell type 0), has constant
        * transform data (Jacobians) (cell type 1), or is general (cell type
@@ -228,6 +347,16 @@ namespace internal
         const std::vector<std::pair<unsigned int, unsigned int>> &cells,
         const FaceInfo<VectorizedArrayType::size()>              &face_info);
 
+      /**
+       * Internal function to move the inverse Jacobians and JxW values of
+       * the cells into the single-precision fields
+       * single_precision_jacobians and single_precision_JxW_values, called
+       * at the end of initialize() and update_mapping() if
+       * single_precision_cell_data is set.
+       */
+      void
+      convert_cell_data_to_float();
+
       /**
        * Computes the information in the given cells, called within
        * initialize.
@@ -309,6 +438,54 @@ namespace internal
       return cell_type[cell_no];
     }
 
+
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    inline void
+    MappingInfo<dim, Number, VectorizedArrayType>::
+      convert_cell_data_from_float(
+        const unsigned int                                 cell_chunk_no,
+        const unsigned int                                 quad_no,
+        const unsigned int                                 n_q_points,
+        MappingInfoStorage<dim, dim, VectorizedArrayType> &data) const
+    {
+      Assert(single_precision_cell_data, ExcNotInitialized());
+      AssertIndexRange(quad_no, single_precision_JxW_values.size());
+      constexpr unsigned int n_lanes = VectorizedArrayType::size();
+
+      // Cartesian and affine cells store the inverse Jacobian and the
+      // Jacobian in two subsequent entries
+      const unsigned int n_entries =
+        get_cell_type(cell_chunk_no) <= affine ? 2 : n_q_points;
+      if (data.JxW_values.size() < n_entries)
+        {
+          data.JxW_values.resize_fast(n_entries);
+          data.jacobians[0].resize_fast(n_entries);
+        }
+
+      const unsigned int offset =
+        cell_data[quad_no].data_index_offsets[cell_chunk_no];
+      const float *JxW_values =
+        single_precision_JxW_values[quad_no].data() + offset * n_lanes;
+      const float *jacobians = single_precision_jacobians[quad_no].data() +
+                               offset * dim * dim * n_lanes;
+      for (unsigned int q = 0; q < n_entries; ++q)
+        {
+          DEAL_II_OPENMP_SIMD_PRAGMA
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            data.JxW_values[q][v] = JxW_values[q * n_lanes + v];
+          for (unsigned int d = 0; d < dim; ++d)
+            for (unsigned int e = 0; e < dim; ++e)
+              {
+                const float *jac =
+                  jacobians + ((q * dim + d) * dim + e) * n_lanes;
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int v = 0; v < n_lanes; ++v)
+                  data.jacobians[0][q][d][e][v] = jac[v];
+              }
+        }
+    }
+
   } // end of namespace MatrixFreeFunctions
 } // end of namespace internal
 
@@ -36,6 +36,7 @@
 #include <deal.II/matrix_free/util.h>
 
 #include <limits>
+#include <type_traits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -53,6 +54,11 @@ namespace internal
       face_data_by_cells.clear();
       cell_type.clear();
       face_type.clear();
+      cell_support_point_offsets.clear();
+      cell_support_points.clear();
+      mapping_shape_info.clear();
+      single_precision_JxW_values.clear();
+      single_precision_jacobians.clear();
       mapping_collection = nullptr;
       mapping            = nullptr;
     }
@@ -72,11 +78,15 @@ namespace internal
       const UpdateFlags update_flags_boundary_faces,
       const UpdateFlags update_flags_inner_faces,
       const UpdateFlags update_flags_faces_by_cells,
-      const bool        piola_transform)
+      const bool        piola_transform,
+      const double      affine_jacobian_tolerance,
+      const bool        compute_geometry_on_the_fly,
+      const bool        store_mapping_data_in_float)
     {
       clear();
-      this->mapping_collection = mapping;
-      this->mapping            = &mapping->operator[](0);
+      this->mapping_collection        = mapping;
+      this->mapping                   = &mapping->operator[](0);
+      this->affine_jacobian_tolerance = affine_jacobian_tolerance;
 
       cell_data.resize(quad.size());
       face_data.resize(quad.size());
@@ -107,6 +117,18 @@ namespace internal
       this->update_flags_inner_faces    = this->update_flags_boundary_faces;
       this->update_flags_faces_by_cells = update_flags_faces_by_cells;
 
+      // the computation of the geometry on the fly only provides the
+      // Jacobians, not their derivatives
+      this->geometry_on_the_fly =
+        compute_geometry_on_the_fly &&
+        (this->update_flags_cells & update_jacobian_grads) == 0u;
+
+      // keeping the data in single precision only makes sense if the data is
+      // computed in double precision
+      this->single_precision_cell_data =
+        store_mapping_data_in_float &&
+        std::is_same_v<typename VectorizedArrayType::value_type, double>;
+
       reference_cell_types.resize(quad.size());
 
       for (unsigned int my_q = 0; my_q < quad.size(); ++my_q)
@@ -191,6 +213,10 @@ namespace internal
         compute_mapping_q(tria, cells, face_info);
       else
         {
+          // computing the geometry on the fly is only supported for the
+          // polynomial description of MappingQ
+          geometry_on_the_fly = false;
+
           // Could call these functions in parallel, but not useful because
           // the work inside is nicely split up already
           initialize_cells(tria, cells, active_fe_index, *mapping);
@@ -198,6 +224,9 @@ namespace internal
             tria, cells, face_info.faces, active_fe_index, *mapping);
           initialize_faces_by_cells(tria, cells, face_info, *mapping);
         }
+
+      if (single_precision_cell_data)
+        convert_cell_data_to_float();
     }
 
 
@@ -229,6 +258,10 @@ namespace internal
         compute_mapping_q(tria, cells, face_info);
       else
         {
+          // computing the geometry on the fly is only supported for the
+          // polynomial description of MappingQ
+          geometry_on_the_fly = false;
+
           // Could call these functions in parallel, but not useful because
           // the work inside is nicely split up already
           initialize_cells(tria, cells, active_fe_index, *mapping);
@@ -236,6 +269,9 @@ namespace internal
             tria, cells, face_info.faces, active_fe_index, *mapping);
           initialize_faces_by_cells(tria, cells, face_info, *mapping);
         }
+
+      if (single_precision_cell_data)
+        convert_cell_data_to_float();
     }
 
 
@@ -404,20 +440,73 @@ namespace internal
 
 
 
+      /**
+       * Compute the Jacobian representing a nearly affine cell, i.e., a cell
+       * classified as affine by a positive affine_jacobian_tolerance, from
+       * the Jacobians in the points of @p quadrature returned by
+       * @p get_jacobian. Rather than the Jacobian in one of the points, this
+       * is the average of the Jacobians weighted by the JxW values, scaled
+       * such that its determinant is the average Jacobian determinant on the
+       * cell. This way, the volume of the cell integrated with the
+       * compressed data is the same as with the Jacobians in all quadrature
+       * points. For Cartesian cells, only the diagonal is kept.
+       */
+      template <int dim, typename Number, typename FunctionType>
+      Tensor<2, dim, Number>
+      compute_average_jacobian(const Quadrature<dim> &quadrature,
+                               const FunctionType    &get_jacobian,
+                               const bool             is_cartesian)
+      {
+        Tensor<2, dim, Number> average_jacobian;
+        Number                 volume           = 0.;
+        double                 reference_volume = 0.;
+        for (unsigned int q = 0; q < quadrature.size(); ++q)
+          {
+            const Tensor<2, dim, Number> jac = get_jacobian(q);
+            const Number JxW = determinant(jac) * quadrature.weight(q);
+            for (unsigned int d = 0; d < dim; ++d)
+              for (unsigned int e = 0; e < dim; ++e)
+                average_jacobian[d][e] += JxW * jac[d][e];
+            volume += JxW;
+            reference_volume += quadrature.weight(q);
+          }
+
+        for (unsigned int d = 0; d < dim; ++d)
+          for (unsigned int e = 0; e < dim; ++e)
+            if (is_cartesian && d != e)
+              average_jacobian[d][e] = 0.;
+            else
+              average_jacobian[d][e] /= volume;
+
+        const Number scaling =
+          std::pow(volume / (reference_volume * determinant(average_jacobian)),
+                   1. / dim);
+        for (unsigned int d = 0; d < dim; ++d)
+          for (unsigned int e = 0; e < dim; ++e)
+            average_jacobian[d][e] *= scaling;
+        return average_jacobian;
+      }
+
+
+
       /**
        * Helper function called internally during the initialize function.
+       * The argument @p affine_jacobian_tolerance gives the relative
+       * variation of the Jacobian within a cell up to which a cell is still
+       * classified as affine.
        */
       template <int dim, typename VectorizedArrayType>
       void
       evaluate_on_cell(const dealii::Triangulation<dim>            &tria,
                        const std::pair<unsigned int, unsigned int> *cells,
                        const unsigned int                           my_q,
-                       GeometryType                                &cell_t_prev,
-                       GeometryType                                *cell_t,
-                       dealii::FEValues<dim, dim>                  &fe_val,
+                       const double                   affine_jacobian_tolerance,
+                       GeometryType                  &cell_t_prev,
+                       GeometryType                  *cell_t,
+                       dealii::FEValues<dim, dim>    &fe_val,
                        LocalData<dim,
                                  typename VectorizedArrayType::value_type,
-                                 VectorizedArrayType>              &cell_data)
+                                 VectorizedArrayType> &cell_data)
       {
         const unsigned int n_q_points   = fe_val.n_quadrature_points;
         const UpdateFlags  update_flags = fe_val.get_update_flags();
@@ -470,6 +559,12 @@ namespace internal
                 // time we come around here
                 if (cell_t[j] == general)
                   {
+                    // cells whose Jacobian varies by less than the relative
+                    // tolerance given by the user are treated as affine
+                    // ("nearly affine" cells)
+                    const double constant_tolerance =
+                      std::max(zero_tolerance_double,
+                               affine_jacobian_tolerance * jac_0.norm());
                     bool jacobian_constant = true;
                     for (unsigned int q = 1; q < n_q_points; ++q)
                       {
@@ -478,7 +573,7 @@ namespace internal
                         for (unsigned int d = 0; d < dim; ++d)
                           for (unsigned int e = 0; e < dim; ++e)
                             if (std::fabs(jac_0[d][e] - jac[d][e]) >
-                                zero_tolerance_double)
+                                constant_tolerance)
                               jacobian_constant = false;
                         if (jacobian_constant == false)
                           break;
@@ -535,8 +630,25 @@ namespace internal
                       cell_t[j] = general;
                   }
 
+                // nearly affine cell: use the average Jacobian on the cell
+                // rather than the one in the first quadrature point
+                if (cell_t[j] <= affine && affine_jacobian_tolerance > 0.)
+                  {
+                    const Tensor<2, dim> jac =
+                      compute_average_jacobian<dim, double>(
+                        fe_val.get_quadrature(),
+                        [&](const unsigned int q) {
+                          return Tensor<2, dim>(fe_val.jacobian(q));
+                        },
+                        cell_t[j] == cartesian);
+                    for (unsigned int d = 0; d < dim; ++d)
+                      for (unsigned int e = 0; e < dim; ++e)
+                        cell_data.const_jac[d][e][j] = jac[d][e];
+                    continue;
+                  }
+
                 // Cartesian cell
-                if (cell_t[j] == cartesian)
+                else if (cell_t[j] == cartesian)
                   {
                     // set Jacobian into diagonal (off-diagonal part is already
                     // zeroed out)
@@ -704,6 +816,7 @@ namespace internal
               evaluate_on_cell(tria,
                                &cells[cell * VectorizedArrayType::size()],
                                my_q,
+                               mapping_info.affine_jacobian_tolerance,
                                cell_t_prev,
                                cell_t,
                                fe_val,
@@ -998,6 +1111,7 @@ namespace internal
         const dealii::Triangulation<dim>                         &tria,
         const std::vector<std::pair<unsigned int, unsigned int>> &cell_array,
         const double                                              jacobian_size,
+        const double              affine_jacobian_tolerance,
         std::vector<GeometryType> &preliminary_cell_type,
         AlignedVector<double>     &plain_quadrature_points,
         AlignedVector<std::array<Tensor<2, dim>, dim + 1>>
@@ -1045,12 +1159,17 @@ namespace internal
                   if (std::abs(my_jacobians[0][d][e]) > 1e-12 * jacobian_size)
                     type = affine;
 
+            // for the check of a constant Jacobian, also accept the
+            // variations up to the relative tolerance given by the user
+            const double constant_tolerance =
+              std::max(1e-12 * jacobian_size,
+                       affine_jacobian_tolerance * my_jacobians[0].norm());
             for (unsigned int q = 1; q < n_mapping_points; ++q)
               for (unsigned int d = 0; d < dim; ++d)
                 for (unsigned int e = 0; e < dim; ++e)
                   if (std::abs(fe_values.jacobian(q)[d][e] -
                                fe_values.jacobian(0)[d][e]) >
-                      1e-12 * jacobian_size)
+                      constant_tolerance)
                     {
                       type = general;
                       goto endloop;
@@ -1144,7 +1263,11 @@ namespace internal
        * This evaluates the mapping information on a range of cells calling
        * into the tensor product interpolators of the matrix-free framework,
        * using a polynomial expansion of the cell geometry in terms of
-       * MappingQ.
+       * MappingQ. If @p geometry_on_the_fly is set, the Jacobians and JxW
+       * values of general cells are not stored, only their quadrature
+       * points. Cells classified as affine by a positive
+       * @p affine_jacobian_tolerance store the average Jacobian computed by
+       * compute_average_jacobian().
        */
       template <int dim,
                 typename Number,
@@ -1157,6 +1280,8 @@ namespace internal
         const std::vector<GeometryType>   &cell_type,
         const std::vector<bool>           &process_cell,
         const UpdateFlags                  update_flags_cells,
+        const bool                         geometry_on_the_fly,
+        const double                       affine_jacobian_tolerance,
         const AlignedVector<double>       &plain_quadrature_points,
         const ShapeInfo<VectorizedDouble> &shape_info,
         MappingInfoStorage<dim, dim, VectorizedArrayType> &my_data)
@@ -1218,19 +1343,36 @@ namespace internal
                           quadrature_points[q][d]);
                 }
 
+              // in case the geometry of general cells is computed on the fly,
+              // we only store the quadrature points of those cells
               const unsigned int n_points =
-                cell_type[cell] <= affine ? 1 : n_q_points;
+                cell_type[cell] <= affine ? 1 :
+                geometry_on_the_fly       ? 0 :
+                                            n_q_points;
+              const auto get_jacobian = [&](const unsigned int q) {
+                Tensor<2, dim, VectorizedDouble> jac;
+                for (unsigned int d = 0; d < dim; ++d)
+                  for (unsigned int e = 0; e < dim; ++e)
+                    jac[d][e] =
+                      eval.begin_gradients()[e + (d * n_q_points + q) * dim];
+                return jac;
+              };
               if (process_cell[cell])
                 for (unsigned int q = 0; q < n_points; ++q)
                   {
                     const unsigned int idx =
                       my_data.data_index_offsets[cell] + q;
-                    Tensor<2, dim, VectorizedDouble> jac;
-                    for (unsigned int d = 0; d < dim; ++d)
-                      for (unsigned int e = 0; e < dim; ++e)
-                        jac[d][e] =
-                          eval
-                            .begin_gradients()[e + (d * n_q_points + q) * dim];
+
+                    // nearly affine cells use the average Jacobian on the
+                    // cell rather than the one in the first quadrature point
+                    Tensor<2, dim, VectorizedDouble> jac =
+                      (cell_type[cell] <= affine &&
+                       affine_jacobian_tolerance > 0.) ?
+                        compute_average_jacobian<dim, VectorizedDouble>(
+                          my_data.descriptor[0].quadrature,
+                          get_jacobian,
+                          cell_type[cell] == cartesian) :
+                        get_jacobian(q);
 
                     // eliminate roundoff errors
                     if (cell_type[cell] == cartesian)
@@ -2663,6 +2805,7 @@ namespace internal
             tria,
             cell_array,
             jacobian_size,
+            affine_jacobian_tolerance,
             preliminary_cell_type,
             plain_quadrature_points,
             jacobians_on_stencil);
@@ -2733,6 +2876,52 @@ namespace internal
                               preliminary_cell_type.data() + cell + n_lanes);
         }
 
+      // step 3b: in case the geometry of general cells is computed on the
+      // fly, keep the mapping support points of those cells in vectorized
+      // format and the interpolation matrices to the quadrature points. Cell
+      // batches that are translations of a previous batch have the same
+      // Jacobians and can share the support points.
+      cell_support_point_offsets.clear();
+      cell_support_points.clear();
+      mapping_shape_info.clear();
+      if (geometry_on_the_fly)
+        {
+          FE_DGQ<dim> fe_geometry(mapping_degree);
+          mapping_shape_info.resize(cell_data.size());
+          for (unsigned int my_q = 0; my_q < cell_data.size(); ++my_q)
+            mapping_shape_info[my_q].reinit(
+              cell_data[my_q].descriptor[0].quadrature, fe_geometry);
+
+          cell_support_point_offsets.resize(cell_type.size(),
+                                            numbers::invalid_unsigned_int);
+          unsigned int n_general_batches = 0;
+          for (unsigned int cell = 0; cell < cell_type.size(); ++cell)
+            if (cell_type[cell] > affine)
+              {
+                if (process_cell[cell])
+                  cell_support_point_offsets[cell] =
+                    (n_general_batches++) * dim * n_mapping_points;
+                else
+                  cell_support_point_offsets[cell] =
+                    cell_support_point_offsets[cell_data_index_vect[cell]];
+              }
+
+          cell_support_points.resize_fast(n_general_batches * dim *
+                                          n_mapping_points);
+          for (unsigned int cell = 0; cell < cell_type.size(); ++cell)
+            if (cell_type[cell] > affine && process_cell[cell])
+              {
+                VectorizedArrayType *support_points =
+                  cell_support_points.data() + cell_support_point_offsets[cell];
+                for (unsigned int v = 0; v < n_lanes; ++v)
+                  for (unsigned int i = 0; i < dim * n_mapping_points; ++i)
+                    support_points[i][v] =
+                      plain_quadrature_points[(cell * n_lanes + v) * dim *
+                                                n_mapping_points +
+                                              i];
+              }
+        }
+
       // step 4: compute the data on cells from the cached quadrature
       // points, filling up all SIMD lanes as appropriate
       for (unsigned int my_q = 0; my_q < cell_data.size(); ++my_q)
@@ -2752,10 +2941,11 @@ namespace internal
                   my_data.data_index_offsets[cell_data_index_vect[cell]];
               else
                 my_data.data_index_offsets[cell] = max_size;
-              max_size =
-                std::max(max_size,
-                         my_data.data_index_offsets[cell] +
-                           (cell_type[cell] <= affine ? 2 : n_q_points));
+              max_size = std::max(max_size,
+                                  my_data.data_index_offsets[cell] +
+                                    (cell_type[cell] <= affine ? 2 :
+                                     geometry_on_the_fly       ? 0 :
+                                                                 n_q_points));
             }
 
           my_data.JxW_values.resize_fast(max_size);
@@ -2796,6 +2986,8 @@ namespace internal
                 cell_type,
                 process_cell,
                 update_flags_cells,
+                geometry_on_the_fly,
+                affine_jacobian_tolerance,
                 plain_quadrature_points,
                 shape_infos[my_q],
                 my_data);
@@ -3323,12 +3515,113 @@ namespace internal
       memory += face_type.capacity() * sizeof(GeometryType);
       memory += faces_by_cells_type.capacity() *
                 GeometryInfo<dim>::faces_per_cell * sizeof(GeometryType);
+      memory +=
+        MemoryConsumption::memory_consumption(cell_support_point_offsets);
+      memory += MemoryConsumption::memory_consumption(cell_support_points);
+      memory += MemoryConsumption::memory_consumption(mapping_shape_info);
+      memory +=
+        MemoryConsumption::memory_consumption(single_precision_JxW_values);
+      memory +=
+        MemoryConsumption::memory_consumption(single_precision_jacobians);
       memory += sizeof(*this);
       return memory;
     }
 
 
 
+    template <int dim, typename Number, typename VectorizedArrayType>
+    void
+    MappingInfo<dim, Number, VectorizedArrayType>::
+      compute_cell_geometry_on_the_fly(
+        const unsigned int                                 cell_chunk_no,
+        const unsigned int                                 quad_no,
+        MappingInfoStorage<dim, dim, VectorizedArrayType> &data,
+        AlignedVector<VectorizedArrayType>                &scratch_data) const
+    {
+      Assert(geometry_on_the_fly, ExcNotInitialized());
+      AssertIndexRange(cell_chunk_no, cell_support_point_offsets.size());
+      AssertIndexRange(quad_no, mapping_shape_info.size());
+      Assert(cell_support_point_offsets[cell_chunk_no] !=
+               numbers::invalid_unsigned_int,
+             ExcMessage("The geometry can only be computed on the fly for "
+                        "cells of type general."));
+
+      const ShapeInfo<VectorizedArrayType> &shape_info =
+        mapping_shape_info[quad_no];
+      const unsigned int n_q_points = shape_info.n_q_points;
+
+      // interpolate the gradients of the polynomial description of the
+      // geometry to the quadrature points with sum factorization
+      FEEvaluationData<dim, VectorizedArrayType, false> eval(shape_info);
+      eval.set_data_pointers(&scratch_data, dim);
+      FEEvaluationFactory<dim, VectorizedArrayType>::evaluate(
+        dim,
+        EvaluationFlags::gradients,
+        cell_support_points.data() + cell_support_point_offsets[cell_chunk_no],
+        eval);
+
+      if (data.JxW_values.size() != n_q_points)
+        {
+          data.JxW_values.resize_fast(n_q_points);
+          data.jacobians[0].resize_fast(n_q_points);
+        }
+
+      const auto &quadrature_weights =
+        cell_data[quad_no].descriptor[0].quadrature_weights;
+      const VectorizedArrayType *gradients = eval.begin_gradients();
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          Tensor<2, dim, VectorizedArrayType> jac;
+          for (unsigned int d = 0; d < dim; ++d)
+            for (unsigned int e = 0; e < dim; ++e)
+              jac[d][e] = gradients[e + (d * n_q_points + q) * dim];
+          data.JxW_values[q]   = determinant(jac) * quadrature_weights[q];
+          data.jacobians[0][q] = transpose(invert(jac));
+        }
+    }
+
+
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    void
+    MappingInfo<dim, Number, VectorizedArrayType>::convert_cell_data_to_float()
+    {
+      constexpr unsigned int n_lanes = VectorizedArrayType::size();
+
+      single_precision_JxW_values.resize(cell_data.size());
+      single_precision_jacobians.resize(cell_data.size());
+      for (unsigned int my_q = 0; my_q < cell_data.size(); ++my_q)
+        {
+          MappingInfoStorage<dim, dim, VectorizedArrayType> &my_data =
+            cell_data[my_q];
+          AssertDimension(my_data.JxW_values.size(),
+                          my_data.jacobians[0].size());
+
+          AlignedVector<float> &JxW_values = single_precision_JxW_values[my_q];
+          AlignedVector<float> &jacobians  = single_precision_jacobians[my_q];
+          JxW_values.resize_fast(my_data.JxW_values.size() * n_lanes);
+          jacobians.resize_fast(my_data.jacobians[0].size() * dim * dim *
+                                n_lanes);
+          for (unsigned int i = 0; i < my_data.JxW_values.size(); ++i)
+            {
+              for (unsigned int v = 0; v < n_lanes; ++v)
+                JxW_values[i * n_lanes + v] = my_data.JxW_values[i][v];
+              for (unsigned int d = 0; d < dim; ++d)
+                for (unsigned int e = 0; e < dim; ++e)
+                  for (unsigned int v = 0; v < n_lanes; ++v)
+                    jacobians[((i * dim + d) * dim + e) * n_lanes + v] =
+                      my_data.jacobians[0][i][d][e][v];
+            }
+
+          // release the memory of the data in the original precision, which
+          // is not accessed any more
+          my_data.JxW_values.clear();
+          my_data.jacobians[0].clear();
+        }
+    }
+
+
+
     template <int dim, typename Number, typename VectorizedArrayType>
     template <typename StreamType>
     void
@@ -3355,6 +3648,16 @@ namespace internal
         {
           out << "    Data component " << j << std::endl;
           cell_data[j].print_memory_consumption(out, task_info);
+          if (single_precision_cell_data)
+            {
+              out << "      Memory float JxW/Jacobians:    ";
+              task_info.print_memory_statistics(
+                out,
+                MemoryConsumption::memory_consumption(
+                  single_precision_JxW_values[j]) +
+                  MemoryConsumption::memory_consumption(
+                    single_precision_jacobians[j]));
+            }
           face_data[j].print_memory_consumption(out, task_info);
           face_data_by_cells[j].print_memory_consumption(out, task_info);
         }
@@ -213,7 +213,12 @@ public:
        * Use the traditional coloring algorithm: this is like
        * TasksParallelScheme::partition_color, but only uses one partition.
        */
-      color = internal::MatrixFreeFunctions::TaskInfo::color
+      color = internal::MatrixFreeFunctions::TaskInfo::color,
+      /**
+       * Keep the cell ordering of the serial case and let the threads claim
+       * chunks of cell batches at run time.
+       */
+      dynamic = internal::MatrixFreeFunctions::TaskInfo::dynamic
     };
 
     /**
@@ -250,6 +255,10 @@ public:
       , cell_vectorization_categories_strict(
           cell_vectorization_categories_strict)
       , allow_ghosted_vectors_in_loops(allow_ghosted_vectors_in_loops)
+      , affine_jacobian_tolerance(0.)
+      , compute_geometry_on_the_fly(false)
+      , store_mapping_data_in_float(false)
+      , tune_evaluation_kernels(false)
       , communicator_sm(MPI_COMM_SELF)
     {}
 
@@ -276,6 +285,11 @@ public:
       , cell_vectorization_categories_strict(
           other.cell_vectorization_categories_strict)
       , allow_ghosted_vectors_in_loops(other.allow_ghosted_vectors_in_loops)
+      , affine_jacobian_tolerance(other.affine_jacobian_tolerance)
+      , compute_geometry_on_the_fly(other.compute_geometry_on_the_fly)
+      , store_mapping_data_in_float(other.store_mapping_data_in_float)
+      , tune_evaluation_kernels(other.tune_evaluation_kernels)
+      , evaluation_kernel_cache_file(other.evaluation_kernel_cache_file)
       , communicator_sm(other.communicator_sm)
     {}
 
@@ -304,13 +318,18 @@ public:
       cell_vectorization_categories_strict =
         other.cell_vectorization_categories_strict;
       allow_ghosted_vectors_in_loops = other.allow_ghosted_vectors_in_loops;
+      affine_jacobian_tolerance      = other.affine_jacobian_tolerance;
+      compute_geometry_on_the_fly    = other.compute_geometry_on_the_fly;
+      store_mapping_data_in_float    = other.store_mapping_data_in_float;
+      tune_evaluation_kernels        = other.tune_evaluation_kernels;
+      evaluation_kernel_cache_file   = other.evaluation_kernel_cache_file;
       communicator_sm                = other.communicator_sm;
 
       return *this;
     }
 
     /**
-     * Set the scheme for task parallelism. There are four options available.
+     * Set the scheme for task parallelism. There are five options available.
      * If set to @p none, the operator application is done in serial without
      * shared memory parallelism. If this class is used together with MPI and
      * MPI is also used for parallelism within the nodes, this flag should be
@@ -337,6 +356,22 @@ public:
      * might degrade parallel performance (bad cache behavior, many
      * synchronization points).
      *
+     * The fourth option @p dynamic keeps the cell ordering and the
+     * subdivision into ranges of the serial case, including the overlap of
+     * the ghost exchange with the computations on cells not adjacent to
+     * other MPI processes. Within each range, the cell batches are grouped
+     * into chunks of tasks_block_size batches, and chunks are colored such
+     * that chunks of the same color do not access the same vector entries.
+     * The threads then claim the chunks of a color one at a time at run
+     * time, such that threads that finish early take over work of slower
+     * threads instead of waiting. Integrals over faces are done by the
+     * calling thread after the cell integrals of each range. As opposed to
+     * the other options, this scheme only relies on the task facilities of
+     * the Threads namespace and is also available if deal.II is configured
+     * with the oneAPI version of TBB. The time the threads spent working and
+     * waiting is accumulated and can be queried by
+     * `get_task_info().print_thread_load_statistics(std::cout)`.
+     *
      * @note Threading support is currently experimental for the case inner
      * face integrals are performed and it is recommended to use MPI
      * parallelism if possible. While the scheme has been verified to work
@@ -548,6 +583,107 @@ public:
      */
     bool allow_ghosted_vectors_in_loops;
 
+    /**
+     * Relative tolerance for detecting cells with a constant Jacobian. For
+     * such cells, MatrixFree only stores a single Jacobian and determinant
+     * per cell rather than one per quadrature point, which reduces the
+     * memory consumption and memory traffic of the geometry data by a factor
+     * of up to the number of quadrature points. By default (value zero),
+     * only cells whose Jacobian is constant up to roundoff are compressed.
+     *
+     * If set to a positive value, cells where the variation of the Jacobian
+     * over all quadrature points, measured relative to the Frobenius norm of
+     * the Jacobian in the first quadrature point, is below the given value
+     * are treated as affine, too. This "nearly affine" compression is
+     * useful for meshes that have been deformed only slightly, e.g. by a
+     * perturbation of the vertices or by a manifold with a large radius of
+     * curvature compared to the mesh size. On those cells, the stored
+     * Jacobian is the average of the Jacobians in the quadrature points
+     * weighted by the JxW values, scaled such that its determinant is the
+     * average Jacobian determinant, so that the volume of the cell is
+     * integrated exactly. Note that this still replaces the geometry on
+     * those cells by an affine approximation, i.e., other integrals computed
+     * with the compressed data differ from the ones with the exact geometry
+     * by an amount proportional to the given tolerance. Values in the range
+     * of the solver tolerance (e.g. 1e-8) are a reasonable choice.
+     */
+    double affine_jacobian_tolerance;
+
+    /**
+     * Option to control whether the inverse Jacobians and JxW values on
+     * cells with a general (curved) geometry should be computed on the fly
+     * in FEEvaluation::reinit() rather than being precomputed and stored for
+     * all quadrature points. In this mode, only the support points of the
+     * mapping are stored for each cell, i.e., $(p+1)^d$ points for a mapping
+     * of degree $p$, and the Jacobians are interpolated from them with the
+     * sum-factorization kernels of the matrix-free framework. This trades
+     * additional arithmetic operations in each cell evaluation for a
+     * considerably smaller memory footprint and memory transfer, which is
+     * most beneficial for high polynomial degrees on curved meshes where
+     * the stored geometry data otherwise exceeds the size of the vectors.
+     *
+     * This option is only supported for mappings of type MappingQ or derived
+     * classes (like MappingQCache) without hp-capabilities, and if neither
+     * update_jacobian_grads nor update_hessians are requested on cells;
+     * otherwise, the data is precomputed as usual. Data on Cartesian and
+     * affine cells as well as all data on faces is always precomputed.
+     * Furthermore, FEEvaluation::reinit() with an array of cell indices is
+     * not supported in this mode. The default is false.
+     *
+     * @note For MatrixFree objects with Number type `float`, the geometry
+     * is computed with single-precision arithmetic in this mode.
+     */
+    bool compute_geometry_on_the_fly;
+
+    /**
+     * Option to store the inverse Jacobians and JxW values on cells in
+     * single precision (`float`) while all arithmetic in FEEvaluation is
+     * still done in the number type of the MatrixFree object. The data of a
+     * cell batch is converted back in FEEvaluation::reinit() into the
+     * internal storage of the FEEvaluation object. On curved meshes with
+     * high polynomial degrees, where the geometry data is the dominant part
+     * of the memory transfer of the operator evaluation, this almost halves
+     * the transferred data for the geometry at the price of a relative
+     * accuracy of the geometry of around 1e-7, which is sufficient for
+     * preconditioners or for solvers that do not need to converge below
+     * that level.
+     *
+     * The Jacobian gradients, the quadrature points, and all data on faces
+     * are kept in the number type of the MatrixFree object.
+     * FEEvaluation::reinit() with an array of cell indices is not supported
+     * in this mode. This option has no effect for MatrixFree objects with
+     * Number type `float`. The default is false.
+     */
+    bool store_mapping_data_in_float;
+
+    /**
+     * Option to select the sum-factorization kernels for the evaluation and
+     * integration on cells by measuring their run time rather than by the
+     * built-in heuristic. For each combination of element and quadrature
+     * formula with symmetric shape functions, the candidate kernels (with
+     * transformation to a collocation basis, with the even-odd
+     * decomposition, and the general kernels) are run a few times during
+     * reinit() on the MPI rank zero, and the fastest is used by all ranks
+     * in FEEvaluation. This adds a setup cost in the order of 10
+     * milliseconds per element. The default is false.
+     */
+    bool tune_evaluation_kernels;
+
+    /**
+     * Name of a file that stores the kernels found by
+     * @p tune_evaluation_kernels, keyed by the CPU model, the dimension, the
+     * polynomial degree, the number of quadrature points, the number of
+     * components, the number type and the SIMD width. If the file contains
+     * an entry for the present setup, the kernel is taken from the file
+     * without measuring; new measurements are appended to the file without
+     * rewriting the existing entries, so several programs can share the
+     * same file. This way, repeated runs on the same machine type can start
+     * with the fastest kernels at no setup cost. The file is only accessed
+     * by MPI rank zero of the communicator of the first DoFHandler. If empty
+     * (the default), the measurements are not stored.
+     */
+    std::string evaluation_kernel_cache_file;
+
     /**
      * Shared-memory MPI communicator. Default: MPI_COMM_SELF.
      */
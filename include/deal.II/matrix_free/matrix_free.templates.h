@@ -40,6 +40,7 @@
 
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 
+#include <deal.II/matrix_free/cell_kernel_tuning.h>
 #include <deal.II/matrix_free/constraint_info.h>
 #include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/face_setup_internal.h>
@@ -424,6 +425,56 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
             for (unsigned int q_no = 0; q_no < quad[nq].size(); ++q_no)
               shape_info(c, nq, fe_no, q_no)
                 .reinit(quad[nq][q_no], dof_handler[no]->get_fe(fe_no), b);
+
+    // Select the sum-factorization kernels by measuring their run time. To
+    // make all MPI ranks use the same kernels and to avoid concurrent access
+    // to the cache file, only rank zero measures and accesses the file.
+    if (additional_data.tune_evaluation_kernels)
+      {
+        const MPI_Comm     comm = dof_handler[0]->get_communicator();
+        const unsigned int my_rank = Utilities::MPI::this_mpi_process(comm);
+        internal::MatrixFreeFunctions::CellKernelVariantCache cache(
+          my_rank == 0 ? additional_data.evaluation_kernel_cache_file : "");
+        for (unsigned int no = 0, c = 0; no < dof_handler.size(); ++no)
+          for (unsigned int b = 0;
+               b < dof_handler[no]->get_fe(0).n_base_elements();
+               ++b, ++c)
+            for (unsigned int fe_no = 0;
+                 fe_no < dof_handler[no]->get_fe_collection().size();
+                 ++fe_no)
+              for (unsigned int nq = 0; nq < n_quad; ++nq)
+                for (unsigned int q_no = 0; q_no < quad[nq].size(); ++q_no)
+                  {
+                    auto &info = shape_info(c, nq, fe_no, q_no);
+                    const unsigned int n_components =
+                      dof_handler[no]->get_fe(fe_no).element_multiplicity(b);
+                    internal::MatrixFreeFunctions::CellKernelVariant variant =
+                      internal::MatrixFreeFunctions::CellKernelVariant::
+                        heuristic;
+                    if (my_rank == 0 && info.data.size() == 1)
+                      {
+                        const std::string key =
+                          internal::MatrixFreeFunctions::
+                            cell_kernel_variant_key<dim>(info, n_components);
+                        if (cache.find(key, variant) == false)
+                          {
+                            variant = internal::MatrixFreeFunctions::
+                              tune_cell_kernel_variant<dim>(info,
+                                                            n_components);
+                            if (variant != internal::MatrixFreeFunctions::
+                                             CellKernelVariant::heuristic)
+                              cache.insert(key, variant);
+                          }
+                      }
+                    if (Utilities::MPI::n_mpi_processes(comm) > 1)
+                      variant = static_cast<
+                        internal::MatrixFreeFunctions::CellKernelVariant>(
+                        Utilities::MPI::broadcast(
+                          comm, static_cast<unsigned int>(variant), 0));
+                    info.cell_kernel_variant = variant;
+                  }
+        cache.write();
+      }
   }
 
   // Store pointers to AffineConstraints objects if Number type matches
@@ -469,11 +520,21 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
                      0;
         }
 
-        // initialize the basic multithreading information that needs to be
-        // passed to the DoFInfo structure
-#if defined(DEAL_II_WITH_TBB) && !defined(DEAL_II_TBB_WITH_ONEAPI)
-      if (additional_data.tasks_parallel_scheme != AdditionalData::none &&
+      // initialize the basic multithreading information that needs to be
+      // passed to the DoFInfo structure. The dynamic scheme only relies on
+      // the task facilities of the Threads namespace and is available for
+      // all threading backends.
+      if (additional_data.tasks_parallel_scheme == AdditionalData::dynamic &&
           MultithreadInfo::n_threads() > 1)
+        {
+          task_info.scheme = internal::MatrixFreeFunctions::TaskInfo::dynamic;
+          task_info.block_size = additional_data.tasks_block_size;
+        }
+      else
+#if defined(DEAL_II_WITH_TBB) && !defined(DEAL_II_TBB_WITH_ONEAPI)
+        if (additional_data.tasks_parallel_scheme != AdditionalData::none &&
+            additional_data.tasks_parallel_scheme != AdditionalData::dynamic &&
+            MultithreadInfo::n_threads() > 1)
         {
           task_info.scheme =
             internal::MatrixFreeFunctions::TaskInfo::TasksParallelScheme(
@@ -489,6 +550,10 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
       // (to separate cells with overlap to other processors from others
       // without).
       initialize_indices(constraints, locally_owned_dofs, additional_data);
+
+      // group the cell batches into chunks that can be worked on
+      // concurrently in case the dynamic scheme is selected
+      task_info.make_dynamic_schedule(dof_info);
     }
 
   // initialize bare structures
@@ -843,7 +908,10 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
         additional_data.mapping_update_flags_boundary_faces,
         additional_data.mapping_update_flags_inner_faces,
         additional_data.mapping_update_flags_faces_by_cells,
-        piola_transform);
+        piola_transform,
+        additional_data.affine_jacobian_tolerance,
+        additional_data.compute_geometry_on_the_fly,
+        additional_data.store_mapping_data_in_float);
 
       mapping_is_initialized = true;
     }
@@ -1497,6 +1565,7 @@ namespace internal
 
     Assert(
       task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::none ||
+        task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::dynamic ||
         cell_vectorization_category.empty(),
       ExcMessage(
         "You explicitly requested re-categorization of cells; however, this "
@@ -1504,7 +1573,9 @@ namespace internal
         "threading in MatrixFree by setting "
         "MatrixFree::Additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none."));
 
-    if (task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::none)
+    // the dynamic scheme works on the same cell ordering as the serial case
+    if (task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::none ||
+        task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::dynamic)
       {
         const bool strict_categories =
           cell_vectorization_categories_strict || hp_functionality_enabled;
@@ -1942,7 +2013,8 @@ MatrixFree<dim, Number, VectorizedArrayType>::initialize_indices(
 
       std::vector<bool> hard_vectorization_boundary(
         task_info.face_partition_data.size(), false);
-      if (task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::none)
+      if (task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::none ||
+          task_info.scheme == internal::MatrixFreeFunctions::TaskInfo::dynamic)
         {
           // In case we do an MPI data exchange, we must make sure to first
           // complete all face integrals with results in the ghost range
@@ -2371,6 +2443,27 @@ MatrixFree<dim, Number, VectorizedArrayType>::print_memory_consumption(
       task_info.print_memory_statistics(
         out, MemoryConsumption::memory_consumption(task_info));
     }
+
+  // report the memory per degree of freedom of the first DoFHandler, which
+  // is the relevant metric for the memory traffic of the operator
+  // evaluation, both for the whole data structure and the geometry data
+  const types::global_dof_index n_dofs =
+    dof_info.empty() || dof_info[0].vector_partitioner.get() == nullptr ?
+      0 :
+      dof_info[0].vector_partitioner->size();
+  if (n_dofs > 0)
+    {
+      const double memory_total =
+        Utilities::MPI::sum(static_cast<double>(memory_consumption()),
+                            task_info.communicator);
+      const double memory_mapping = Utilities::MPI::sum(
+        static_cast<double>(mapping_info.memory_consumption()),
+        task_info.communicator);
+      out << "   Memory per DoF total / mapping:   "
+          << memory_total / static_cast<double>(n_dofs) << " / "
+          << memory_mapping / static_cast<double>(n_dofs) << " bytes"
+          << std::endl;
+    }
 }
 
 
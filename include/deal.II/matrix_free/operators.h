@@ -33,6 +33,8 @@
 
 #include <deal.II/multigrid/mg_constrained_dofs.h>
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
 DEAL_II_NAMESPACE_OPEN
@@ -312,6 +314,34 @@ namespace MatrixFreeOperators
     void
     vmult(VectorType &dst, const VectorType &src) const;
 
+    /**
+     * Matrix-vector multiplication that runs the two given functions on
+     * subranges of the locally owned entries of the vectors before and after
+     * the matrix-vector product touches them, respectively, as described in
+     * MatrixFree::cell_loop(). This allows vector updates, like the ones in
+     * the iteration of PreconditionChebyshev, to be performed while the
+     * entries are still in cache, rather than in separate sweeps through
+     * memory. PreconditionChebyshev and PreconditionRelaxation detect this
+     * function and select their fused implementations automatically.
+     *
+     * As opposed to the vmult() function above, @p dst is not set to zero by
+     * this function; @p operation_before_matrix_vector_product needs to do
+     * that on the range it is passed. The constrained entries (both from
+     * hanging nodes and edge constraints) are treated the same way as in the
+     * other function and are final once
+     * @p operation_after_matrix_vector_product is called on them.
+     *
+     * @note This function is only supported for operators with a single
+     * block.
+     */
+    void
+    vmult(VectorType       &dst,
+          const VectorType &src,
+          const std::function<void(const unsigned int, const unsigned int)>
+            &operation_before_matrix_vector_product,
+          const std::function<void(const unsigned int, const unsigned int)>
+            &operation_after_matrix_vector_product) const;
+
     /**
      * Transpose matrix-vector multiplication.
      */
@@ -429,6 +459,27 @@ namespace MatrixFreeOperators
     virtual void
     Tapply_add(VectorType &dst, const VectorType &src) const;
 
+    /**
+     * Apply operator to @p src and add result in @p dst, running the two
+     * given functions on subranges of the locally owned entries before and
+     * after the cell loop accesses them, respectively, see
+     * MatrixFree::cell_loop().
+     *
+     * The default implementation runs @p operation_before_matrix_vector_product
+     * on the whole locally owned range, calls apply_add(), and then runs
+     * @p operation_after_matrix_vector_product on the whole range. Derived
+     * classes that implement apply_add() by a MatrixFree::cell_loop() should
+     * override this function and pass the two functions on to the cell loop.
+     */
+    virtual void
+    apply_add_with_operations(
+      VectorType       &dst,
+      const VectorType &src,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_before_matrix_vector_product,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_after_matrix_vector_product) const;
+
     /**
      * MatrixFree object to be used with this operator.
      */
@@ -825,6 +876,19 @@ namespace MatrixFreeOperators
     virtual void
     apply_add(VectorType &dst, const VectorType &src) const override;
 
+    /**
+     * Same as apply_add(), but passing the two functions on to the
+     * MatrixFree::cell_loop().
+     */
+    virtual void
+    apply_add_with_operations(
+      VectorType       &dst,
+      const VectorType &src,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_before_matrix_vector_product,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_after_matrix_vector_product) const override;
+
     /**
      * For this operator, there is just a cell contribution.
      */
@@ -975,6 +1039,19 @@ namespace MatrixFreeOperators
     virtual void
     apply_add(VectorType &dst, const VectorType &src) const override;
 
+    /**
+     * Same as apply_add(), but passing the two functions on to the
+     * MatrixFree::cell_loop().
+     */
+    virtual void
+    apply_add_with_operations(
+      VectorType       &dst,
+      const VectorType &src,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_before_matrix_vector_product,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_after_matrix_vector_product) const override;
+
     /**
      * Applies the Laplace operator on a cell.
      */
@@ -1471,6 +1548,88 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, typename VectorType, typename VectorizedArrayType>
+  void
+  Base<dim, VectorType, VectorizedArrayType>::vmult(
+    VectorType       &dst,
+    const VectorType &src,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &operation_before_matrix_vector_product,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &operation_after_matrix_vector_product) const
+  {
+    using Number =
+      typename Base<dim, VectorType, VectorizedArrayType>::value_type;
+    AssertDimension(dst.size(), src.size());
+    AssertDimension(BlockHelper::n_blocks(dst), 1);
+    AssertDimension(BlockHelper::n_blocks(src), 1);
+    AssertDimension(selected_rows.size(), 1);
+    adjust_ghost_range_if_necessary(src, false);
+    adjust_ghost_range_if_necessary(dst, true);
+
+    auto &dst_block = BlockHelper::subblock(dst, 0);
+    auto &src_block = BlockHelper::subblock(const_cast<VectorType &>(src), 0);
+    const std::vector<unsigned int> &constrained_dofs =
+      data->get_constrained_dofs(selected_rows[0]);
+    const std::vector<unsigned int> &edge_indices =
+      edge_constrained_indices[0];
+    std::vector<std::pair<Number, Number>> &edge_values =
+      edge_constrained_values[0];
+    Assert(std::is_sorted(constrained_dofs.begin(), constrained_dofs.end()),
+           ExcInternalError());
+    Assert(std::is_sorted(edge_indices.begin(), edge_indices.end()),
+           ExcInternalError());
+
+    // the ranges passed by the cell loop are disjoint, so the two functions
+    // below work on separate entries of the vectors also when called
+    // concurrently
+    apply_add_with_operations(
+      dst,
+      src,
+      [&](const unsigned int begin, const unsigned int end) {
+        if (operation_before_matrix_vector_product)
+          operation_before_matrix_vector_product(begin, end);
+
+        // set zero Dirichlet values on the input vector and remember the
+        // values to reset them after the operator has been applied
+        for (unsigned int i = std::lower_bound(edge_indices.begin(),
+                                               edge_indices.end(),
+                                               begin) -
+                              edge_indices.begin();
+             i < edge_indices.size() && edge_indices[i] < end;
+             ++i)
+          {
+            edge_values[i].first = src_block.local_element(edge_indices[i]);
+            src_block.local_element(edge_indices[i]) = 0.;
+          }
+      },
+      [&](const unsigned int begin, const unsigned int end) {
+        for (auto it = std::lower_bound(constrained_dofs.begin(),
+                                        constrained_dofs.end(),
+                                        begin);
+             it != constrained_dofs.end() && *it < end;
+             ++it)
+          dst_block.local_element(*it) += src_block.local_element(*it);
+
+        // reset edge constrained values and multiply by unit matrix
+        for (unsigned int i = std::lower_bound(edge_indices.begin(),
+                                               edge_indices.end(),
+                                               begin) -
+                              edge_indices.begin();
+             i < edge_indices.size() && edge_indices[i] < end;
+             ++i)
+          {
+            src_block.local_element(edge_indices[i]) = edge_values[i].first;
+            dst_block.local_element(edge_indices[i]) = edge_values[i].first;
+          }
+
+        if (operation_after_matrix_vector_product)
+          operation_after_matrix_vector_product(begin, end);
+      });
+  }
+
+
+
   template <int dim, typename VectorType, typename VectorizedArrayType>
   void
   Base<dim, VectorType, VectorizedArrayType>::vmult_add(
@@ -1786,6 +1945,27 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, typename VectorType, typename VectorizedArrayType>
+  void
+  Base<dim, VectorType, VectorizedArrayType>::apply_add_with_operations(
+    VectorType       &dst,
+    const VectorType &src,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &operation_before_matrix_vector_product,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &operation_after_matrix_vector_product) const
+  {
+    const unsigned int locally_owned_size =
+      BlockHelper::subblock(dst, 0).locally_owned_size();
+    if (operation_before_matrix_vector_product)
+      operation_before_matrix_vector_product(0, locally_owned_size);
+    apply_add(dst, src);
+    if (operation_after_matrix_vector_product)
+      operation_after_matrix_vector_product(0, locally_owned_size);
+  }
+
+
+
   template <int dim, typename VectorType, typename VectorizedArrayType>
   void
   Base<dim, VectorType, VectorizedArrayType>::precondition_Jacobi(
@@ -2113,6 +2293,39 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename VectorType,
+            typename VectorizedArrayType>
+  void
+  MassOperator<dim,
+               fe_degree,
+               n_q_points_1d,
+               n_components,
+               VectorType,
+               VectorizedArrayType>::
+    apply_add_with_operations(
+      VectorType       &dst,
+      const VectorType &src,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_before_matrix_vector_product,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_after_matrix_vector_product) const
+  {
+    Base<dim, VectorType, VectorizedArrayType>::data->cell_loop(
+      &MassOperator::local_apply_cell,
+      this,
+      dst,
+      src,
+      operation_before_matrix_vector_product,
+      operation_after_matrix_vector_product,
+      this->selected_rows[0]);
+  }
+
+
+
   template <int dim,
             int fe_degree,
             int n_q_points_1d,
@@ -2306,6 +2519,39 @@ namespace MatrixFreeOperators
       &LaplaceOperator::local_apply_cell, this, dst, src);
   }
 
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename VectorType,
+            typename VectorizedArrayType>
+  void
+  LaplaceOperator<dim,
+                  fe_degree,
+                  n_q_points_1d,
+                  n_components,
+                  VectorType,
+                  VectorizedArrayType>::
+    apply_add_with_operations(
+      VectorType       &dst,
+      const VectorType &src,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_before_matrix_vector_product,
+      const std::function<void(const unsigned int, const unsigned int)>
+        &operation_after_matrix_vector_product) const
+  {
+    Base<dim, VectorType, VectorizedArrayType>::data->cell_loop(
+      &LaplaceOperator::local_apply_cell,
+      this,
+      dst,
+      src,
+      operation_before_matrix_vector_product,
+      operation_after_matrix_vector_product,
+      this->selected_rows[0]);
+  }
+
   namespace Implementation
   {
     template <typename VectorizedArrayType>
@@ -122,6 +122,46 @@ namespace internal
 
 
 
+    /**
+     * An enum that selects the sum-factorization kernels for the evaluation
+     * and integration on cells with elements of type
+     * ElementType::tensor_symmetric, ElementType::tensor_symmetric_hermite,
+     * or ElementType::tensor_symmetric_no_collocation. All variants give the
+     * same result up to roundoff, but differ in their performance depending
+     * on the polynomial degree, the number of quadrature points, the number
+     * type and the hardware.
+     *
+     * @ingroup matrixfree
+     */
+    enum class CellKernelVariant : unsigned char
+    {
+      /**
+       * Select the kernels by a heuristic based on the element type and the
+       * number of quadrature points.
+       */
+      heuristic = 0,
+
+      /**
+       * Transform the values to a collocation basis in the quadrature points
+       * and compute the gradients there, if supported by the element.
+       */
+      transform_to_collocation = 1,
+
+      /**
+       * Use the even-odd decomposition of the one-dimensional shape
+       * function matrices for values and gradients.
+       */
+      even_odd = 2,
+
+      /**
+       * Use the kernels for general tensor-product elements without
+       * exploiting the symmetry of the shape functions.
+       */
+      general = 3
+    };
+
+
+
     /**
      * This struct stores the shape functions, their gradients and Hessians
      * evaluated for a one-dimensional section of a tensor product finite
@@ -400,6 +440,15 @@ namespace internal
        */
       ElementType element_type;
 
+      /**
+       * The variant of the sum-factorization kernels used on cells. The
+       * default CellKernelVariant::heuristic lets FEEvaluation choose based
+       * on the element type, other values can be set by the kernel
+       * autotuning of MatrixFree, see
+       * MatrixFree::AdditionalData::tune_evaluation_kernels.
+       */
+      CellKernelVariant cell_kernel_variant;
+
       /**
        * Empty constructor. Does nothing.
        */
@@ -23,6 +23,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi_stub.h>
+#include <deal.II/base/mutex.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/vectorization.h>
 
@@ -99,6 +100,9 @@ namespace internal
 
   namespace MatrixFreeFunctions
   {
+    // forward declaration
+    struct DoFInfo;
+
     /**
      * A struct that collects all information related to parallelization with
      * threads: The work is subdivided into tasks that can be done
@@ -109,13 +113,16 @@ namespace internal
       // enum for choice of how to build the task graph. Odd add versions with
       // preblocking and even versions with postblocking. partition_partition
       // and partition_color are deprecated but kept for backward
-      // compatibility.
+      // compatibility. The scheme dynamic uses the same cell ordering as the
+      // serial case and distributes chunks of cell batches among the threads
+      // at run time.
       enum TasksParallelScheme
       {
         none,
         partition_partition,
         partition_color,
-        color
+        color,
+        dynamic
       };
 
       /**
@@ -136,6 +143,49 @@ namespace internal
       void
       loop(MFWorkerInterface &worker) const;
 
+      /**
+       * Runs the cell work of the range @p range_index of the serial
+       * partitioning for the TasksParallelScheme::dynamic scheme: The chunks
+       * of cell batches of each color are claimed by the threads one after
+       * another from a shared counter, such that threads that finish early
+       * take over the remaining work of the others. The colors are processed
+       * one after another.
+       */
+      void
+      dynamic_cell_loop(MFWorkerInterface &worker,
+                        const unsigned int range_index) const;
+
+      /**
+       * Sets up the chunks of cell batches for the TasksParallelScheme::dynamic
+       * scheme. Each range of the serial partitioning in
+       * @p cell_partition_data is split into chunks of @p block_size cell
+       * batches (or a guess based on the number of threads, if zero), and
+       * the chunks are colored such that chunks of the same color do not
+       * write into the same vector entries according to the indices stored
+       * in @p dof_info.
+       */
+      void
+      make_dynamic_schedule(const std::vector<DoFInfo> &dof_info);
+
+      /**
+       * Prints the time the threads spent in the cell work of loops with the
+       * TasksParallelScheme::dynamic scheme, and the time they were idle
+       * waiting for other threads to finish a color, accumulated since the
+       * setup or the last call to reset_thread_load_statistics(). Loops that
+       * run concurrently on the same object all add to the same statistics,
+       * so the idle times are only meaningful for loops run one after
+       * another.
+       */
+      template <typename StreamType>
+      void
+      print_thread_load_statistics(StreamType &out) const;
+
+      /**
+       * Resets the statistics printed by print_thread_load_statistics().
+       */
+      void
+      reset_thread_load_statistics() const;
+
       /**
        * Make the number of cells which can only be treated in the
        * communication overlap divisible by the vectorization length.
@@ -599,6 +649,43 @@ namespace internal
        */
       unsigned int n_workers;
 
+      /**
+       * Ranges of cell batches handed to a thread at once in the
+       * TasksParallelScheme::dynamic scheme, sorted by the range index of the
+       * serial partitioning and by colors within each range.
+       */
+      std::vector<std::pair<unsigned int, unsigned int>> dynamic_chunks;
+
+      /**
+       * Index of the first chunk in @p dynamic_chunks of each color.
+       */
+      std::vector<unsigned int> dynamic_color_ptr;
+
+      /**
+       * Index of the first color in @p dynamic_color_ptr for each range in
+       * @p cell_partition_data.
+       */
+      std::vector<unsigned int> dynamic_range_ptr;
+
+      /**
+       * Accumulated time in seconds each thread spent working on chunks in
+       * the TasksParallelScheme::dynamic scheme.
+       */
+      mutable std::vector<double> dynamic_thread_busy_time;
+
+      /**
+       * Accumulated wall time in seconds of all colors processed in the
+       * TasksParallelScheme::dynamic scheme, i.e., the sum of busy and idle
+       * time of each thread.
+       */
+      mutable double dynamic_wall_time;
+
+      /**
+       * Mutex to protect the two statistics fields above, which are updated
+       * at the end of each call to dynamic_cell_loop().
+       */
+      mutable Threads::Mutex dynamic_statistics_mutex;
+
       /**
        * Stores whether a particular task is at an MPI boundary and needs data
        * exchange
@@ -20,6 +20,7 @@
 
 #include <deal.II/grid/tria.h>
 
+#include <deal.II/matrix_free/evaluation_template_factory.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/vector_access_internal.h>
@@ -156,6 +157,96 @@ namespace MatrixFreeTools
     const unsigned int quad_no                  = 0,
     const unsigned int first_selected_component = 0);
 
+  /**
+   * Compute the matrix representation of a linear operator (@p matrix), given
+   * @p matrix_free and the operation @p quadrature_operation that the
+   * operator performs on the quadrature points of a cell, i.e., the part of
+   * the cell integral between the calls to FEEvaluation::evaluate() with
+   * @p evaluation_flags and FEEvaluation::integrate() with
+   * @p integration_flags. Constrained entries on the diagonal are set to one.
+   *
+   * As opposed to the function above, which applies the complete cell
+   * operation to each unit vector of a cell in turn, this function evaluates
+   * the unit vectors on the reference cell only once, as this step is
+   * independent of the cell, and tests the data submitted for all columns
+   * of the cell matrix with a single call to the sum-factorization kernels.
+   * Furthermore, the cell matrices of cells without constrained degrees of
+   * freedom are added to @p matrix directly without going through
+   * AffineConstraints::distribute_local_to_global(). This makes the
+   * computation of the matrix considerably faster for higher polynomial
+   * degrees.
+   *
+   * @note The constraints are not resolved in a vectorized way across the
+   *   cells of a batch: the cell matrix of each cell with at least one
+   *   constrained degree of freedom is passed to
+   *   AffineConstraints::distribute_local_to_global() on its own. The reason
+   *   is that @p constraints may contain arbitrary, possibly inhomogeneous
+   *   or chained constraints that are not known to @p matrix_free, whose
+   *   constraint pool and hanging-node treatment only describe the
+   *   constraints given to MatrixFree::reinit(). On meshes with many hanging
+   *   nodes, the speedup of this function over the one above is therefore
+   *   smaller.
+   *
+   * The parameters @p dof_no, @p quad_no, and @p first_selected_component are
+   * passed to the constructor of the FEEvaluation that is internally set up.
+   *
+   * @note Raviart-Thomas elements are not supported by this function.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number>                    &constraints,
+    MatrixType                                         &matrix,
+    const EvaluationFlags::EvaluationFlags              evaluation_flags,
+    const EvaluationFlags::EvaluationFlags              integration_flags,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+                      &quadrature_operation,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Same as above but with a class and a function pointer.
+   */
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number>                    &constraints,
+    MatrixType                                         &matrix,
+    const EvaluationFlags::EvaluationFlags              evaluation_flags,
+    const EvaluationFlags::EvaluationFlags              integration_flags,
+    void (CLASS::*quadrature_operation)(FEEvaluation<dim,
+                                                     fe_degree,
+                                                     n_q_points_1d,
+                                                     n_components,
+                                                     Number,
+                                                     VectorizedArrayType> &)
+      const,
+    const CLASS       *owning_class,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
 
 
   /**
@@ -1305,6 +1396,286 @@ namespace MatrixFreeTools
       first_selected_component);
   }
 
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number>                    &constraints_in,
+    MatrixType                                         &matrix,
+    const EvaluationFlags::EvaluationFlags              evaluation_flags,
+    const EvaluationFlags::EvaluationFlags              integration_flags,
+    const std::function<void(FEEvaluation<dim,
+                                          fe_degree,
+                                          n_q_points_1d,
+                                          n_components,
+                                          Number,
+                                          VectorizedArrayType> &)>
+                      &quadrature_operation,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    std::unique_ptr<AffineConstraints<typename MatrixType::value_type>>
+      constraints_for_matrix;
+    const AffineConstraints<typename MatrixType::value_type> &constraints =
+      internal::create_new_affine_constraints_if_needed(matrix,
+                                                        constraints_in,
+                                                        constraints_for_matrix);
+
+    matrix_free.template cell_loop<MatrixType, MatrixType>(
+      [&](const auto &, auto &dst, const auto &, const auto range) {
+        FEEvaluation<dim,
+                     fe_degree,
+                     n_q_points_1d,
+                     n_components,
+                     Number,
+                     VectorizedArrayType>
+          integrator(
+            matrix_free, range, dof_no, quad_no, first_selected_component);
+
+        const unsigned int dofs_per_cell = integrator.dofs_per_cell;
+        const unsigned int n_q_points    = integrator.n_q_points;
+
+        const auto &shape_info =
+          matrix_free.get_shape_info(dof_no,
+                                     quad_no,
+                                     first_selected_component,
+                                     integrator.get_active_fe_index(),
+                                     integrator.get_active_quadrature_index());
+        Assert(shape_info.element_type !=
+                 dealii::internal::MatrixFreeFunctions::tensor_raviart_thomas,
+               ExcNotImplemented());
+
+        // The unit vectors of all columns of the cell matrix are treated as
+        // the components of a single evaluator, such that the
+        // sum-factorization kernels work on all of them in one call. Since
+        // FEEvaluation keeps the derivatives in the quadrature points in
+        // reference coordinates, the evaluated unit vectors are the same on
+        // all cells and are computed once here. On general cells, Hessians
+        // also need the gradients.
+        const unsigned int n_column_components = dofs_per_cell * n_components;
+        AlignedVector<VectorizedArrayType>                 columns_data;
+        FEEvaluationData<dim, VectorizedArrayType, false> columns(shape_info);
+        columns.set_data_pointers(&columns_data, n_column_components);
+
+        EvaluationFlags::EvaluationFlags unit_flags = evaluation_flags;
+        if (evaluation_flags & EvaluationFlags::hessians)
+          unit_flags |= EvaluationFlags::gradients;
+
+        AlignedVector<VectorizedArrayType> column_dofs(dofs_per_cell *
+                                                       dofs_per_cell);
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          column_dofs[j * dofs_per_cell + j] = Number(1.);
+        if (unit_flags != EvaluationFlags::nothing)
+          dealii::internal::FEEvaluationFactory<dim, VectorizedArrayType>::
+            evaluate(n_column_components,
+                     unit_flags,
+                     column_dofs.data(),
+                     columns);
+
+        const unsigned int n_values    = n_components * n_q_points;
+        const unsigned int n_gradients = n_values * dim;
+        const unsigned int n_hessians  = n_values * (dim * (dim + 1) / 2);
+
+        AlignedVector<VectorizedArrayType> unit_values, unit_gradients,
+          unit_hessians;
+        if (unit_flags & EvaluationFlags::values)
+          {
+            unit_values.resize_fast(dofs_per_cell * n_values);
+            std::copy_n(columns.begin_values(),
+                        unit_values.size(),
+                        unit_values.begin());
+          }
+        if (unit_flags & EvaluationFlags::gradients)
+          {
+            unit_gradients.resize_fast(dofs_per_cell * n_gradients);
+            std::copy_n(columns.begin_gradients(),
+                        unit_gradients.size(),
+                        unit_gradients.begin());
+          }
+        if (unit_flags & EvaluationFlags::hessians)
+          {
+            unit_hessians.resize_fast(dofs_per_cell * n_hessians);
+            std::copy_n(columns.begin_hessians(),
+                        unit_hessians.size(),
+                        unit_hessians.begin());
+          }
+
+        // Integration of Hessians on general cells uses additional data
+        // internal to FEEvaluation, so test the columns one by one in that
+        // case
+        const bool integrate_batched =
+          (integration_flags & EvaluationFlags::hessians) == 0;
+
+        std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+        std::vector<types::global_dof_index> dof_indices_mf(dofs_per_cell);
+
+        std::array<FullMatrix<typename MatrixType::value_type>,
+                   VectorizedArrayType::size()>
+          matrices;
+
+        std::fill_n(matrices.begin(),
+                    VectorizedArrayType::size(),
+                    FullMatrix<typename MatrixType::value_type>(dofs_per_cell,
+                                                                dofs_per_cell));
+
+        const auto &lexicographic_numbering =
+          shape_info.lexicographic_numbering;
+
+        for (auto cell = range.first; cell < range.second; ++cell)
+          {
+            integrator.reinit(cell);
+
+#  ifdef DEBUG
+            // mark the quadrature data as initialized, it is overwritten
+            // below
+            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+              integrator.begin_dof_values()[i] = Number();
+            integrator.evaluate(unit_flags);
+#  endif
+
+            const unsigned int n_filled_lanes =
+              matrix_free.n_active_entries_per_cell_batch(cell);
+
+            for (unsigned int j = 0; j < dofs_per_cell; ++j)
+              {
+                if (unit_flags & EvaluationFlags::values)
+                  std::copy_n(unit_values.begin() + j * n_values,
+                              n_values,
+                              integrator.begin_values());
+                if (unit_flags & EvaluationFlags::gradients)
+                  std::copy_n(unit_gradients.begin() + j * n_gradients,
+                              n_gradients,
+                              integrator.begin_gradients());
+                if (unit_flags & EvaluationFlags::hessians)
+                  std::copy_n(unit_hessians.begin() + j * n_hessians,
+                              n_hessians,
+                              integrator.begin_hessians());
+
+                quadrature_operation(integrator);
+
+                if (integrate_batched)
+                  {
+                    if (integration_flags & EvaluationFlags::values)
+                      std::copy_n(integrator.begin_values(),
+                                  n_values,
+                                  columns.begin_values() + j * n_values);
+                    if (integration_flags & EvaluationFlags::gradients)
+                      std::copy_n(integrator.begin_gradients(),
+                                  n_gradients,
+                                  columns.begin_gradients() + j * n_gradients);
+                  }
+                else
+                  {
+                    integrator.integrate(integration_flags);
+                    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                      column_dofs[j * dofs_per_cell + i] =
+                        integrator.begin_dof_values()[i];
+                  }
+              }
+
+            if (integrate_batched)
+              dealii::internal::FEEvaluationFactory<dim, VectorizedArrayType>::
+                integrate(n_column_components,
+                          integration_flags,
+                          column_dofs.data(),
+                          columns,
+                          false);
+
+            for (unsigned int v = 0; v < n_filled_lanes; ++v)
+              for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                  matrices[v](i, j) = column_dofs[j * dofs_per_cell + i][v];
+
+            for (unsigned int v = 0; v < n_filled_lanes; ++v)
+              {
+                const auto cell_v =
+                  matrix_free.get_cell_iterator(cell, v, dof_no);
+
+                if (matrix_free.get_mg_level() != numbers::invalid_unsigned_int)
+                  cell_v->get_mg_dof_indices(dof_indices);
+                else
+                  cell_v->get_dof_indices(dof_indices);
+
+                bool has_constraints = false;
+                for (unsigned int j = 0; j < dof_indices.size(); ++j)
+                  {
+                    dof_indices_mf[j] = dof_indices[lexicographic_numbering[j]];
+                    has_constraints |=
+                      constraints.is_constrained(dof_indices_mf[j]);
+                  }
+
+                // without constraints, the resolution in
+                // AffineConstraints::distribute_local_to_global() reduces to
+                // the addition of the cell matrix. The constraints are
+                // resolved lane by lane otherwise, as they need not coincide
+                // with the ones stored in matrix_free
+                if (has_constraints)
+                  constraints.distribute_local_to_global(matrices[v],
+                                                         dof_indices_mf,
+                                                         dst);
+                else
+                  dst.add(dof_indices_mf, matrices[v]);
+              }
+          }
+      },
+      matrix,
+      matrix);
+
+    matrix.compress(VectorOperation::add);
+  }
+
+  template <typename CLASS,
+            int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename MatrixType>
+  void
+  compute_matrix(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    const AffineConstraints<Number>                    &constraints,
+    MatrixType                                         &matrix,
+    const EvaluationFlags::EvaluationFlags              evaluation_flags,
+    const EvaluationFlags::EvaluationFlags              integration_flags,
+    void (CLASS::*quadrature_operation)(FEEvaluation<dim,
+                                                     fe_degree,
+                                                     n_q_points_1d,
+                                                     n_components,
+                                                     Number,
+                                                     VectorizedArrayType> &)
+      const,
+    const CLASS       *owning_class,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    compute_matrix<dim,
+                   fe_degree,
+                   n_q_points_1d,
+                   n_components,
+                   Number,
+                   VectorizedArrayType,
+                   MatrixType>(
+      matrix_free,
+      constraints,
+      matrix,
+      evaluation_flags,
+      integration_flags,
+      [&](auto &feeval) { (owning_class->*quadrature_operation)(feeval); },
+      dof_no,
+      quad_no,
+      first_selected_component);
+  }
+
 #endif // DOXYGEN
 
 } // namespace MatrixFreeTools
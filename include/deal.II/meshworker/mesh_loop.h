@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/work_stream.h>
@@ -34,6 +35,7 @@
 
 #include <functional>
 #include <type_traits>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -1062,6 +1064,120 @@ namespace MeshWorker
                                     queue_length,
                                     chunk_size);
   }
+
+  /**
+   * A variant of the mesh_loop() function for cell integrals that hands
+   * groups of up to @p batch_size cells to the cell worker at once, as
+   * needed by FEValuesBatch. The locally owned cells of @p iterator_range
+   * are split into consecutive batches, which are then processed in
+   * parallel by WorkStream::run(), with one call to the @p copier per
+   * batch. The CopyData object therefore needs to hold the local
+   * contributions of all cells of a batch. Faces are not visited.
+   *
+   * An example for the assembly of a matrix is given by
+   * @code
+   * using CellIteratorType = decltype(dof_handler.begin_active());
+   *
+   * struct ScratchData
+   * {
+   *   ScratchData(const FiniteElement<dim> &fe,
+   *               const Quadrature<dim>    &quadrature)
+   *     : fe_batch(fe, quadrature, update_gradients | update_JxW_values)
+   *   {}
+   *
+   *   FEValuesBatch<dim> fe_batch;
+   * };
+   *
+   * using CopyData =
+   *   std::array<MeshWorker::CopyData<1, 1, 1>,
+   *              FEValuesBatch<dim>::n_lanes>;
+   *
+   * auto cell_worker = [&](const ArrayView<const CellIteratorType> &cells,
+   *                        ScratchData                             &scratch,
+   *                        CopyData                                &copy) {
+   *   scratch.fe_batch.reinit(cells);
+   *   ...
+   * };
+   *
+   * MeshWorker::mesh_loop_batched(dof_handler.active_cell_iterators(),
+   *                               cell_worker, copier,
+   *                               ScratchData(fe, quadrature), CopyData(),
+   *                               FEValuesBatch<dim>::n_lanes);
+   * @endcode
+   *
+   * @ingroup MeshWorker
+   */
+  template <typename CellIteratorType,
+            class ScratchData,
+            class CopyData,
+            typename CellIteratorBaseType =
+              typename internal::CellIteratorBaseType<CellIteratorType>::type>
+  void
+  mesh_loop_batched(
+    IteratorRange<CellIteratorType> iterator_range,
+    const std_cxx20::type_identity_t<
+      std::function<void(const ArrayView<const CellIteratorBaseType> &,
+                         ScratchData &,
+                         CopyData &)>> &cell_worker,
+    const std_cxx20::type_identity_t<std::function<void(const CopyData &)>>
+      &copier,
+
+    const ScratchData &sample_scratch_data,
+    const CopyData    &sample_copy_data,
+
+    const unsigned int batch_size,
+    const unsigned int queue_length = 2 * MultithreadInfo::n_threads(),
+    const unsigned int chunk_size   = 8)
+  {
+    Assert(batch_size > 0, ExcMessage("The batch size must be positive."));
+
+    std::vector<CellIteratorBaseType> cells;
+    for (const auto &cell : iterator_range)
+      {
+        const bool ignore_subdomain =
+          (cell->get_triangulation().locally_owned_subdomain() ==
+           numbers::invalid_subdomain_id);
+
+        const types::subdomain_id current_subdomain_id =
+          (cell->is_level_cell() ? cell->level_subdomain_id() :
+                                   cell->subdomain_id());
+
+        if (ignore_subdomain ||
+            (current_subdomain_id ==
+             cell->get_triangulation().locally_owned_subdomain()))
+          cells.push_back(cell);
+      }
+
+    std::vector<unsigned int> batch_starts;
+    for (unsigned int start = 0; start < cells.size(); start += batch_size)
+      batch_starts.push_back(start);
+
+    auto batch_action =
+      [&](const std::vector<unsigned int>::const_iterator &batch_start,
+          ScratchData                                     &scratch,
+          CopyData                                        &copy) {
+        // First reset the CopyData class to the empty copy_data given by the
+        // user.
+        copy = sample_copy_data;
+
+        const unsigned int n_cells =
+          std::min<std::size_t>(batch_size, cells.size() - *batch_start);
+        cell_worker(ArrayView<const CellIteratorBaseType>(cells.data() +
+                                                            *batch_start,
+                                                          n_cells),
+                    scratch,
+                    copy);
+      };
+
+    WorkStream::run(batch_starts.cbegin(),
+                    batch_starts.cend(),
+                    batch_action,
+                    copier,
+                    sample_scratch_data,
+                    sample_copy_data,
+                    queue_length,
+                    chunk_size);
+  }
 } // namespace MeshWorker
 
 DEAL_II_NAMESPACE_CLOSE
@@ -22,6 +22,7 @@
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/householder.h>
 #include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/sparse_amg.h>
 
 #include <deal.II/multigrid/mg_base.h>
 
@@ -239,6 +240,63 @@ private:
   LAPACKFullMatrix<number> matrix;
 };
 
+/**
+ * Coarse grid solver using the algebraic multigrid method of the class
+ * SparseAMG on the sparse coarse-grid matrix. As opposed to the other
+ * classes of this file, it does not solve the coarse-grid problem exactly,
+ * but applies a given number of V-cycles of the algebraic multigrid method.
+ * This is meant for coarse meshes that are too large to be factorized or
+ * inverted efficiently, for example in geometric multigrid methods on
+ * complicated geometries whose coarse mesh already has many cells, and does
+ * not need any external library.
+ *
+ * Since the V-cycle is a symmetric operator, the multigrid method with this
+ * coarse-grid solver can be used as a preconditioner for the conjugate
+ * gradient method.
+ */
+template <typename number = double>
+class MGCoarseGridAMG : public MGCoarseGridBase<Vector<number>>
+{
+public:
+  /**
+   * Constructor leaving an uninitialized object.
+   */
+  MGCoarseGridAMG() = default;
+
+  /**
+   * Set up the algebraic multigrid hierarchy for the given coarse-grid
+   * matrix, which needs to remain alive and unchanged as long as this object
+   * is used. Every application of this object runs @p n_cycles V-cycles.
+   */
+  void
+  initialize(const SparseMatrix<number> &A,
+             const unsigned int          n_cycles = 1,
+             const typename SparseAMG<number>::AdditionalData &additional_data =
+               typename SparseAMG<number>::AdditionalData());
+
+  void
+  operator()(const unsigned int    level,
+             Vector<number>       &dst,
+             const Vector<number> &src) const override;
+
+  /**
+   * Return the underlying algebraic multigrid preconditioner.
+   */
+  const SparseAMG<number> &
+  get_amg() const;
+
+private:
+  /**
+   * The algebraic multigrid hierarchy.
+   */
+  SparseAMG<number> amg;
+
+  /**
+   * Number of V-cycles per application.
+   */
+  unsigned int n_cycles = 1;
+};
+
 /** @} */
 
 #ifndef DOXYGEN
@@ -501,6 +559,44 @@ MGCoarseGridSVD<number, VectorType>::log() const
 }
 
 
+
+/* ------------------ Functions for MGCoarseGridAMG -------------------- */
+
+template <typename number>
+void
+MGCoarseGridAMG<number>::initialize(
+  const SparseMatrix<number>                       &A,
+  const unsigned int                                n_cycles,
+  const typename SparseAMG<number>::AdditionalData &additional_data)
+{
+  Assert(n_cycles > 0, ExcMessage("At least one V-cycle is needed."));
+  this->n_cycles = n_cycles;
+  amg.initialize(A, additional_data);
+}
+
+
+
+template <typename number>
+void
+MGCoarseGridAMG<number>::operator()(const unsigned int /*level*/,
+                                    Vector<number>       &dst,
+                                    const Vector<number> &src) const
+{
+  amg.vmult(dst, src);
+  for (unsigned int cycle = 1; cycle < n_cycles; ++cycle)
+    amg.step(dst, src);
+}
+
+
+
+template <typename number>
+const SparseAMG<number> &
+MGCoarseGridAMG<number>::get_amg() const
+{
+  return amg;
+}
+
+
 #endif // DOXYGEN
 
 DEAL_II_NAMESPACE_CLOSE
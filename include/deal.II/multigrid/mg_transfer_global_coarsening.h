@@ -23,7 +23,10 @@
 #include <deal.II/dofs/dof_handler.h>
 
 #include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
 
 #include <deal.II/matrix_free/constraint_info.h>
 #include <deal.II/matrix_free/shape_info.h>
@@ -52,6 +55,9 @@ namespace RepartitioningPolicyTools
 
 template <int dim, typename Number>
 class MGTransferMF;
+
+template <int dim, typename VectorType>
+class MGTwoLevelTransferAgglomeration;
 #endif
 
 
@@ -204,6 +210,48 @@ namespace MGTransferGlobalCoarseningTools
     const RepartitioningPolicyTools::Base<dim, spacedim> &policy,
     const bool repartition_fine_triangulation = false);
 
+  /**
+   * Basis functions on the agglomerates of cells that form the coarse spaces
+   * of MGTwoLevelTransferAgglomeration.
+   */
+  enum class AgglomerationBasis
+  {
+    /**
+     * One constant function per agglomerate and vector component.
+     */
+    piecewise_constant,
+    /**
+     * One constant and @p dim linear functions per agglomerate and vector
+     * component.
+     */
+    piecewise_linear
+  };
+
+  /**
+   * Create a sequence of transfer operators of type
+   * MGTwoLevelTransferAgglomeration below the space described by
+   * @p dof_handler and @p constraints, i.e., below the coarse mesh of a
+   * geometric or polynomial coarsening sequence. Each operator agglomerates
+   * the agglomerates of the previous one, until the global number of
+   * unknowns on the coarsest space is at most @p max_coarse_size, no further
+   * agglomeration is possible, or @p max_levels spaces have been created.
+   *
+   * In the returned vector, the first entry is the transfer between the
+   * coarsest and the second coarsest space and the last entry is the transfer
+   * into the space of @p dof_handler, which matches the numbering of the
+   * levels of an MGLevelObject.
+   */
+  template <int dim, typename Number>
+  std::vector<std::shared_ptr<MGTwoLevelTransferAgglomeration<
+    dim,
+    LinearAlgebra::distributed::Vector<Number>>>>
+  create_agglomeration_sequence(
+    const DoFHandler<dim>           &dof_handler,
+    const AffineConstraints<Number> &constraints,
+    const AgglomerationBasis basis = AgglomerationBasis::piecewise_constant,
+    const types::global_dof_index max_coarse_size = 1000,
+    const unsigned int            max_levels      = 20);
+
 } // namespace MGTransferGlobalCoarseningTools
 
 
@@ -559,9 +607,13 @@ public:
    * Check if a fast templated version of the polynomial transfer between
    * @p fe_degree_fine and @p fe_degree_coarse is available.
    *
-   * @note Currently, the polynomial coarsening strategies: 1) go-to-one,
-   *   2) bisect, and 3) decrease-by-one are precompiled with templates for
-   *   degrees up to 9.
+   * @note Currently, the transfer between all pairs of polynomial degrees
+   *   up to 9 with @p fe_degree_coarse not larger than @p fe_degree_fine is
+   *   precompiled with templates. This includes the polynomial coarsening
+   *   strategies 1) go-to-one, 2) bisect, and 3) decrease-by-one, as well as
+   *   the transfer between arbitrary elements of an hp::FECollection on
+   *   hp-meshes, which is performed cell-batch-wise for all cells with the
+   *   same pair of degrees.
    */
   static bool
   fast_polynomial_transfer_supported(const unsigned int fe_degree_fine,
@@ -985,6 +1037,287 @@ private:
 
 
 
+/**
+ * Class for transfer between a space of finite element functions, or a space
+ * on agglomerates of cells, and a coarser space whose basis functions are
+ * constant or linear on agglomerates of cells.
+ *
+ * Global coarsening with MGTwoLevelTransfer ends at the coarse mesh, which
+ * for meshes created by external tools can still have many cells. This class
+ * allows to add further, algebraic levels below the coarse mesh: The cells
+ * of the mesh are clustered into agglomerates by a greedy aggregation on the
+ * graph of face neighbors as returned by
+ * GridTools::get_face_connectivity_of_cells(), and the coarse space consists
+ * of functions that are constant, or linear, on each agglomerate. These
+ * agglomerates can in turn be clustered again by a second object of this
+ * class, using the graph of neighboring agglomerates, and so on. The
+ * resulting objects can be used in an MGLevelObject together with other
+ * transfer operators, e.g., of type MGTwoLevelTransfer, and passed to
+ * MGTransferGlobalCoarsening. The function
+ * MGTransferGlobalCoarseningTools::create_agglomeration_sequence() sets up a
+ * complete sequence of such operators.
+ *
+ * Each value of a finite element function associated with a support point
+ * is prolongated from the coarse functions of the agglomerates of the
+ * adjacent locally owned cells, evaluated at the support point and averaged
+ * over these cells. Constrained degrees of freedom are left untouched, as in
+ * MGTwoLevelTransfer. Between two spaces on agglomerates, the prolongation
+ * is the exact embedding. The interpolation performs a least-squares fit of
+ * the values on each agglomerate.
+ *
+ * Since the coarse spaces are not described by a DoFHandler, the operators
+ * on the coarse levels can not be set up by MatrixFree. Instead, they are
+ * obtained by the Galerkin product $P^T A P$ with the prolongation matrix
+ * $P$ via compute_coarse_matrix(), such that the coarsest matrix can be
+ * passed to a direct solver.
+ *
+ * The agglomerates are formed on each process separately from the locally
+ * owned cells, so that the transfer needs no communication. As a
+ * consequence, the coarsest space has at least one agglomerate per process.
+ *
+ * @note This class requires finite elements with support points, e.g.,
+ *   FE_Q, FE_DGQ, FE_SimplexP, or systems of these, and only works on the
+ *   active level of the DoFHandler.
+ */
+template <int dim, typename VectorType>
+class MGTwoLevelTransferAgglomeration
+  : public MGTwoLevelTransferBase<VectorType>
+{
+public:
+  /**
+   * Perform prolongation.
+   */
+  void
+  prolongate_and_add(VectorType &dst, const VectorType &src) const override;
+
+  /**
+   * Perform restriction.
+   */
+  void
+  restrict_and_add(VectorType &dst, const VectorType &src) const override;
+
+  /**
+   * Perform interpolation of a solution vector from the fine level to the
+   * coarse level.
+   */
+  void
+  interpolate(VectorType &dst, const VectorType &src) const override;
+
+  /**
+   * Return the memory consumption of the allocated memory in this class.
+   */
+  std::size_t
+  memory_consumption() const override;
+};
+
+
+
+/**
+ * Class for transfer to a space on agglomerates of cells.
+ *
+ * Specialization for LinearAlgebra::distributed::Vector.
+ */
+template <int dim, typename Number>
+class MGTwoLevelTransferAgglomeration<
+  dim,
+  LinearAlgebra::distributed::Vector<Number>>
+  : public MGTwoLevelTransferBase<LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  /**
+   * Set up the transfer from the finite element space described by
+   * @p dof_handler_fine and @p constraint_fine to a space with the given
+   * @p basis on agglomerates of the locally owned active cells.
+   */
+  void
+  reinit(const DoFHandler<dim>           &dof_handler_fine,
+         const AffineConstraints<Number> &constraint_fine =
+           AffineConstraints<Number>(),
+         const MGTransferGlobalCoarseningTools::AgglomerationBasis basis =
+           MGTransferGlobalCoarseningTools::AgglomerationBasis::
+             piecewise_constant);
+
+  /**
+   * Set up the transfer from the coarse space of @p transfer_fine to a space
+   * with the same kind of basis functions on agglomerates of the
+   * agglomerates of @p transfer_fine.
+   */
+  void
+  reinit(const MGTwoLevelTransferAgglomeration &transfer_fine);
+
+  /**
+   * Return the number of agglomerates of the coarse space on the present
+   * process.
+   */
+  unsigned int
+  n_agglomerates() const;
+
+  /**
+   * Compute the matrix $P^T A P$ on the coarse space from the matrix $A$ on
+   * the fine space given by @p matrix_fine, where $P$ is the prolongation
+   * matrix. The rows of @p matrix_fine associated with constrained degrees
+   * of freedom do not contribute, since they are excluded from $P$.
+   *
+   * @note Currently only implemented for a single MPI process.
+   */
+  void
+  compute_coarse_matrix(const SparseMatrix<Number> &matrix_fine,
+                        SparsityPattern            &sparsity_pattern_coarse,
+                        SparseMatrix<Number>       &matrix_coarse) const;
+
+  /**
+   * Perform interpolation of a solution vector from the fine level to the
+   * coarse level.
+   */
+  void
+  interpolate(
+    LinearAlgebra::distributed::Vector<Number>       &dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Enable inplace vector operations if external and internal vectors
+   * are compatible.
+   */
+  void
+  enable_inplace_operations_if_possible(
+    const std::shared_ptr<const Utilities::MPI::Partitioner>
+      &partitioner_coarse,
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_fine)
+    override;
+
+  /**
+   * Return the memory consumption of the allocated memory in this class.
+   */
+  std::size_t
+  memory_consumption() const override;
+
+protected:
+  /**
+   * Perform prolongation.
+   */
+  void
+  prolongate_and_add_internal(
+    LinearAlgebra::distributed::Vector<Number>       &dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Perform restriction.
+   */
+  void
+  restrict_and_add_internal(
+    LinearAlgebra::distributed::Vector<Number>       &dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+private:
+  /**
+   * Cluster the vertices of the graph @p connectivity for which
+   * @p is_active is set into agglomerates, fill the geometric information
+   * of the agglomerates from the ones of the vertices given by @p centers,
+   * @p measures, and @p sizes, and set up the coarse partitioner. Return
+   * the agglomerate of each vertex.
+   */
+  std::vector<unsigned int>
+  setup_agglomerates(const DynamicSparsityPattern  &connectivity,
+                     const std::vector<bool>       &is_active,
+                     const std::vector<Point<dim>> &centers,
+                     const std::vector<double>     &measures,
+                     const std::vector<double>     &sizes,
+                     const MPI_Comm                 communicator);
+
+  /**
+   * Evaluate the coarse basis functions of agglomerate @p agglomerate at
+   * the point @p point.
+   */
+  std::array<double, dim + 1>
+  evaluate_basis(const unsigned int agglomerate, const Point<dim> &point) const;
+
+  /**
+   * Pointer to the DoFHandler object used during initialization. Only set
+   * if the fine space is a finite element space.
+   */
+  SmartPointer<const DoFHandler<dim>> dof_handler_fine;
+
+  /**
+   * Multigrid level used during initialization.
+   */
+  unsigned int mg_level_fine;
+
+  /**
+   * The kind of basis functions on the agglomerates.
+   */
+  MGTransferGlobalCoarseningTools::AgglomerationBasis basis;
+
+  /**
+   * Number of basis functions per agglomerate and vector component.
+   */
+  unsigned int n_basis_functions;
+
+  /**
+   * Number of vector components.
+   */
+  unsigned int n_components;
+
+  /**
+   * Measure-weighted center of each coarse agglomerate.
+   */
+  std::vector<Point<dim>> agglomerate_centers;
+
+  /**
+   * Measure of each coarse agglomerate.
+   */
+  std::vector<double> agglomerate_measures;
+
+  /**
+   * Radius of a ball around the center of each coarse agglomerate that
+   * contains the agglomerate, used to scale the linear basis functions.
+   */
+  std::vector<double> agglomerate_sizes;
+
+  /**
+   * Graph of the coarse agglomerates connected via a face, used for
+   * agglomerating them further.
+   */
+  DynamicSparsityPattern agglomerate_connectivity;
+
+  /**
+   * Prolongation matrix in compressed row storage, with the rows given by
+   * the locally owned fine degrees of freedom and the columns by the locally
+   * owned coarse degrees of freedom, both in local numbering.
+   */
+  std::vector<unsigned int> prolongation_row_starts;
+
+  /**
+   * Column indices of the prolongation matrix.
+   */
+  std::vector<unsigned int> prolongation_column_indices;
+
+  /**
+   * Values of the prolongation matrix.
+   */
+  std::vector<Number> prolongation_values;
+
+  /**
+   * Interpolation matrix in compressed row storage, with the rows given by
+   * the locally owned coarse degrees of freedom and the columns by the
+   * locally owned fine degrees of freedom, both in local numbering.
+   */
+  std::vector<unsigned int> interpolation_row_starts;
+
+  /**
+   * Column indices of the interpolation matrix.
+   */
+  std::vector<unsigned int> interpolation_column_indices;
+
+  /**
+   * Values of the interpolation matrix.
+   */
+  std::vector<Number> interpolation_values;
+
+  friend class MGTransferMF<dim, Number>;
+};
+
+
+
 /**
  * Implementation of the MGTransferBase. In contrast to
  * other multigrid transfer operators, the user can provide separate
@@ -38,8 +38,11 @@
 
 #include <deal.II/grid/cell_id_translator.h>
 #include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/tria_description.h>
 
+#include <deal.II/lac/full_matrix.h>
+
 #include <deal.II/matrix_free/evaluation_kernels.h>
 #include <deal.II/matrix_free/evaluation_template_factory.h>
 #include <deal.II/matrix_free/fe_point_evaluation.h>
@@ -82,20 +85,9 @@ namespace
         fu.template run<2 * deg, deg>(); // h-MG (FE_Q)
       else if ((degree_fine == (2 * deg + 1)) && (degree_coarse == deg))
         fu.template run<2 * deg + 1, deg>(); // h-MG
-      else if ((degree_fine == deg) && (degree_coarse == std::max(deg / 2, 1u)))
-        {
-          constexpr unsigned int degree_coarse_used = std::max(deg / 2u, 1u);
-          fu.template run<deg, degree_coarse_used>(); // p-MG: bisection
-        }
-      else if ((degree_fine == deg) && (degree_coarse == deg))
-        fu.template run<deg, deg>(); // identity (nothing to do)
-      else if ((degree_fine == deg) && (degree_coarse == std::max(deg - 1, 1u)))
-        {
-          constexpr unsigned int degree_coarse_used = std::max(deg - 1u, 1u);
-          fu.template run<deg, degree_coarse_used>(); // p-MG: --
-        }
-      else if ((degree_fine == deg) && (degree_coarse == 1))
-        fu.template run<deg, 1>(); // p-MG: jump to 1
+      else if ((degree_fine == deg) && (degree_coarse >= 1) &&
+               (degree_coarse <= deg))
+        run_p<Fu, deg>(fu); // p-MG, including the identity
       else if (deg < max_degree)
         return run<Fu, std::min(deg + 1, max_degree)>(fu); // try next degree
       else
@@ -109,6 +101,25 @@ namespace
     }
 
   private:
+    /**
+     * Select the coarse degree of a p-transfer from the fine degree
+     * @p deg. All pairs of degrees are precompiled, since the cells of
+     * an hp-mesh can be coarsened between any two elements of the
+     * hp::FECollection, and not only along the common polynomial coarsening
+     * sequences.
+     */
+    template <typename Fu, unsigned int deg, unsigned int deg_coarse = 1>
+    void
+    run_p(Fu &fu)
+    {
+      if (degree_coarse == deg_coarse)
+        fu.template run<deg, deg_coarse>();
+      else if constexpr (deg_coarse < deg)
+        run_p<Fu, deg, deg_coarse + 1>(fu);
+      else
+        Assert(false, ExcInternalError());
+    }
+
     const unsigned int degree_fine;
     const unsigned int degree_coarse;
   };
@@ -2399,9 +2410,31 @@ namespace internal
           0);
       });
 
+      // number the pairs in the order of the map and store the numbers in a
+      // flat table indexed by the coarse and the fine active FE index, which
+      // is cheaper to query in the loops over the cells below than the map
+      const unsigned int n_fes_fine =
+        dof_handler_fine.get_fe_collection().size();
+      std::vector<unsigned int> fe_pair_numbers(
+        dof_handler_coarse.get_fe_collection().size() * n_fes_fine,
+        numbers::invalid_unsigned_int);
+
       unsigned int counter = 0;
       for (auto &f : fe_index_pairs)
-        f.second = counter++;
+        {
+          f.second = counter++;
+          fe_pair_numbers[f.first.first * n_fes_fine + f.first.second] =
+            f.second;
+        }
+
+      const auto get_fe_pair_no = [&](const auto &cell_coarse,
+                                      const auto &cell_fine) {
+        const unsigned int fe_pair_no =
+          fe_pair_numbers[cell_coarse->active_fe_index() * n_fes_fine +
+                          cell_fine->active_fe_index()];
+        AssertIndexRange(fe_pair_no, fe_index_pairs.size());
+        return fe_pair_no;
+      };
 
       transfer.schemes.resize(fe_index_pairs.size());
 
@@ -2410,9 +2443,7 @@ namespace internal
         for (auto &scheme : transfer.schemes)
           scheme.n_coarse_cells = 0;
         process_cells([&](const auto &cell_coarse, const auto &cell_fine) {
-          transfer
-            .schemes[fe_index_pairs[std::pair<unsigned int, unsigned int>(
-              cell_coarse->active_fe_index(), cell_fine->active_fe_index())]]
+          transfer.schemes[get_fe_pair_no(cell_coarse, cell_fine)]
             .n_coarse_cells++;
         });
       }
@@ -2558,9 +2589,7 @@ namespace internal
         transfer.constraint_info_fine.reinit(cell_no.back());
 
         process_cells([&](const auto &cell_coarse, const auto &cell_fine) {
-          const auto fe_pair_no =
-            fe_index_pairs[std::pair<unsigned int, unsigned int>(
-              cell_coarse->active_fe_index(), cell_fine->active_fe_index())];
+          const auto fe_pair_no = get_fe_pair_no(cell_coarse, cell_fine);
 
           // parent
           {
@@ -2766,9 +2795,7 @@ namespace internal
             }
 
           process_cells([&](const auto &cell_coarse, const auto &cell_fine) {
-            const auto fe_pair_no =
-              fe_index_pairs[std::pair<unsigned int, unsigned int>(
-                cell_coarse->active_fe_index(), cell_fine->active_fe_index())];
+            const auto fe_pair_no = get_fe_pair_no(cell_coarse, cell_fine);
 
             for (unsigned int i = 0;
                  i < transfer.schemes[fe_pair_no].n_dofs_per_cell_fine;
@@ -4129,6 +4156,14 @@ MGTransferMF<dim, Number>::get_dof_handler_fine() const
     {
       return {t->dof_handler_fine, t->mg_level_fine};
     }
+  else if (const auto t = dynamic_cast<const MGTwoLevelTransferAgglomeration<
+             dim,
+             LinearAlgebra::distributed::Vector<Number>> *>(
+             this->transfer[this->transfer.max_level()].get()))
+    {
+      Assert(t->dof_handler_fine != nullptr, ExcNotImplemented());
+      return {t->dof_handler_fine, t->mg_level_fine};
+    }
   else
     {
       Assert(false, ExcNotImplemented());
@@ -5546,6 +5581,842 @@ MGTwoLevelTransferNonNested<dim, LinearAlgebra::distributed::Vector<Number>>::
 }
 
 
+
+namespace internal
+{
+  namespace
+  {
+    /**
+     * Cluster the vertices of the graph @p connectivity for which
+     * @p is_active is set into agglomerates, by a greedy aggregation in
+     * three phases: First, vertices whose active neighbors are all
+     * unassigned form an agglomerate together with these neighbors. Then,
+     * the remaining vertices join the agglomerate from the first phase of one
+     * of their neighbors, and finally, left-over vertices form agglomerates
+     * with their unassigned neighbors. Inactive vertices are assigned the
+     * index numbers::invalid_unsigned_int.
+     */
+    std::vector<unsigned int>
+    compute_agglomerates(const DynamicSparsityPattern &connectivity,
+                         const std::vector<bool>      &is_active,
+                         unsigned int                 &n_agglomerates)
+    {
+      const unsigned int invalid    = numbers::invalid_unsigned_int;
+      const unsigned int n_vertices = connectivity.n_rows();
+      AssertDimension(is_active.size(), n_vertices);
+
+      const auto for_each_neighbor = [&](const unsigned int v,
+                                         const auto        &fu) {
+        for (unsigned int k = 0; k < connectivity.row_length(v); ++k)
+          {
+            const unsigned int w = connectivity.column_number(v, k);
+            if (w != v && is_active[w])
+              fu(w);
+          }
+      };
+
+      std::vector<unsigned int> agglomerates(n_vertices, invalid);
+      n_agglomerates = 0;
+
+      // phase 1: agglomerates of vertices with all neighbors unassigned
+      for (unsigned int v = 0; v < n_vertices; ++v)
+        if (is_active[v] && agglomerates[v] == invalid)
+          {
+            bool all_neighbors_unassigned = true;
+            for_each_neighbor(v, [&](const unsigned int w) {
+              if (agglomerates[w] != invalid)
+                all_neighbors_unassigned = false;
+            });
+
+            if (all_neighbors_unassigned)
+              {
+                agglomerates[v] = n_agglomerates;
+                for_each_neighbor(v, [&](const unsigned int w) {
+                  agglomerates[w] = n_agglomerates;
+                });
+                ++n_agglomerates;
+              }
+          }
+
+      // phase 2: join the agglomerate of a neighbor from phase 1
+      const std::vector<unsigned int> agglomerates_phase_1 = agglomerates;
+      for (unsigned int v = 0; v < n_vertices; ++v)
+        if (is_active[v] && agglomerates[v] == invalid)
+          for_each_neighbor(v, [&](const unsigned int w) {
+            if (agglomerates[v] == invalid &&
+                agglomerates_phase_1[w] != invalid)
+              agglomerates[v] = agglomerates_phase_1[w];
+          });
+
+      // phase 3: agglomerates of the left-over vertices
+      for (unsigned int v = 0; v < n_vertices; ++v)
+        if (is_active[v] && agglomerates[v] == invalid)
+          {
+            agglomerates[v] = n_agglomerates;
+            for_each_neighbor(v, [&](const unsigned int w) {
+              if (agglomerates[w] == invalid)
+                agglomerates[w] = n_agglomerates;
+            });
+            ++n_agglomerates;
+          }
+
+      return agglomerates;
+    }
+
+
+
+    /**
+     * Fill a matrix in compressed row storage with @p n_rows rows from the
+     * given (row, column, value) triplets. Triplets with the same row and
+     * column are summed up.
+     */
+    template <typename Number>
+    void
+    fill_compressed_row_storage(
+      std::vector<std::tuple<unsigned int, unsigned int, Number>> &entries,
+      const unsigned int                                           n_rows,
+      std::vector<unsigned int>                                   &row_starts,
+      std::vector<unsigned int> &column_indices,
+      std::vector<Number>       &values)
+    {
+      std::sort(entries.begin(),
+                entries.end(),
+                [](const auto &a, const auto &b) {
+                  return std::make_pair(std::get<0>(a), std::get<1>(a)) <
+                         std::make_pair(std::get<0>(b), std::get<1>(b));
+                });
+
+      row_starts.assign(n_rows + 1, 0);
+      column_indices.clear();
+      values.clear();
+
+      for (unsigned int k = 0; k < entries.size(); ++k)
+        if (k > 0 && std::get<0>(entries[k]) == std::get<0>(entries[k - 1]) &&
+            std::get<1>(entries[k]) == std::get<1>(entries[k - 1]))
+          values.back() += std::get<2>(entries[k]);
+        else
+          {
+            AssertIndexRange(std::get<0>(entries[k]), n_rows);
+            ++row_starts[std::get<0>(entries[k]) + 1];
+            column_indices.push_back(std::get<1>(entries[k]));
+            values.push_back(std::get<2>(entries[k]));
+          }
+
+      std::partial_sum(row_starts.begin(),
+                       row_starts.end(),
+                       row_starts.begin());
+    }
+  } // namespace
+} // namespace internal
+
+
+
+template <int dim, typename Number>
+std::vector<unsigned int>
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  setup_agglomerates(const DynamicSparsityPattern  &connectivity,
+                     const std::vector<bool>       &is_active,
+                     const std::vector<Point<dim>> &centers,
+                     const std::vector<double>     &measures,
+                     const std::vector<double>     &sizes,
+                     const MPI_Comm                 communicator)
+{
+  unsigned int                    n_agglomerates = 0;
+  const std::vector<unsigned int> agglomerates =
+    internal::compute_agglomerates(connectivity, is_active, n_agglomerates);
+
+  agglomerate_centers.assign(n_agglomerates, Point<dim>());
+  agglomerate_measures.assign(n_agglomerates, 0.);
+  agglomerate_sizes.assign(n_agglomerates, 0.);
+
+  for (unsigned int v = 0; v < agglomerates.size(); ++v)
+    if (is_active[v])
+      {
+        agglomerate_centers[agglomerates[v]] += measures[v] * centers[v];
+        agglomerate_measures[agglomerates[v]] += measures[v];
+      }
+
+  for (unsigned int a = 0; a < n_agglomerates; ++a)
+    agglomerate_centers[a] /= agglomerate_measures[a];
+
+  for (unsigned int v = 0; v < agglomerates.size(); ++v)
+    if (is_active[v])
+      agglomerate_sizes[agglomerates[v]] =
+        std::max(agglomerate_sizes[agglomerates[v]],
+                 agglomerate_centers[agglomerates[v]].distance(centers[v]) +
+                   sizes[v]);
+
+  agglomerate_connectivity.reinit(n_agglomerates, n_agglomerates);
+  for (unsigned int v = 0; v < agglomerates.size(); ++v)
+    if (is_active[v])
+      for (unsigned int k = 0; k < connectivity.row_length(v); ++k)
+        {
+          const unsigned int w = connectivity.column_number(v, k);
+          if (is_active[w])
+            agglomerate_connectivity.add(agglomerates[v], agglomerates[w]);
+        }
+
+  const IndexSet locally_owned_dofs =
+    Utilities::MPI::create_ascending_partitioning(
+      communicator,
+      n_agglomerates * n_components *
+        n_basis_functions)[Utilities::MPI::this_mpi_process(communicator)];
+
+  this->partitioner_coarse =
+    std::make_shared<Utilities::MPI::Partitioner>(locally_owned_dofs,
+                                                  communicator);
+  this->vec_coarse.reinit(this->partitioner_coarse);
+
+  return agglomerates;
+}
+
+
+
+template <int dim, typename Number>
+std::array<double, dim + 1>
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  evaluate_basis(const unsigned int agglomerate, const Point<dim> &point) const
+{
+  std::array<double, dim + 1> values;
+  values[0] = 1.;
+  for (unsigned int d = 0; d < dim; ++d)
+    values[d + 1] = (point[d] - agglomerate_centers[agglomerate][d]) /
+                    agglomerate_sizes[agglomerate];
+  return values;
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  reinit(const DoFHandler<dim>                                    &dof_handler,
+         const AffineConstraints<Number>                          &constraint,
+         const MGTransferGlobalCoarseningTools::AgglomerationBasis basis)
+{
+  this->dof_handler_fine = &dof_handler;
+  this->mg_level_fine    = numbers::invalid_unsigned_int;
+  this->basis            = basis;
+  this->n_basis_functions =
+    basis == MGTransferGlobalCoarseningTools::AgglomerationBasis::
+               piecewise_constant ?
+      1 :
+      dim + 1;
+  this->n_components = dof_handler.get_fe_collection().n_components();
+
+  const MPI_Comm communicator = dof_handler.get_communicator();
+
+  this->partitioner_fine =
+    std::make_shared<Utilities::MPI::Partitioner>(
+      dof_handler.locally_owned_dofs(), communicator);
+  this->vec_fine.reinit(this->partitioner_fine);
+  this->vec_fine_needs_ghost_update = false;
+  this->fine_element_is_continuous =
+    dof_handler.get_fe(0).n_dofs_per_vertex() > 0;
+
+  // agglomerate the locally owned cells
+  const Triangulation<dim> &tria = dof_handler.get_triangulation();
+
+  DynamicSparsityPattern cell_connectivity;
+  GridTools::get_face_connectivity_of_cells(tria, cell_connectivity);
+
+  std::vector<bool>       is_locally_owned(tria.n_active_cells(), false);
+  std::vector<Point<dim>> centers(tria.n_active_cells());
+  std::vector<double>     measures(tria.n_active_cells());
+  std::vector<double>     sizes(tria.n_active_cells());
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        const unsigned int index = cell->active_cell_index();
+        is_locally_owned[index]  = true;
+        centers[index]           = cell->center();
+        measures[index]          = cell->measure();
+        sizes[index]             = 0.5 * cell->diameter();
+      }
+
+  const std::vector<unsigned int> agglomerate_of_cell =
+    setup_agglomerates(cell_connectivity,
+                       is_locally_owned,
+                       centers,
+                       measures,
+                       sizes,
+                       communicator);
+
+  // the support points of the fine degrees of freedom are computed with a
+  // linear mapping, one FEValues object for each element of the collection
+  const auto &fe_collection = dof_handler.get_fe_collection();
+  std::vector<std::unique_ptr<FEValues<dim>>> fe_values(fe_collection.size());
+  for (unsigned int i = 0; i < fe_collection.size(); ++i)
+    {
+      const FiniteElement<dim> &fe = fe_collection[i];
+      Assert(fe.has_support_points(), ExcNotImplemented());
+      fe_values[i] = std::make_unique<FEValues<dim>>(
+        fe.reference_cell().template get_default_linear_mapping<dim, dim>(),
+        fe,
+        Quadrature<dim>(fe.get_unit_support_points()),
+        update_quadrature_points);
+    }
+
+  // count the locally owned cells around each locally owned degree of
+  // freedom, over which the prolongated values are averaged
+  const unsigned int n_dofs_fine =
+    this->partitioner_fine->locally_owned_size();
+  std::vector<unsigned int>            n_cells_of_dof(n_dofs_fine, 0);
+  std::vector<types::global_dof_index> dof_indices;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices(dof_indices);
+        for (const types::global_dof_index i : dof_indices)
+          if (this->partitioner_fine->in_local_range(i))
+            ++n_cells_of_dof[this->partitioner_fine->global_to_local(i)];
+      }
+
+  // collect the entries of the prolongation matrix and the support points
+  // of the degrees of freedom of each agglomerate and component
+  std::vector<std::tuple<unsigned int, unsigned int, Number>>
+    prolongation_entries;
+  std::vector<std::pair<std::pair<unsigned int, unsigned int>, Point<dim>>>
+    support_points;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        const FiniteElement<dim> &fe = cell->get_fe();
+        fe_values[cell->active_fe_index()]->reinit(cell);
+        dof_indices.resize(fe.n_dofs_per_cell());
+        cell->get_dof_indices(dof_indices);
+
+        const unsigned int agglomerate =
+          agglomerate_of_cell[cell->active_cell_index()];
+        for (unsigned int k = 0; k < dof_indices.size(); ++k)
+          if (this->partitioner_fine->in_local_range(dof_indices[k]))
+            {
+              const unsigned int i =
+                this->partitioner_fine->global_to_local(dof_indices[k]);
+              const Point<dim> &point =
+                fe_values[cell->active_fe_index()]->quadrature_point(k);
+              const unsigned int group =
+                agglomerate * n_components +
+                fe.system_to_component_index(k).first;
+              support_points.emplace_back(std::make_pair(group, i), point);
+
+              if (constraint.is_constrained(dof_indices[k]))
+                continue;
+
+              const auto values = evaluate_basis(agglomerate, point);
+              for (unsigned int b = 0; b < n_basis_functions; ++b)
+                prolongation_entries.emplace_back(i,
+                                                  group * n_basis_functions +
+                                                    b,
+                                                  values[b] /
+                                                    n_cells_of_dof[i]);
+            }
+      }
+
+  internal::fill_compressed_row_storage(prolongation_entries,
+                                        n_dofs_fine,
+                                        prolongation_row_starts,
+                                        prolongation_column_indices,
+                                        prolongation_values);
+
+  // the interpolation is a least-squares fit of the basis functions to the
+  // values at the support points of each agglomerate and component
+  std::sort(support_points.begin(),
+            support_points.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  support_points.erase(std::unique(support_points.begin(),
+                                   support_points.end(),
+                                   [](const auto &a, const auto &b) {
+                                     return a.first == b.first;
+                                   }),
+                       support_points.end());
+
+  std::vector<std::tuple<unsigned int, unsigned int, Number>>
+                     interpolation_entries;
+  FullMatrix<double> mass_matrix(n_basis_functions, n_basis_functions);
+  for (unsigned int begin = 0; begin < support_points.size();)
+    {
+      const unsigned int group       = support_points[begin].first.first;
+      const unsigned int agglomerate = group / n_components;
+
+      unsigned int end = begin + 1;
+      while (end < support_points.size() &&
+             support_points[end].first.first == group)
+        ++end;
+
+      mass_matrix = 0.;
+      for (unsigned int q = begin; q < end; ++q)
+        {
+          const auto values =
+            evaluate_basis(agglomerate, support_points[q].second);
+          for (unsigned int b = 0; b < n_basis_functions; ++b)
+            for (unsigned int c = 0; c < n_basis_functions; ++c)
+              mass_matrix(b, c) += values[b] * values[c];
+        }
+
+      // regularize the linear part in case the support points do not span
+      // all directions, i.e., if the second moments of the points about
+      // their mean (the Schur complement of the constant function) are
+      // singular. Otherwise, the fit must reproduce the functions in the
+      // span of the basis exactly, so leave the matrix untouched.
+      if (n_basis_functions > 1)
+        {
+          FullMatrix<double> moments(dim, dim);
+          double             diagonal_product = 1.;
+          for (unsigned int d = 0; d < dim; ++d)
+            {
+              for (unsigned int e = 0; e < dim; ++e)
+                moments(d, e) = mass_matrix(d + 1, e + 1) -
+                                mass_matrix(d + 1, 0) * mass_matrix(0, e + 1) /
+                                  mass_matrix(0, 0);
+              diagonal_product *= moments(d, d);
+            }
+          if (moments.determinant() <= 1e-12 * diagonal_product)
+            for (unsigned int b = 1; b < n_basis_functions; ++b)
+              mass_matrix(b, b) += 1e-10 * mass_matrix(0, 0);
+        }
+      mass_matrix.gauss_jordan();
+
+      for (unsigned int q = begin; q < end; ++q)
+        {
+          const auto values =
+            evaluate_basis(agglomerate, support_points[q].second);
+          for (unsigned int b = 0; b < n_basis_functions; ++b)
+            {
+              double value = 0.;
+              for (unsigned int c = 0; c < n_basis_functions; ++c)
+                value += mass_matrix(b, c) * values[c];
+              interpolation_entries.emplace_back(group * n_basis_functions + b,
+                                                 support_points[q].first.second,
+                                                 value);
+            }
+        }
+
+      begin = end;
+    }
+
+  internal::fill_compressed_row_storage(
+    interpolation_entries,
+    this->partitioner_coarse->locally_owned_size(),
+    interpolation_row_starts,
+    interpolation_column_indices,
+    interpolation_values);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  reinit(const MGTwoLevelTransferAgglomeration &transfer_fine)
+{
+  this->dof_handler_fine  = nullptr;
+  this->mg_level_fine     = numbers::invalid_unsigned_int;
+  this->basis             = transfer_fine.basis;
+  this->n_basis_functions = transfer_fine.n_basis_functions;
+  this->n_components      = transfer_fine.n_components;
+
+  const MPI_Comm communicator =
+    transfer_fine.partitioner_coarse->get_mpi_communicator();
+
+  this->partitioner_fine = std::make_shared<Utilities::MPI::Partitioner>(
+    transfer_fine.partitioner_coarse->locally_owned_range(), communicator);
+  this->vec_fine.reinit(this->partitioner_fine);
+  this->vec_fine_needs_ghost_update = false;
+  this->fine_element_is_continuous  = false;
+
+  // agglomerate the agglomerates of the fine space
+  const unsigned int              n_children = transfer_fine.n_agglomerates();
+  const std::vector<unsigned int> parents =
+    setup_agglomerates(transfer_fine.agglomerate_connectivity,
+                       std::vector<bool>(n_children, true),
+                       transfer_fine.agglomerate_centers,
+                       transfer_fine.agglomerate_measures,
+                       transfer_fine.agglomerate_sizes,
+                       communicator);
+  const auto &centers_fine = transfer_fine.agglomerate_centers;
+  const auto &sizes_fine   = transfer_fine.agglomerate_sizes;
+
+  // average offset of the centers of the children from the center of their
+  // parent, scaled by the size of the parent, needed for the interpolation
+  std::vector<unsigned int>   n_children_of_parent(n_agglomerates(), 0);
+  std::vector<Tensor<1, dim>> mean_offsets(n_agglomerates());
+  for (unsigned int b = 0; b < n_children; ++b)
+    {
+      const unsigned int a = parents[b];
+      ++n_children_of_parent[a];
+      mean_offsets[a] += (centers_fine[b] - agglomerate_centers[a]) /
+                         agglomerate_sizes[a];
+    }
+  for (unsigned int a = 0; a < n_agglomerates(); ++a)
+    mean_offsets[a] /= n_children_of_parent[a];
+
+  // the prolongation is the exact embedding of the functions on the parent
+  // into the space of the children, the interpolation averages the
+  // functions of the children
+  std::vector<std::tuple<unsigned int, unsigned int, Number>>
+    prolongation_entries;
+  std::vector<std::tuple<unsigned int, unsigned int, Number>>
+    interpolation_entries;
+  for (unsigned int b = 0; b < n_children; ++b)
+    for (unsigned int c = 0; c < n_components; ++c)
+      {
+        const unsigned int a = parents[b];
+        const unsigned int child_dof =
+          (b * n_components + c) * n_basis_functions;
+        const unsigned int parent_dof =
+          (a * n_components + c) * n_basis_functions;
+        const double weight = 1. / n_children_of_parent[a];
+
+        prolongation_entries.emplace_back(child_dof, parent_dof, 1.);
+        interpolation_entries.emplace_back(parent_dof, child_dof, weight);
+
+        for (unsigned int d = 0; d + 1 < n_basis_functions; ++d)
+          {
+            const double scaling = sizes_fine[b] / agglomerate_sizes[a];
+
+            prolongation_entries.emplace_back(
+              child_dof,
+              parent_dof + 1 + d,
+              (centers_fine[b][d] - agglomerate_centers[a][d]) /
+                agglomerate_sizes[a]);
+            prolongation_entries.emplace_back(child_dof + 1 + d,
+                                              parent_dof + 1 + d,
+                                              scaling);
+
+            interpolation_entries.emplace_back(parent_dof + 1 + d,
+                                               child_dof + 1 + d,
+                                               weight / scaling);
+            interpolation_entries.emplace_back(parent_dof,
+                                               child_dof + 1 + d,
+                                               -mean_offsets[a][d] * weight /
+                                                 scaling);
+          }
+      }
+
+  internal::fill_compressed_row_storage(
+    prolongation_entries,
+    this->partitioner_fine->locally_owned_size(),
+    prolongation_row_starts,
+    prolongation_column_indices,
+    prolongation_values);
+  internal::fill_compressed_row_storage(
+    interpolation_entries,
+    this->partitioner_coarse->locally_owned_size(),
+    interpolation_row_starts,
+    interpolation_column_indices,
+    interpolation_values);
+}
+
+
+
+template <int dim, typename Number>
+unsigned int
+MGTwoLevelTransferAgglomeration<
+  dim,
+  LinearAlgebra::distributed::Vector<Number>>::n_agglomerates() const
+{
+  return agglomerate_centers.size();
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  compute_coarse_matrix(const SparseMatrix<Number> &matrix_fine,
+                        SparsityPattern            &sparsity_pattern_coarse,
+                        SparseMatrix<Number>       &matrix_coarse) const
+{
+  AssertThrow(Utilities::MPI::n_mpi_processes(
+                this->partitioner_fine->get_mpi_communicator()) == 1,
+              ExcNotImplemented());
+
+  const unsigned int n_rows_fine = prolongation_row_starts.size() - 1;
+  const unsigned int n_rows_coarse =
+    this->partitioner_coarse->locally_owned_size();
+  AssertDimension(matrix_fine.m(), n_rows_fine);
+  AssertDimension(matrix_fine.n(), n_rows_fine);
+
+  // compute the rows of A P one at a time and hand them to the given
+  // function, which adds them to the rows of P^T A P given by the nonzero
+  // entries in the respective row of P
+  std::vector<Number>                  row_values(n_rows_coarse, Number());
+  std::vector<bool>                    is_touched(n_rows_coarse, false);
+  std::vector<types::global_dof_index> row_indices;
+
+  const auto loop_over_rows = [&](const auto &fu) {
+    for (unsigned int i = 0; i < n_rows_fine; ++i)
+      if (prolongation_row_starts[i] < prolongation_row_starts[i + 1])
+        {
+          row_indices.clear();
+          for (auto entry = matrix_fine.begin(i); entry != matrix_fine.end(i);
+               ++entry)
+            {
+              const unsigned int k = entry->column();
+              for (unsigned int l = prolongation_row_starts[k];
+                   l < prolongation_row_starts[k + 1];
+                   ++l)
+                {
+                  const unsigned int j = prolongation_column_indices[l];
+                  if (is_touched[j] == false)
+                    {
+                      is_touched[j] = true;
+                      row_indices.push_back(j);
+                    }
+                  row_values[j] += entry->value() * prolongation_values[l];
+                }
+            }
+
+          std::sort(row_indices.begin(), row_indices.end());
+          fu(i);
+
+          for (const auto j : row_indices)
+            {
+              is_touched[j] = false;
+              row_values[j] = Number();
+            }
+        }
+  };
+
+  DynamicSparsityPattern dsp(n_rows_coarse, n_rows_coarse);
+  for (unsigned int j = 0; j < n_rows_coarse; ++j)
+    dsp.add(j, j);
+  loop_over_rows([&](const unsigned int i) {
+    for (unsigned int l = prolongation_row_starts[i];
+         l < prolongation_row_starts[i + 1];
+         ++l)
+      dsp.add_entries(prolongation_column_indices[l],
+                      row_indices.begin(),
+                      row_indices.end(),
+                      true);
+  });
+  sparsity_pattern_coarse.copy_from(dsp);
+  matrix_coarse.reinit(sparsity_pattern_coarse);
+
+  std::vector<Number> scaled_row_values;
+  loop_over_rows([&](const unsigned int i) {
+    scaled_row_values.resize(row_indices.size());
+    for (unsigned int l = prolongation_row_starts[i];
+         l < prolongation_row_starts[i + 1];
+         ++l)
+      {
+        for (unsigned int m = 0; m < row_indices.size(); ++m)
+          scaled_row_values[m] =
+            prolongation_values[l] * row_values[row_indices[m]];
+        matrix_coarse.add(prolongation_column_indices[l],
+                          row_indices.size(),
+                          row_indices.data(),
+                          scaled_row_values.data(),
+                          false,
+                          true);
+      }
+  });
+
+  // coarse degrees of freedom that are not connected to any unconstrained
+  // fine degree of freedom get a unit diagonal to keep the matrix invertible
+  for (unsigned int j = 0; j < n_rows_coarse; ++j)
+    if (matrix_coarse.diag_element(j) == Number())
+      matrix_coarse.diag_element(j) = Number(1.);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  prolongate_and_add_internal(
+    LinearAlgebra::distributed::Vector<Number>       &dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  for (unsigned int i = 0; i + 1 < prolongation_row_starts.size(); ++i)
+    {
+      Number sum = Number();
+      for (unsigned int l = prolongation_row_starts[i];
+           l < prolongation_row_starts[i + 1];
+           ++l)
+        sum += prolongation_values[l] *
+               src.local_element(prolongation_column_indices[l]);
+      dst.local_element(i) += sum;
+    }
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  restrict_and_add_internal(
+    LinearAlgebra::distributed::Vector<Number>       &dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  for (unsigned int i = 0; i + 1 < prolongation_row_starts.size(); ++i)
+    {
+      const Number value = src.local_element(i);
+      for (unsigned int l = prolongation_row_starts[i];
+           l < prolongation_row_starts[i + 1];
+           ++l)
+        dst.local_element(prolongation_column_indices[l]) +=
+          prolongation_values[l] * value;
+    }
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  interpolate(LinearAlgebra::distributed::Vector<Number>       &dst,
+              const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  AssertDimension(dst.locally_owned_size(),
+                  interpolation_row_starts.size() - 1);
+  AssertDimension(src.locally_owned_size(),
+                  prolongation_row_starts.size() - 1);
+
+  for (unsigned int j = 0; j + 1 < interpolation_row_starts.size(); ++j)
+    {
+      Number sum = Number();
+      for (unsigned int l = interpolation_row_starts[j];
+           l < interpolation_row_starts[j + 1];
+           ++l)
+        sum += interpolation_values[l] *
+               src.local_element(interpolation_column_indices[l]);
+      dst.local_element(j) = sum;
+    }
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransferAgglomeration<dim,
+                                LinearAlgebra::distributed::Vector<Number>>::
+  enable_inplace_operations_if_possible(
+    const std::shared_ptr<const Utilities::MPI::Partitioner>
+      &external_partitioner_coarse,
+    const std::shared_ptr<const Utilities::MPI::Partitioner>
+      &external_partitioner_fine)
+{
+  // only locally owned entries are accessed, so any external partitioner
+  // with the same locally owned range can be used, with the ghost exchange
+  // of the embedded partitioners being empty
+  if (this->partitioner_coarse->is_globally_compatible(
+        *external_partitioner_coarse))
+    {
+      this->vec_coarse.reinit(0);
+      this->partitioner_coarse = external_partitioner_coarse;
+    }
+  else if (internal::is_partitioner_contained(this->partitioner_coarse,
+                                              external_partitioner_coarse))
+    {
+      this->vec_coarse.reinit(0);
+      this->partitioner_coarse_embedded =
+        internal::create_embedded_partitioner(this->partitioner_coarse,
+                                              external_partitioner_coarse);
+      this->partitioner_coarse = external_partitioner_coarse;
+    }
+
+  if (this->partitioner_fine->is_globally_compatible(
+        *external_partitioner_fine))
+    {
+      this->vec_fine.reinit(0);
+      this->partitioner_fine = external_partitioner_fine;
+    }
+  else if (internal::is_partitioner_contained(this->partitioner_fine,
+                                              external_partitioner_fine))
+    {
+      this->vec_fine.reinit(0);
+      this->partitioner_fine_embedded =
+        internal::create_embedded_partitioner(this->partitioner_fine,
+                                              external_partitioner_fine);
+      this->partitioner_fine = external_partitioner_fine;
+    }
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTwoLevelTransferAgglomeration<
+  dim,
+  LinearAlgebra::distributed::Vector<Number>>::memory_consumption() const
+{
+  std::size_t size = 0;
+
+  size += this->partitioner_fine->memory_consumption();
+  size += this->partitioner_coarse->memory_consumption();
+  size += this->vec_fine.memory_consumption();
+  size += this->vec_coarse.memory_consumption();
+  size += MemoryConsumption::memory_consumption(agglomerate_centers);
+  size += MemoryConsumption::memory_consumption(agglomerate_measures);
+  size += MemoryConsumption::memory_consumption(agglomerate_sizes);
+  size += agglomerate_connectivity.memory_consumption();
+  size += MemoryConsumption::memory_consumption(prolongation_row_starts);
+  size += MemoryConsumption::memory_consumption(prolongation_column_indices);
+  size += MemoryConsumption::memory_consumption(prolongation_values);
+  size += MemoryConsumption::memory_consumption(interpolation_row_starts);
+  size += MemoryConsumption::memory_consumption(interpolation_column_indices);
+  size += MemoryConsumption::memory_consumption(interpolation_values);
+
+  return size;
+}
+
+
+
+namespace MGTransferGlobalCoarseningTools
+{
+  template <int dim, typename Number>
+  std::vector<std::shared_ptr<MGTwoLevelTransferAgglomeration<
+    dim,
+    LinearAlgebra::distributed::Vector<Number>>>>
+  create_agglomeration_sequence(const DoFHandler<dim>           &dof_handler,
+                                const AffineConstraints<Number> &constraints,
+                                const AgglomerationBasis         basis,
+                                const types::global_dof_index max_coarse_size,
+                                const unsigned int            max_levels)
+  {
+    using TransferType = MGTwoLevelTransferAgglomeration<
+      dim,
+      LinearAlgebra::distributed::Vector<Number>>;
+
+    std::vector<std::shared_ptr<TransferType>> transfers;
+    if (dof_handler.n_dofs() <= max_coarse_size || max_levels < 2)
+      return transfers;
+
+    transfers.emplace_back(std::make_shared<TransferType>());
+    transfers.back()->reinit(dof_handler, constraints, basis);
+
+    while (transfers.back()->partitioner_coarse->size() > max_coarse_size &&
+           transfers.size() + 1 < max_levels)
+      {
+        const auto transfer = std::make_shared<TransferType>();
+        transfer->reinit(*transfers.back());
+
+        // stop if the agglomerates could not be clustered any further
+        if (transfer->partitioner_coarse->size() ==
+            transfers.back()->partitioner_coarse->size())
+          break;
+
+        transfers.emplace_back(transfer);
+      }
+
+    std::reverse(transfers.begin(), transfers.end());
+
+    return transfers;
+  }
+} // namespace MGTransferGlobalCoarseningTools
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -19,6 +19,7 @@
 
 #include <boost/serialization/utility.hpp>
 
+#include <algorithm>
 #include <limits>
 
 DEAL_II_NAMESPACE_OPEN
@@ -28,6 +29,86 @@ namespace Utilities
 {
   namespace MPI
   {
+    PersistentRequests::PersistentRequests(const PersistentRequests &)
+      : PersistentRequests()
+    {}
+
+
+
+    PersistentRequests::PersistentRequests(PersistentRequests &&other) noexcept
+      : requests(std::move(other.requests))
+      , setup(other.setup)
+    {
+      other.requests.clear();
+    }
+
+
+
+    PersistentRequests::~PersistentRequests()
+    {
+      try
+        {
+          clear();
+        }
+      catch (...)
+        {}
+    }
+
+
+
+    PersistentRequests &
+    PersistentRequests::operator=(const PersistentRequests &)
+    {
+      clear();
+      return *this;
+    }
+
+
+
+    PersistentRequests &
+    PersistentRequests::operator=(PersistentRequests &&other) noexcept
+    {
+      std::swap(requests, other.requests);
+      std::swap(setup, other.setup);
+      return *this;
+    }
+
+
+
+    void
+    PersistentRequests::clear()
+    {
+#  ifdef DEAL_II_WITH_MPI
+      // the requests might outlive MPI, e.g. for vectors with static storage
+      // duration, in which case they have been freed by MPI_Finalize()
+      if (requests.size() > 0)
+        {
+          int finalized = 0;
+          int ierr      = MPI_Finalized(&finalized);
+          AssertThrowMPI(ierr);
+          if (finalized == 0)
+            for (MPI_Request &request : requests)
+              if (request != MPI_REQUEST_NULL)
+                {
+                  ierr = MPI_Request_free(&request);
+                  AssertThrowMPI(ierr);
+                }
+        }
+#  endif
+      requests.clear();
+      setup = {};
+    }
+
+
+
+    bool
+    PersistentRequests::started(const std::vector<MPI_Request> &requests) const
+    {
+      return !requests.empty() && requests == this->requests;
+    }
+
+
+
     Partitioner::Partitioner()
       : global_size(0)
       , local_range_data(
@@ -533,6 +614,140 @@ namespace Utilities
 
 
 
+#  ifdef DEAL_II_WITH_MPI
+    std::shared_ptr<const Partitioner::SharedMemoryData>
+    Partitioner::create_shared_memory_data(const MPI_Comm communicator_sm) const
+    {
+      auto data             = std::make_shared<SharedMemoryData>();
+      data->communicator_sm = communicator_sm;
+
+      // the ranks within the communicator of this class of the processes in
+      // the shared-memory communicator, ordered by their rank within
+      // communicator_sm
+      const std::vector<unsigned int> sm_ranks =
+        Utilities::MPI::mpi_processes_within_communicator(communicator,
+                                                          communicator_sm);
+      const auto get_sm_rank = [&](const unsigned int rank) {
+        const auto it = std::find(sm_ranks.begin(), sm_ranks.end(), rank);
+        return it == sm_ranks.end() ?
+                 numbers::invalid_unsigned_int :
+                 static_cast<unsigned int>(it - sm_ranks.begin());
+      };
+
+      // the first locally owned index and the number of locally owned
+      // entries of all processes in the shared-memory communicator, to
+      // translate the indices into positions in their arrays
+      const std::vector<types::global_dof_index> first_owned =
+        Utilities::MPI::all_gather(communicator_sm, local_range_data.first);
+      const std::vector<unsigned int> n_owned =
+        Utilities::MPI::all_gather(communicator_sm, locally_owned_size());
+
+      // ghost entries: find the positions in the arrays of the owners and
+      // tell each owner where the entries it needs to import from the
+      // calling process start within its ghost range
+      std::vector<unsigned int> ghost_offsets(ghost_targets_data.size());
+      std::vector<MPI_Request>  requests;
+      data->n_sm_ghost_targets = 0;
+      data->ghost_ranges_ptr.push_back(0);
+      unsigned int offset = 0;
+      for (unsigned int i = 0; i < ghost_targets_data.size(); ++i)
+        {
+          const unsigned int sm_rank =
+            get_sm_rank(ghost_targets_data[i].first);
+          data->ghost_targets_sm_rank.push_back(sm_rank);
+          if (sm_rank != numbers::invalid_unsigned_int)
+            {
+              ++data->n_sm_ghost_targets;
+              for (unsigned int k = offset;
+                   k < offset + ghost_targets_data[i].second;
+                   ++k)
+                {
+                  const unsigned int position = static_cast<unsigned int>(
+                    ghost_indices_data.nth_index_in_set(k) -
+                    first_owned[sm_rank]);
+                  if (data->ghost_ranges.size() > data->ghost_ranges_ptr[i] &&
+                      data->ghost_ranges.back()[1] +
+                          data->ghost_ranges.back()[2] ==
+                        position)
+                    ++data->ghost_ranges.back()[2];
+                  else
+                    data->ghost_ranges.push_back({{k, position, 1}});
+                }
+
+              ghost_offsets[i] = offset;
+              requests.emplace_back();
+              const int ierr = MPI_Isend(
+                &ghost_offsets[i],
+                1,
+                MPI_UNSIGNED,
+                sm_rank,
+                internal::Tags::partitioner_initialize_shared_memory_access,
+                communicator_sm,
+                &requests.back());
+              AssertThrowMPI(ierr);
+            }
+          data->ghost_ranges_ptr.push_back(data->ghost_ranges.size());
+          offset += ghost_targets_data[i].second;
+        }
+
+      // import entries: receive the position of the entries within the
+      // ghost range of the other processes
+      std::vector<unsigned int> import_offsets(import_targets_data.size());
+      data->n_sm_import_targets = 0;
+      for (unsigned int i = 0; i < import_targets_data.size(); ++i)
+        {
+          const unsigned int sm_rank =
+            get_sm_rank(import_targets_data[i].first);
+          data->import_targets_sm_rank.push_back(sm_rank);
+          if (sm_rank != numbers::invalid_unsigned_int)
+            {
+              ++data->n_sm_import_targets;
+              requests.emplace_back();
+              const int ierr = MPI_Irecv(
+                &import_offsets[i],
+                1,
+                MPI_UNSIGNED,
+                sm_rank,
+                internal::Tags::partitioner_initialize_shared_memory_access,
+                communicator_sm,
+                &requests.back());
+              AssertThrowMPI(ierr);
+            }
+        }
+
+      const int ierr =
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+      AssertThrowMPI(ierr);
+
+      // the import indices are sorted by the ghost indices of the receiving
+      // process, so the ranges follow each other in its ghost array
+      data->import_ranges_ptr.push_back(0);
+      for (unsigned int i = 0; i < import_targets_data.size(); ++i)
+        {
+          const unsigned int sm_rank = data->import_targets_sm_rank[i];
+          if (sm_rank != numbers::invalid_unsigned_int)
+            {
+              unsigned int position = n_owned[sm_rank] + import_offsets[i];
+              for (unsigned int j = import_indices_chunks_by_rank_data[i];
+                   j < import_indices_chunks_by_rank_data[i + 1];
+                   ++j)
+                {
+                  const unsigned int length = import_indices_data[j].second -
+                                              import_indices_data[j].first;
+                  data->import_ranges.push_back(
+                    {{import_indices_data[j].first, position, length}});
+                  position += length;
+                }
+            }
+          data->import_ranges_ptr.push_back(data->import_ranges.size());
+        }
+
+      return data;
+    }
+#  endif
+
+
+
     void
     Partitioner::initialize_import_indices_plain_dev() const
     {
@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/partitioner.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/types.h>
@@ -62,6 +63,8 @@
 #include <cmath>
 #include <functional>
 #include <map>
+#include <numeric>
+#include <tuple>
 #include <vector>
 
 
@@ -2882,6 +2885,195 @@ namespace DoFRenumbering
     return new_global_numbers;
   }
 
+
+
+  namespace
+  {
+    // Helper function for DoFRenumbering::space_filling_curve_blocks(). Like
+    // compute_hierarchical_recursive(), this function recurses into the
+    // children of the given cell in Z order, and appends the locally owned
+    // terminal cells to the given list.
+    template <int dim, typename CellIteratorType>
+    void
+    collect_cells_in_z_order(const CellIteratorType        &cell,
+                             std::vector<CellIteratorType> &cells)
+    {
+      if (cell->has_children())
+        for (unsigned int c = 0; c < cell->n_children(); ++c)
+          collect_cells_in_z_order<dim>(cell->child(c), cells);
+      else if (cell->is_locally_owned())
+        cells.push_back(cell);
+    }
+  } // namespace
+
+
+
+  template <int dim, int spacedim>
+  void
+  space_filling_curve_blocks(DoFHandler<dim, spacedim> &dof_handler,
+                             const std::size_t          block_size_in_bytes,
+                             const unsigned int         bytes_per_dof)
+  {
+    std::vector<types::global_dof_index> renumbering;
+    compute_space_filling_curve_blocks(renumbering,
+                                       dof_handler,
+                                       block_size_in_bytes,
+                                       bytes_per_dof);
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  compute_space_filling_curve_blocks(
+    std::vector<types::global_dof_index> &new_dof_indices,
+    const DoFHandler<dim, spacedim>      &dof_handler,
+    const std::size_t                     block_size_in_bytes,
+    const unsigned int                    bytes_per_dof)
+  {
+    Assert(dof_handler.has_active_dofs(), ExcDoFHandlerNotInitialized());
+    Assert(bytes_per_dof > 0,
+           ExcMessage("The number of bytes per DoF must be positive."));
+
+    using CellIterator = typename DoFHandler<dim, spacedim>::cell_iterator;
+
+    // Summary of the algorithm below:
+    // (a) collect the locally owned cells in Z order, traversing the coarse
+    //     cells in the order of p4est for distributed triangulations as in
+    //     hierarchical()
+    // (b) split the cells into blocks touching at most max_dofs_per_block
+    //     DoFs, and record the first and last block touching each locally
+    //     owned DoF as well as the order in which DoFs are first touched
+    // (c) determine the MPI processes importing each locally owned DoF
+    // (d) sort the DoFs not imported by other processes by their blocks,
+    //     followed by the imported ones grouped by the importing processes
+    std::vector<CellIterator> cells;
+    if (const parallel::distributed::Triangulation<dim, spacedim> *tria =
+          dynamic_cast<const parallel::distributed::Triangulation<dim, spacedim>
+                         *>(&dof_handler.get_triangulation()))
+      {
+#ifdef DEAL_II_WITH_P4EST
+        for (unsigned int c = 0; c < tria->n_cells(0); ++c)
+          collect_cells_in_z_order<dim>(
+            CellIterator(tria,
+                         0,
+                         tria->get_p4est_tree_to_coarse_cell_permutation()[c],
+                         &dof_handler),
+            cells);
+#else
+        Assert(false, ExcNotImplemented());
+#endif
+      }
+    else
+      for (const auto &cell : dof_handler.cell_iterators_on_level(0))
+        collect_cells_in_z_order<dim>(cell, cells);
+
+    const IndexSet &owned_dofs = dof_handler.locally_owned_dofs();
+    const IndexSet  active_dofs =
+      DoFTools::extract_locally_active_dofs(dof_handler);
+    const unsigned int n_owned_dofs = owned_dofs.n_elements();
+
+    const std::size_t max_dofs_per_block =
+      std::max<std::size_t>(1, block_size_in_bytes / bytes_per_dof);
+
+    std::vector<unsigned int> first_touch(n_owned_dofs,
+                                          numbers::invalid_unsigned_int);
+    std::vector<unsigned int> first_block(n_owned_dofs,
+                                          numbers::invalid_unsigned_int);
+    std::vector<unsigned int> last_block(n_owned_dofs,
+                                         numbers::invalid_unsigned_int);
+    std::vector<unsigned int> last_block_of_active_dof(
+      active_dofs.n_elements(), numbers::invalid_unsigned_int);
+
+    unsigned int                         n_touched_dofs  = 0;
+    unsigned int                         block           = 0;
+    std::size_t                          n_dofs_in_block = 0;
+    std::vector<types::global_dof_index> dof_indices;
+    for (const CellIterator &cell : cells)
+      {
+        dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+        cell->get_dof_indices(dof_indices);
+
+        // start a new block if the DoFs of this cell not yet part of the
+        // current block would exceed the size of the block
+        unsigned int n_new_dofs = 0;
+        for (const types::global_dof_index dof_index : dof_indices)
+          if (last_block_of_active_dof[active_dofs.index_within_set(
+                dof_index)] != block)
+            ++n_new_dofs;
+        if (n_dofs_in_block > 0 &&
+            n_dofs_in_block + n_new_dofs > max_dofs_per_block)
+          {
+            ++block;
+            n_dofs_in_block = 0;
+          }
+
+        for (const types::global_dof_index dof_index : dof_indices)
+          {
+            unsigned int &last_block_of_dof =
+              last_block_of_active_dof[active_dofs.index_within_set(
+                dof_index)];
+            if (last_block_of_dof != block)
+              {
+                last_block_of_dof = block;
+                ++n_dofs_in_block;
+              }
+
+            const types::global_dof_index local_index =
+              owned_dofs.index_within_set(dof_index);
+            if (local_index != numbers::invalid_dof_index)
+              {
+                if (first_touch[local_index] == numbers::invalid_unsigned_int)
+                  {
+                    first_touch[local_index] = n_touched_dofs++;
+                    first_block[local_index] = block;
+                  }
+                last_block[local_index] = block;
+              }
+          }
+      }
+
+    // group 0 holds the DoFs not imported by other processes, the other
+    // groups the DoFs imported by a particular set of processes
+    std::vector<unsigned int> group(n_owned_dofs, 0);
+    if (dynamic_cast<const parallel::TriangulationBase<dim, spacedim> *>(
+          &dof_handler.get_triangulation()) != nullptr)
+      {
+        const Utilities::MPI::Partitioner partitioner(
+          owned_dofs, active_dofs, dof_handler.get_communicator());
+        const std::vector<std::vector<unsigned int>> dofs_by_rank_access =
+          group_dofs_by_rank_access(partitioner);
+        for (unsigned int g = 1; g < dofs_by_rank_access.size(); ++g)
+          for (const unsigned int i : dofs_by_rank_access[g])
+            group[i] = g;
+      }
+
+    // DoFs not touched by any locally owned cell, which should not happen
+    // for the usual DoF distribution, are kept at the end of group 0 in
+    // their original order by the stable sort
+    const auto sort_key = [&](const unsigned int i) {
+      if (group[i] == 0)
+        return std::make_tuple(0U,
+                               first_block[i],
+                               last_block[i] != first_block[i],
+                               first_touch[i]);
+      else
+        return std::make_tuple(group[i], 0U, false, first_touch[i]);
+    };
+    std::vector<unsigned int> new_order(n_owned_dofs);
+    std::iota(new_order.begin(), new_order.end(), 0U);
+    std::stable_sort(new_order.begin(),
+                     new_order.end(),
+                     [&](const unsigned int a, const unsigned int b) {
+                       return sort_key(a) < sort_key(b);
+                     });
+
+    new_dof_indices.resize(n_owned_dofs);
+    for (unsigned int i = 0; i < n_owned_dofs; ++i)
+      new_dof_indices[new_order[i]] = owned_dofs.nth_index_in_set(i);
+  }
+
 } // namespace DoFRenumbering
 
 
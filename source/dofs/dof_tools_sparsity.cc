@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
@@ -40,10 +41,12 @@
 #include <deal.II/hp/q_collection.h>
 
 #include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparsity_pattern_base.h>
 #include <deal.II/lac/vector.h>
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 DEAL_II_NAMESPACE_OPEN
@@ -109,6 +112,186 @@ namespace DoFTools
 
 
 
+  namespace internal
+  {
+    namespace
+    {
+      /**
+       * A sparsity pattern that does not store any entries, but hands the
+       * entries of each row added to it on to a function object. This
+       * allows to observe the entries generated by
+       * AffineConstraints::add_entries_local_to_global().
+       */
+      template <typename FunctionType>
+      class SparsityPatternForwarder : public SparsityPatternBase
+      {
+      public:
+        SparsityPatternForwarder(const size_type     n_dofs,
+                                 const FunctionType &add_row_entries)
+          : SparsityPatternBase(n_dofs, n_dofs)
+          , function(add_row_entries)
+        {}
+
+        using SparsityPatternBase::add_row_entries;
+
+        virtual void
+        add_row_entries(const size_type                  &row,
+                        const ArrayView<const size_type> &columns,
+                        const bool indices_are_sorted = false) override
+        {
+          (void)indices_are_sorted;
+          function(row, columns);
+        }
+
+      private:
+        const FunctionType &function;
+      };
+    } // namespace
+  }   // namespace internal
+
+
+
+  template <int dim, int spacedim, typename number>
+  void
+  make_compressed_sparsity_pattern(const DoFHandler<dim, spacedim> &dof,
+                                   SparsityPattern                 &sparsity,
+                                   const AffineConstraints<number> &constraints,
+                                   const bool keep_constrained_dofs,
+                                   const types::subdomain_id subdomain_id)
+  {
+    using size_type                      = SparsityPattern::size_type;
+    const types::global_dof_index n_dofs = dof.n_dofs();
+
+    // If we have a distributed Triangulation only allow locally_owned
+    // subdomain, as in make_sparsity_pattern() above
+    if (const auto *triangulation = dynamic_cast<
+          const parallel::DistributedTriangulationBase<dim, spacedim> *>(
+          &dof.get_triangulation()))
+      {
+        Assert((subdomain_id == numbers::invalid_subdomain_id) ||
+                 (subdomain_id == triangulation->locally_owned_subdomain()),
+               ExcMessage(
+                 "For distributed Triangulation objects and associated "
+                 "DoFHandler objects, asking for any subdomain other than the "
+                 "locally owned one does not make sense."));
+      }
+
+    std::vector<typename DoFHandler<dim, spacedim>::active_cell_iterator>
+      cells;
+    for (const auto &cell : dof.active_cell_iterators())
+      if (((subdomain_id == numbers::invalid_subdomain_id) ||
+           (subdomain_id == cell->subdomain_id())) &&
+          cell->is_locally_owned())
+        cells.push_back(cell);
+
+    // run AffineConstraints::add_entries_local_to_global() on all cells in
+    // parallel and pass the generated entries to the given function, which
+    // must be safe to call concurrently
+    const unsigned int cell_grain_size = 64;
+    const unsigned int row_grain_size =
+      dealii::internal::SparseMatrixImplementation::minimum_parallel_grain_size;
+    const auto         loop_over_cells = [&](const auto &add_row_entries) {
+      parallel::apply_to_subranges(
+        std::size_t(0),
+        cells.size(),
+        [&](const std::size_t begin, const std::size_t end) {
+          internal::SparsityPatternForwarder<
+            std::remove_reference_t<decltype(add_row_entries)>>
+            forwarder(n_dofs, add_row_entries);
+          std::vector<types::global_dof_index> dofs_on_this_cell;
+          for (std::size_t c = begin; c < end; ++c)
+            {
+              dofs_on_this_cell.resize(cells[c]->get_fe().n_dofs_per_cell());
+              cells[c]->get_dof_indices(dofs_on_this_cell);
+              constraints.add_entries_local_to_global(dofs_on_this_cell,
+                                                      forwarder,
+                                                      keep_constrained_dofs);
+            }
+        },
+        cell_grain_size);
+    };
+
+    // first pass: count the entries of each row, including duplicates
+    // generated by several cells
+    std::vector<std::atomic<std::size_t>> row_counters(n_dofs);
+    loop_over_cells(
+      [&](const size_type row, const ArrayView<const size_type> &columns) {
+        row_counters[row].fetch_add(columns.size(), std::memory_order_relaxed);
+      });
+
+    // reserve one more slot in each row for the diagonal entry, which a
+    // SparsityPattern always stores for square matrices
+    std::vector<std::size_t> row_start(n_dofs + 1);
+    row_start[0] = 0;
+    for (types::global_dof_index row = 0; row < n_dofs; ++row)
+      row_start[row + 1] = row_start[row] + 1 + row_counters[row].load();
+
+    std::unique_ptr<size_type[]> entries(new size_type[row_start[n_dofs]]);
+    parallel::apply_to_subranges(
+      types::global_dof_index(0),
+      n_dofs,
+      [&](const types::global_dof_index begin,
+          const types::global_dof_index end) {
+        for (types::global_dof_index row = begin; row < end; ++row)
+          {
+            entries[row_start[row]] = row;
+            row_counters[row].store(row_start[row] + 1,
+                                    std::memory_order_relaxed);
+          }
+      },
+      row_grain_size);
+
+    // second pass: write the entries into the slots of the rows, now using
+    // the counters as the position of the next free slot
+    loop_over_cells(
+      [&](const size_type row, const ArrayView<const size_type> &columns) {
+        const std::size_t position =
+          row_counters[row].fetch_add(columns.size(),
+                                      std::memory_order_relaxed);
+        std::copy(columns.begin(), columns.end(), &entries[position]);
+      });
+    std::vector<std::atomic<std::size_t>>().swap(row_counters);
+
+    // remove the duplicates within each row
+    std::vector<unsigned int> row_lengths(n_dofs);
+    parallel::apply_to_subranges(
+      types::global_dof_index(0),
+      n_dofs,
+      [&](const types::global_dof_index begin,
+          const types::global_dof_index end) {
+        for (types::global_dof_index row = begin; row < end; ++row)
+          {
+            size_type *const row_begin = &entries[row_start[row]];
+            size_type *const row_end   = &entries[row_start[row + 1]];
+            std::sort(row_begin, row_end);
+            row_lengths[row] = std::unique(row_begin, row_end) - row_begin;
+          }
+      },
+      row_grain_size);
+
+    // finally copy the rows into the sparsity pattern, whose rows have
+    // exactly the right length
+    sparsity.reinit(n_dofs, n_dofs, row_lengths);
+    parallel::apply_to_subranges(
+      types::global_dof_index(0),
+      n_dofs,
+      [&](const types::global_dof_index begin,
+          const types::global_dof_index end) {
+        for (types::global_dof_index row = begin; row < end; ++row)
+          sparsity.add_row_entries(
+            row,
+            make_array_view(&entries[row_start[row]],
+                            &entries[row_start[row]] + row_lengths[row]),
+            true);
+      },
+      row_grain_size);
+    entries.reset();
+
+    sparsity.compress();
+  }
+
+
+
   template <int dim, int spacedim, typename number>
   void
   make_sparsity_pattern(const DoFHandler<dim, spacedim> &dof,
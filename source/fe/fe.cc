@@ -29,8 +29,10 @@
 
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include <numeric>
 #include <typeinfo>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -1399,6 +1401,94 @@ FiniteElement<dim, spacedim>::get_subface_data(
 
 
 
+template <int dim, int spacedim>
+bool
+FiniteElement<dim, spacedim>::internal_data_is_shareable() const
+{
+  return false;
+}
+
+
+
+template <int dim, int spacedim>
+std::shared_ptr<const typename FiniteElement<dim, spacedim>::InternalDataBase>
+FiniteElement<dim, spacedim>::get_shared_data(
+  const UpdateFlags             flags,
+  const Mapping<dim, spacedim> &mapping,
+  const Quadrature<dim>        &quadrature,
+  dealii::internal::FEValuesImplementation::FiniteElementRelatedData<dim,
+                                                                     spacedim>
+    &output_data) const
+{
+  if (internal_data_is_shareable() == false)
+    return get_data(flags, mapping, quadrature, output_data);
+
+  // the data shared between the callers, together with the information
+  // get_data() has written into the output object
+  struct SharedData
+  {
+    std::unique_ptr<const InternalDataBase> fe_data;
+    dealii::internal::FEValuesImplementation::
+      FiniteElementRelatedData<dim, spacedim>
+        output_data;
+  };
+
+  // the cache only holds weak pointers, so the data is released as soon as
+  // the last FEValues object using it goes out of scope. FEValues subscribes
+  // to both the finite element and the mapping, so neither of them can be
+  // destroyed, and their address be reused by another object, while an
+  // entry of the cache is alive
+  struct CacheEntry
+  {
+    const FiniteElement<dim, spacedim> *fe;
+    const Mapping<dim, spacedim>       *mapping;
+    UpdateFlags                         flags;
+    Quadrature<dim>                     quadrature;
+    std::weak_ptr<const SharedData>     data;
+  };
+  static std::mutex              cache_mutex;
+  static std::vector<CacheEntry> cache;
+
+  const auto matches = [&](const CacheEntry &entry) {
+    return entry.fe == this && entry.mapping == &mapping &&
+           entry.flags == flags && entry.quadrature == quadrature;
+  };
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    for (const CacheEntry &entry : cache)
+      if (matches(entry))
+        if (const std::shared_ptr<const SharedData> data = entry.data.lock())
+          {
+            output_data = data->output_data;
+            return std::shared_ptr<const InternalDataBase>(data,
+                                                           data->fe_data.get());
+          }
+  }
+
+  // compute the data outside the lock, as it is the expensive part and
+  // the get_data() function of an element might itself ask other elements
+  // for their shared data
+  auto data         = std::make_shared<SharedData>();
+  data->fe_data     = get_data(flags, mapping, quadrature, output_data);
+  data->output_data = output_data;
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.erase(std::remove_if(cache.begin(),
+                               cache.end(),
+                               [](const CacheEntry &entry) {
+                                 return entry.data.expired();
+                               }),
+                cache.end());
+    cache.push_back({this, &mapping, flags, quadrature, data});
+  }
+
+  return std::shared_ptr<const InternalDataBase>(data, data->fe_data.get());
+}
+
+
+
 template <int dim, int spacedim>
 const FiniteElement<dim, spacedim> &
 FiniteElement<dim, spacedim>::base_element(const unsigned int index) const
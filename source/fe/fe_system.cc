@@ -253,7 +253,7 @@ FESystem<dim, spacedim>::InternalData::~InternalData()
 
 
 template <int dim, int spacedim>
-typename FiniteElement<dim, spacedim>::InternalDataBase &
+const typename FiniteElement<dim, spacedim>::InternalDataBase &
 FESystem<dim, spacedim>::InternalData::get_fe_data(
   const unsigned int base_no) const
 {
@@ -267,7 +267,8 @@ template <int dim, int spacedim>
 void
 FESystem<dim, spacedim>::InternalData::set_fe_data(
   const unsigned int base_no,
-  std::unique_ptr<typename FiniteElement<dim, spacedim>::InternalDataBase> ptr)
+  std::shared_ptr<const typename FiniteElement<dim, spacedim>::InternalDataBase>
+    ptr)
 {
   AssertIndexRange(base_no, base_fe_datas.size());
   base_fe_datas[base_no] = std::move(ptr);
@@ -1132,11 +1133,14 @@ FESystem<dim, spacedim>::get_data(
       // for them; it would be nice if we could already copy something
       // out of the base output object into the system output object,
       // but we can't because we can't know what the elements already
-      // copied and/or will want to update on every cell
-      auto base_fe_data = base_element(base_no).get_data(flags,
-                                                         mapping,
-                                                         quadrature,
-                                                         base_fe_output_object);
+      // copied and/or will want to update on every cell. the data of
+      // the base elements only depends on the reference cell and can
+      // often be shared with other FEValues objects
+      auto base_fe_data =
+        base_element(base_no).get_shared_data(flags,
+                                              mapping,
+                                              quadrature,
+                                              base_fe_output_object);
 
       data.set_fe_data(base_no, std::move(base_fe_data));
     }
@@ -1402,8 +1406,8 @@ FESystem<dim, spacedim>::compute_fill(
     for (unsigned int base_no = 0; base_no < this->n_base_elements(); ++base_no)
       {
         const FiniteElement<dim, spacedim> &base_fe = base_element(base_no);
-        typename FiniteElement<dim, spacedim>::InternalDataBase &base_fe_data =
-          fe_data.get_fe_data(base_no);
+        const typename FiniteElement<dim, spacedim>::InternalDataBase
+          &base_fe_data = fe_data.get_fe_data(base_no);
         internal::FEValuesImplementation::FiniteElementRelatedData<dim,
                                                                    spacedim>
           &base_data = fe_data.get_fe_output_object(base_no);
@@ -34,6 +34,8 @@
 
 #include <deal.II/lac/vector.h>
 
+#include <deal.II/matrix_free/shape_info.h>
+
 #include <boost/container/small_vector.hpp>
 
 #include <iomanip>
@@ -239,14 +241,17 @@ FEValues<dim, spacedim>::initialize(const UpdateFlags update_flags)
                                          flags);
 
   // then get objects into which the FE and the Mapping can store
-  // intermediate data used across calls to reinit. we can do this in parallel
-  Threads::Task<
-    std::unique_ptr<typename FiniteElement<dim, spacedim>::InternalDataBase>>
+  // intermediate data used across calls to reinit. we can do this in
+  // parallel. the data of the FE only depends on the reference cell and can
+  // often be shared with other FEValues objects, e.g., the copies of the
+  // scratch data on the different threads of a WorkStream loop
+  Threads::Task<std::shared_ptr<
+    const typename FiniteElement<dim, spacedim>::InternalDataBase>>
     fe_get_data = Threads::new_task([&]() {
-      return this->fe->get_data(flags,
-                                *this->mapping,
-                                quadrature,
-                                this->finite_element_output);
+      return this->fe->get_shared_data(flags,
+                                       *this->mapping,
+                                       quadrature,
+                                       this->finite_element_output);
     });
 
   Threads::Task<
@@ -362,12 +367,84 @@ FEValues<dim, spacedim>::do_reinit()
 
 
 
+template <int dim, int spacedim>
+void
+FEValues<dim, spacedim>::enable_sum_factorization(const bool enable)
+{
+  this->tensor_product_shape_info.reset();
+  if (enable == false)
+    return;
+
+  // the shape data of the matrix-free framework is only available for
+  // dim==spacedim
+  if constexpr (dim == spacedim)
+    {
+      using namespace internal::MatrixFreeFunctions;
+
+      const FiniteElement<dim> &fe = *this->fe;
+      if (fe.reference_cell().is_hyper_cube() == false ||
+          fe.n_base_elements() != 1 || fe.n_dofs_per_cell() == 0 ||
+          quadrature.is_tensor_product() == false ||
+          ShapeInfo<double>::is_supported(fe) == false)
+        return;
+
+      // exclude elements whose shape functions are rescaled on each cell in
+      // fill_fe_values(), like FE_Hermite, since the univariate shape data
+      // only describes the shape functions on the unit cell
+      if (fe.requires_update_flags(update_values | update_gradients) &
+          update_rescale)
+        return;
+
+      // ShapeInfo describes all coordinate directions by the same
+      // one-dimensional data
+      const auto &quadrature_1d = quadrature.get_tensor_basis();
+      for (unsigned int d = 1; d < dim; ++d)
+        if (!(quadrature_1d[d] == quadrature_1d[0]))
+          return;
+
+      auto shape_info =
+        std::make_shared<ShapeInfo<double>>(quadrature_1d[0], fe);
+
+      // exclude elements that are not a full tensor product of the
+      // univariate shape functions, like FE_DGP or FE_Q_DG0
+      const UnivariateShapeData<double> &shape_data = shape_info->data.front();
+      if (shape_info->element_type > tensor_general ||
+          shape_info->element_type == truncated_tensor ||
+          Utilities::pow(shape_data.fe_degree + 1, dim) !=
+            fe.base_element(0).n_dofs_per_cell() ||
+          Utilities::pow(shape_data.n_q_points_1d, dim) != quadrature.size())
+        return;
+
+      // the gradients in real space are computed from the gradients on the
+      // unit cell with the inverse Jacobians of the mapping
+      if ((this->update_flags & update_gradients) &&
+          !(this->update_flags & update_inverse_jacobians))
+        initialize(this->update_flags | update_inverse_jacobians);
+
+      this->tensor_product_shape_info = std::move(shape_info);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+bool
+FEValues<dim, spacedim>::uses_sum_factorization() const
+{
+  return this->tensor_product_shape_info != nullptr;
+}
+
+
+
 template <int dim, int spacedim>
 std::size_t
 FEValues<dim, spacedim>::memory_consumption() const
 {
   return (FEValuesBase<dim, spacedim>::memory_consumption() +
-          MemoryConsumption::memory_consumption(quadrature));
+          MemoryConsumption::memory_consumption(quadrature) +
+          (this->tensor_product_shape_info != nullptr ?
+             this->tensor_product_shape_info->memory_consumption() :
+             0));
 }
 
 #endif
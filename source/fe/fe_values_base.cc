@@ -34,6 +34,9 @@
 
 #include <deal.II/lac/vector.h>
 
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+
 #include <boost/container/small_vector.hpp>
 
 #include <iomanip>
@@ -711,6 +714,181 @@ namespace internal
               }
         }
   }
+
+
+
+  // The sum-factorization kernels of the matrix-free framework multiply the
+  // double-valued univariate shape data with the coefficients, which works
+  // for coefficients that are real or complex numbers based on double
+  template <typename Number>
+  constexpr bool use_sum_factorization_for_number_type =
+    std::is_same_v<typename numbers::NumberTraits<Number>::real_type, double>;
+
+
+
+  // Return whether the values and gradients of a finite element function
+  // with coefficients of type Number are computed with sum factorization,
+  // i.e., whether the FEValues object has been set up for it and the number
+  // type is supported
+  template <typename Number>
+  bool
+  use_sum_factorization(
+    const MatrixFreeFunctions::ShapeInfo<double> *shape_info)
+  {
+    return use_sum_factorization_for_number_type<Number> &&
+           shape_info != nullptr;
+  }
+
+
+
+  // Evaluate the values and gradients of all components of a finite element
+  // function in the quadrature points of a tensor-product element with sum
+  // factorization, using the kernels of the matrix-free framework. The
+  // results are stored with the component as the slowest running index,
+  // i.e., in values[c * n_quadrature_points + q], and either of the two
+  // output arrays may be a null pointer if the respective quantity is not
+  // needed. The gradients on the unit cell are transformed to real space
+  // with the inverse Jacobians of the mapping.
+  template <int dim, int spacedim, typename Number>
+  void
+  do_function_values_sum_factorization(
+    const MatrixFreeFunctions::ShapeInfo<double>        &shape_info,
+    const ArrayView<const Number>                       &dof_values,
+    const std::vector<DerivativeForm<1, spacedim, dim>> &inverse_jacobians,
+    Number                                              *values,
+    Tensor<1, spacedim, Number>                         *gradients)
+  {
+    if constexpr (use_sum_factorization_for_number_type<Number>)
+      {
+        const MatrixFreeFunctions::UnivariateShapeData<double> &shape_data =
+          shape_info.data.front();
+        const unsigned int n_rows    = shape_data.fe_degree + 1;
+        const unsigned int n_columns = shape_data.n_q_points_1d;
+        const unsigned int dofs_per_component =
+          Utilities::fixed_power<dim>(n_rows);
+        const unsigned int n_quadrature_points =
+          Utilities::fixed_power<dim>(n_columns);
+        AssertDimension(dof_values.size(),
+                        dofs_per_component * shape_info.n_components);
+        Assert(gradients == nullptr ||
+                 inverse_jacobians.size() >= n_quadrature_points,
+               ExcInternalError());
+
+        EvaluatorTensorProduct<evaluate_general, dim, 0, 0, Number, double>
+          eval(shape_data.shape_values,
+               shape_data.shape_gradients,
+               shape_data.shape_hessians,
+               n_rows,
+               n_columns);
+
+        // storage for the coefficients of one component in lexicographic
+        // order, for the two intermediate results of the sweeps through the
+        // coordinate directions, and for the gradients on the unit cell
+        const unsigned int temp_size =
+          Utilities::fixed_power<dim>(std::max(n_rows, n_columns));
+        boost::container::small_vector<Number, 200> scratch(
+          dofs_per_component + 2 * temp_size + dim * n_quadrature_points);
+        Number *dofs_lexicographic = scratch.data();
+        Number *temp1              = dofs_lexicographic + dofs_per_component;
+        Number *temp2              = temp1 + temp_size;
+        Number *unit_gradients     = temp2 + temp_size;
+
+        for (unsigned int c = 0; c < shape_info.n_components; ++c)
+          {
+            for (unsigned int i = 0; i < dofs_per_component; ++i)
+              dofs_lexicographic[i] =
+                dof_values[shape_info.lexicographic_numbering
+                             [c * dofs_per_component + i]];
+
+            Number *values_c =
+              (values != nullptr ? values + c * n_quadrature_points : nullptr);
+
+            if (gradients == nullptr)
+              {
+                if constexpr (dim == 1)
+                  eval.template values<0, true, false>(dofs_lexicographic,
+                                                       values_c);
+                else if constexpr (dim == 2)
+                  {
+                    eval.template values<0, true, false>(dofs_lexicographic,
+                                                         temp1);
+                    eval.template values<1, true, false>(temp1, values_c);
+                  }
+                else if constexpr (dim == 3)
+                  {
+                    eval.template values<0, true, false>(dofs_lexicographic,
+                                                         temp1);
+                    eval.template values<1, true, false>(temp1, temp2);
+                    eval.template values<2, true, false>(temp2, values_c);
+                  }
+                continue;
+              }
+
+            // compute the derivative in direction d by applying the
+            // univariate gradient matrix in direction d and the value
+            // matrix in all other directions, reusing the partial sums
+            // between the directions as in FEEvaluation
+            if constexpr (dim == 1)
+              {
+                eval.template gradients<0, true, false>(dofs_lexicographic,
+                                                        unit_gradients);
+                if (values_c != nullptr)
+                  eval.template values<0, true, false>(dofs_lexicographic,
+                                                       values_c);
+              }
+            else if constexpr (dim == 2)
+              {
+                eval.template gradients<0, true, false>(dofs_lexicographic,
+                                                        temp1);
+                eval.template values<1, true, false>(temp1, unit_gradients);
+                eval.template values<0, true, false>(dofs_lexicographic,
+                                                     temp1);
+                eval.template gradients<1, true, false>(
+                  temp1, unit_gradients + n_quadrature_points);
+                if (values_c != nullptr)
+                  eval.template values<1, true, false>(temp1, values_c);
+              }
+            else if constexpr (dim == 3)
+              {
+                eval.template gradients<0, true, false>(dofs_lexicographic,
+                                                        temp1);
+                eval.template values<1, true, false>(temp1, temp2);
+                eval.template values<2, true, false>(temp2, unit_gradients);
+                eval.template values<0, true, false>(dofs_lexicographic,
+                                                     temp1);
+                eval.template gradients<1, true, false>(temp1, temp2);
+                eval.template values<2, true, false>(
+                  temp2, unit_gradients + n_quadrature_points);
+                eval.template values<1, true, false>(temp1, temp2);
+                eval.template gradients<2, true, false>(
+                  temp2, unit_gradients + 2 * n_quadrature_points);
+                if (values_c != nullptr)
+                  eval.template values<2, true, false>(temp2, values_c);
+              }
+
+            Tensor<1, spacedim, Number> *gradients_c =
+              gradients + c * n_quadrature_points;
+            for (unsigned int q = 0; q < n_quadrature_points; ++q)
+              {
+                Tensor<1, spacedim, Number> gradient;
+                for (unsigned int e = 0; e < dim; ++e)
+                  for (unsigned int d = 0; d < spacedim; ++d)
+                    gradient[d] += inverse_jacobians[q][e][d] *
+                                   unit_gradients[e * n_quadrature_points + q];
+                gradients_c[q] = gradient;
+              }
+          }
+      }
+    else
+      {
+        (void)shape_info;
+        (void)dof_values;
+        (void)inverse_jacobians;
+        (void)values;
+        (void)gradients;
+        Assert(false, ExcInternalError());
+      }
+  }
 } // namespace internal
 
 
@@ -731,10 +909,21 @@ FEValuesBase<dim, spacedim>::get_function_values(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell.get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_values(make_array_view(dof_values.begin(),
-                                               dof_values.end()),
-                               this->finite_element_output.shape_values,
-                               values);
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(values.size(), n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        make_array_view(dof_values.begin(), dof_values.end()),
+        this->mapping_output.inverse_jacobians,
+        values.data(),
+        nullptr);
+    }
+  else
+    internal::do_function_values(make_array_view(dof_values.begin(),
+                                                 dof_values.end()),
+                                 this->finite_element_output.shape_values,
+                                 values);
 }
 
 
@@ -755,9 +944,20 @@ FEValuesBase<dim, spacedim>::get_function_values(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   auto view = make_array_view(dof_values.begin(), dof_values.end());
   fe_function.extract_subvector_to(indices, view);
-  internal::do_function_values(view,
-                               this->finite_element_output.shape_values,
-                               values);
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(values.size(), n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        view,
+        this->mapping_output.inverse_jacobians,
+        values.data(),
+        nullptr);
+    }
+  else
+    internal::do_function_values(view,
+                                 this->finite_element_output.shape_values,
+                                 values);
 }
 
 
@@ -778,12 +978,32 @@ FEValuesBase<dim, spacedim>::get_function_values(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell.get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_values(
-    make_array_view(dof_values.begin(), dof_values.end()),
-    this->finite_element_output.shape_values,
-    *fe,
-    this->finite_element_output.shape_function_to_row_table,
-    make_array_view(values.begin(), values.end()));
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(values.size(), n_quadrature_points);
+      const unsigned int n_components = fe->n_components();
+      boost::container::small_vector<Number, 200> values_by_component(
+        n_components * n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        make_array_view(dof_values.begin(), dof_values.end()),
+        this->mapping_output.inverse_jacobians,
+        values_by_component.data(),
+        nullptr);
+      for (unsigned int q = 0; q < n_quadrature_points; ++q)
+        {
+          AssertDimension(values[q].size(), n_components);
+          for (unsigned int c = 0; c < n_components; ++c)
+            values[q][c] = values_by_component[c * n_quadrature_points + q];
+        }
+    }
+  else
+    internal::do_function_values(
+      make_array_view(dof_values.begin(), dof_values.end()),
+      this->finite_element_output.shape_values,
+      *fe,
+      this->finite_element_output.shape_function_to_row_table,
+      make_array_view(values.begin(), values.end()));
 }
 
 
@@ -806,14 +1026,36 @@ FEValuesBase<dim, spacedim>::get_function_values(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   auto view = make_array_view(dof_values.begin(), dof_values.end());
   fe_function.extract_subvector_to(indices, view);
-  internal::do_function_values(
-    view,
-    this->finite_element_output.shape_values,
-    *fe,
-    this->finite_element_output.shape_function_to_row_table,
-    make_array_view(values.begin(), values.end()),
-    false,
-    indices.size() / dofs_per_cell);
+  if (internal::use_sum_factorization<Number>(
+        tensor_product_shape_info.get()) &&
+      indices.size() == dofs_per_cell)
+    {
+      AssertDimension(values.size(), n_quadrature_points);
+      const unsigned int n_components = fe->n_components();
+      boost::container::small_vector<Number, 200> values_by_component(
+        n_components * n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        view,
+        this->mapping_output.inverse_jacobians,
+        values_by_component.data(),
+        nullptr);
+      for (unsigned int q = 0; q < n_quadrature_points; ++q)
+        {
+          AssertDimension(values[q].size(), n_components);
+          for (unsigned int c = 0; c < n_components; ++c)
+            values[q][c] = values_by_component[c * n_quadrature_points + q];
+        }
+    }
+  else
+    internal::do_function_values(
+      view,
+      this->finite_element_output.shape_values,
+      *fe,
+      this->finite_element_output.shape_function_to_row_table,
+      make_array_view(values.begin(), values.end()),
+      false,
+      indices.size() / dofs_per_cell);
 }
 
 
@@ -838,14 +1080,49 @@ FEValuesBase<dim, spacedim>::get_function_values(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   auto view = make_array_view(dof_values.begin(), dof_values.end());
   fe_function.extract_subvector_to(indices, view);
-  internal::do_function_values(
-    view,
-    this->finite_element_output.shape_values,
-    *fe,
-    this->finite_element_output.shape_function_to_row_table,
-    make_array_view(values.begin(), values.end()),
-    quadrature_points_fastest,
-    indices.size() / dofs_per_cell);
+  if (internal::use_sum_factorization<Number>(
+        tensor_product_shape_info.get()) &&
+      indices.size() == dofs_per_cell)
+    {
+      const unsigned int n_components = fe->n_components();
+      boost::container::small_vector<Number, 200> values_by_component(
+        n_components * n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        view,
+        this->mapping_output.inverse_jacobians,
+        values_by_component.data(),
+        nullptr);
+      if (quadrature_points_fastest)
+        {
+          AssertDimension(values.size(), n_components);
+          for (unsigned int c = 0; c < n_components; ++c)
+            {
+              AssertDimension(values[c].size(), n_quadrature_points);
+              for (unsigned int q = 0; q < n_quadrature_points; ++q)
+                values[c][q] = values_by_component[c * n_quadrature_points + q];
+            }
+        }
+      else
+        {
+          AssertDimension(values.size(), n_quadrature_points);
+          for (unsigned int q = 0; q < n_quadrature_points; ++q)
+            {
+              AssertDimension(values[q].size(), n_components);
+              for (unsigned int c = 0; c < n_components; ++c)
+                values[q][c] = values_by_component[c * n_quadrature_points + q];
+            }
+        }
+    }
+  else
+    internal::do_function_values(
+      view,
+      this->finite_element_output.shape_values,
+      *fe,
+      this->finite_element_output.shape_function_to_row_table,
+      make_array_view(values.begin(), values.end()),
+      quadrature_points_fastest,
+      indices.size() / dofs_per_cell);
 }
 
 
@@ -866,10 +1143,21 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell.get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(make_array_view(dof_values.begin(),
-                                                    dof_values.end()),
-                                    this->finite_element_output.shape_gradients,
-                                    gradients);
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(gradients.size(), n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        make_array_view(dof_values.begin(), dof_values.end()),
+        this->mapping_output.inverse_jacobians,
+        nullptr,
+        gradients.data());
+    }
+  else
+    internal::do_function_derivatives(
+      make_array_view(dof_values.begin(), dof_values.end()),
+      this->finite_element_output.shape_gradients,
+      gradients);
 }
 
 
@@ -890,9 +1178,19 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   auto view = make_array_view(dof_values.begin(), dof_values.end());
   fe_function.extract_subvector_to(indices, view);
-  internal::do_function_derivatives(view,
-                                    this->finite_element_output.shape_gradients,
-                                    gradients);
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(gradients.size(), n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        view,
+        this->mapping_output.inverse_jacobians,
+        nullptr,
+        gradients.data());
+    }
+  else
+    internal::do_function_derivatives(
+      view, this->finite_element_output.shape_gradients, gradients);
 }
 
 
@@ -912,12 +1210,33 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   // get function values of dofs on this cell
   Vector<Number> dof_values(dofs_per_cell);
   present_cell.get_interpolated_dof_values(fe_function, dof_values);
-  internal::do_function_derivatives(
-    make_array_view(dof_values.begin(), dof_values.end()),
-    this->finite_element_output.shape_gradients,
-    *fe,
-    this->finite_element_output.shape_function_to_row_table,
-    make_array_view(gradients.begin(), gradients.end()));
+  if (internal::use_sum_factorization<Number>(tensor_product_shape_info.get()))
+    {
+      AssertDimension(gradients.size(), n_quadrature_points);
+      const unsigned int n_components = fe->n_components();
+      boost::container::small_vector<Tensor<1, spacedim, Number>, 200>
+        gradients_by_component(n_components * n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        make_array_view(dof_values.begin(), dof_values.end()),
+        this->mapping_output.inverse_jacobians,
+        nullptr,
+        gradients_by_component.data());
+      for (unsigned int q = 0; q < n_quadrature_points; ++q)
+        {
+          AssertDimension(gradients[q].size(), n_components);
+          for (unsigned int c = 0; c < n_components; ++c)
+            gradients[q][c] =
+              gradients_by_component[c * n_quadrature_points + q];
+        }
+    }
+  else
+    internal::do_function_derivatives(
+      make_array_view(dof_values.begin(), dof_values.end()),
+      this->finite_element_output.shape_gradients,
+      *fe,
+      this->finite_element_output.shape_function_to_row_table,
+      make_array_view(gradients.begin(), gradients.end()));
 }
 
 
@@ -941,14 +1260,51 @@ FEValuesBase<dim, spacedim>::get_function_gradients(
   boost::container::small_vector<Number, 200> dof_values(dofs_per_cell);
   auto view = make_array_view(dof_values.begin(), dof_values.end());
   fe_function.extract_subvector_to(indices, view);
-  internal::do_function_derivatives(
-    view,
-    this->finite_element_output.shape_gradients,
-    *fe,
-    this->finite_element_output.shape_function_to_row_table,
-    make_array_view(gradients.begin(), gradients.end()),
-    quadrature_points_fastest,
-    indices.size() / dofs_per_cell);
+  if (internal::use_sum_factorization<Number>(
+        tensor_product_shape_info.get()) &&
+      indices.size() == dofs_per_cell)
+    {
+      const unsigned int n_components = fe->n_components();
+      boost::container::small_vector<Tensor<1, spacedim, Number>, 200>
+        gradients_by_component(n_components * n_quadrature_points);
+      internal::do_function_values_sum_factorization<dim, spacedim, Number>(
+        *tensor_product_shape_info,
+        view,
+        this->mapping_output.inverse_jacobians,
+        nullptr,
+        gradients_by_component.data());
+      if (quadrature_points_fastest)
+        {
+          AssertDimension(gradients.size(), n_components);
+          for (unsigned int c = 0; c < n_components; ++c)
+            {
+              AssertDimension(gradients[c].size(), n_quadrature_points);
+              for (unsigned int q = 0; q < n_quadrature_points; ++q)
+                gradients[c][q] =
+                  gradients_by_component[c * n_quadrature_points + q];
+            }
+        }
+      else
+        {
+          AssertDimension(gradients.size(), n_quadrature_points);
+          for (unsigned int q = 0; q < n_quadrature_points; ++q)
+            {
+              AssertDimension(gradients[q].size(), n_components);
+              for (unsigned int c = 0; c < n_components; ++c)
+                gradients[q][c] =
+                  gradients_by_component[c * n_quadrature_points + q];
+            }
+        }
+    }
+  else
+    internal::do_function_derivatives(
+      view,
+      this->finite_element_output.shape_gradients,
+      *fe,
+      this->finite_element_output.shape_function_to_row_table,
+      make_array_view(gradients.begin(), gradients.end()),
+      quadrature_points_fastest,
+      indices.size() / dofs_per_cell);
 }
 
 
@@ -1412,6 +1768,26 @@ FEValuesBase<dim, spacedim>::maybe_invalidate_previous_present_cell(
 
 
 
+template <int dim, int spacedim>
+void
+FEValuesBase<dim, spacedim>::do_set_present_cell_keeping_data(
+  const CellIteratorContainer &cell)
+{
+  Assert(present_cell.is_initialized(), ExcNotReinited());
+  const typename Triangulation<dim, spacedim>::cell_iterator tria_cell = cell;
+  Assert(&tria_cell->get_triangulation() ==
+             &get_cell()->get_triangulation() &&
+           tria_cell == get_cell(),
+         ExcMessage("The data of this object can only be kept for the cell "
+                    "it was last initialized for."));
+
+  maybe_invalidate_previous_present_cell(tria_cell);
+  check_cell_similarity(tria_cell);
+  present_cell = cell;
+}
+
+
+
 template <int dim, int spacedim>
 inline void
 FEValuesBase<dim, spacedim>::check_cell_similarity(
@@ -1462,6 +1838,15 @@ FEValuesBase<dim, spacedim>::get_cell_similarity() const
 
 
 
+template <int dim, int spacedim>
+bool
+FEValuesBase<dim, spacedim>::has_present_cell() const
+{
+  return present_cell.is_initialized();
+}
+
+
+
 template <int dim, int spacedim>
 const unsigned int FEValuesBase<dim, spacedim>::dimension;
 
@@ -0,0 +1,264 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/reference_cell.h>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  namespace FEValuesBatchImplementation
+  {
+    UpdateFlags
+    compute_update_flags(const UpdateFlags update_flags)
+    {
+      UpdateFlags flags = update_flags;
+
+      // the gradients are computed from the inverse Jacobians and the JxW
+      // values from the Jacobians
+      if (flags & update_gradients)
+        flags |= update_inverse_jacobians;
+      if (flags & update_inverse_jacobians)
+        flags |= update_jacobians;
+      if (flags & update_JxW_values)
+        flags |= update_jacobians;
+
+      return flags;
+    }
+  } // namespace FEValuesBatchImplementation
+} // namespace internal
+
+
+
+template <int dim, typename Number>
+FEValuesBatch<dim, Number>::FEValuesBatch(
+  const Mapping<dim, dim>       &mapping,
+  const FiniteElement<dim, dim> &fe,
+  const Quadrature<dim>         &quadrature,
+  const UpdateFlags              update_flags)
+  : n_quadrature_points(quadrature.size())
+  , dofs_per_cell(fe.n_dofs_per_cell())
+  , mapping(dynamic_cast<const MappingQ<dim, dim> *>(&mapping))
+  , fe(&fe)
+  , quadrature(quadrature)
+  , update_flags(
+      internal::FEValuesBatchImplementation::compute_update_flags(update_flags))
+  , n_filled_lanes(0)
+{
+  AssertThrow(this->mapping != nullptr,
+              ExcMessage("FEValuesBatch only works with mappings of type "
+                         "MappingQ or classes derived from it."));
+  AssertThrow(fe.reference_cell() == ReferenceCells::get_hypercube<dim>(),
+              ExcMessage("FEValuesBatch only works with elements defined on "
+                         "hypercube cells."));
+  AssertThrow(fe.is_primitive(),
+              ExcMessage("FEValuesBatch only works with primitive elements."));
+
+  const std::vector<Point<dim>> &points = quadrature.get_points();
+
+  if (this->update_flags & update_values)
+    {
+      shape_values.reinit(dofs_per_cell, n_quadrature_points);
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int q = 0; q < n_quadrature_points; ++q)
+          shape_values(i, q) = fe.shape_value(i, points[q]);
+    }
+
+  if (this->update_flags & update_gradients)
+    {
+      unit_shape_gradients.reinit(dofs_per_cell, n_quadrature_points);
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int q = 0; q < n_quadrature_points; ++q)
+          unit_shape_gradients(i, q) = fe.shape_grad(i, points[q]);
+      shape_gradients.reinit(dofs_per_cell, n_quadrature_points);
+    }
+
+  // the polynomials of the mapping are numbered lexicographically, whereas
+  // the support points are returned in hierarchical order
+  const TensorProductPolynomials<dim> mapping_polynomials(
+    this->mapping->polynomials_1d);
+  const std::vector<unsigned int> &lexicographic_to_hierarchic =
+    this->mapping->renumber_lexicographic_to_hierarchic;
+  const unsigned int n_mapping_points = mapping_polynomials.n();
+  AssertDimension(lexicographic_to_hierarchic.size(), n_mapping_points);
+
+  mapping_support_points.resize(n_mapping_points);
+
+  if (this->update_flags & update_quadrature_points)
+    {
+      mapping_shape_values.reinit(n_quadrature_points, n_mapping_points);
+      for (unsigned int q = 0; q < n_quadrature_points; ++q)
+        for (unsigned int i = 0; i < n_mapping_points; ++i)
+          mapping_shape_values(q, lexicographic_to_hierarchic[i]) =
+            mapping_polynomials.compute_value(i, points[q]);
+      quadrature_points.resize(n_quadrature_points);
+    }
+
+  if (this->update_flags & update_jacobians)
+    {
+      mapping_shape_gradients.reinit(n_quadrature_points, n_mapping_points);
+      for (unsigned int q = 0; q < n_quadrature_points; ++q)
+        for (unsigned int i = 0; i < n_mapping_points; ++i)
+          mapping_shape_gradients(q, lexicographic_to_hierarchic[i]) =
+            mapping_polynomials.compute_grad(i, points[q]);
+      jacobians.resize(n_quadrature_points);
+    }
+
+  if (this->update_flags & update_inverse_jacobians)
+    inverse_jacobians.resize(n_quadrature_points);
+
+  if (this->update_flags & update_JxW_values)
+    JxW_values.resize(n_quadrature_points);
+}
+
+
+
+template <int dim, typename Number>
+FEValuesBatch<dim, Number>::FEValuesBatch(
+  const FiniteElement<dim, dim> &fe,
+  const Quadrature<dim>         &quadrature,
+  const UpdateFlags              update_flags)
+  : FEValuesBatch(
+      fe.reference_cell().template get_default_linear_mapping<dim, dim>(),
+      fe,
+      quadrature,
+      update_flags)
+{}
+
+
+
+template <int dim, typename Number>
+void
+FEValuesBatch<dim, Number>::do_reinit()
+{
+  const unsigned int n_mapping_points = mapping_support_points.size();
+
+  // collect the support points of the mapping; the lanes beyond the number
+  // of cells duplicate the last cell
+  for (unsigned int lane = 0; lane < n_filled_lanes; ++lane)
+    {
+      const std::vector<Point<dim>> points =
+        mapping->compute_mapping_support_points(cells[lane]);
+      AssertDimension(points.size(), n_mapping_points);
+      for (unsigned int k = 0; k < n_mapping_points; ++k)
+        for (unsigned int d = 0; d < dim; ++d)
+          mapping_support_points[k][d][lane] = points[k][d];
+    }
+  for (unsigned int lane = n_filled_lanes; lane < n_lanes; ++lane)
+    for (unsigned int k = 0; k < n_mapping_points; ++k)
+      for (unsigned int d = 0; d < dim; ++d)
+        mapping_support_points[k][d][lane] =
+          mapping_support_points[k][d][n_filled_lanes - 1];
+
+  if (update_flags & update_quadrature_points)
+    for (unsigned int q = 0; q < n_quadrature_points; ++q)
+      {
+        Point<dim, VectorizedArrayType> point;
+        for (unsigned int k = 0; k < n_mapping_points; ++k)
+          for (unsigned int d = 0; d < dim; ++d)
+            point[d] +=
+              mapping_shape_values(q, k) * mapping_support_points[k][d];
+        quadrature_points[q] = point;
+      }
+
+  if (!(update_flags & update_jacobians))
+    return;
+
+  for (unsigned int q = 0; q < n_quadrature_points; ++q)
+    {
+      Tensor<2, dim, VectorizedArrayType> jacobian;
+      for (unsigned int k = 0; k < n_mapping_points; ++k)
+        {
+          const Tensor<1, dim, Number> &gradient =
+            mapping_shape_gradients(q, k);
+          for (unsigned int d = 0; d < dim; ++d)
+            for (unsigned int e = 0; e < dim; ++e)
+              jacobian[d][e] += gradient[e] * mapping_support_points[k][d];
+        }
+      jacobians[q] = jacobian;
+
+      if (update_flags & update_JxW_values)
+        {
+          const VectorizedArrayType determinant =
+            dealii::determinant(jacobian);
+          // the lanes beyond the number of cells are copies of the last
+          // cell, so it suffices to check the filled lanes
+          for (unsigned int lane = 0; lane < n_filled_lanes; ++lane)
+            Assert(determinant[lane] > 0,
+                   ExcMessage("The Jacobian of the mapping on the cell " +
+                              cells[lane]->id().to_string() +
+                              " is not positive."));
+          JxW_values[q] = determinant * Number(quadrature.weight(q));
+        }
+
+      if (!(update_flags & update_inverse_jacobians))
+        continue;
+
+      const Tensor<2, dim, VectorizedArrayType> inverse = invert(jacobian);
+      inverse_jacobians[q] = inverse;
+
+      // the gradients are transformed by the transpose of the inverse
+      // Jacobian
+      if (update_flags & update_gradients)
+        for (unsigned int i = 0; i < dofs_per_cell; ++i)
+          {
+            const Tensor<1, dim, Number> &unit_gradient =
+              unit_shape_gradients(i, q);
+            Tensor<1, dim, VectorizedArrayType> gradient;
+            for (unsigned int d = 0; d < dim; ++d)
+              for (unsigned int e = 0; e < dim; ++e)
+                gradient[d] += unit_gradient[e] * inverse[e][d];
+            shape_gradients(i, q) = gradient;
+          }
+    }
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+FEValuesBatch<dim, Number>::memory_consumption() const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(quadrature) +
+         MemoryConsumption::memory_consumption(shape_values) +
+         MemoryConsumption::memory_consumption(unit_shape_gradients) +
+         MemoryConsumption::memory_consumption(mapping_shape_values) +
+         MemoryConsumption::memory_consumption(mapping_shape_gradients) +
+         MemoryConsumption::memory_consumption(mapping_support_points) +
+         MemoryConsumption::memory_consumption(quadrature_points) +
+         MemoryConsumption::memory_consumption(jacobians) +
+         MemoryConsumption::memory_consumption(inverse_jacobians) +
+         MemoryConsumption::memory_consumption(JxW_values) +
+         MemoryConsumption::memory_consumption(shape_gradients);
+}
+
+
+
+//--------------------------- Explicit instantiations -----------------------
+#include "fe_values_batch.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
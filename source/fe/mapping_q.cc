@@ -54,15 +54,36 @@ MappingQ<dim, spacedim>::InternalData::InternalData(
   , n_shape_functions(Utilities::fixed_power<dim>(polynomial_degree + 1))
   , line_support_points(QGaussLobatto<1>(polynomial_degree + 1))
   , tensor_product_quadrature(false)
+  , cache_cell_data(false)
+  , use_affine_fast_path(false)
+  , cell_data_cache_triangulation(nullptr)
+  , cell_data_cache_generation(0)
   , output_data(nullptr)
 {}
 
 
 
+template <int dim, int spacedim>
+MappingQ<dim, spacedim>::InternalData::~InternalData()
+{
+  cell_data_cache_signal.disconnect();
+}
+
+
+
 template <int dim, int spacedim>
 std::size_t
 MappingQ<dim, spacedim>::InternalData::memory_consumption() const
 {
+  std::size_t cell_data_cache_memory = 0;
+  for (const auto &entry : cell_data_cache)
+    cell_data_cache_memory +=
+      sizeof(entry) +
+      MemoryConsumption::memory_consumption(entry.second.quadrature_points) +
+      MemoryConsumption::memory_consumption(entry.second.jacobians) +
+      MemoryConsumption::memory_consumption(entry.second.inverse_jacobians) +
+      MemoryConsumption::memory_consumption(entry.second.volume_elements);
+
   return (
     Mapping<dim, spacedim>::InternalDataBase::memory_consumption() +
     MemoryConsumption::memory_consumption(quadrature_points) +
@@ -71,6 +92,7 @@ MappingQ<dim, spacedim>::InternalData::memory_consumption() const
     MemoryConsumption::memory_consumption(mapping_support_points) +
     MemoryConsumption::memory_consumption(cell_of_current_support_points) +
     MemoryConsumption::memory_consumption(volume_elements) +
+    cell_data_cache_memory +
     MemoryConsumption::memory_consumption(polynomial_degree) +
     MemoryConsumption::memory_consumption(n_shape_functions));
 }
@@ -237,6 +259,9 @@ MappingQ<dim, spacedim>::MappingQ(const unsigned int p)
   , support_point_weights_cell(
       internal::MappingQImplementation::compute_support_point_weights_cell<dim>(
         this->polynomial_degree))
+  , cache_cell_data(false)
+  , use_affine_fast_path(false)
+  , cell_data_cache_generation(0)
 {
   Assert(p >= 1,
          ExcMessage("It only makes sense to create polynomial mappings "
@@ -263,6 +288,9 @@ MappingQ<dim, spacedim>::MappingQ(const MappingQ<dim, spacedim> &mapping)
   , support_point_weights_perimeter_to_interior(
       mapping.support_point_weights_perimeter_to_interior)
   , support_point_weights_cell(mapping.support_point_weights_cell)
+  , cache_cell_data(mapping.cache_cell_data)
+  , use_affine_fast_path(mapping.use_affine_fast_path)
+  , cell_data_cache_generation(mapping.cell_data_cache_generation)
 {}
 
 
@@ -285,6 +313,35 @@ MappingQ<dim, spacedim>::get_degree() const
 
 
 
+template <int dim, int spacedim>
+void
+MappingQ<dim, spacedim>::enable_cell_data_cache(const bool enable)
+{
+  cache_cell_data = enable;
+  clear_cell_data_cache();
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQ<dim, spacedim>::enable_affine_fast_path(const bool enable)
+{
+  use_affine_fast_path = enable;
+  clear_cell_data_cache();
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQ<dim, spacedim>::clear_cell_data_cache()
+{
+  ++cell_data_cache_generation;
+}
+
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 MappingQ<dim, spacedim>::transform_unit_to_real_cell(
@@ -735,6 +792,9 @@ MappingQ<dim, spacedim>::get_data(const UpdateFlags      update_flags,
     std::make_unique<InternalData>(polynomial_degree);
   auto &data = dynamic_cast<InternalData &>(*data_ptr);
   data.initialize(this->requires_update_flags(update_flags), q, q.size());
+  data.cache_cell_data            = cache_cell_data;
+  data.use_affine_fast_path       = use_affine_fast_path;
+  data.cell_data_cache_generation = cell_data_cache_generation;
 
   return data_ptr;
 }
@@ -797,20 +857,8 @@ MappingQ<dim, spacedim>::fill_fe_values(
   const InternalData &data = static_cast<const InternalData &>(internal_data);
   data.output_data         = &output_data;
 
-  const unsigned int n_q_points = quadrature.size();
-
-  // recompute the support points of the transformation of this
-  // cell. we tried to be clever here in an earlier version of the
-  // library by checking whether the cell is the same as the one we
-  // had visited last, but it turns out to be difficult to determine
-  // that because a cell for the purposes of a mapping is
-  // characterized not just by its (triangulation, level, index)
-  // triple, but also by the locations of its vertices, the manifold
-  // object attached to the cell and all of its bounding faces/edges,
-  // etc. to reliably test that the "cell" we are on is, therefore,
-  // not easily done
-  data.mapping_support_points = this->compute_mapping_support_points(cell);
-  data.cell_of_current_support_points = cell;
+  const unsigned int n_q_points   = quadrature.size();
+  const UpdateFlags  update_flags = data.update_each;
 
   // if the order of the mapping is greater than 1, then do not reuse any cell
   // similarity information. This is necessary because the cell similarity
@@ -821,37 +869,167 @@ MappingQ<dim, spacedim>::fill_fe_values(
        cell_similarity :
        CellSimilarity::none);
 
-  if (dim > 1 && data.tensor_product_quadrature)
+  // the fast path for affine cells and the cache of the cell data only cover
+  // the quantities up to the first derivative of the mapping
+  const bool first_derivatives_only =
+    (dim == spacedim) &&
+    !(update_flags &
+      (update_jacobian_grads | update_jacobian_pushed_forward_grads |
+       update_jacobian_2nd_derivatives |
+       update_jacobian_pushed_forward_2nd_derivatives |
+       update_jacobian_3rd_derivatives |
+       update_jacobian_pushed_forward_3rd_derivatives));
+
+  const bool use_cache      = data.cache_cell_data && first_derivatives_only;
+  bool       found_in_cache = false;
+  if (use_cache)
     {
-      internal::MappingQImplementation::
-        maybe_update_q_points_Jacobians_and_grads_tensor<dim, spacedim>(
-          computed_cell_similarity,
-          data,
-          output_data.quadrature_points,
-          output_data.jacobians,
-          output_data.inverse_jacobians,
-          output_data.jacobian_grads);
+      // discard the data cached before a call to clear_cell_data_cache()
+      if (data.cell_data_cache_generation != cell_data_cache_generation)
+        {
+          data.cell_data_cache.clear();
+          data.cell_data_cache_generation = cell_data_cache_generation;
+        }
+
+      // connect to the triangulation in order to clear the cache whenever
+      // the mesh changes, including the destruction of the triangulation
+      if (data.cell_data_cache_triangulation != &cell->get_triangulation())
+        {
+          data.cell_data_cache_signal.disconnect();
+          data.cell_data_cache.clear();
+          data.cell_data_cache_triangulation = &cell->get_triangulation();
+          data.cell_data_cache_signal =
+            cell->get_triangulation().signals.any_change.connect([&data]() {
+              data.cell_data_cache.clear();
+              data.cell_data_cache_triangulation = nullptr;
+            });
+        }
+
+      const auto entry = data.cell_data_cache.find(cell->id());
+      if (entry != data.cell_data_cache.end())
+        {
+          found_in_cache = true;
+
+          const typename InternalData::CachedCellData &cached = entry->second;
+          if (cached.is_affine)
+            internal::MappingQImplementation::update_q_points_Jacobians_affine(
+              data,
+              cached.quadrature_points[0],
+              cached.jacobians[0],
+              make_array_view(quadrature.get_points()),
+              output_data.quadrature_points,
+              output_data.jacobians,
+              output_data.inverse_jacobians);
+          else
+            {
+              if (update_flags & update_quadrature_points)
+                output_data.quadrature_points = cached.quadrature_points;
+              if (update_flags & update_contravariant_transformation)
+                output_data.jacobians = cached.jacobians;
+              if (update_flags & update_covariant_transformation)
+                output_data.inverse_jacobians = cached.inverse_jacobians;
+              if (update_flags & update_volume_elements)
+                std::copy(cached.volume_elements.begin(),
+                          cached.volume_elements.end(),
+                          data.volume_elements.begin());
+            }
+        }
     }
-  else
+
+  if (!found_in_cache)
     {
-      internal::MappingQImplementation::maybe_update_q_points_Jacobians_generic(
-        computed_cell_similarity,
-        data,
-        make_array_view(quadrature.get_points()),
-        polynomials_1d,
-        renumber_lexicographic_to_hierarchic,
-        output_data.quadrature_points,
-        output_data.jacobians,
-        output_data.inverse_jacobians);
-
-      internal::MappingQImplementation::maybe_update_jacobian_grads<dim,
-                                                                    spacedim>(
-        computed_cell_similarity,
-        data,
-        make_array_view(quadrature.get_points()),
-        polynomials_1d,
-        renumber_lexicographic_to_hierarchic,
-        output_data.jacobian_grads);
+      // recompute the support points of the transformation of this
+      // cell. we tried to be clever here in an earlier version of the
+      // library by checking whether the cell is the same as the one we
+      // had visited last, but it turns out to be difficult to determine
+      // that because a cell for the purposes of a mapping is
+      // characterized not just by its (triangulation, level, index)
+      // triple, but also by the locations of its vertices, the manifold
+      // object attached to the cell and all of its bounding faces/edges,
+      // etc. to reliably test that the "cell" we are on is, therefore,
+      // not easily done
+      data.mapping_support_points = this->compute_mapping_support_points(cell);
+      data.cell_of_current_support_points = cell;
+
+      // on affine cells, the Jacobian is constant and can be read off from
+      // the vertices, so we can skip the evaluation of the polynomial
+      // mapping in the quadrature points if this has been enabled
+      DerivativeForm<1, dim, spacedim> affine_jacobian;
+      const bool                       is_affine =
+        data.use_affine_fast_path && first_derivatives_only &&
+        internal::MappingQImplementation::compute_affine_jacobian(
+          data.mapping_support_points,
+          unit_cell_support_points,
+          affine_jacobian);
+
+      if (is_affine)
+        {
+          internal::MappingQImplementation::update_q_points_Jacobians_affine(
+            data,
+            data.mapping_support_points[0],
+            affine_jacobian,
+            make_array_view(quadrature.get_points()),
+            output_data.quadrature_points,
+            output_data.jacobians,
+            output_data.inverse_jacobians);
+        }
+      else if (dim > 1 && data.tensor_product_quadrature)
+        {
+          internal::MappingQImplementation::
+            maybe_update_q_points_Jacobians_and_grads_tensor<dim, spacedim>(
+              computed_cell_similarity,
+              data,
+              output_data.quadrature_points,
+              output_data.jacobians,
+              output_data.inverse_jacobians,
+              output_data.jacobian_grads);
+        }
+      else
+        {
+          internal::MappingQImplementation::
+            maybe_update_q_points_Jacobians_generic(
+              computed_cell_similarity,
+              data,
+              make_array_view(quadrature.get_points()),
+              polynomials_1d,
+              renumber_lexicographic_to_hierarchic,
+              output_data.quadrature_points,
+              output_data.jacobians,
+              output_data.inverse_jacobians);
+
+          internal::MappingQImplementation::maybe_update_jacobian_grads<
+            dim,
+            spacedim>(computed_cell_similarity,
+                      data,
+                      make_array_view(quadrature.get_points()),
+                      polynomials_1d,
+                      renumber_lexicographic_to_hierarchic,
+                      output_data.jacobian_grads);
+        }
+
+      if (use_cache)
+        {
+          typename InternalData::CachedCellData cached;
+          cached.is_affine = is_affine;
+          if (is_affine)
+            {
+              cached.quadrature_points = {data.mapping_support_points[0]};
+              cached.jacobians         = {affine_jacobian};
+            }
+          else
+            {
+              if (update_flags & update_quadrature_points)
+                cached.quadrature_points = output_data.quadrature_points;
+              if (update_flags & update_contravariant_transformation)
+                cached.jacobians = output_data.jacobians;
+              if (update_flags & update_covariant_transformation)
+                cached.inverse_jacobians = output_data.inverse_jacobians;
+              if (update_flags & update_volume_elements)
+                cached.volume_elements.assign(data.volume_elements.begin(),
+                                              data.volume_elements.end());
+            }
+          data.cell_data_cache.emplace(cell->id(), std::move(cached));
+        }
     }
 
   internal::MappingQImplementation::maybe_update_jacobian_pushed_forward_grads<
@@ -899,8 +1077,7 @@ MappingQ<dim, spacedim>::fill_fe_values(
       renumber_lexicographic_to_hierarchic,
       output_data.jacobian_pushed_forward_3rd_derivatives);
 
-  const UpdateFlags          update_flags = data.update_each;
-  const std::vector<double> &weights      = quadrature.get_weights();
+  const std::vector<double> &weights = quadrature.get_weights();
 
   // Multiply quadrature weights by absolute value of Jacobian determinants or
   // the area element g=sqrt(DX^t DX) in case of codim > 0
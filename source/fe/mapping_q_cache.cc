@@ -145,6 +145,10 @@ MappingQCache<dim, spacedim>::initialize(
   clear_signal = triangulation.signals.any_change.connect(
     [&]() -> void { this->support_point_cache.reset(); });
 
+  // the support points are computed anew, so the geometry data cached by
+  // MappingQ::fill_fe_values() is not valid any more
+  this->clear_cell_data_cache();
+
   support_point_cache =
     std::make_shared<std::vector<std::vector<std::vector<Point<spacedim>>>>>(
       triangulation.n_levels());
@@ -14,6 +14,8 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
@@ -42,6 +44,8 @@ SparsityPattern::SparsityPattern()
   , max_vec_len(0)
   , max_row_length(0)
   , compressed(false)
+  , thread_loop_partitioner(
+      std::make_shared<parallel::internal::TBBPartitioner>())
 {
   reinit(0, 0, 0);
 }
@@ -272,11 +276,14 @@ SparsityPattern::reinit(const size_type                      m,
       rowstart = std::make_unique<std::size_t[]>(max_dim + 1);
     }
 
-  // allocate memory for the column numbers if necessary
+  // allocate memory for the column numbers if necessary. the memory is
+  // not initialized here but in the parallel loop below
   if (vec_len > max_vec_len)
     {
       max_vec_len = vec_len;
-      colnums     = std::make_unique<size_type[]>(max_vec_len);
+      colnums     = std::unique_ptr<size_type[]>(new size_type[max_vec_len]);
+      thread_loop_partitioner =
+        std::make_shared<parallel::internal::TBBPartitioner>();
     }
 
   // set the rowstart array
@@ -292,14 +299,23 @@ SparsityPattern::reinit(const size_type                      m,
            ((vec_len == 1) && (rowstart[rows] == 0)),
          ExcInternalError());
 
-  // preset the column numbers by a value indicating it is not in use
-  std::fill_n(colnums.get(), vec_len, invalid_entry);
-
-  // if diagonal elements are special: let the first entry in each row be the
-  // diagonal value
-  if (store_diagonal_first_in_row)
-    for (size_type i = 0; i < n_rows(); ++i)
-      colnums[rowstart[i]] = i;
+  // preset the column numbers by a value indicating it is not in use. if
+  // diagonal elements are special: let the first entry in each row be the
+  // diagonal value. this is the first access to the memory of the column
+  // numbers, so use the same partition of the rows among threads as the
+  // matrix-vector products
+  apply_to_row_subranges([this](const size_type begin_row,
+                                const size_type end_row) {
+    std::fill(colnums.get() + rowstart[begin_row],
+              colnums.get() + rowstart[end_row],
+              invalid_entry);
+    if (store_diagonal_first_in_row)
+      for (size_type i = begin_row; i < end_row; ++i)
+        colnums[rowstart[i]] = i;
+  });
+  std::fill(colnums.get() + rowstart[rows],
+            colnums.get() + vec_len,
+            invalid_entry);
 
   compressed = false;
 }
@@ -328,6 +344,63 @@ SparsityPattern::reinit(const size_type    m,
 
 
 
+void
+SparsityPattern::apply_to_row_subranges(
+  const std::function<void(const size_type, const size_type)> &f) const
+{
+  if (rows == 0 || rowstart == nullptr)
+    return;
+
+#ifdef DEAL_II_WITH_TBB
+  const size_type grain_size =
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size;
+  // only go to the parallel function in case there are at least 4 parallel
+  // items, otherwise the overhead is too large
+  if (rows >= 4 * grain_size && MultithreadInfo::n_threads() > 1)
+    {
+      const size_type n_chunks =
+        std::min(static_cast<size_type>(4 * MultithreadInfo::n_threads()),
+                 rows / grain_size);
+      const std::size_t n_entries = rowstart[rows];
+
+      // the first row of a chunk is the first row with at least the
+      // chunk's share of the entries before it. the chunks are contiguous
+      // and cover all rows, including rows without entries, because the
+      // first chunk starts at row 0 and the last one ends at row rows
+      const auto chunk_start = [&](const size_type chunk) -> size_type {
+        if (chunk == n_chunks)
+          return rows;
+        return std::lower_bound(rowstart.get(),
+                                rowstart.get() + rows,
+                                n_entries * chunk / n_chunks) -
+               rowstart.get();
+      };
+
+      std::shared_ptr<tbb::affinity_partitioner> tbb_partitioner =
+        thread_loop_partitioner->acquire_one_partitioner();
+      // the grain size refers to chunks here, see the loops in
+      // VectorOperations
+      parallel::internal::parallel_for(
+        static_cast<size_type>(0),
+        n_chunks,
+        [&](const tbb::blocked_range<size_type> &range) {
+          const size_type begin_row = chunk_start(range.begin());
+          const size_type end_row   = chunk_start(range.end());
+          if (begin_row < end_row)
+            f(begin_row, end_row);
+        },
+        1,
+        tbb_partitioner);
+      thread_loop_partitioner->release_one_partitioner(tbb_partitioner);
+      return;
+    }
+#endif
+
+  f(size_type(0), rows);
+}
+
+
+
 void
 SparsityPattern::compress()
 {
@@ -342,83 +415,77 @@ SparsityPattern::compress()
   if (compressed)
     return;
 
-  size_type next_free_entry = 0, next_row_start = 0, row_length = 0;
-
-  // first find out how many non-zero elements there are, in order to allocate
-  // the right amount of memory
-  const std::size_t nonzero_elements =
-    std::count_if(&colnums[rowstart[0]],
-                  &colnums[rowstart[rows]],
-                  [](const size_type col) { return col != invalid_entry; });
-  // now allocate the respective memory
-  std::unique_ptr<size_type[]> new_colnums(new size_type[nonzero_elements]);
-
-
-  // reserve temporary storage to store the entries of one row
-  std::vector<size_type> tmp_entries(max_row_length);
-
-  // Traverse all rows
-  for (size_type line = 0; line < n_rows(); ++line)
+  // first find out how many non-zero elements there are in each row, in
+  // order to allocate the right amount of memory. the used entries of a row
+  // come before the first unused one
+  std::vector<std::size_t> new_rowstart(rows + 1);
+  for (size_type line = 0; line < rows; ++line)
     {
-      // copy used entries, break if first unused entry is reached
-      row_length = 0;
+      size_type row_length = 0;
       for (size_type j = rowstart[line]; j < rowstart[line + 1];
            ++j, ++row_length)
-        if (colnums[j] != invalid_entry)
-          tmp_entries[row_length] = colnums[j];
-        else
+        if (colnums[j] == invalid_entry)
           break;
-      // now @p{rowstart} is the number of entries in this line
-
-      // Sort only beginning at the second entry, if optimized storage of
-      // diagonal entries is on.
-
-      // if this line is empty or has only one entry, don't sort
-      if (row_length > 1)
-        std::sort((store_diagonal_first_in_row) ? tmp_entries.begin() + 1 :
-                                                  tmp_entries.begin(),
-                  tmp_entries.begin() + row_length);
-
-      // insert column numbers into the new field
-      for (size_type j = 0; j < row_length; ++j)
-        new_colnums[next_free_entry++] = tmp_entries[j];
-
-      // note new start of this and the next row
-      rowstart[line] = next_row_start;
-      next_row_start = next_free_entry;
-
-      // some internal checks: either the matrix is not quadratic, or if it
-      // is, then the first element of this row must be the diagonal element
-      // (i.e. with column index==line number)
-      // this test only makes sense if we have written to the index
-      // rowstart_line in new_colnums which is the case if row_length is not 0,
-      // so check this first
-      Assert((!store_diagonal_first_in_row) ||
-               (row_length != 0 && new_colnums[rowstart[line]] == line),
-             ExcInternalError());
-      // assert that the first entry does not show up in the remaining ones
-      // and that the remaining ones are unique among themselves (this handles
-      // both cases, quadratic and rectangular matrices)
-      //
-      // the only exception here is if the row contains no entries at all
-      Assert((rowstart[line] == next_row_start) ||
-               (std::find(&new_colnums[rowstart[line] + 1],
-                          &new_colnums[next_row_start],
-                          new_colnums[rowstart[line]]) ==
-                &new_colnums[next_row_start]),
-             ExcInternalError());
-      Assert((rowstart[line] == next_row_start) ||
-               (std::adjacent_find(&new_colnums[rowstart[line] + 1],
-                                   &new_colnums[next_row_start]) ==
-                &new_colnums[next_row_start]),
-             ExcInternalError());
+      new_rowstart[line + 1] = new_rowstart[line] + row_length;
     }
+  const std::size_t nonzero_elements = new_rowstart[rows];
+  Assert(nonzero_elements ==
+           static_cast<std::size_t>(std::count_if(
+             &colnums[rowstart[0]],
+             &colnums[rowstart[rows]],
+             [](const size_type col) { return col != invalid_entry; })),
+         ExcInternalError());
 
-  // assert that we have used all allocated space, no more and no less
-  Assert(next_free_entry == nonzero_elements, ExcInternalError());
+  // now allocate the respective memory
+  std::unique_ptr<size_type[]> new_colnums(new size_type[nonzero_elements]);
 
-  // set iterator-past-the-end
-  rowstart[rows] = next_row_start;
+  // note the new start of each row, including the iterator-past-the-end,
+  // such that the loop below uses the same partition of the rows as the
+  // matrix-vector products
+  std::swap_ranges(new_rowstart.begin(), new_rowstart.end(), rowstart.get());
+  const std::vector<std::size_t> &old_rowstart = new_rowstart;
+
+  // copy the used entries of each row into the new field. the rows are
+  // independent, so this is done in parallel, which also places the new
+  // memory close to the threads that work on it in the matrix-vector
+  // products
+  apply_to_row_subranges([&](const size_type begin_row,
+                             const size_type end_row) {
+    for (size_type line = begin_row; line < end_row; ++line)
+      {
+        size_type *const row_begin = &new_colnums[rowstart[line]];
+        size_type *const row_end   = &new_colnums[rowstart[line + 1]];
+        std::copy(&colnums[old_rowstart[line]],
+                  &colnums[old_rowstart[line]] + (row_end - row_begin),
+                  row_begin);
+
+        // Sort only beginning at the second entry, if optimized storage of
+        // diagonal entries is on.
+
+        // if this line is empty or has only one entry, don't sort
+        if (row_end - row_begin > 1)
+          std::sort(store_diagonal_first_in_row ? row_begin + 1 : row_begin,
+                    row_end);
+
+        // some internal checks: either the matrix is not quadratic, or if it
+        // is, then the first element of this row must be the diagonal
+        // element (i.e. with column index==line number)
+        Assert((!store_diagonal_first_in_row) ||
+                 (row_end != row_begin && *row_begin == line),
+               ExcInternalError());
+        // assert that the first entry does not show up in the remaining ones
+        // and that the remaining ones are unique among themselves (this
+        // handles both cases, quadratic and rectangular matrices)
+        //
+        // the only exception here is if the row contains no entries at all
+        Assert((row_begin == row_end) ||
+                 (std::find(row_begin + 1, row_end, *row_begin) == row_end),
+               ExcInternalError());
+        Assert((row_begin == row_end) ||
+                 (std::adjacent_find(row_begin + 1, row_end) == row_end),
+               ExcInternalError());
+      }
+  });
 
   // set colnums to the newly allocated array and delete previous content
   // in the process
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/matrix_free/cell_kernel_tuning.h>
+
+#include <cstdlib>
+#include <fstream>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    std::string
+    get_cpu_model_name()
+    {
+      static const std::string model_name = []() {
+        // Linux reports the model in /proc/cpuinfo; on other systems, we do
+        // not distinguish between CPU models
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string   line;
+        while (std::getline(cpuinfo, line))
+          if (line.compare(0, 10, "model name") == 0)
+            {
+              const std::size_t colon = line.find(':');
+              if (colon != std::string::npos)
+                return Utilities::trim(line.substr(colon + 1));
+            }
+        return std::string("unknown");
+      }();
+      return model_name;
+    }
+
+
+
+    CellKernelVariantCache::CellKernelVariantCache(const std::string &filename)
+      : filename(filename)
+    {
+      if (filename.empty())
+        return;
+
+      std::ifstream file(filename);
+      std::string   line;
+      while (std::getline(file, line))
+        {
+          const std::size_t separator = line.rfind('\t');
+          if (separator == std::string::npos)
+            continue;
+          const int value = std::atoi(line.c_str() + separator + 1);
+          if (value > static_cast<int>(CellKernelVariant::heuristic) &&
+              value <= static_cast<int>(CellKernelVariant::general))
+            entries[line.substr(0, separator)] =
+              static_cast<CellKernelVariant>(value);
+        }
+    }
+
+
+
+    bool
+    CellKernelVariantCache::find(const std::string &key,
+                                 CellKernelVariant &variant) const
+    {
+      const auto entry = entries.find(key);
+      if (entry == entries.end())
+        return false;
+      variant = entry->second;
+      return true;
+    }
+
+
+
+    void
+    CellKernelVariantCache::insert(const std::string      &key,
+                                   const CellKernelVariant variant)
+    {
+      entries[key] = variant;
+      new_entries.emplace_back(key, variant);
+    }
+
+
+
+    void
+    CellKernelVariantCache::write()
+    {
+      if (filename.empty() || new_entries.empty())
+        return;
+
+      // Only append the new entries rather than rewriting the whole file, in
+      // order to keep the entries another program has added to the file in
+      // the meantime. If the last line of the file is incomplete, e.g.
+      // because a previous program was interrupted while writing, start a
+      // new line such that only the incomplete line is skipped when reading
+      // the file.
+      bool needs_newline = false;
+      {
+        std::ifstream file(filename, std::ios::binary);
+        if (file && file.seekg(-1, std::ios::end))
+          needs_newline = (file.get() != '\n');
+      }
+
+      std::ofstream file(filename, std::ios::app);
+      AssertThrow(file, ExcIO());
+      if (needs_newline)
+        file << '\n';
+      for (const auto &entry : new_entries)
+        file << entry.first << '\t' << static_cast<int>(entry.second) << '\n';
+      file.flush();
+      AssertThrow(file, ExcIO());
+
+      new_entries.clear();
+    }
+  } // namespace MatrixFreeFunctions
+} // namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
@@ -19,10 +19,12 @@
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/multithread_info.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 
+#include <deal.II/matrix_free/dof_info.h>
 #include <deal.II/matrix_free/task_info.h>
 #include <deal.II/matrix_free/util.h>
 
@@ -36,6 +38,10 @@
 #  endif
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
 #include <set>
 
@@ -354,7 +360,7 @@ namespace internal
       // pieces of updates within the loop, so this index will collect all
       // calls in that case and work like a single complete loop over all
       // cells
-      if (scheme != none)
+      if (scheme != none && scheme != dynamic)
         funct.cell_loop_pre_range(numbers::invalid_unsigned_int);
       else
         funct.cell_loop_pre_range(
@@ -364,7 +370,7 @@ namespace internal
 
 #if defined(DEAL_II_WITH_TBB) && !defined(DEAL_II_TBB_WITH_ONEAPI)
 
-      if (scheme != none)
+      if (scheme != none && scheme != dynamic)
         {
           funct.zero_dst_vector_range(numbers::invalid_unsigned_int);
           if (scheme == partition_partition && evens > 0)
@@ -604,7 +610,8 @@ namespace internal
       else
 #endif
         // serial loop, go through up to three times and do the MPI transfer at
-        // the beginning/end of the second part
+        // the beginning/end of the second part. For the dynamic scheme, the
+        // cell work within each range is distributed among the threads.
         {
           for (unsigned int part = 0; part < partition_row_index.size() - 2;
                ++part)
@@ -621,7 +628,10 @@ namespace internal
                   AssertIndexRange(i + 1, cell_partition_data.size());
                   if (cell_partition_data[i + 1] > cell_partition_data[i])
                     {
-                      funct.cell(i);
+                      if (scheme == dynamic)
+                        dynamic_cell_loop(funct, i);
+                      else
+                        funct.cell(i);
                     }
 
                   if (face_partition_data.empty() == false)
@@ -641,7 +651,7 @@ namespace internal
         }
       funct.vector_compress_finish();
 
-      if (scheme != none)
+      if (scheme != none && scheme != dynamic)
         funct.cell_loop_post_range(numbers::invalid_unsigned_int);
       else
         funct.cell_loop_post_range(
@@ -650,6 +660,224 @@ namespace internal
 
 
 
+    void
+    TaskInfo::dynamic_cell_loop(MFWorkerInterface &funct,
+                                const unsigned int range_index) const
+    {
+      AssertIndexRange(range_index + 1, dynamic_range_ptr.size());
+
+      // Accumulate the statistics of this call locally, where each task
+      // only writes into its own entry, and merge them into the member
+      // variables at the end, since several loops might run concurrently
+      // on the same object
+      const unsigned int  n_threads = MultithreadInfo::n_threads();
+      std::vector<double> thread_busy_time(n_threads, 0.);
+      double              wall_time = 0.;
+
+      for (unsigned int color = dynamic_range_ptr[range_index];
+           color < dynamic_range_ptr[range_index + 1];
+           ++color)
+        {
+          const unsigned int begin = dynamic_color_ptr[color];
+          const unsigned int end   = dynamic_color_ptr[color + 1];
+          if (begin == end)
+            continue;
+
+          const auto color_start = std::chrono::steady_clock::now();
+
+          // The threads pick the next chunk from a shared counter until all
+          // chunks of the current color are done. As the chunks of a color
+          // do not write into the same vector entries, no further
+          // synchronization is needed within a color.
+          std::atomic<unsigned int> next_chunk(begin);
+          const auto                work_on_chunks = [&](const unsigned int t) {
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned int c = next_chunk++; c < end; c = next_chunk++)
+              funct.cell(dynamic_chunks[c]);
+            thread_busy_time[t] +=
+              std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                .count();
+          };
+
+          const unsigned int n_workers = std::min(n_threads, end - begin);
+          Threads::TaskGroup<void> tasks;
+          for (unsigned int t = 1; t < n_workers; ++t)
+            tasks += Threads::new_task([&work_on_chunks, t]() {
+              work_on_chunks(t);
+            });
+          work_on_chunks(0);
+          tasks.join_all();
+
+          wall_time +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          color_start)
+              .count();
+        }
+
+      std::lock_guard<std::mutex> lock(dynamic_statistics_mutex);
+      if (dynamic_thread_busy_time.size() < n_threads)
+        dynamic_thread_busy_time.resize(n_threads, 0.);
+      for (unsigned int t = 0; t < n_threads; ++t)
+        dynamic_thread_busy_time[t] += thread_busy_time[t];
+      dynamic_wall_time += wall_time;
+    }
+
+
+
+    void
+    TaskInfo::make_dynamic_schedule(const std::vector<DoFInfo> &dof_info)
+    {
+      dynamic_chunks.clear();
+      dynamic_color_ptr.clear();
+      dynamic_range_ptr.clear();
+      reset_thread_load_statistics();
+      if (scheme != dynamic)
+        return;
+
+      // the ranges with ghost cells at the end of cell_partition_data are not
+      // part of the loop
+      const unsigned int n_ranges =
+        partition_row_index[partition_row_index.size() - 2];
+      const unsigned int n_cell_batches = cell_partition_data[n_ranges];
+
+      if (block_size == 0)
+        {
+          unsigned int max_dofs_per_cell = 1;
+          for (const DoFInfo &info : dof_info)
+            for (const unsigned int dofs : info.dofs_per_cell)
+              max_dofs_per_cell = std::max(max_dofs_per_cell, dofs);
+          guess_block_size(max_dofs_per_cell);
+        }
+      const unsigned int chunk_size =
+        std::max(1U, std::min(block_size, n_cell_batches));
+
+      // Greedy coloring of the chunks within each range: for each vector
+      // entry, we record the colors of the chunks accessing it in a bit mask
+      // and assign the first color not yet used by any of the entries of a
+      // chunk. If we run out of colors, the chunks of the range are
+      // processed one after another.
+      using ColorMask               = std::uint64_t;
+      const unsigned int max_colors = 8 * sizeof(ColorMask);
+      std::vector<std::vector<ColorMask>> entry_colors(dof_info.size());
+      for (unsigned int no = 0; no < dof_info.size(); ++no)
+        {
+          unsigned int n_entries = 0;
+          for (const unsigned int index : dof_info[no].dof_indices)
+            n_entries = std::max(n_entries, index + 1);
+          entry_colors[no].resize(n_entries, ColorMask());
+        }
+
+      std::vector<unsigned int>                          indices;
+      std::vector<std::vector<unsigned int>>             chunk_indices;
+      std::vector<std::pair<unsigned int, unsigned int>> chunks;
+      std::vector<unsigned int>                          chunk_colors;
+
+      dynamic_range_ptr.push_back(0);
+      dynamic_color_ptr.push_back(0);
+      for (unsigned int range = 0; range < n_ranges; ++range)
+        {
+          chunks.clear();
+          for (unsigned int cell = cell_partition_data[range];
+               cell < cell_partition_data[range + 1];
+               cell += chunk_size)
+            chunks.emplace_back(cell,
+                                std::min(cell + chunk_size,
+                                         cell_partition_data[range + 1]));
+
+          chunk_colors.assign(chunks.size(), 0);
+          unsigned int n_colors      = chunks.empty() ? 0 : 1;
+          bool         out_of_colors = false;
+          chunk_indices.resize(dof_info.size());
+          for (unsigned int c = 0; c < chunks.size(); ++c)
+            {
+              ColorMask used_colors = 0;
+              for (unsigned int no = 0; no < dof_info.size(); ++no)
+                {
+                  chunk_indices[no].clear();
+                  if (dof_info[no].row_starts.empty())
+                    continue;
+                  for (unsigned int cell = chunks[c].first;
+                       cell < chunks[c].second;
+                       ++cell)
+                    {
+                      dof_info[no].get_dof_indices_on_cell_batch(indices,
+                                                                 cell);
+                      chunk_indices[no].insert(chunk_indices[no].end(),
+                                               indices.begin(),
+                                               indices.end());
+                    }
+                  for (const unsigned int index : chunk_indices[no])
+                    used_colors |= entry_colors[no][index];
+                }
+
+              unsigned int color = 0;
+              while (color < max_colors &&
+                     (used_colors & (ColorMask(1) << color)) != 0)
+                ++color;
+              if (color == max_colors)
+                {
+                  out_of_colors = true;
+                  break;
+                }
+              chunk_colors[c] = color;
+              n_colors        = std::max(n_colors, color + 1);
+              for (unsigned int no = 0; no < dof_info.size(); ++no)
+                for (const unsigned int index : chunk_indices[no])
+                  entry_colors[no][index] |= ColorMask(1) << color;
+            }
+
+          // reset the masks for the next range
+          for (auto &colors : entry_colors)
+            std::fill(colors.begin(), colors.end(), ColorMask());
+
+          if (out_of_colors)
+            {
+              n_colors = chunks.size();
+              for (unsigned int c = 0; c < chunks.size(); ++c)
+                chunk_colors[c] = c;
+            }
+
+          // sort the chunks by colors, keeping the order within each color
+          for (unsigned int color = 0; color < n_colors; ++color)
+            {
+              for (unsigned int c = 0; c < chunks.size(); ++c)
+                if (chunk_colors[c] == color)
+                  dynamic_chunks.push_back(chunks[c]);
+              dynamic_color_ptr.push_back(dynamic_chunks.size());
+            }
+          dynamic_range_ptr.push_back(dynamic_color_ptr.size() - 1);
+        }
+    }
+
+
+
+    void
+    TaskInfo::reset_thread_load_statistics() const
+    {
+      std::lock_guard<std::mutex> lock(dynamic_statistics_mutex);
+      dynamic_thread_busy_time.clear();
+      dynamic_wall_time = 0.;
+    }
+
+
+
+    template <typename StreamType>
+    void
+    TaskInfo::print_thread_load_statistics(StreamType &out) const
+    {
+      std::lock_guard<std::mutex> lock(dynamic_statistics_mutex);
+      out << "Thread load of dynamic cell loops, wall time "
+          << dynamic_wall_time << " s" << std::endl;
+      for (unsigned int t = 0; t < dynamic_thread_busy_time.size(); ++t)
+        out << "  Thread " << std::setw(3) << t << ": busy "
+            << dynamic_thread_busy_time[t] << " s, idle "
+            << std::max(0., dynamic_wall_time - dynamic_thread_busy_time[t])
+            << " s" << std::endl;
+    }
+
+
+
     TaskInfo::TaskInfo()
     {
       clear();
@@ -679,6 +907,10 @@ namespace internal
       partition_odds.clear();
       partition_n_blocked_workers.clear();
       partition_n_workers.clear();
+      dynamic_chunks.clear();
+      dynamic_color_ptr.clear();
+      dynamic_range_ptr.clear();
+      reset_thread_load_statistics();
       communicator = MPI_COMM_SELF;
       my_pid       = 0;
       n_procs      = 1;
@@ -714,7 +946,10 @@ namespace internal
         MemoryConsumption::memory_consumption(partition_evens) +
         MemoryConsumption::memory_consumption(partition_odds) +
         MemoryConsumption::memory_consumption(partition_n_blocked_workers) +
-        MemoryConsumption::memory_consumption(partition_n_workers));
+        MemoryConsumption::memory_consumption(partition_n_workers) +
+        MemoryConsumption::memory_consumption(dynamic_chunks) +
+        MemoryConsumption::memory_consumption(dynamic_color_ptr) +
+        MemoryConsumption::memory_consumption(dynamic_range_ptr));
     }
 
 
@@ -2360,6 +2595,12 @@ internal::MatrixFreeFunctions::TaskInfo::print_memory_statistics<std::ostream>(
 template void
 internal::MatrixFreeFunctions::TaskInfo::print_memory_statistics<
   ConditionalOStream>(ConditionalOStream &, const std::size_t) const;
+template void
+internal::MatrixFreeFunctions::TaskInfo::print_thread_load_statistics<
+  std::ostream>(std::ostream &) const;
+template void
+internal::MatrixFreeFunctions::TaskInfo::print_thread_load_statistics<
+  ConditionalOStream>(ConditionalOStream &) const;
 
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,113 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check DoFRenumbering::space_filling_curve_blocks on an adaptively refined
+// mesh: with a single block covering all DoFs, the result must coincide
+// with DoFRenumbering::hierarchical, and with small blocks, the result must
+// still be a permutation of the DoF indices
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <algorithm>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+std::vector<types::global_dof_index>
+get_cell_dof_indices(const DoFHandler<dim> &dof_handler)
+{
+  std::vector<types::global_dof_index> result, dof_indices;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+      cell->get_dof_indices(dof_indices);
+      result.insert(result.end(), dof_indices.begin(), dof_indices.end());
+    }
+  return result;
+}
+
+
+
+template <int dim>
+void
+check(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, -1., 1.);
+  tria.refine_global(2);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  DoFHandler<dim> dof_handler_ref(tria);
+  dof_handler_ref.distribute_dofs(fe);
+
+  deallog << "dim=" << dim << " fe=" << fe.get_name() << std::endl;
+
+  DoFRenumbering::hierarchical(dof_handler_ref);
+  DoFRenumbering::space_filling_curve_blocks(dof_handler,
+                                             std::size_t(1) << 30);
+  deallog << "Single block matches hierarchical: "
+          << (get_cell_dof_indices(dof_handler) ==
+                  get_cell_dof_indices(dof_handler_ref) ?
+                "yes" :
+                "no")
+          << std::endl;
+
+  for (const std::size_t block_size : {64, 512, 4096})
+    {
+      dof_handler.distribute_dofs(fe);
+      std::vector<types::global_dof_index> renumbering;
+      DoFRenumbering::compute_space_filling_curve_blocks(renumbering,
+                                                         dof_handler,
+                                                         block_size);
+
+      std::vector<types::global_dof_index> sorted(renumbering);
+      std::sort(sorted.begin(), sorted.end());
+      bool is_permutation = sorted.size() == dof_handler.n_dofs();
+      for (unsigned int i = 0; i < sorted.size(); ++i)
+        if (sorted[i] != i)
+          is_permutation = false;
+      deallog << "Block size " << block_size
+              << " bytes is permutation: " << (is_permutation ? "yes" : "no")
+              << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check<2>(FE_Q<2>(2));
+  check<2>(FESystem<2>(FE_Q<2>(2), 2, FE_Q<2>(1), 1));
+  check<3>(FE_Q<3>(1));
+  check<3>(FE_Q<3>(3));
+}
@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that DoFTools::make_compressed_sparsity_pattern gives the same
+// pattern as DoFTools::make_sparsity_pattern on a DynamicSparsityPattern
+// that is copied into a SparsityPattern, for meshes with hanging nodes and
+// with and without keeping the constrained degrees of freedom
+
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include "../tests.h"
+
+
+
+bool
+patterns_equal(const SparsityPattern &a, const SparsityPattern &b)
+{
+  if (a.n_rows() != b.n_rows() || a.n_cols() != b.n_cols() ||
+      a.n_nonzero_elements() != b.n_nonzero_elements())
+    return false;
+  for (unsigned int row = 0; row < a.n_rows(); ++row)
+    {
+      if (a.row_length(row) != b.row_length(row))
+        return false;
+      for (unsigned int k = 0; k < a.row_length(row); ++k)
+        if (a.column_number(row, k) != b.column_number(row, k))
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void
+check(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, -1, 1);
+  tria.refine_global(2);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0 && cell->center()[1] < 0)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.begin_active(3)->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  constraints.add_line(0);
+  constraints.close();
+
+  for (const bool keep_constrained_dofs : {true, false})
+    {
+      DynamicSparsityPattern dsp(dof_handler.n_dofs());
+      DoFTools::make_sparsity_pattern(dof_handler,
+                                      dsp,
+                                      constraints,
+                                      keep_constrained_dofs);
+      SparsityPattern reference;
+      reference.copy_from(dsp);
+
+      SparsityPattern sparsity;
+      DoFTools::make_compressed_sparsity_pattern(dof_handler,
+                                                 sparsity,
+                                                 constraints,
+                                                 keep_constrained_dofs);
+
+      deallog << fe.get_name() << " keep constrained dofs "
+              << (keep_constrained_dofs ? "true" : "false")
+              << ", patterns equal: "
+              << (patterns_equal(sparsity, reference) ? "yes" : "no")
+              << ", compressed: " << (sparsity.is_compressed() ? "yes" : "no")
+              << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+  MultithreadInfo::set_thread_limit(4);
+
+  check<2>(FE_Q<2>(1));
+  check<2>(FE_Q<2>(3));
+  check<2>(FESystem<2>(FE_Q<2>(2), 2));
+  check<3>(FE_Q<3>(1));
+  check<3>(FE_Q<3>(2));
+}
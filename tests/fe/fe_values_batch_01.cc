@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that FEValuesBatch computes the same shape values, shape gradients,
+// quadrature points, Jacobians, and JxW values as FEValues on each lane,
+// for a curved mesh described by a high-order MappingQ, a scalar and a
+// vector-valued element, and batches that are only partially filled.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_shell(tria, Point<dim>(), 0.5, 1., 0, true);
+  tria.refine_global(1);
+
+  const MappingQ<dim> mapping(3);
+  const QGauss<dim>   quadrature(fe.degree + 1);
+  const UpdateFlags   flags = update_values | update_gradients |
+                            update_quadrature_points | update_jacobians |
+                            update_JxW_values;
+
+  FEValues<dim>      fe_values(mapping, fe, quadrature, flags);
+  FEValuesBatch<dim> fe_batch(mapping, fe, quadrature, flags);
+
+  std::vector<typename Triangulation<dim>::active_cell_iterator> cells;
+  for (const auto &cell : tria.active_cell_iterators())
+    cells.push_back(cell);
+
+  constexpr unsigned int n_lanes = FEValuesBatch<dim>::n_lanes;
+
+  double max_error = 0.;
+  for (unsigned int start = 0, batch = 0; start < cells.size(); ++batch)
+    {
+      // use partially filled batches in every other step
+      const unsigned int n_cells =
+        std::min<std::size_t>(batch % 2 == 0 ? n_lanes :
+                                               std::max(n_lanes / 2, 1U),
+                              cells.size() - start);
+      fe_batch.reinit(
+        ArrayView<const typename Triangulation<dim>::active_cell_iterator>(
+          cells.data() + start, n_cells));
+
+      for (unsigned int lane = 0; lane < fe_batch.n_active_lanes(); ++lane)
+        {
+          fe_values.reinit(cells[start + lane]);
+          for (const unsigned int q : fe_values.quadrature_point_indices())
+            {
+              max_error = std::max(max_error,
+                                   std::abs(fe_values.JxW(q) -
+                                            fe_batch.JxW(q)[lane]) /
+                                     fe_values.JxW(q));
+              for (unsigned int d = 0; d < dim; ++d)
+                {
+                  max_error =
+                    std::max(max_error,
+                             std::abs(fe_values.quadrature_point(q)[d] -
+                                      fe_batch.quadrature_point(q)[d][lane]));
+                  for (unsigned int e = 0; e < dim; ++e)
+                    max_error =
+                      std::max(max_error,
+                               std::abs(fe_values.jacobian(q)[d][e] -
+                                        fe_batch.jacobian(q)[d][e][lane]));
+                }
+              for (const unsigned int i : fe_values.dof_indices())
+                {
+                  max_error = std::max(max_error,
+                                       std::abs(fe_values.shape_value(i, q) -
+                                                fe_batch.shape_value(i, q)[0]));
+                  for (unsigned int d = 0; d < dim; ++d)
+                    max_error = std::max(
+                      max_error,
+                      std::abs(fe_values.shape_grad(i, q)[d] -
+                               fe_batch.shape_grad(i, q)[d][lane]));
+                }
+            }
+        }
+
+      start += n_cells;
+    }
+
+  deallog << fe.get_name() << ": " << (max_error < 1e-10 ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>(FE_Q<2>(2));
+  test<2>(FESystem<2>(FE_Q<2>(3), 2));
+  test<3>(FE_Q<3>(2));
+  test<3>(FESystem<3>(FE_Q<3>(1), 3));
+}
@@ -0,0 +1,124 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that FEValues objects that share the precomputed data of the finite
+// element, because they use the same element, mapping, quadrature formula,
+// and update flags, compute the same values and gradients as a FEValues
+// object with its own data, also when they are reinitialized on different
+// cells in an interleaved way and when the objects that created the shared
+// data have gone out of scope.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <memory>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+double
+compare(const FEValues<dim> &fe_values, const FEValues<dim> &reference)
+{
+  double max_error = 0.;
+  for (const unsigned int q : fe_values.quadrature_point_indices())
+    for (const unsigned int i : fe_values.dof_indices())
+      for (unsigned int c = 0; c < fe_values.get_fe().n_components(); ++c)
+        {
+          max_error =
+            std::max(max_error,
+                     std::abs(fe_values.shape_value_component(i, q, c) -
+                              reference.shape_value_component(i, q, c)));
+          max_error =
+            std::max(max_error,
+                     (fe_values.shape_grad_component(i, q, c) -
+                      reference.shape_grad_component(i, q, c))
+                       .norm());
+        }
+  return max_error;
+}
+
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_shell(tria, Point<dim>(), 0.5, 1.);
+  tria.refine_global(1);
+
+  const MappingQ<dim> mapping(2);
+  const QGauss<dim>   quadrature(fe.degree + 1);
+  const UpdateFlags   flags = update_values | update_gradients;
+
+  // the reference object requests different flags and thus does not share
+  // its data with the other objects
+  FEValues<dim> reference(mapping, fe, quadrature, flags | update_hessians);
+
+  double max_error = 0.;
+  for (unsigned int round = 0; round < 2; ++round)
+    {
+      // in the second round, the objects of the first round are gone and
+      // the data is computed anew
+      std::vector<std::unique_ptr<FEValues<dim>>> fe_values;
+      for (unsigned int i = 0; i < 3; ++i)
+        fe_values.push_back(
+          std::make_unique<FEValues<dim>>(mapping, fe, quadrature, flags));
+
+      std::vector<typename Triangulation<dim>::active_cell_iterator> cells;
+      for (const auto &cell : tria.active_cell_iterators())
+        cells.push_back(cell);
+
+      for (unsigned int c = 0; c + fe_values.size() <= cells.size();
+           c += fe_values.size())
+        {
+          for (unsigned int i = 0; i < fe_values.size(); ++i)
+            fe_values[i]->reinit(cells[c + i]);
+          for (unsigned int i = 0; i < fe_values.size(); ++i)
+            {
+              reference.reinit(cells[c + i]);
+              max_error =
+                std::max(max_error, compare(*fe_values[i], reference));
+            }
+        }
+    }
+
+  deallog << fe.get_name() << ": " << (max_error < 1e-12 ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>(FE_Q<2>(3));
+  test<2>(FESystem<2>(FE_Q<2>(2), 2, FE_Q<2>(1), 1));
+  test<3>(FE_Q<3>(2));
+  test<3>(FESystem<3>(FE_Q<3>(2), 3, FE_Q<3>(1), 1));
+}
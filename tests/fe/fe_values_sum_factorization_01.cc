@@ -0,0 +1,228 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that FEValues::get_function_values() and
+// FEValues::get_function_gradients() compute the same results with sum
+// factorization as with the tabulated shape functions, for scalar and
+// vector-valued tensor-product elements on a deformed mesh, and that sum
+// factorization is only used for supported elements and quadrature formulas.
+// FE_Hermite, whose shape functions are rescaled on each cell, is checked on
+// a mesh of non-unit rectangular cells with MappingCartesian.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgp.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_hermite.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_cartesian.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe,
+     const Quadrature<dim>    &quadrature,
+     const bool                cartesian_mesh = false)
+{
+  Triangulation<dim> tria;
+  if (cartesian_mesh)
+    {
+      Point<dim> p1, p2;
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          p1[d] = -1. - d;
+          p2[d] = 2.;
+        }
+      GridGenerator::hyper_rectangle(tria, p1, p2);
+      tria.refine_global(1);
+    }
+  else
+    {
+      GridGenerator::hyper_ball(tria);
+      tria.refine_global(1);
+      GridTools::distort_random(0.1, tria);
+    }
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = random_value<double>();
+
+  const MappingQ<dim>         mapping_q(2);
+  const MappingCartesian<dim> mapping_cartesian;
+  const Mapping<dim>         &mapping =
+    cartesian_mesh ? static_cast<const Mapping<dim> &>(mapping_cartesian) :
+                     static_cast<const Mapping<dim> &>(mapping_q);
+
+  const UpdateFlags flags = update_values | update_gradients;
+  FEValues<dim>     fe_values(mapping, fe, quadrature, flags);
+  FEValues<dim>     fe_values_sf(mapping, fe, quadrature, flags);
+  fe_values_sf.enable_sum_factorization();
+
+  deallog << fe.get_name() << ": sum factorization "
+          << (fe_values_sf.uses_sum_factorization() ? "enabled" : "disabled");
+
+  const unsigned int n_q_points   = quadrature.size();
+  const unsigned int n_components = fe.n_components();
+  double             max_error    = 0.;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+      fe_values_sf.reinit(cell);
+
+      if (n_components == 1)
+        {
+          std::vector<double>         values(n_q_points), values_sf(n_q_points);
+          std::vector<Tensor<1, dim>> gradients(n_q_points),
+            gradients_sf(n_q_points);
+          fe_values.get_function_values(solution, values);
+          fe_values.get_function_gradients(solution, gradients);
+          fe_values_sf.get_function_values(solution, values_sf);
+          fe_values_sf.get_function_gradients(solution, gradients_sf);
+
+          // the variants with indices of the degrees of freedom
+          std::vector<types::global_dof_index> dof_indices(
+            fe.n_dofs_per_cell());
+          cell->get_dof_indices(dof_indices);
+          std::vector<double>         values_ind(n_q_points);
+          std::vector<Tensor<1, dim>> gradients_ind(n_q_points);
+          fe_values_sf.get_function_values(solution,
+                                           make_array_view(dof_indices),
+                                           values_ind);
+          fe_values_sf.get_function_gradients(solution,
+                                              make_array_view(dof_indices),
+                                              gradients_ind);
+
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            {
+              max_error =
+                std::max(max_error, std::abs(values[q] - values_sf[q]));
+              max_error =
+                std::max(max_error, std::abs(values[q] - values_ind[q]));
+              max_error =
+                std::max(max_error, (gradients[q] - gradients_sf[q]).norm());
+              max_error =
+                std::max(max_error, (gradients[q] - gradients_ind[q]).norm());
+            }
+        }
+      else
+        {
+          std::vector<Vector<double>> values(n_q_points,
+                                             Vector<double>(n_components)),
+            values_sf(n_q_points, Vector<double>(n_components));
+          std::vector<std::vector<Tensor<1, dim>>> gradients(
+            n_q_points, std::vector<Tensor<1, dim>>(n_components)),
+            gradients_sf(n_q_points, std::vector<Tensor<1, dim>>(n_components));
+          fe_values.get_function_values(solution, values);
+          fe_values.get_function_gradients(solution, gradients);
+          fe_values_sf.get_function_values(solution, values_sf);
+          fe_values_sf.get_function_gradients(solution, gradients_sf);
+
+          // the variants with indices of the degrees of freedom, with the
+          // quadrature points running fastest for the gradients
+          std::vector<types::global_dof_index> dof_indices(
+            fe.n_dofs_per_cell());
+          cell->get_dof_indices(dof_indices);
+          std::vector<Vector<double>> values_ind(n_q_points,
+                                                 Vector<double>(n_components));
+          std::vector<std::vector<Tensor<1, dim>>> gradients_ind(
+            n_components, std::vector<Tensor<1, dim>>(n_q_points));
+          fe_values_sf.get_function_values(solution,
+                                           make_array_view(dof_indices),
+                                           values_ind);
+          fe_values_sf.get_function_gradients(solution,
+                                              make_array_view(dof_indices),
+                                              make_array_view(gradients_ind),
+                                              true);
+
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            for (unsigned int c = 0; c < n_components; ++c)
+              {
+                max_error =
+                  std::max(max_error, std::abs(values[q][c] - values_sf[q][c]));
+                max_error =
+                  std::max(max_error,
+                           std::abs(values[q][c] - values_ind[q][c]));
+                max_error =
+                  std::max(max_error,
+                           (gradients[q][c] - gradients_sf[q][c]).norm());
+                max_error =
+                  std::max(max_error,
+                           (gradients[q][c] - gradients_ind[c][q]).norm());
+              }
+        }
+    }
+
+  deallog << ", results " << (max_error < 1e-10 ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  const QGauss<dim> quadrature(4);
+
+  test<dim>(FE_Q<dim>(1), quadrature);
+  test<dim>(FE_Q<dim>(3), quadrature);
+  test<dim>(FE_DGQ<dim>(2), quadrature);
+  test<dim>(FESystem<dim>(FE_Q<dim>(2), dim), quadrature);
+
+  // more quadrature points than shape functions in each direction
+  test<dim>(FE_Q<dim>(1), QGauss<dim>(5));
+
+  // not supported: an element that is not a full tensor product, a system of
+  // different elements, and a quadrature formula that is not a tensor
+  // product
+  test<dim>(FE_DGP<dim>(2), quadrature);
+  test<dim>(FESystem<dim>(FE_Q<dim>(2), dim, FE_Q<dim>(1), 1), quadrature);
+  test<dim>(FE_Q<dim>(2),
+            Quadrature<dim>(quadrature.get_points(), quadrature.get_weights()));
+
+  // not supported: an element whose shape functions are rescaled on each
+  // cell
+  test<dim>(FE_Hermite<dim>(3), quadrature, true);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,231 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that FEInterfaceValues::enable_face_data_reuse() gives the same
+// results as a freshly initialized object when every interface of a mesh
+// with hanging nodes is visited from both sides in succession, repeatedly
+// from the same side, and after the vertices of the mesh have been moved,
+// either through GridTools::scale() or directly with an explicit call to
+// enable_face_data_reuse() to discard the data.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_interface_values.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+
+// The arguments of FEInterfaceValues::reinit() for one side of an interface
+template <int dim>
+struct InterfaceSide
+{
+  typename DoFHandler<dim>::cell_iterator cell;
+  unsigned int                            face_no;
+  unsigned int                            sub_face_no;
+};
+
+
+
+template <int dim>
+double
+compare(const FEInterfaceValues<dim> &fiv,
+        const FEInterfaceValues<dim> &reference,
+        const Vector<double>         &solution)
+{
+  if (fiv.get_interface_dof_indices() !=
+        reference.get_interface_dof_indices() ||
+      fiv.get_cell(0) != reference.get_cell(0) ||
+      fiv.get_cell(1) != reference.get_cell(1))
+    return 1.;
+
+  for (const unsigned int i : fiv.dof_indices())
+    if (fiv.interface_dof_to_dof_indices(i) !=
+        reference.interface_dof_to_dof_indices(i))
+      return 1.;
+
+  std::vector<double> jumps(fiv.n_quadrature_points),
+    jumps_reference(fiv.n_quadrature_points);
+  fiv.get_jump_in_function_values(solution, jumps);
+  reference.get_jump_in_function_values(solution, jumps_reference);
+
+  double max_error = 0.;
+  for (const unsigned int q : fiv.quadrature_point_indices())
+    {
+      max_error = std::max(max_error, std::abs(fiv.JxW(q) - reference.JxW(q)));
+      max_error =
+        std::max(max_error, (fiv.normal(q) - reference.normal(q)).norm());
+      max_error = std::max(max_error,
+                           (fiv.get_quadrature_points()[q] -
+                            reference.get_quadrature_points()[q])
+                             .norm());
+      max_error = std::max(max_error, std::abs(jumps[q] - jumps_reference[q]));
+      for (const unsigned int i : fiv.dof_indices())
+        {
+          max_error =
+            std::max(max_error,
+                     std::abs(fiv.jump_in_shape_values(i, q) -
+                              reference.jump_in_shape_values(i, q)));
+          max_error =
+            std::max(max_error,
+                     (fiv.average_of_shape_gradients(i, q) -
+                      reference.average_of_shape_gradients(i, q))
+                       .norm());
+        }
+    }
+  return max_error;
+}
+
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = random_value<double>();
+
+  // collect all interfaces, seen from both sides
+  std::vector<std::pair<InterfaceSide<dim>, InterfaceSide<dim>>> interfaces;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    for (const unsigned int f : cell->face_indices())
+      if (!cell->at_boundary(f))
+        {
+          const auto neighbor = cell->neighbor(f);
+          if (cell->neighbor_is_coarser(f))
+            {
+              const auto face_pair = cell->neighbor_of_coarser_neighbor(f);
+              interfaces.push_back(
+                {{cell, f, numbers::invalid_unsigned_int},
+                 {neighbor, face_pair.first, face_pair.second}});
+            }
+          else if (neighbor->has_children())
+            for (unsigned int sf = 0; sf < cell->face(f)->n_children(); ++sf)
+              interfaces.push_back(
+                {{cell, f, sf},
+                 {cell->neighbor_child_on_subface(f, sf),
+                  cell->neighbor_of_neighbor(f),
+                  numbers::invalid_unsigned_int}});
+          else
+            interfaces.push_back(
+              {{cell, f, numbers::invalid_unsigned_int},
+               {neighbor,
+                cell->neighbor_of_neighbor(f),
+                numbers::invalid_unsigned_int}});
+        }
+
+  const MappingQ<dim>   mapping(2);
+  const QGauss<dim - 1> quadrature(fe.degree + 1);
+
+  const UpdateFlags flags = update_values | update_gradients |
+                            update_quadrature_points | update_normal_vectors |
+                            update_JxW_values;
+
+  FEInterfaceValues<dim> fiv(mapping, fe, quadrature, flags);
+  fiv.enable_face_data_reuse();
+  FEInterfaceValues<dim> reference(mapping, fe, quadrature, flags);
+
+  const auto reinit = [](FEInterfaceValues<dim>   &fe_interface_values,
+                         const InterfaceSide<dim> &side,
+                         const InterfaceSide<dim> &side_neighbor) {
+    fe_interface_values.reinit(side.cell,
+                               side.face_no,
+                               side.sub_face_no,
+                               side_neighbor.cell,
+                               side_neighbor.face_no,
+                               side_neighbor.sub_face_no);
+  };
+
+  double max_error = 0.;
+  for (const auto &[side, side_neighbor] : interfaces)
+    {
+      // both sides in succession, and the same side twice
+      for (const bool swap : {false, true, true})
+        {
+          const auto &first  = swap ? side_neighbor : side;
+          const auto &second = swap ? side : side_neighbor;
+          reinit(fiv, first, second);
+          reinit(reference, first, second);
+          max_error = std::max(max_error, compare(fiv, reference, solution));
+        }
+    }
+  deallog << fe.get_name() << ": " << (max_error < 1e-12 ? "OK" : "FAILED")
+          << std::endl;
+
+  // the data must not be reused after the mesh has been moved, neither the
+  // one of the FEFaceValues objects nor the support points of the cell kept
+  // by MappingQ, so compare to a new object on the same interface
+  const auto &[side, side_neighbor] = interfaces.front();
+  reinit(fiv, side, side_neighbor);
+  GridTools::scale(0.5, tria);
+  reinit(fiv, side, side_neighbor);
+  {
+    FEInterfaceValues<dim> reference(mapping, fe, quadrature, flags);
+    reinit(reference, side, side_neighbor);
+    deallog << fe.get_name() << " after mesh movement: "
+            << (compare(fiv, reference, solution) < 1e-12 ? "OK" : "FAILED")
+            << std::endl;
+  }
+
+  // moving the vertices directly is not noticed by the FEFaceValues
+  // objects, so the data needs to be discarded explicitly
+  reinit(fiv, side, side_neighbor);
+  GridTools::distort_random(0.1, tria);
+  fiv.enable_face_data_reuse();
+  reinit(fiv, side, side_neighbor);
+  {
+    FEInterfaceValues<dim> reference(mapping, fe, quadrature, flags);
+    reinit(reference, side, side_neighbor);
+    deallog << fe.get_name() << " after distort_random: "
+            << (compare(fiv, reference, solution) < 1e-12 ? "OK" : "FAILED")
+            << std::endl;
+  }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>(FE_Q<2>(2));
+  test<2>(FE_DGQ<2>(1));
+  test<3>(FE_Q<3>(2));
+  test<3>(FE_DGQ<3>(1));
+}
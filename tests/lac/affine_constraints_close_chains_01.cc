@@ -0,0 +1,57 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check that AffineConstraints::close() resolves long chains of
+// constraints, both in the order of increasing and decreasing indices,
+// including constraints to an inhomogeneity only
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include "../tests.h"
+
+
+void
+test(const bool reverse)
+{
+  deallog << (reverse ? "decreasing" : "increasing") << " chain" << std::endl;
+
+  // x_k = 1/2 x_{k+1} + 1/2 x_8 + 1 with k+1 replaced by k-1 for the
+  // decreasing chain, x_8 = 2, and x_9 unconstrained
+  const unsigned int        n = 8;
+  AffineConstraints<double> constraints;
+  for (unsigned int k = 1; k < n - 1; ++k)
+    {
+      const unsigned int i    = reverse ? n - 1 - k : k;
+      const unsigned int next = reverse ? i - 1 : i + 1;
+      constraints.add_constraint(i, {{next, 0.5}, {n, 0.5}}, 1.);
+    }
+  constraints.add_constraint(reverse ? 0 : n - 1, {{n + 1, 1.}}, 0.);
+  constraints.add_constraint(n, {}, 2.);
+  constraints.close();
+
+  constraints.print(deallog.get_file_stream());
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(false);
+  test(true);
+}
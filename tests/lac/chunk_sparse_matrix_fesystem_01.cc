@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check ChunkSparseMatrix with the chunk size equal to the number of
+// components of an FESystem, which uses the vectorized kernels for the
+// matrix-vector products: compare vmult, Tvmult, vmult_add and
+// precondition_Jacobi against a SparseMatrix assembled with the same cell
+// matrices, on a mesh with hanging nodes
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/chunk_sparse_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+template <int dim, typename number>
+void
+test(const unsigned int degree, const unsigned int n_components)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FE_Q<dim> fe_q(degree);
+  FESystem<dim>   fe(fe_q, n_components);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<number> constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  constraints.close();
+
+  SparsityPattern      sparsity;
+  ChunkSparsityPattern chunk_sparsity;
+  {
+    DynamicSparsityPattern dsp(dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern(dof, dsp, constraints, false);
+    sparsity.copy_from(dsp);
+    chunk_sparsity.copy_from(dsp, n_components);
+  }
+  SparseMatrix<number>      sparse(sparsity);
+  ChunkSparseMatrix<number> chunk_sparse(chunk_sparsity);
+
+  // random cell matrices with a dominant diagonal, such that the diagonal
+  // of the global matrix is nonzero for the Jacobi preconditioner
+  FullMatrix<number> local_mat(fe.dofs_per_cell, fe.dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices(fe.dofs_per_cell);
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+          local_mat(i, j) = random_value<number>() + (i == j ? 10. : 0.);
+      cell->get_dof_indices(local_dof_indices);
+      constraints.distribute_local_to_global(local_mat,
+                                             local_dof_indices,
+                                             sparse);
+      constraints.distribute_local_to_global(local_mat,
+                                             local_dof_indices,
+                                             chunk_sparse);
+    }
+
+  Vector<number> src(dof.n_dofs()), dst(dof.n_dofs()), ref(dof.n_dofs());
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src(i) = random_value<number>();
+
+  const double tolerance = std::is_same_v<number, float> ? 1e-5 : 1e-12;
+  const auto   check     = [&](const std::string &name) {
+    dst -= ref;
+    deallog << name << " error below tolerance: "
+            << (dst.linfty_norm() < tolerance * ref.linfty_norm() ? "yes" :
+                                                                          "no")
+            << std::endl;
+  };
+
+  sparse.vmult(ref, src);
+  chunk_sparse.vmult(dst, src);
+  check("vmult");
+
+  sparse.vmult_add(ref, src);
+  chunk_sparse.vmult(dst, src);
+  chunk_sparse.vmult_add(dst, src);
+  check("vmult_add");
+
+  sparse.Tvmult(ref, src);
+  chunk_sparse.Tvmult(dst, src);
+  check("Tvmult");
+
+  sparse.precondition_Jacobi(ref, src, 0.8);
+  chunk_sparse.precondition_Jacobi(dst, src, 0.8);
+  check("precondition_Jacobi");
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, double>(1, 2);
+  test<2, double>(2, 3);
+  test<2, float>(2, 2);
+  deallog.pop();
+  deallog.push("3d");
+  test<3, double>(1, 3);
+  test<3, double>(2, 4);
+  test<3, float>(1, 4);
+  deallog.pop();
+}
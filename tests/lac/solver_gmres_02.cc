@@ -0,0 +1,117 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+// Check the fused classical Gram-Schmidt orthogonalization used by
+// SolverGMRES for distributed vectors: The norm of the orthogonalized
+// vector obtained from the single reduction must agree with the norm
+// computed explicitly, and the basis must remain orthonormal also for more
+// than 128 basis vectors and when the new vector is almost contained in the
+// span of the previous vectors.
+
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_gmres.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+double
+orthogonality_error(
+  const internal::SolverGMRESImplementation::TmpVectors<VectorType> &basis,
+  const unsigned int                                                 n_vectors)
+{
+  double error = 0;
+  for (unsigned int i = 0; i < n_vectors; ++i)
+    for (unsigned int j = 0; j <= i; ++j)
+      error = std::max(error,
+                       std::abs(basis[i] * basis[j] - (i == j ? 1. : 0.)));
+  return error;
+}
+
+
+
+void
+test(const unsigned int size, const unsigned int max_dim)
+{
+  deallog << "Vector size " << size << ", basis size " << max_dim
+          << std::endl;
+
+  GrowingVectorMemory<VectorType> memory;
+  VectorType                      template_vector(size);
+  Vector<double>                  h(max_dim + 1);
+
+  internal::SolverGMRESImplementation::TmpVectors<VectorType> basis(max_dim + 2,
+                                                                    memory);
+
+  VectorType &first = basis(0, template_vector);
+  for (unsigned int i = 0; i < size; ++i)
+    first(i) = random_value<double>();
+  first /= first.l2_norm();
+
+  bool norms_agree = true;
+  for (unsigned int dim = 1; dim <= max_dim; ++dim)
+    {
+      VectorType &vv = basis(dim, template_vector);
+      for (unsigned int i = 0; i < size; ++i)
+        vv(i) = random_value<double>();
+
+      // For every tenth vector, make the new vector almost linearly
+      // dependent on the previous ones to check the path with explicit norm
+      // computation
+      if (dim % 10 == 0)
+        {
+          vv *= 1e-8;
+          for (unsigned int i = 0; i < dim; ++i)
+            vv.add(1. + i, basis[i]);
+        }
+
+      bool         re_orthogonalize = false;
+      const double norm =
+        internal::SolverGMRESImplementation::iterated_gram_schmidt(
+          LinearAlgebra::OrthogonalizationStrategy::classical_gram_schmidt,
+          basis,
+          dim,
+          0,
+          vv,
+          h,
+          re_orthogonalize);
+
+      const double explicit_norm = vv.l2_norm();
+      if (std::abs(norm - explicit_norm) > 1e-10 * explicit_norm)
+        norms_agree = false;
+
+      vv /= norm;
+    }
+
+  deallog << "Norms agree with explicit computation: "
+          << (norms_agree ? "yes" : "no") << std::endl;
+  deallog << "Basis orthonormal: "
+          << (orthogonality_error(basis, max_dim + 1) < 1e-10 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(97, 20);
+  test(1013, 150);
+}
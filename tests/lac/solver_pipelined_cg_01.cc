@@ -0,0 +1,81 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+// Check SolverPipelinedCG for a diagonal matrix, both for the generic path
+// with dealii::Vector and the path with merged vector updates for
+// LinearAlgebra::distributed::Vector. The residuals should be the same as
+// the ones of SolverCG (see solver_cg_interleave_01).
+
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+template <typename VectorType>
+SolverControl::State
+monitor_norm(const unsigned int iteration,
+             const double       check_value,
+             const VectorType &)
+{
+  deallog << "   Pipelined CG residual at iteration " << iteration << ": "
+          << check_value << std::endl;
+  return SolverControl::success;
+}
+
+
+
+template <typename VectorType>
+void
+test()
+{
+  // Create diagonal matrix with entries between 1 and 30
+  DiagonalMatrix<VectorType> matrix;
+  matrix.get_vector().reinit(30);
+  for (unsigned int i = 0; i < matrix.m(); ++i)
+    matrix.get_vector()(i) = i + 1;
+
+  DiagonalMatrix<VectorType> unit_matrix;
+  unit_matrix.get_vector().reinit(30);
+  unit_matrix.get_vector() = 1.0;
+
+  VectorType rhs(matrix.m()), sol(matrix.m());
+  rhs = 1.;
+
+  deallog << "Solve with PreconditionIdentity: " << std::endl;
+  SolverControl                 control(30, 1e-4);
+  SolverPipelinedCG<VectorType> solver(control);
+  solver.connect(&monitor_norm<VectorType>);
+  solver.solve(matrix, sol, rhs, PreconditionIdentity());
+
+  deallog << "Solve with diagonal preconditioner: " << std::endl;
+  sol = 0;
+  solver.solve(matrix, sol, rhs, unit_matrix);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<Vector<double>>();
+  test<LinearAlgebra::distributed::Vector<double>>();
+}
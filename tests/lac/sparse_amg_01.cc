@@ -0,0 +1,116 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// solve the five-point Laplace problem with CG preconditioned by SparseAMG
+// and check that the number of iterations stays bounded as the mesh is
+// refined, that the preconditioner is symmetric, and that repeated V-cycles
+// through step() converge on their own
+
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+#include "../testmatrix.h"
+
+
+template <typename number>
+void
+test(const unsigned int size)
+{
+  const unsigned int dim = (size - 1) * (size - 1);
+  deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<number> A(structure);
+  testproblem.five_point(A);
+
+  typename SparseAMG<number>::AdditionalData data;
+  data.max_coarse_size = 20;
+  SparseAMG<number> amg;
+  amg.initialize(A, data);
+
+  deallog << "Levels:";
+  for (unsigned int level = 0; level < amg.n_levels(); ++level)
+    deallog << ' ' << amg.get_level_matrix(level).m();
+  deallog << std::endl;
+
+  // the V-cycle needs to be symmetric for the use within CG
+  Vector<number> u(dim), v(dim), Bu(dim), Bv(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    {
+      u(i) = random_value<number>();
+      v(i) = random_value<number>();
+    }
+  amg.vmult(Bu, u);
+  amg.vmult(Bv, v);
+  deallog << "Symmetric: "
+          << (std::abs(v * Bu - u * Bv) < 1e-4 * std::abs(v * Bu) ? "yes" :
+                                                                      "no")
+          << std::endl;
+
+  // the residual of the float variant cannot be reduced by much more than
+  // three orders of magnitude in float precision
+  const double   tolerance = std::is_same_v<number, float> ? 1e-3 : 1e-6;
+  Vector<number> solution(dim), rhs(dim);
+  rhs = 1.;
+
+  {
+    SolverControl            control(100, tolerance * rhs.l2_norm());
+    SolverCG<Vector<number>> solver(control);
+    check_solver_within_range(solver.solve(A, solution, rhs, amg),
+                              control.last_step(),
+                              1,
+                              13);
+  }
+
+  {
+    solution = 0.;
+    Vector<number> residual(dim);
+    unsigned int   n_cycles = 0;
+    for (; n_cycles < 100; ++n_cycles)
+      if (A.residual(residual, solution, rhs) < tolerance * rhs.l2_norm())
+        break;
+      else
+        amg.step(solution, rhs);
+    if (n_cycles <= 35)
+      deallog << "V-cycles converged within 35 steps" << std::endl;
+    else
+      deallog << "V-cycles converged after " << n_cycles << " steps"
+              << std::endl;
+  }
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog << std::setprecision(4);
+
+  for (unsigned int size = 16; size <= 128; size *= 2)
+    test<double>(size);
+
+  test<float>(64);
+}
@@ -0,0 +1,199 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that SparseMatrixSELL gives the same results as the SparseMatrix it
+// is created from for vmult, Tvmult, residual and the element access, for
+// different sorting scopes, and that it can be used in SolverCG with
+// PreconditionChebyshev.
+
+
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+#include "../testmatrix.h"
+
+
+
+template <typename number>
+void
+check_operations()
+{
+  const double tolerance = std::is_same_v<number, float> ? 1e-5 : 1e-12;
+
+  FDMatrix        testproblem(23, 17);
+  const auto      size = (23 - 1) * (17 - 1);
+  SparsityPattern sparsity(size, size, 9);
+  testproblem.nine_point_structure(sparsity);
+  sparsity.compress();
+  SparseMatrix<number> matrix(sparsity);
+  testproblem.nine_point(matrix, true);
+
+  Vector<number> src(size), src_t(size), dst(size), dst_ref(size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+      src(i)   = random_value<number>();
+      src_t(i) = random_value<number>();
+    }
+
+  for (const unsigned int sorting_scope :
+       {SparseMatrixSELL<number>::slice_size,
+        32 * SparseMatrixSELL<number>::slice_size,
+        1024 * SparseMatrixSELL<number>::slice_size})
+    {
+      deallog << "Sorting scope "
+              << sorting_scope / SparseMatrixSELL<number>::slice_size
+              << " slices" << std::endl;
+
+      const SparseMatrixSELL<number> sell(matrix, sorting_scope);
+      deallog << "Nonzero elements match: "
+              << (sell.n_nonzero_elements() == matrix.n_nonzero_elements() ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      bool elements_match = true;
+      for (unsigned int i = 0; i < size; i += 7)
+        for (unsigned int j = 0; j < size; ++j)
+          if (sell.el(i, j) != matrix.el(i, j))
+            elements_match = false;
+      deallog << "Elements match: " << (elements_match ? "yes" : "no")
+              << std::endl;
+
+      matrix.vmult(dst_ref, src);
+      sell.vmult(dst, src);
+      dst -= dst_ref;
+      deallog << "vmult error below tolerance: "
+              << (dst.linfty_norm() < tolerance * dst_ref.linfty_norm() ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      dst_ref = src_t;
+      dst     = src_t;
+      matrix.vmult_add(dst_ref, src);
+      sell.vmult_add(dst, src);
+      dst -= dst_ref;
+      deallog << "vmult_add error below tolerance: "
+              << (dst.linfty_norm() < tolerance * dst_ref.linfty_norm() ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      matrix.Tvmult(dst_ref, src);
+      sell.Tvmult(dst, src);
+      dst -= dst_ref;
+      deallog << "Tvmult error below tolerance: "
+              << (dst.linfty_norm() < tolerance * dst_ref.linfty_norm() ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      dst_ref = src_t;
+      dst     = src_t;
+      matrix.Tvmult_add(dst_ref, src);
+      sell.Tvmult_add(dst, src);
+      dst -= dst_ref;
+      deallog << "Tvmult_add error below tolerance: "
+              << (dst.linfty_norm() < tolerance * dst_ref.linfty_norm() ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      const number norm_ref = matrix.residual(dst_ref, src, src_t);
+      const number norm     = sell.residual(dst, src, src_t);
+      dst -= dst_ref;
+      deallog << "residual error below tolerance: "
+              << (dst.linfty_norm() < tolerance * dst_ref.linfty_norm() &&
+                      std::abs(norm - norm_ref) < tolerance * norm_ref ?
+                    "yes" :
+                    "no")
+              << std::endl;
+    }
+}
+
+
+
+void
+check_solver()
+{
+  FDMatrix        testproblem(33, 33);
+  const auto      size = 32 * 32;
+  SparsityPattern sparsity(size, size, 5);
+  testproblem.five_point_structure(sparsity);
+  sparsity.compress();
+  SparseMatrix<double> matrix(sparsity);
+  testproblem.five_point(matrix);
+  const SparseMatrixSELL<double> sell(matrix);
+
+  Vector<double> rhs(size), solution(size), solution_ref(size);
+  for (unsigned int i = 0; i < size; ++i)
+    rhs(i) = random_value<double>();
+
+  PreconditionChebyshev<SparseMatrix<double>, Vector<double>> prec_ref;
+  PreconditionChebyshev<SparseMatrixSELL<double>, Vector<double>> prec;
+  PreconditionChebyshev<SparseMatrixSELL<double>,
+                        Vector<double>>::AdditionalData data;
+  data.degree = 3;
+  prec.initialize(sell, data);
+  prec_ref.initialize(matrix,
+                      PreconditionChebyshev<SparseMatrix<double>,
+                                            Vector<double>>::AdditionalData(3));
+
+  {
+    SolverControl control(1000, 1e-10 * rhs.l2_norm(), false, false);
+    SolverCG<Vector<double>> solver(control);
+    solver.solve(matrix, solution_ref, rhs, prec_ref);
+  }
+  {
+    SolverControl control(1000, 1e-10 * rhs.l2_norm(), false, false);
+    SolverCG<Vector<double>> solver(control);
+    solver.solve(sell, solution, rhs, prec);
+    deallog << "CG with Chebyshev converged: "
+            << (control.last_check() == SolverControl::success ? "yes" : "no")
+            << std::endl;
+  }
+
+  solution -= solution_ref;
+  deallog << "Solution matches SparseMatrix: "
+          << (solution.linfty_norm() < 1e-8 * solution_ref.linfty_norm() ?
+                "yes" :
+                "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("float");
+  check_operations<float>();
+  deallog.pop();
+  deallog.push("double");
+  check_operations<double>();
+  deallog.pop();
+
+  check_solver();
+}
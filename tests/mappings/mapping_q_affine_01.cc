@@ -0,0 +1,190 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check the quadrature points, Jacobians, inverse Jacobians, and JxW values
+// computed by MappingQ with the shortcut for affine cells enabled on a mesh
+// with both affine and non-affine cells, with a tensor-product and a general
+// quadrature formula, and with the cache of the cell data enabled over
+// several sweeps, a refinement, a movement of the mesh, and an explicit
+// clearing of the cache after the vertices have been moved directly. The
+// reference values are computed from
+// MappingQ::transform_unit_to_real_cell() with central finite differences,
+// which are exact for the quadratic mapping used here up to roundoff.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+Point<dim>
+deformation(const Point<dim> &p)
+{
+  // an affine map everywhere, plus a bilinear perturbation for x > 0.5 that
+  // turns the cells there into general quadrilaterals/hexahedra
+  Point<dim> q = p;
+  q[0] = 2. * p[0] + 0.3 * p[1] + 0.2 * std::max(p[0] - 0.5, 0.) * p[1];
+  q[1] = p[1] - 0.1 * p[0];
+  return q;
+}
+
+
+
+template <int dim>
+double
+compute_error(const MappingQ<dim>      &mapping,
+              const Triangulation<dim> &tria,
+              FEValues<dim>            &fe_values)
+{
+  const Quadrature<dim> &quadrature = fe_values.get_quadrature();
+  const double           h          = 1e-4;
+
+  double max_error = 0.;
+  for (const auto &cell : tria.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        {
+          const Point<dim> &unit_point = quadrature.point(q);
+          const Point<dim>  point =
+            mapping.transform_unit_to_real_cell(cell, unit_point);
+
+          Tensor<2, dim> jacobian;
+          for (unsigned int e = 0; e < dim; ++e)
+            {
+              Point<dim> left = unit_point, right = unit_point;
+              left[e] -= h;
+              right[e] += h;
+              const Tensor<1, dim> derivative =
+                (mapping.transform_unit_to_real_cell(cell, right) -
+                 mapping.transform_unit_to_real_cell(cell, left)) /
+                (2. * h);
+              for (unsigned int d = 0; d < dim; ++d)
+                jacobian[d][e] = derivative[d];
+            }
+          const Tensor<2, dim> inverse_jacobian = invert(jacobian);
+
+          max_error =
+            std::max(max_error, (fe_values.quadrature_point(q) - point).norm());
+          max_error = std::max(max_error,
+                               std::abs(fe_values.JxW(q) -
+                                        determinant(jacobian) *
+                                          quadrature.weight(q)) /
+                                 fe_values.JxW(q));
+          for (unsigned int d = 0; d < dim; ++d)
+            for (unsigned int e = 0; e < dim; ++e)
+              {
+                max_error =
+                  std::max(max_error,
+                           std::abs(fe_values.jacobian(q)[d][e] -
+                                    jacobian[d][e]));
+                max_error =
+                  std::max(max_error,
+                           std::abs(fe_values.inverse_jacobian(q)[d][e] -
+                                    inverse_jacobian[d][e]));
+              }
+        }
+    }
+  return max_error;
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, 4);
+  GridTools::transform(&deformation<dim>, tria);
+
+  const FE_Q<dim>   fe(1);
+  const UpdateFlags flags = update_quadrature_points | update_jacobians |
+                            update_inverse_jacobians | update_JxW_values;
+
+  const QGauss<dim>     quadrature(3);
+  const Quadrature<dim> general_quadrature(quadrature.get_points(),
+                                           quadrature.get_weights());
+
+  MappingQ<dim> mapping(2);
+  mapping.enable_affine_fast_path();
+  {
+    FEValues<dim> fe_values(mapping, fe, quadrature, flags);
+    deallog << "tensor-product quadrature: "
+            << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" :
+                                                                "FAILED")
+            << std::endl;
+  }
+  {
+    FEValues<dim> fe_values(mapping, fe, general_quadrature, flags);
+    deallog << "general quadrature: "
+            << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" :
+                                                                "FAILED")
+            << std::endl;
+  }
+
+  mapping.enable_cell_data_cache();
+  FEValues<dim> fe_values(mapping, fe, quadrature, flags);
+  for (unsigned int sweep = 0; sweep < 2; ++sweep)
+    deallog << "cached, sweep " << sweep << ": "
+            << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" :
+                                                                "FAILED")
+            << std::endl;
+
+  tria.refine_global(1);
+  deallog << "cached, after refinement: "
+          << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" : "FAILED")
+          << std::endl;
+
+  GridTools::scale(0.5, tria);
+  deallog << "cached, after mesh movement: "
+          << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" : "FAILED")
+          << std::endl;
+
+  // moving the vertices directly is not signaled by the triangulation, so
+  // the cache needs to be cleared explicitly
+  GridTools::distort_random(0.05, tria);
+  mapping.clear_cell_data_cache();
+  deallog << "cached, after clear_cell_data_cache: "
+          << (compute_error(mapping, tria, fe_values) < 1e-9 ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
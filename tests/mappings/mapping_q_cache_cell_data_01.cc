@@ -0,0 +1,107 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check that MappingQCache::initialize() clears the geometry data cached by
+// FEValues objects created before, see MappingQ::enable_cell_data_cache(),
+// such that the quadrature points follow the new support points
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+#include <deal.II/fe/mapping_q_cache.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+
+  const MappingQ<dim> mapping(1);
+  MappingQCache<dim>  mapping_cache(1);
+  mapping_cache.enable_affine_fast_path();
+  mapping_cache.enable_cell_data_cache();
+
+  // stretch the mesh in x direction by the given factor
+  const auto initialize = [&](const double factor) {
+    mapping_cache.initialize(
+      mapping,
+      tria,
+      [&](const typename Triangulation<dim>::cell_iterator &,
+          const Point<dim> &p) {
+        Point<dim> q = p;
+        q[0] *= factor;
+        return q;
+      },
+      false);
+  };
+  initialize(1.);
+
+  // the FEValues object is kept over the steps, so its cache would return
+  // the quadrature points of the first step if it was not cleared by
+  // initialize()
+  const FE_Q<dim>   fe(1);
+  const QGauss<dim> quadrature(2);
+
+  FEValues<dim> fe_values(mapping_cache,
+                          fe,
+                          quadrature,
+                          update_quadrature_points);
+
+  for (unsigned int step = 0; step < 3; ++step)
+    {
+      const double factor = 1. + 0.5 * step;
+      initialize(factor);
+
+      double error = 0;
+      for (unsigned int sweep = 0; sweep < 2; ++sweep)
+        for (const auto &cell : tria.active_cell_iterators())
+          {
+            fe_values.reinit(cell);
+            for (const unsigned int q : fe_values.quadrature_point_indices())
+              error += std::abs(
+                fe_values.quadrature_point(q)[0] -
+                factor *
+                  mapping.transform_unit_to_real_cell(cell,
+                                                      quadrature.point(q))[0]);
+          }
+      deallog << "step " << step << ": " << (error < 1e-12 ? "OK" : "FAILED")
+              << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
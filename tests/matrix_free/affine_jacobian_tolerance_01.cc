@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check MatrixFree::AdditionalData::affine_jacobian_tolerance: On a mesh
+// whose vertices have been perturbed very slightly, the cells are not affine
+// with the default settings, but are detected as affine (and thus stored
+// with a single Jacobian per cell) with a relative tolerance of 1e-6. The
+// integrals computed with the compressed geometry must agree with the exact
+// ones to high accuracy. For a larger perturbation compressed with a relative
+// tolerance of 1e-2, the volume of the mesh must still be the same as the
+// one computed by FEValues. Both the MappingQ path and the general FEValues
+// path (via MappingManifold) are checked.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_manifold.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const Mapping<dim> &mapping,
+     const double        tolerance,
+     const double        perturbation = 1e-9)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(3);
+  GridTools::transform(
+    [&](const Point<dim> &p) {
+      Point<dim> result = p;
+      double     factor = perturbation;
+      for (unsigned int d = 0; d < dim; ++d)
+        factor *= std::sin(numbers::PI * p[d]);
+      for (unsigned int d = 0; d < dim; ++d)
+        result[d] += factor * (d + 1);
+      return result;
+    },
+    tria);
+
+  FE_DGQ<dim>     fe(2);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MatrixFree<dim, double>                          mf_data;
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.mapping_update_flags =
+    update_gradients | update_JxW_values | update_quadrature_points;
+  data.affine_jacobian_tolerance = tolerance;
+  mf_data.reinit(mapping, dof, constraints, QGauss<1>(3), data);
+
+  bool   all_affine = true;
+  double volume     = 0;
+  double moment     = 0;
+
+  FEEvaluation<dim, 2> fe_eval(mf_data);
+  for (unsigned int cell = 0; cell < mf_data.n_cell_batches(); ++cell)
+    {
+      fe_eval.reinit(cell);
+      if (fe_eval.get_cell_type() > internal::MatrixFreeFunctions::affine)
+        all_affine = false;
+      VectorizedArray<double> local_volume = 0, local_moment = 0;
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+        {
+          local_volume += fe_eval.JxW(q);
+          local_moment +=
+            fe_eval.JxW(q) * fe_eval.quadrature_point(q)[0] *
+            fe_eval.quadrature_point(q)[dim - 1];
+        }
+      for (unsigned int v = 0;
+           v < mf_data.n_active_entries_per_cell_batch(cell);
+           ++v)
+        {
+          volume += local_volume[v];
+          moment += local_moment[v];
+        }
+    }
+
+  // the volume of the compressed cells must be the one computed with the
+  // Jacobians in all quadrature points
+  double        reference_volume = 0;
+  FEValues<dim> fe_values(mapping, fe, QGauss<dim>(3), update_JxW_values);
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        reference_volume += fe_values.JxW(q);
+    }
+
+  deallog << "Perturbation " << perturbation << ", tolerance " << tolerance
+          << ", all cells affine: " << (all_affine ? "yes" : "no")
+          << ", volume: " << volume << ", moment: " << moment
+          << ", volume exact: "
+          << (std::abs(volume - reference_volume) < 1e-12 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  deallog << std::setprecision(8);
+
+  {
+    deallog.push("MappingQ");
+    MappingQ<2> mapping(1);
+    test<2>(mapping, 0.);
+    test<2>(mapping, 1e-6);
+    test<2>(mapping, 0., 1e-4);
+    test<2>(mapping, 1e-2, 1e-4);
+    deallog.pop();
+  }
+  {
+    deallog.push("MappingManifold");
+    MappingManifold<2> mapping;
+    test<2>(mapping, 0.);
+    test<2>(mapping, 1e-6);
+    test<2>(mapping, 0., 1e-4);
+    test<2>(mapping, 1e-2, 1e-4);
+    deallog.pop();
+  }
+  {
+    deallog.push("MappingQ");
+    MappingQ<3> mapping(2);
+    test<3>(mapping, 0.);
+    test<3>(mapping, 1e-6);
+    test<3>(mapping, 0., 1e-4);
+    test<3>(mapping, 1e-2, 1e-4);
+    deallog.pop();
+  }
+}
@@ -0,0 +1,254 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check the variants of the sum-factorization kernels on cells selected by
+// ShapeInfo::cell_kernel_variant: all variants must give the same values
+// and gradients in the quadrature points and the same integrals. Then check
+// that MatrixFree::AdditionalData::tune_evaluation_kernels stores the
+// selection in the cache file and reads it again.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/cell_kernel_tuning.h>
+#include <deal.II/matrix_free/evaluation_template_factory.h>
+#include <deal.II/matrix_free/fe_evaluation_data.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/shape_info.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test_variants(const FiniteElement<dim> &fe, const unsigned int n_q_points_1d)
+{
+  using VectorizedArrayType = VectorizedArray<double>;
+  using namespace internal::MatrixFreeFunctions;
+
+  ShapeInfo<VectorizedArrayType> shape_info(QGauss<1>(n_q_points_1d), fe, 0);
+  const unsigned int n_components = fe.element_multiplicity(0);
+  const unsigned int n_dofs =
+    shape_info.dofs_per_component_on_cell * n_components;
+  const unsigned int n_q_points = shape_info.n_q_points;
+
+  deallog << "Testing " << fe.get_name() << " with " << n_q_points_1d
+          << " points" << std::endl;
+
+  AlignedVector<VectorizedArrayType> dofs(n_dofs);
+  for (unsigned int i = 0; i < n_dofs; ++i)
+    for (unsigned int v = 0; v < VectorizedArrayType::size(); ++v)
+      dofs[i][v] = random_value<double>();
+
+  std::vector<double> reference_quad, reference_dofs;
+  for (const CellKernelVariant variant :
+       {CellKernelVariant::heuristic,
+        CellKernelVariant::transform_to_collocation,
+        CellKernelVariant::even_odd,
+        CellKernelVariant::general})
+    {
+      shape_info.cell_kernel_variant = variant;
+
+      AlignedVector<VectorizedArrayType>                 scratch_data;
+      FEEvaluationData<dim, VectorizedArrayType, false> eval(shape_info);
+      eval.set_data_pointers(&scratch_data, n_components);
+      internal::FEEvaluationFactory<dim, VectorizedArrayType>::evaluate(
+        n_components,
+        EvaluationFlags::values | EvaluationFlags::gradients,
+        dofs.data(),
+        eval);
+
+      std::vector<double> quad;
+      for (unsigned int i = 0; i < n_components * n_q_points; ++i)
+        quad.push_back(eval.begin_values()[i][0]);
+      for (unsigned int i = 0; i < n_components * dim * n_q_points; ++i)
+        quad.push_back(eval.begin_gradients()[i][0]);
+
+      AlignedVector<VectorizedArrayType> result(n_dofs);
+      internal::FEEvaluationFactory<dim, VectorizedArrayType>::integrate(
+        n_components,
+        EvaluationFlags::values | EvaluationFlags::gradients,
+        result.data(),
+        eval,
+        false);
+      std::vector<double> integrals;
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        integrals.push_back(result[i][0]);
+
+      if (variant == CellKernelVariant::heuristic)
+        {
+          reference_quad = quad;
+          reference_dofs = integrals;
+        }
+      else
+        {
+          double error_quad = 0, error_dofs = 0, norm_quad = 0, norm_dofs = 0;
+          for (unsigned int i = 0; i < quad.size(); ++i)
+            {
+              error_quad = std::max(error_quad,
+                                    std::abs(quad[i] - reference_quad[i]));
+              norm_quad  = std::max(norm_quad, std::abs(reference_quad[i]));
+            }
+          for (unsigned int i = 0; i < integrals.size(); ++i)
+            {
+              error_dofs = std::max(error_dofs,
+                                    std::abs(integrals[i] - reference_dofs[i]));
+              norm_dofs  = std::max(norm_dofs, std::abs(reference_dofs[i]));
+            }
+          deallog << "Variant " << static_cast<int>(variant)
+                  << " matches heuristic: "
+                  << (error_quad < 1e-12 * norm_quad &&
+                          error_dofs < 1e-12 * norm_dofs ?
+                        "yes" :
+                        "no")
+                  << std::endl;
+        }
+    }
+
+  const CellKernelVariant tuned =
+    tune_cell_kernel_variant<dim>(shape_info, n_components);
+  deallog << "Tuning selected a specific variant: "
+          << (tuned != CellKernelVariant::heuristic ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+void
+test_cache()
+{
+  using namespace internal::MatrixFreeFunctions;
+
+  const std::string filename = "kernel_cache.txt";
+  std::remove(filename.c_str());
+  {
+    CellKernelVariantCache cache(filename);
+    cache.insert("model A dim=3 degree=4", CellKernelVariant::even_odd);
+    cache.insert("model B dim=2 degree=2", CellKernelVariant::general);
+    cache.write();
+  }
+
+  CellKernelVariantCache cache(filename);
+  CellKernelVariant      variant = CellKernelVariant::heuristic;
+  deallog << "Found entry A: "
+          << (cache.find("model A dim=3 degree=4", variant) ? "yes" : "no")
+          << ", variant " << static_cast<int>(variant) << std::endl;
+  deallog << "Found entry B: "
+          << (cache.find("model B dim=2 degree=2", variant) ? "yes" : "no")
+          << ", variant " << static_cast<int>(variant) << std::endl;
+  deallog << "Found entry C: "
+          << (cache.find("model C dim=2 degree=2", variant) ? "yes" : "no")
+          << std::endl;
+
+  // two caches created from the same file before either has written its
+  // entries must not remove the entries of the other one
+  {
+    CellKernelVariantCache cache_1(filename);
+    CellKernelVariantCache cache_2(filename);
+    cache_1.insert("model C dim=2 degree=2",
+                   CellKernelVariant::transform_to_collocation);
+    cache_2.insert("model D dim=3 degree=3", CellKernelVariant::even_odd);
+    cache_1.write();
+    cache_2.write();
+  }
+  {
+    CellKernelVariantCache cache_merged(filename);
+    unsigned int           n_found = 0;
+    for (const std::string key : {"model A dim=3 degree=4",
+                                  "model B dim=2 degree=2",
+                                  "model C dim=2 degree=2",
+                                  "model D dim=3 degree=3"})
+      n_found += cache_merged.find(key, variant) ? 1 : 0;
+    deallog << "Entries found after writing from two caches: " << n_found
+            << std::endl;
+  }
+  std::remove(filename.c_str());
+}
+
+
+
+void
+test_matrix_free()
+{
+  const std::string filename = "kernel_cache_matrix_free.txt";
+  std::remove(filename.c_str());
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  FE_Q<2>       fe(3);
+  DoFHandler<2> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MatrixFree<2, double>::AdditionalData data;
+  data.tune_evaluation_kernels      = true;
+  data.evaluation_kernel_cache_file = filename;
+
+  for (unsigned int run = 0; run < 2; ++run)
+    {
+      MatrixFree<2, double> matrix_free;
+      matrix_free.reinit(
+        MappingQ1<2>(), dof_handler, constraints, QGauss<1>(4), data);
+
+      std::ifstream file(filename);
+      std::string   line;
+      unsigned int  n_lines = 0;
+      while (std::getline(file, line))
+        ++n_lines;
+      deallog << "Run " << run << ", entries in cache file: " << n_lines
+              << ", kernel selected: "
+              << (matrix_free.get_shape_info().cell_kernel_variant !=
+                      internal::MatrixFreeFunctions::CellKernelVariant::
+                        heuristic ?
+                    "yes" :
+                    "no")
+              << std::endl;
+    }
+  std::remove(filename.c_str());
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test_variants<2>(FE_Q<2>(3), 4);
+  test_variants<2>(FE_Q<2>(3), 5);
+  test_variants<2>(FESystem<2>(FE_DGQ<2>(4), 2), 5);
+  test_variants<3>(FE_Q<3>(2), 3);
+  test_variants<3>(FE_Q<3>(4), 7);
+  test_cache();
+  test_matrix_free();
+}
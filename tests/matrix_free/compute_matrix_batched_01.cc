@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that MatrixFreeTools::compute_matrix() with a quadrature-point
+// operation, which evaluates and integrates all columns of the cell matrix
+// at once, gives the same matrix as the variant with the complete cell
+// operation on meshes with hanging nodes and curved cells, for scalar and
+// vector-valued elements and for an operator with Hessians
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree, int n_components, bool use_hessians>
+void
+test(const bool curved_mesh)
+{
+  using Number              = double;
+  using VectorizedArrayType = VectorizedArray<Number>;
+  using Integrator          = FEEvaluation<dim,
+                                  fe_degree,
+                                  fe_degree + 1,
+                                  n_components,
+                                  Number,
+                                  VectorizedArrayType>;
+
+  Triangulation<dim> tria;
+  if (curved_mesh)
+    GridGenerator::hyper_ball(tria);
+  else
+    GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FE_Q<dim> fe_q(fe_degree);
+  FESystem<dim>   fe(fe_q, n_components);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<Number> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  VectorTools::interpolate_boundary_values(
+    dof_handler, 0, Functions::ZeroFunction<dim>(n_components), constraints);
+  constraints.close();
+
+  typename MatrixFree<dim, Number, VectorizedArrayType>::AdditionalData data;
+  data.mapping_update_flags = update_values | update_gradients |
+                              update_JxW_values |
+                              (use_hessians ? update_hessians : update_default);
+
+  MatrixFree<dim, Number, VectorizedArrayType> matrix_free;
+  matrix_free.reinit(MappingQ<dim>(2),
+                     dof_handler,
+                     constraints,
+                     QGauss<1>(fe_degree + 1),
+                     data);
+
+  DynamicSparsityPattern dsp(dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints);
+  SparsityPattern sparsity_pattern;
+  sparsity_pattern.copy_from(dsp);
+
+  SparseMatrix<Number> reference(sparsity_pattern), batched(sparsity_pattern);
+
+  const auto evaluation_flags =
+    use_hessians ? (EvaluationFlags::values | EvaluationFlags::hessians) :
+                   (EvaluationFlags::values | EvaluationFlags::gradients);
+
+  // mass matrix plus either a Laplacian or a term with second derivatives
+  const auto quadrature_operation = [&](Integrator &phi) {
+    for (const unsigned int q : phi.quadrature_point_indices())
+      {
+        phi.submit_value(phi.get_value(q), q);
+        if (use_hessians)
+          phi.submit_hessian(phi.get_hessian(q), q);
+        else
+          phi.submit_gradient(phi.get_gradient(q), q);
+      }
+  };
+
+  MatrixFreeTools::compute_matrix<dim,
+                                  fe_degree,
+                                  fe_degree + 1,
+                                  n_components,
+                                  Number,
+                                  VectorizedArrayType,
+                                  SparseMatrix<Number>>(
+    matrix_free, constraints, reference, [&](Integrator &phi) {
+      phi.evaluate(evaluation_flags);
+      quadrature_operation(phi);
+      phi.integrate(evaluation_flags);
+    });
+
+  MatrixFreeTools::compute_matrix<dim,
+                                  fe_degree,
+                                  fe_degree + 1,
+                                  n_components,
+                                  Number,
+                                  VectorizedArrayType,
+                                  SparseMatrix<Number>>(matrix_free,
+                                                        constraints,
+                                                        batched,
+                                                        evaluation_flags,
+                                                        evaluation_flags,
+                                                        quadrature_operation);
+
+  batched.add(-1., reference);
+  deallog << "Testing " << fe.get_name() << (curved_mesh ? " curved" : "")
+          << (use_hessians ? " with Hessians" : "")
+          << ", difference below tolerance: "
+          << (batched.frobenius_norm() < 1e-12 * reference.frobenius_norm() ?
+                "yes" :
+                "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2, 1, 1, false>(false);
+  test<2, 3, 1, false>(false);
+  test<2, 3, 1, false>(true);
+  test<2, 2, 2, false>(true);
+  test<2, 2, 1, true>(false);
+  test<3, 2, 1, false>(true);
+  test<3, 2, 3, false>(false);
+}
@@ -0,0 +1,165 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check that copies of an FEEvaluation object do not share the storage of
+// the geometry computed in reinit() with
+// MatrixFree::AdditionalData::compute_geometry_on_the_fly: reinit() on a
+// copy must not change the data of the original object, and copies created
+// by the copy constructor and the assignment operator can be used
+// concurrently on several threads.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <thread>
+
+#include "../tests.h"
+
+
+template <int dim, typename Number>
+VectorizedArray<Number>
+compute_volume(FEEvaluation<dim, -1, 0, 1, Number> &phi,
+               const unsigned int                   cell)
+{
+  phi.reinit(cell);
+  VectorizedArray<Number> volume = 0;
+  for (const unsigned int q : phi.quadrature_point_indices())
+    volume += phi.JxW(q);
+  return volume;
+}
+
+
+
+template <typename Number>
+bool
+is_equal(const VectorizedArray<Number> &a, const VectorizedArray<Number> &b)
+{
+  for (unsigned int v = 0; v < VectorizedArray<Number>::size(); ++v)
+    if (a[v] != b[v])
+      return false;
+  return true;
+}
+
+
+
+template <int dim, typename Number>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(4 - dim);
+
+  const FE_Q<dim> fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  const MappingQ<dim> mapping(2);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MatrixFree<dim, Number>                          matrix_free;
+  typename MatrixFree<dim, Number>::AdditionalData data;
+  data.tasks_parallel_scheme =
+    MatrixFree<dim, Number>::AdditionalData::none;
+  data.mapping_update_flags        = update_JxW_values;
+  data.compute_geometry_on_the_fly = true;
+  matrix_free.reinit(mapping, dof_handler, constraints, QGauss<1>(3), data);
+
+  deallog << "Geometry on the fly: "
+          << (matrix_free.get_mapping_info().geometry_on_the_fly ? "yes" :
+                                                                    "no")
+          << std::endl;
+
+  const unsigned int n_cells = matrix_free.n_cell_batches();
+  FEEvaluation<dim, -1, 0, 1, Number>  phi(matrix_free);
+  std::vector<VectorizedArray<Number>> reference(n_cells);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+    reference[cell] = compute_volume(phi, cell);
+
+  // reinit() on a copy must not change the data of the original
+  {
+    compute_volume(phi, 0);
+    FEEvaluation<dim, -1, 0, 1, Number> copy(phi);
+    compute_volume(copy, n_cells - 1);
+    FEEvaluation<dim, -1, 0, 1, Number> assigned(matrix_free);
+    assigned = phi;
+    compute_volume(assigned, n_cells - 2);
+
+    VectorizedArray<Number> volume = 0;
+    for (const unsigned int q : phi.quadrature_point_indices())
+      volume += phi.JxW(q);
+    deallog << "Original unchanged by copies: "
+            << (is_equal(volume, reference[0]) ? "OK" : "FAILED")
+            << std::endl;
+  }
+
+  // copies of phi used concurrently on several threads, each thread working
+  // on every n_threads-th cell batch
+  const unsigned int                   n_threads = 4;
+  std::vector<VectorizedArray<Number>> result(n_cells);
+  std::vector<std::thread>             threads;
+  for (unsigned int t = 0; t < n_threads; ++t)
+    threads.emplace_back([&, t]() {
+      FEEvaluation<dim, -1, 0, 1, Number> copy(phi);
+      FEEvaluation<dim, -1, 0, 1, Number> assigned(matrix_free);
+      assigned = phi;
+      for (unsigned int repeat = 0; repeat < 20; ++repeat)
+        for (unsigned int cell = t; cell < n_cells; cell += n_threads)
+          {
+            result[cell] =
+              compute_volume(repeat % 2 == 0 ? copy : assigned, cell);
+            // give the other threads the chance to run in between
+            std::this_thread::yield();
+            AssertThrow(is_equal(result[cell], reference[cell]),
+                        ExcInternalError());
+          }
+    });
+  for (auto &thread : threads)
+    thread.join();
+
+  bool all_equal = true;
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+    all_equal &= is_equal(result[cell], reference[cell]);
+  deallog << "Threaded copies: " << (all_equal ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2, double>();
+  test<3, double>();
+  test<2, float>();
+}
@@ -0,0 +1,289 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that MatrixFreeOperators::Base::vmult() with operations before and
+// after the matrix-vector product gives the same result as the plain
+// vmult(), both for an active operator with hanging-node constraints and for
+// level operators with edge constraints, and that PreconditionChebyshev,
+// which runs its vector updates within these operations, computes the same
+// as for an operator that only provides the plain vmult()
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+// hides the vmult() variant with operations of the operator, so that
+// PreconditionChebyshev falls back to separate vector updates
+template <typename OperatorType>
+class PlainOperator : public Subscriptor
+{
+public:
+  using value_type = typename OperatorType::value_type;
+  using size_type  = typename OperatorType::size_type;
+  using VectorType = LinearAlgebra::distributed::Vector<value_type>;
+
+  PlainOperator(const OperatorType &op)
+    : op(op)
+  {}
+
+  size_type
+  m() const
+  {
+    return op.m();
+  }
+
+  size_type
+  n() const
+  {
+    return op.n();
+  }
+
+  value_type
+  el(const unsigned int row, const unsigned int col) const
+  {
+    return op.el(row, col);
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    op.vmult(dst, src);
+  }
+
+  void
+  Tvmult(VectorType &dst, const VectorType &src) const
+  {
+    op.Tvmult(dst, src);
+  }
+
+private:
+  const OperatorType &op;
+};
+
+
+
+template <typename OperatorType>
+void
+check(const OperatorType &op)
+{
+  using Number     = typename OperatorType::value_type;
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  VectorType src, dst, reference;
+  op.initialize_dof_vector(src);
+  op.initialize_dof_vector(dst);
+  op.initialize_dof_vector(reference);
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = random_value<Number>();
+
+  op.vmult(reference, src);
+
+  // fill the destination with garbage that the operation before the
+  // matrix-vector product needs to overwrite, and count the entries seen by
+  // the two operations
+  dst                   = 42.;
+  unsigned int n_before = 0;
+  unsigned int n_after  = 0;
+  VectorType   src_copy(src);
+  op.vmult(
+    dst,
+    src,
+    [&](const unsigned int begin, const unsigned int end) {
+      for (unsigned int i = begin; i < end; ++i)
+        dst.local_element(i) = 0.;
+      n_before += end - begin;
+    },
+    [&](const unsigned int begin, const unsigned int end) {
+      n_after += end - begin;
+    });
+  AssertThrow(n_before == src.locally_owned_size(), ExcInternalError());
+  AssertThrow(n_after == src.locally_owned_size(), ExcInternalError());
+
+  // the source vector must be left untouched
+  src_copy.add(-1., src);
+  AssertThrow(src_copy.linfty_norm() == 0., ExcInternalError());
+
+  dst.add(-1., reference);
+  AssertThrow(dst.linfty_norm() < 1e-12 * reference.linfty_norm(),
+              ExcInternalError());
+
+  // compare the Chebyshev iteration with the fused vector updates against
+  // the one with separate vector updates
+  using Smoother = PreconditionChebyshev<OperatorType, VectorType>;
+  typename Smoother::AdditionalData smoother_data;
+  smoother_data.smoothing_range     = 15.;
+  smoother_data.degree              = 5;
+  smoother_data.eig_cg_n_iterations = 15;
+  smoother_data.preconditioner      = op.get_matrix_diagonal_inverse();
+  Smoother smoother;
+  smoother.initialize(op, smoother_data);
+
+  using PlainSmoother =
+    PreconditionChebyshev<PlainOperator<OperatorType>, VectorType>;
+  typename PlainSmoother::AdditionalData plain_smoother_data;
+  plain_smoother_data.smoothing_range     = 15.;
+  plain_smoother_data.degree              = 5;
+  plain_smoother_data.eig_cg_n_iterations = 15;
+  plain_smoother_data.preconditioner      = op.get_matrix_diagonal_inverse();
+  const PlainOperator<OperatorType> plain_op(op);
+  PlainSmoother                     plain_smoother;
+  plain_smoother.initialize(plain_op, plain_smoother_data);
+
+  smoother.vmult(dst, src);
+  plain_smoother.vmult(reference, src);
+  dst.add(-1., reference);
+  AssertThrow(dst.linfty_norm() < 1e-10 * reference.linfty_norm(),
+              ExcInternalError());
+
+  op.initialize_dof_vector(dst);
+  op.initialize_dof_vector(reference);
+  for (unsigned int i = 0; i < dst.locally_owned_size(); ++i)
+    reference.local_element(i) = dst.local_element(i) = random_value<Number>();
+  smoother.step(dst, src);
+  plain_smoother.step(reference, src);
+  dst.add(-1., reference);
+  AssertThrow(dst.linfty_norm() < 1e-10 * reference.linfty_norm(),
+              ExcInternalError());
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  using Number     = double;
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+  using OperatorType = MatrixFreeOperators::
+    LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, VectorType>;
+
+  parallel::distributed::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::limit_level_difference_at_vertices,
+    parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->is_locally_owned() && cell->center().norm() < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FE_Q<dim> fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  dof.distribute_mg_dofs();
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  const MappingQ1<dim> mapping;
+
+  {
+    AffineConstraints<Number> constraints;
+    constraints.reinit(DoFTools::extract_locally_relevant_dofs(dof));
+    DoFTools::make_hanging_node_constraints(dof, constraints);
+    VectorTools::interpolate_boundary_values(dof,
+                                             0,
+                                             Functions::ZeroFunction<dim>(),
+                                             constraints);
+    constraints.close();
+
+    typename MatrixFree<dim, Number>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, Number>::AdditionalData::none;
+    const auto matrix_free = std::make_shared<MatrixFree<dim, Number>>();
+    matrix_free->reinit(
+      mapping, dof, constraints, QGauss<1>(fe_degree + 1), additional_data);
+
+    OperatorType op;
+    op.initialize(matrix_free);
+    op.compute_diagonal();
+    check(op);
+    deallog << "active operator OK" << std::endl;
+  }
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof, {0});
+
+  for (unsigned int level = 0; level < tria.n_global_levels(); ++level)
+    {
+      AffineConstraints<Number> level_constraints;
+      level_constraints.reinit(
+        DoFTools::extract_locally_relevant_level_dofs(dof, level));
+      level_constraints.add_lines(
+        mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      typename MatrixFree<dim, Number>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        MatrixFree<dim, Number>::AdditionalData::none;
+      additional_data.mg_level = level;
+      const auto matrix_free = std::make_shared<MatrixFree<dim, Number>>();
+      matrix_free->reinit(mapping,
+                          dof,
+                          level_constraints,
+                          QGauss<1>(fe_degree + 1),
+                          additional_data);
+
+      OperatorType op;
+      op.initialize(matrix_free, mg_constrained_dofs, level);
+      op.compute_diagonal();
+      check(op);
+      deallog << "level operator " << level << " OK" << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  mpi_initlog();
+
+  deallog.push("2d");
+  test<2, 1>();
+  test<2, 3>();
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3, 2>();
+  deallog.pop();
+}
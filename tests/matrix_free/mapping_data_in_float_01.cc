@@ -0,0 +1,164 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check MatrixFree::AdditionalData::store_mapping_data_in_float: the action
+// of a Laplace operator on a curved mesh (hyper ball) with the inverse
+// Jacobians and JxW values kept in single precision must agree with the one
+// with data in double precision up to the accuracy of float, both for the
+// MappingQ path and the general FEValues path (via MappingManifold) of the
+// setup, and in combination with the computation of the geometry on the
+// fly. For float numbers, the option has no effect.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_manifold.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim, typename Number>
+std::size_t
+apply_laplacian(const Mapping<dim>                               &mapping,
+                const DoFHandler<dim>                            &dof_handler,
+                const bool                                        in_float,
+                const bool                                        on_the_fly,
+                const LinearAlgebra::distributed::Vector<Number> &src,
+                LinearAlgebra::distributed::Vector<Number>       &dst)
+{
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MatrixFree<dim, Number>                          matrix_free;
+  typename MatrixFree<dim, Number>::AdditionalData data;
+  data.mapping_update_flags        = update_gradients | update_JxW_values;
+  data.store_mapping_data_in_float = in_float;
+  data.compute_geometry_on_the_fly = on_the_fly;
+  matrix_free.reinit(mapping,
+                     dof_handler,
+                     constraints,
+                     QGauss<1>(dof_handler.get_fe().degree + 1),
+                     data);
+
+  if (in_float)
+    deallog << "Mapping data in float: "
+            << (matrix_free.get_mapping_info().single_precision_cell_data ?
+                  "yes" :
+                  "no")
+            << std::endl;
+
+  matrix_free.initialize_dof_vector(dst);
+  matrix_free.template cell_loop<LinearAlgebra::distributed::Vector<Number>,
+                                 LinearAlgebra::distributed::Vector<Number>>(
+    [](const MatrixFree<dim, Number>                    &matrix_free,
+       LinearAlgebra::distributed::Vector<Number>       &dst,
+       const LinearAlgebra::distributed::Vector<Number> &src,
+       const std::pair<unsigned int, unsigned int>      &cell_range) {
+      FEEvaluation<dim, -1, 0, 1, Number> phi(matrix_free);
+      for (unsigned int cell = cell_range.first; cell < cell_range.second;
+           ++cell)
+        {
+          phi.reinit(cell);
+          phi.gather_evaluate(src,
+                              EvaluationFlags::values |
+                                EvaluationFlags::gradients);
+          for (unsigned int q = 0; q < phi.n_q_points; ++q)
+            {
+              phi.submit_value(phi.get_value(q), q);
+              phi.submit_gradient(phi.get_gradient(q), q);
+            }
+          phi.integrate_scatter(EvaluationFlags::values |
+                                  EvaluationFlags::gradients,
+                                dst);
+        }
+    },
+    dst,
+    src,
+    true);
+
+  return matrix_free.get_mapping_info().memory_consumption();
+}
+
+
+
+template <int dim, typename Number>
+void
+test(const unsigned int degree, const bool on_the_fly = false)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(1);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  MappingQ<dim>        mapping(degree);
+  MappingManifold<dim> mapping_manifold;
+
+  LinearAlgebra::distributed::Vector<Number> src(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src(i) = std::sin(0.37 * i);
+
+  const double tolerance = std::is_same_v<Number, float> ? 1e-4 : 1e-5;
+
+  deallog << "Testing dim=" << dim << " degree=" << degree << " "
+          << (std::is_same_v<Number, float> ? "float" : "double")
+          << (on_the_fly ? " with geometry on the fly" : "") << std::endl;
+  for (const Mapping<dim> *my_mapping :
+       std::vector<const Mapping<dim> *>{&mapping, &mapping_manifold})
+    {
+      LinearAlgebra::distributed::Vector<Number> reference, result;
+      const std::size_t memory_reference = apply_laplacian(
+        *my_mapping, dof_handler, false, on_the_fly, src, reference);
+      const std::size_t memory = apply_laplacian(
+        *my_mapping, dof_handler, true, on_the_fly, src, result);
+      result -= reference;
+      deallog << "Relative difference below tolerance: "
+              << (result.linfty_norm() < tolerance * reference.linfty_norm() ?
+                    "yes" :
+                    "no")
+              << ", memory reduced: "
+              << (memory < memory_reference ? "yes" : "no") << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2, double>(2);
+  test<2, double>(4);
+  test<2, float>(3);
+  test<3, double>(3);
+  test<3, double>(3, true);
+}
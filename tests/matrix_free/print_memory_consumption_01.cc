@@ -0,0 +1,125 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check the line with the memory per degree of freedom printed by
+// MatrixFree::print_memory_consumption(). The numbers themselves depend on
+// the platform (e.g., the width of the SIMD registers), so they are compared
+// against MatrixFree::memory_consumption() and
+// MappingInfo::memory_consumption() divided by the number of degrees of
+// freedom instead of being written to the output.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <sstream>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const bool curved, const unsigned int degree)
+{
+  Triangulation<dim> tria;
+  if (curved)
+    GridGenerator::hyper_ball(tria);
+  else
+    GridGenerator::hyper_cube(tria);
+  tria.refine_global(5 - dim);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MatrixFree<dim, double>                          matrix_free;
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.mapping_update_flags = update_gradients | update_JxW_values;
+  matrix_free.reinit(
+    MappingQ<dim>(2), dof_handler, constraints, QGauss<1>(degree + 1), data);
+
+  std::ostringstream stream;
+  std::ostream      &out = stream;
+  matrix_free.print_memory_consumption(out);
+
+  // find the line with the memory per DoF and read the two numbers of the
+  // form 'total / mapping bytes'
+  const std::string label = "Memory per DoF total / mapping:";
+
+  std::istringstream lines(stream.str());
+  std::string        line;
+  bool               found          = false;
+  double             memory_total   = 0;
+  double             memory_mapping = 0;
+  while (std::getline(lines, line))
+    if (line.find(label) != std::string::npos)
+      {
+        std::istringstream numbers(line.substr(line.find(label) +
+                                               label.size()));
+        std::string        separator;
+        numbers >> memory_total >> separator >> memory_mapping;
+        found = true;
+      }
+
+  const double n_dofs = dof_handler.n_dofs();
+  const double expected_total =
+    static_cast<double>(matrix_free.memory_consumption()) / n_dofs;
+  const double expected_mapping =
+    static_cast<double>(matrix_free.get_mapping_info().memory_consumption()) /
+    n_dofs;
+
+  deallog << "Testing dim=" << dim << " degree=" << degree
+          << (curved ? " curved" : " affine") << std::endl;
+  deallog << "Found memory per DoF: " << (found ? "yes" : "no") << std::endl;
+  const bool total_matches =
+    std::abs(memory_total - expected_total) < 1e-4 * expected_total;
+  const bool mapping_matches =
+    std::abs(memory_mapping - expected_mapping) < 1e-4 * expected_mapping;
+  deallog << "Total matches memory_consumption(): "
+          << (total_matches ? "yes" : "no") << std::endl;
+  deallog << "Mapping matches MappingInfo::memory_consumption(): "
+          << (mapping_matches ? "yes" : "no") << std::endl;
+  const bool mapping_below_total =
+    memory_mapping > 0 && memory_mapping < memory_total;
+  deallog << "Mapping below total: " << (mapping_below_total ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>(false, 2);
+  test<2>(true, 3);
+  test<3>(false, 2);
+  test<3>(true, 2);
+}
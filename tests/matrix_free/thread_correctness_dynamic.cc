@@ -0,0 +1,173 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests the correctness of the dynamic thread scheduling of the matrix-free
+// class against the serial loop on meshes with hanging nodes
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+#include "create_mesh.h"
+#include "matrix_vector_mf.h"
+
+
+template <int dim, int fe_degree, typename number>
+void
+sub_test()
+{
+  Triangulation<dim> tria;
+  create_mesh(tria);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center().norm() < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  if (dim == 2)
+    tria.refine_global(1);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+      unsigned int counter = 0;
+      for (const auto &cell : tria.active_cell_iterators())
+        if (counter++ % (7 - i) == 0)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+
+      dof.distribute_dofs(fe);
+      AffineConstraints<double> constraints;
+      DoFTools::make_hanging_node_constraints(dof, constraints);
+      VectorTools::interpolate_boundary_values(dof,
+                                               0,
+                                               Functions::ZeroFunction<dim>(),
+                                               constraints);
+      constraints.close();
+
+      MatrixFree<dim, number> mf_data, mf_data_dynamic, mf_data_dynamic_1;
+      {
+        const QGauss<1> quad(fe_degree + 1);
+        mf_data.reinit(MappingQ1<dim>{},
+                       dof,
+                       constraints,
+                       quad,
+                       typename MatrixFree<dim, number>::AdditionalData(
+                         MatrixFree<dim, number>::AdditionalData::none));
+        mf_data_dynamic.reinit(
+          MappingQ1<dim>{},
+          dof,
+          constraints,
+          quad,
+          typename MatrixFree<dim, number>::AdditionalData(
+            MatrixFree<dim, number>::AdditionalData::dynamic));
+
+        // block size of 1 cell batch, giving the largest number of colors
+        mf_data_dynamic_1.reinit(
+          MappingQ1<dim>{},
+          dof,
+          constraints,
+          quad,
+          typename MatrixFree<dim, number>::AdditionalData(
+            MatrixFree<dim, number>::AdditionalData::dynamic, 1));
+      }
+      deallog << "Dynamic scheme active: "
+              << (mf_data_dynamic.get_task_info().scheme ==
+                      internal::MatrixFreeFunctions::TaskInfo::dynamic ?
+                    "yes" :
+                    "no")
+              << std::endl;
+
+      MatrixFreeTest<dim, fe_degree, number> mf_ref(mf_data);
+      MatrixFreeTest<dim, fe_degree, number> mf_dynamic(mf_data_dynamic);
+      MatrixFreeTest<dim, fe_degree, number> mf_dynamic_1(mf_data_dynamic_1);
+      Vector<number>                         in_dist(dof.n_dofs());
+      Vector<number> out_dist(in_dist), out_dynamic(in_dist),
+        out_dynamic_1(in_dist);
+
+      for (unsigned int i = 0; i < dof.n_dofs(); ++i)
+        {
+          if (constraints.is_constrained(i))
+            continue;
+          const double entry = random_value<double>();
+          in_dist(i)         = entry;
+        }
+
+      mf_ref.vmult(out_dist, in_dist);
+
+      // the summation order into the vector entries differs from the serial
+      // loop, so compare with a tolerance
+      const double tolerance = (std::is_same_v<number, float> ? 1e-5 : 1e-12) *
+                               out_dist.linfty_norm();
+      for (unsigned int sweep = 0; sweep < 5; ++sweep)
+        {
+          mf_dynamic.vmult(out_dynamic, in_dist);
+          mf_dynamic_1.vmult(out_dynamic_1, in_dist);
+
+          out_dynamic -= out_dist;
+          out_dynamic_1 -= out_dist;
+          deallog << "Sweep " << sweep << ", error dynamic below tolerance: "
+                  << (out_dynamic.linfty_norm() < tolerance ? "yes" : "no")
+                  << ", with block size 1: "
+                  << (out_dynamic_1.linfty_norm() < tolerance ? "yes" : "no")
+                  << std::endl;
+        }
+    }
+  deallog << std::endl;
+}
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  deallog << "Test doubles" << std::endl;
+  sub_test<dim, fe_degree, double>();
+  deallog << "Test floats" << std::endl;
+  sub_test<dim, fe_degree, float>();
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 1>();
+  test<2, 2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 2>();
+  deallog.pop();
+}
@@ -0,0 +1,228 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Assemble the Laplace matrix and a right hand side with
+// MeshWorker::mesh_loop_batched() and FEValuesBatch, and compare with the
+// assembly through MeshWorker::mesh_loop() and FEValues.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/meshworker/copy_data.h>
+#include <deal.II/meshworker/mesh_loop.h>
+#include <deal.II/meshworker/scratch_data.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+struct BatchScratchData
+{
+  BatchScratchData(const Mapping<dim>       &mapping,
+                   const FiniteElement<dim> &fe,
+                   const Quadrature<dim>    &quadrature)
+    : fe_batch(mapping,
+               fe,
+               quadrature,
+               update_values | update_gradients | update_quadrature_points |
+                 update_JxW_values)
+  {}
+
+  FEValuesBatch<dim> fe_batch;
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(dim == 2 ? 3 : 1);
+  GridTools::distort_random(0.1, tria);
+
+  const FE_Q<dim>     fe(2);
+  const MappingQ<dim> mapping(2);
+  const QGauss<dim>   quadrature(fe.degree + 1);
+  DoFHandler<dim>     dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  const AffineConstraints<double> constraints;
+
+  SparsityPattern sparsity_pattern;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    sparsity_pattern.copy_from(dsp);
+  }
+
+  using CellIteratorType = decltype(dof_handler.begin_active());
+
+  // the reference assembly with FEValues
+  SparseMatrix<double> matrix(sparsity_pattern);
+  Vector<double>       rhs(dof_handler.n_dofs());
+  {
+    using ScratchData = MeshWorker::ScratchData<dim>;
+    using CopyData    = MeshWorker::CopyData<1, 1, 1>;
+
+    const auto cell_worker = [](const CellIteratorType &cell,
+                                ScratchData            &scratch_data,
+                                CopyData               &copy_data) {
+      const FEValues<dim> &fe_values = scratch_data.reinit(cell);
+      const unsigned int   dofs_per_cell = fe_values.dofs_per_cell;
+      copy_data.reinit(dofs_per_cell);
+      cell->get_dof_indices(copy_data.local_dof_indices[0]);
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        for (const unsigned int i : fe_values.dof_indices())
+          {
+            for (const unsigned int j : fe_values.dof_indices())
+              copy_data.matrices[0](i, j) +=
+                fe_values.shape_grad(i, q) * fe_values.shape_grad(j, q) *
+                fe_values.JxW(q);
+            copy_data.vectors[0](i) +=
+              fe_values.quadrature_point(q)[0] * fe_values.shape_value(i, q) *
+              fe_values.JxW(q);
+          }
+    };
+
+    const auto copier = [&](const CopyData &copy_data) {
+      constraints.distribute_local_to_global(copy_data.matrices[0],
+                                             copy_data.vectors[0],
+                                             copy_data.local_dof_indices[0],
+                                             matrix,
+                                             rhs);
+    };
+
+    MeshWorker::mesh_loop(dof_handler.active_cell_iterators(),
+                          cell_worker,
+                          copier,
+                          ScratchData(mapping,
+                                      fe,
+                                      quadrature,
+                                      update_values | update_gradients |
+                                        update_quadrature_points |
+                                        update_JxW_values),
+                          CopyData(),
+                          MeshWorker::assemble_own_cells);
+  }
+
+  // the assembly with FEValuesBatch, with one entry in the copy data per
+  // lane
+  SparseMatrix<double> matrix_batch(sparsity_pattern);
+  Vector<double>       rhs_batch(dof_handler.n_dofs());
+  {
+    using ScratchData = BatchScratchData<dim>;
+    using CopyData    = std::vector<MeshWorker::CopyData<1, 1, 1>>;
+    using CellBatch   = ArrayView<const CellIteratorType>;
+
+    const auto cell_worker = [](const CellBatch &cells,
+                                ScratchData     &scratch_data,
+                                CopyData        &copy_data) {
+      FEValuesBatch<dim> &fe_batch = scratch_data.fe_batch;
+      fe_batch.reinit(cells);
+
+      const unsigned int dofs_per_cell = fe_batch.dofs_per_cell;
+      Table<2, VectorizedArray<double>> cell_matrix(dofs_per_cell,
+                                                    dofs_per_cell);
+      AlignedVector<VectorizedArray<double>> cell_rhs(dofs_per_cell);
+      for (const unsigned int q : fe_batch.quadrature_point_indices())
+        for (const unsigned int i : fe_batch.dof_indices())
+          {
+            const Tensor<1, dim, VectorizedArray<double>> grad_i_JxW =
+              fe_batch.shape_grad(i, q) * fe_batch.JxW(q);
+            for (const unsigned int j : fe_batch.dof_indices())
+              cell_matrix(i, j) += grad_i_JxW * fe_batch.shape_grad(j, q);
+            cell_rhs[i] += fe_batch.quadrature_point(q)[0] *
+                           fe_batch.shape_value(i, q) * fe_batch.JxW(q);
+          }
+
+      copy_data.resize(cells.size());
+      for (unsigned int lane = 0; lane < cells.size(); ++lane)
+        {
+          copy_data[lane].reinit(dofs_per_cell);
+          cells[lane]->get_dof_indices(copy_data[lane].local_dof_indices[0]);
+          for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            {
+              for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                copy_data[lane].matrices[0](i, j) = cell_matrix(i, j)[lane];
+              copy_data[lane].vectors[0](i) = cell_rhs[i][lane];
+            }
+        }
+    };
+
+    const auto copier = [&](const CopyData &copy_data) {
+      for (const auto &copy : copy_data)
+        constraints.distribute_local_to_global(copy.matrices[0],
+                                               copy.vectors[0],
+                                               copy.local_dof_indices[0],
+                                               matrix_batch,
+                                               rhs_batch);
+    };
+
+    MeshWorker::mesh_loop_batched(dof_handler.active_cell_iterators(),
+                                  cell_worker,
+                                  copier,
+                                  ScratchData(mapping, fe, quadrature),
+                                  CopyData(),
+                                  FEValuesBatch<dim>::n_lanes);
+  }
+
+  matrix_batch.add(-1., matrix);
+  rhs_batch.add(-1., rhs);
+  deallog << "matrix "
+          << (matrix_batch.frobenius_norm() < 1e-12 * matrix.frobenius_norm() ?
+                "OK" :
+                "FAILED")
+          << std::endl;
+  deallog << "right hand side "
+          << (rhs_batch.l2_norm() < 1e-12 * rhs.l2_norm() ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
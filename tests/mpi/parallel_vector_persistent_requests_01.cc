@@ -0,0 +1,128 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check repeated update_ghost_values() and compress() calls, which re-use
+// the persistent MPI requests of the vector, also with different
+// communication channels, after swapping vectors and after reinit()
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "../tests.h"
+
+
+void
+check(LinearAlgebra::distributed::Vector<double> &v,
+      const unsigned int                          n_local,
+      const double                                offset)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int next    = ((myid + 1) % numproc) * n_local;
+  const unsigned int prev    = ((myid + numproc - 1) % numproc) * n_local;
+
+  for (unsigned int channel : {0U, 3U, 0U, 7U})
+    {
+      for (unsigned int i = 0; i < n_local; ++i)
+        v(myid * n_local + i) = offset + channel + myid * n_local + i;
+
+      v.update_ghost_values_start(channel);
+      v.update_ghost_values_finish();
+      AssertThrow(v(next) == offset + channel + next, ExcInternalError());
+      AssertThrow(v(prev + n_local - 1) ==
+                    offset + channel + prev + n_local - 1,
+                  ExcInternalError());
+      v.zero_out_ghost_values();
+
+      // every process adds one to the first entry of the next process and to
+      // the last entry of the previous process
+      v(next) += 1.;
+      v(prev + n_local - 1) += 1.;
+      v.compress_start(channel, VectorOperation::add);
+      v.compress_finish(VectorOperation::add);
+      AssertThrow(v(myid * n_local) == offset + channel + myid * n_local + 1.,
+                  ExcInternalError());
+      AssertThrow(v(myid * n_local + n_local - 1) ==
+                    offset + channel + myid * n_local + n_local,
+                  ExcInternalError());
+    }
+}
+
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  if (myid == 0)
+    deallog << "numproc=" << numproc << std::endl;
+
+  // each processor owns n_local indices and ghosts the first index of the next
+  // and the last index of the previous processor
+  for (const unsigned int n_local : {4U, 6U})
+    {
+      IndexSet local_owned(numproc * n_local);
+      local_owned.add_range(myid * n_local, myid * n_local + n_local);
+      IndexSet local_relevant = local_owned;
+      local_relevant.add_index(((myid + 1) % numproc) * n_local);
+      local_relevant.add_index(((myid + numproc - 1) % numproc) * n_local +
+                               n_local - 1);
+
+      LinearAlgebra::distributed::Vector<double> v(local_owned,
+                                                   local_relevant,
+                                                   MPI_COMM_WORLD);
+      LinearAlgebra::distributed::Vector<double> w(v);
+
+      check(v, n_local, 0.);
+      check(w, n_local, 10.);
+      check(v, n_local, 20.);
+
+      v.swap(w);
+      check(v, n_local, 30.);
+      check(w, n_local, 40.);
+
+      w.reinit(v);
+      check(w, n_local, 50.);
+      check(v, n_local, 60.);
+
+      if (myid == 0)
+        deallog << "OK with " << n_local << " local indices" << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      test();
+    }
+  else
+    test();
+}
@@ -0,0 +1,241 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that a vector created by the copy constructor or the assignment
+// operator from a vector whose persistent MPI requests have already been set
+// up gets its own requests: update_ghost_values() and compress() on the copy
+// and on the original must neither interfere with each other nor access the
+// memory of the other vector, also when the communication of both is in
+// flight at the same time
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+void
+fill(VectorType &v, const unsigned int n_local, const double offset)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  for (unsigned int i = 0; i < n_local; ++i)
+    v(myid * n_local + i) = offset + myid * n_local + i;
+}
+
+
+
+void
+check_ghosts(const VectorType  &v,
+             const unsigned int n_local,
+             const double       offset)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int next    = ((myid + 1) % numproc) * n_local;
+  const unsigned int prev    = ((myid + numproc - 1) % numproc) * n_local;
+
+  AssertThrow(v(next) == offset + next, ExcInternalError());
+  AssertThrow(v(prev + n_local - 1) == offset + prev + n_local - 1,
+              ExcInternalError());
+}
+
+
+
+// every process adds one to the first entry of the next process and to the
+// last entry of the previous process
+void
+add_to_ghosts(VectorType &v, const unsigned int n_local)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  v(((myid + 1) % numproc) * n_local) += 1.;
+  v(((myid + numproc - 1) % numproc) * n_local + n_local - 1) += 1.;
+}
+
+
+
+void
+check_compressed(const VectorType  &v,
+                 const unsigned int n_local,
+                 const double       offset)
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  AssertThrow(v(myid * n_local) == offset + myid * n_local + 1.,
+              ExcInternalError());
+  AssertThrow(v(myid * n_local + n_local - 1) ==
+                offset + myid * n_local + n_local,
+              ExcInternalError());
+  for (unsigned int i = 1; i < n_local - 1; ++i)
+    AssertThrow(v(myid * n_local + i) == offset + myid * n_local + i,
+                ExcInternalError());
+}
+
+
+
+// run one update_ghost_values() and one compress() on a single vector
+void
+check_single(VectorType &v, const unsigned int n_local, const double offset)
+{
+  fill(v, n_local, offset);
+  v.update_ghost_values();
+  check_ghosts(v, n_local, offset);
+  v.zero_out_ghost_values();
+
+  add_to_ghosts(v, n_local);
+  v.compress(VectorOperation::add);
+  check_compressed(v, n_local, offset);
+}
+
+
+
+// run one update_ghost_values() and one compress() on both vectors, one
+// after the other
+void
+check_sequential(VectorType        &v,
+                 VectorType        &w,
+                 const unsigned int n_local,
+                 const double       offset)
+{
+  fill(v, n_local, offset);
+  fill(w, n_local, offset + 100.);
+
+  v.update_ghost_values();
+  w.update_ghost_values();
+  check_ghosts(v, n_local, offset);
+  check_ghosts(w, n_local, offset + 100.);
+  v.zero_out_ghost_values();
+  w.zero_out_ghost_values();
+
+  add_to_ghosts(v, n_local);
+  add_to_ghosts(w, n_local);
+  w.compress(VectorOperation::add);
+  v.compress(VectorOperation::add);
+  check_compressed(v, n_local, offset);
+  check_compressed(w, n_local, offset + 100.);
+}
+
+
+
+// start the communication of both vectors before finishing any of them
+void
+check_overlapping(VectorType        &v,
+                  VectorType        &w,
+                  const unsigned int n_local,
+                  const double       offset)
+{
+  fill(v, n_local, offset);
+  fill(w, n_local, offset + 100.);
+
+  v.update_ghost_values_start(0);
+  w.update_ghost_values_start(1);
+  w.update_ghost_values_finish();
+  v.update_ghost_values_finish();
+  check_ghosts(v, n_local, offset);
+  check_ghosts(w, n_local, offset + 100.);
+  v.zero_out_ghost_values();
+  w.zero_out_ghost_values();
+
+  add_to_ghosts(v, n_local);
+  add_to_ghosts(w, n_local);
+  w.compress_start(1, VectorOperation::add);
+  v.compress_start(0, VectorOperation::add);
+  v.compress_finish(VectorOperation::add);
+  w.compress_finish(VectorOperation::add);
+  check_compressed(v, n_local, offset);
+  check_compressed(w, n_local, offset + 100.);
+}
+
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  if (myid == 0)
+    deallog << "numproc=" << numproc << std::endl;
+
+  // each processor owns n_local indices and ghosts the first index of the next
+  // and the last index of the previous processor
+  const unsigned int n_local = 5;
+  IndexSet           local_owned(numproc * n_local);
+  local_owned.add_range(myid * n_local, myid * n_local + n_local);
+  IndexSet local_relevant = local_owned;
+  local_relevant.add_index(((myid + 1) % numproc) * n_local);
+  local_relevant.add_index(((myid + numproc - 1) % numproc) * n_local +
+                           n_local - 1);
+
+  VectorType v(local_owned, local_relevant, MPI_COMM_WORLD);
+
+  // set up the persistent requests of v before copying it
+  check_single(v, n_local, 0.);
+
+  {
+    VectorType w(v);
+    check_sequential(v, w, n_local, 10.);
+    check_sequential(w, v, n_local, 20.);
+    check_overlapping(v, w, n_local, 30.);
+    check_overlapping(w, v, n_local, 40.);
+  }
+  if (myid == 0)
+    deallog << "Copy constructor OK" << std::endl;
+
+  // the requests of v must still be valid after the copy has been destroyed
+  check_single(v, n_local, 50.);
+
+  {
+    VectorType w;
+    w = v;
+    check_overlapping(v, w, n_local, 60.);
+    check_sequential(w, v, n_local, 70.);
+
+    // assign once more, now that the requests of w have been set up
+    w = v;
+    check_overlapping(w, v, n_local, 80.);
+    check_sequential(v, w, n_local, 90.);
+  }
+  if (myid == 0)
+    deallog << "Assignment OK" << std::endl;
+
+  check_single(v, n_local, 100.);
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      test();
+    }
+  else
+    test();
+}
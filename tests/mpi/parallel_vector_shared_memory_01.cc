@@ -0,0 +1,143 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check update_ghost_values() and compress() for vectors with a
+// shared-memory communicator, which access the entries of the processes
+// within that communicator directly, against a vector without shared
+// memory. The shared-memory communicator is either the full communicator of
+// the node or a subset of it, to mix the direct access with MPI messages.
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "../tests.h"
+
+
+void
+check(const MPI_Comm comm_sm, const unsigned int n_local)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  // each process ghosts a few entries of every other process, some of them
+  // in contiguous ranges
+  IndexSet locally_owned(numproc * n_local);
+  locally_owned.add_range(myid * n_local, (myid + 1) * n_local);
+  IndexSet ghosts(numproc * n_local);
+  for (unsigned int p = 0; p < numproc; ++p)
+    if (p != myid)
+      for (unsigned int k = 0; k < 4; ++k)
+        ghosts.add_index(p * n_local + (myid + 3 * k + k / 2) % n_local);
+
+  const auto partitioner =
+    std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                  ghosts,
+                                                  MPI_COMM_WORLD);
+  LinearAlgebra::distributed::Vector<double> v, reference;
+  v.reinit(partitioner, comm_sm);
+  reference.reinit(partitioner);
+
+  for (const unsigned int channel : {0U, 5U, 0U})
+    {
+      for (unsigned int i = 0; i < n_local; ++i)
+        {
+          v.local_element(i)         = 1. + channel + myid * n_local + i;
+          reference.local_element(i) = v.local_element(i);
+        }
+
+      v.update_ghost_values_start(channel);
+      v.update_ghost_values_finish();
+      reference.update_ghost_values();
+      for (const auto index : ghosts)
+        AssertThrow(v(index) == reference(index), ExcInternalError());
+
+      v.zero_out_ghost_values();
+      reference.zero_out_ghost_values();
+
+      for (const VectorOperation::values operation :
+           {VectorOperation::add, VectorOperation::max})
+        {
+          for (const auto index : ghosts)
+            {
+              v(index)         = 0.5 * (myid + 1) + index;
+              reference(index) = v(index);
+            }
+          v.compress_start(channel, operation);
+          v.compress_finish(operation);
+          reference.compress(operation);
+
+          for (unsigned int i = 0; i < n_local; ++i)
+            AssertThrow(v.local_element(i) == reference.local_element(i),
+                        ExcInternalError());
+          for (unsigned int i = 0; i < partitioner->n_ghost_indices(); ++i)
+            AssertThrow(v.local_element(n_local + i) == 0., ExcInternalError());
+        }
+    }
+
+  if (myid == 0)
+    deallog << "OK with " << n_local << " local indices" << std::endl;
+}
+
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  if (myid == 0)
+    deallog << "numproc=" << numproc << std::endl;
+
+  MPI_Comm comm_sm;
+  MPI_Comm_split_type(
+    MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myid, MPI_INFO_NULL, &comm_sm);
+
+  MPI_Comm comm_sm_half;
+  MPI_Comm_split(comm_sm,
+                 Utilities::MPI::this_mpi_process(comm_sm) % 2,
+                 myid,
+                 &comm_sm_half);
+
+  for (const MPI_Comm comm : {comm_sm, comm_sm_half})
+    for (const unsigned int n_local : {8U, 13U})
+      check(comm, n_local);
+
+  MPI_Comm_free(&comm_sm_half);
+  MPI_Comm_free(&comm_sm);
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      test();
+    }
+  else
+    test();
+}
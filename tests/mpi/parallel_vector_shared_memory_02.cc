@@ -0,0 +1,194 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// check that vectors with different shared-memory communicators can use
+// the same partitioner at the same time, and that the copy constructor,
+// reinit() from another vector, and the assignment operator take over the
+// shared-memory communicator of the source vector
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include "../tests.h"
+
+
+void
+check_ghosts(const LinearAlgebra::distributed::Vector<double> &v,
+             const IndexSet                                   &ghosts,
+             const double                                      shift)
+{
+  for (const auto index : ghosts)
+    AssertThrow(v(index) == shift + index, ExcInternalError());
+}
+
+
+
+void
+fill(LinearAlgebra::distributed::Vector<double> &v, const double shift)
+{
+  v.zero_out_ghost_values();
+  for (const auto index : v.locally_owned_elements())
+    v(index) = shift + index;
+  v.update_ghost_values();
+}
+
+
+
+void
+check(const MPI_Comm comm_sm, const MPI_Comm comm_sm_half)
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int n_local = 10;
+
+  IndexSet locally_owned(numproc * n_local);
+  locally_owned.add_range(myid * n_local, (myid + 1) * n_local);
+  IndexSet ghosts(numproc * n_local);
+  for (unsigned int p = 0; p < numproc; ++p)
+    if (p != myid)
+      for (unsigned int k = 0; k < 3; ++k)
+        ghosts.add_index(p * n_local + (myid + 4 * k) % n_local);
+
+  const auto partitioner =
+    std::make_shared<Utilities::MPI::Partitioner>(locally_owned,
+                                                  ghosts,
+                                                  MPI_COMM_WORLD);
+
+  // three vectors on the same partitioner, set up in an interleaved way
+  LinearAlgebra::distributed::Vector<double> v_sm, v_half, v_plain;
+  v_sm.reinit(partitioner, comm_sm);
+  v_plain.reinit(partitioner);
+  v_half.reinit(partitioner, comm_sm_half);
+
+  fill(v_sm, 1.);
+  fill(v_half, 2.);
+  fill(v_plain, 3.);
+  check_ghosts(v_sm, ghosts, 1.);
+  check_ghosts(v_half, ghosts, 2.);
+  check_ghosts(v_plain, ghosts, 3.);
+  if (myid == 0)
+    deallog << "Shared partitioner: " << v_sm.shared_vector_data().size()
+            << ' ' << v_half.shared_vector_data().size() << ' '
+            << v_plain.shared_vector_data().size() << std::endl;
+
+  // the copy constructor and reinit() take over the communicator; the copy
+  // constructor only copies the locally owned entries
+  LinearAlgebra::distributed::Vector<double> copy(v_half);
+  copy.update_ghost_values();
+  check_ghosts(copy, ghosts, 2.);
+  fill(copy, 4.);
+  check_ghosts(copy, ghosts, 4.);
+  check_ghosts(v_half, ghosts, 2.);
+
+  LinearAlgebra::distributed::Vector<float> v_float;
+  v_float.reinit(v_sm);
+  v_float.zero_out_ghost_values();
+  for (const auto index : locally_owned)
+    v_float(index) = 5. + index;
+  v_float.update_ghost_values();
+  for (const auto index : ghosts)
+    AssertThrow(v_float(index) == 5.f + index, ExcInternalError());
+  if (myid == 0)
+    deallog << "Copy constructor: " << copy.shared_vector_data().size()
+            << ", reinit: " << v_float.shared_vector_data().size()
+            << std::endl;
+
+  // the assignment operator takes over the communicator, also when the
+  // partitioner is the same
+  LinearAlgebra::distributed::Vector<double> w;
+  w.reinit(partitioner);
+  w = v_sm;
+  check_ghosts(w, ghosts, 1.);
+  fill(w, 6.);
+  check_ghosts(w, ghosts, 6.);
+  check_ghosts(v_sm, ghosts, 1.);
+  if (myid == 0)
+    deallog << "Assignment from shared: " << w.shared_vector_data().size()
+            << std::endl;
+
+  w = v_half;
+  check_ghosts(w, ghosts, 2.);
+  fill(w, 7.);
+  check_ghosts(w, ghosts, 7.);
+  if (myid == 0)
+    deallog << "Assignment from half: " << w.shared_vector_data().size()
+            << std::endl;
+
+  w = v_plain;
+  check_ghosts(w, ghosts, 3.);
+  fill(w, 8.);
+  check_ghosts(w, ghosts, 8.);
+  if (myid == 0)
+    deallog << "Assignment from plain: " << w.shared_vector_data().size()
+            << std::endl;
+
+  // the source vectors are not affected by the updates of the copies
+  check_ghosts(v_sm, ghosts, 1.);
+  check_ghosts(v_half, ghosts, 2.);
+  check_ghosts(v_plain, ghosts, 3.);
+}
+
+
+
+void
+test()
+{
+  const unsigned int myid    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+
+  if (myid == 0)
+    deallog << "numproc=" << numproc << std::endl;
+
+  MPI_Comm comm_sm;
+  MPI_Comm_split_type(
+    MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myid, MPI_INFO_NULL, &comm_sm);
+
+  MPI_Comm comm_sm_half;
+  MPI_Comm_split(comm_sm,
+                 Utilities::MPI::this_mpi_process(comm_sm) % 2,
+                 myid,
+                 &comm_sm_half);
+
+  check(comm_sm, comm_sm_half);
+
+  MPI_Comm_free(&comm_sm_half);
+  MPI_Comm_free(&comm_sm);
+
+  if (myid == 0)
+    deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      test();
+    }
+  else
+    test();
+}
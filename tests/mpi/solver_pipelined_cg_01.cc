@@ -0,0 +1,181 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Check SolverPipelinedCG with LinearAlgebra::distributed::Vector on
+// several processes for a 1d Laplacian with variable coefficient whose
+// vmult() exchanges the ghost entries at the process boundaries. The number
+// of iterations should be the same as for SolverCG.
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+class LaplaceOperator
+{
+public:
+  LaplaceOperator(const unsigned int n_local_rows)
+  {
+    const unsigned int n_procs =
+      Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+    const unsigned int my_id = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+    n_rows      = n_local_rows * n_procs;
+    first_local = my_id * n_local_rows;
+    end_local   = first_local + n_local_rows;
+
+    IndexSet owned(n_rows);
+    owned.add_range(first_local, end_local);
+    IndexSet ghosts(n_rows);
+    if (first_local > 0)
+      ghosts.add_index(first_local - 1);
+    if (end_local < n_rows)
+      ghosts.add_index(end_local);
+
+    partitioner = std::make_shared<const Utilities::MPI::Partitioner>(
+      owned, ghosts, MPI_COMM_WORLD);
+  }
+
+  void
+  initialize_dof_vector(VectorType &vec) const
+  {
+    vec.reinit(partitioner);
+  }
+
+  // coefficient between the nodes i and i+1
+  double
+  coefficient(const types::global_dof_index i) const
+  {
+    return 1. + (i % 7);
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    src.update_ghost_values();
+    for (types::global_dof_index i = first_local; i < end_local; ++i)
+      {
+        double value =
+          (coefficient(i) + (i > 0 ? coefficient(i - 1) : 1.)) * src(i);
+        if (i > 0)
+          value -= coefficient(i - 1) * src(i - 1);
+        if (i + 1 < n_rows)
+          value -= coefficient(i) * src(i + 1);
+        dst(i) = value;
+      }
+    src.zero_out_ghost_values();
+  }
+
+  void
+  compute_diagonal(VectorType &diagonal) const
+  {
+    initialize_dof_vector(diagonal);
+    for (types::global_dof_index i = first_local; i < end_local; ++i)
+      diagonal(i) = coefficient(i) + (i > 0 ? coefficient(i - 1) : 1.);
+  }
+
+private:
+  types::global_dof_index                            n_rows;
+  types::global_dof_index                            first_local;
+  types::global_dof_index                            end_local;
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+};
+
+
+
+template <typename PreconditionerType>
+void
+solve(const LaplaceOperator    &laplace,
+      const PreconditionerType &preconditioner)
+{
+  VectorType rhs, sol;
+  laplace.initialize_dof_vector(rhs);
+  laplace.initialize_dof_vector(sol);
+  rhs = 1.;
+
+  // do not log the final residuals, which depend on roundoff
+  SolverControl        control_cg(1000, 1e-8 * rhs.l2_norm(), false, false);
+  SolverCG<VectorType> solver_cg(control_cg);
+  solver_cg.solve(laplace, sol, rhs, preconditioner);
+  const VectorType sol_cg = sol;
+
+  sol = 0.;
+  SolverControl                 control_pipelined(1000,
+                                                  1e-8 * rhs.l2_norm(),
+                                                  false,
+                                                  false);
+  SolverPipelinedCG<VectorType> solver_pipelined(control_pipelined);
+  solver_pipelined.solve(laplace, sol, rhs, preconditioner);
+
+  deallog << "Iterations CG: " << control_cg.last_step()
+          << ", pipelined CG: " << control_pipelined.last_step() << std::endl;
+
+  sol -= sol_cg;
+  deallog << "Relative difference of solutions below 1e-8: "
+          << (sol.l2_norm() < 1e-8 * sol_cg.l2_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+void
+test(const unsigned int n_local_rows)
+{
+  deallog << "n_local_rows=" << n_local_rows << std::endl;
+
+  LaplaceOperator laplace(n_local_rows);
+
+  deallog << "Solve with PreconditionIdentity" << std::endl;
+  solve(laplace, PreconditionIdentity());
+
+  deallog << "Solve with Jacobi preconditioner" << std::endl;
+  DiagonalMatrix<VectorType> jacobi;
+  laplace.compute_diagonal(jacobi.get_vector());
+  for (double &entry : jacobi.get_vector())
+    entry = 1. / entry;
+  solve(laplace, jacobi);
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  unsigned int myid = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    initlog();
+  else
+    deallog.depth_console(0);
+
+  test(10);
+  test(20);
+}
@@ -0,0 +1,227 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test the agglomeration-based transfer operators created by
+// MGTransferGlobalCoarseningTools::create_agglomeration_sequence() on a mesh
+// whose coarse mesh is already fine: The number of unknowns needs to
+// decrease from level to level, the interpolation followed by the
+// prolongation through all levels needs to reproduce functions in the span
+// of the agglomerate basis, the restriction needs to be the transpose of the
+// prolongation, and compute_coarse_matrix() needs to return the Galerkin
+// product of the Laplace matrix.
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+class Linear : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    double value = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      value += (d + 1.) * p[d];
+    return value;
+  }
+};
+
+
+
+template <int dim>
+void
+test(const MGTransferGlobalCoarseningTools::AgglomerationBasis basis)
+{
+  using Number     = double;
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  const bool is_linear =
+    basis == MGTransferGlobalCoarseningTools::AgglomerationBasis::
+               piecewise_linear;
+
+  Triangulation<dim> tria;
+  GridGenerator::subdivided_hyper_cube(tria, dim == 2 ? 16 : 6);
+
+  const FE_Q<dim> fe(1);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  const AffineConstraints<Number> constraints;
+
+  const types::global_dof_index max_coarse_size = 50;
+
+  const auto transfers =
+    MGTransferGlobalCoarseningTools::create_agglomeration_sequence(
+      dof_handler, constraints, basis, max_coarse_size);
+
+  const std::string label = is_linear ? "linear: " : "constant: ";
+
+  bool sizes_ok = transfers.size() > 0 &&
+                  transfers[0]->partitioner_coarse->size() <= max_coarse_size;
+  for (const auto &transfer : transfers)
+    if (transfer->partitioner_coarse->size() >=
+        transfer->partitioner_fine->size())
+      sizes_ok = false;
+  deallog << label << "coarsening " << (sizes_ok ? "OK" : "FAILED")
+          << std::endl;
+
+  // interpolate the function down to the coarsest level and prolongate it
+  // back, which needs to give the interpolant on the finest level for
+  // functions in the span of the basis on the agglomerates
+  const unsigned int      n_levels = transfers.size() + 1;
+  std::vector<VectorType> vectors(n_levels);
+  vectors[0].reinit(transfers[0]->partitioner_coarse);
+  for (unsigned int l = 1; l < n_levels; ++l)
+    vectors[l].reinit(transfers[l - 1]->partitioner_fine);
+
+  VectorType reference(dof_handler.locally_owned_dofs(), MPI_COMM_WORLD);
+  if (is_linear)
+    VectorTools::interpolate(dof_handler, Linear<dim>(), reference);
+  else
+    VectorTools::interpolate(dof_handler,
+                             Functions::ConstantFunction<dim>(2.),
+                             reference);
+  vectors.back().copy_locally_owned_data_from(reference);
+
+  for (unsigned int l = n_levels - 1; l > 0; --l)
+    transfers[l - 1]->interpolate(vectors[l - 1], vectors[l]);
+  for (unsigned int l = 1; l < n_levels; ++l)
+    {
+      vectors[l] = 0.;
+      transfers[l - 1]->prolongate_and_add(vectors[l], vectors[l - 1]);
+    }
+
+  vectors.back().add(-1., reference);
+  deallog << label << "reproduction "
+          << (vectors.back().linfty_norm() < 1e-10 * reference.linfty_norm() ?
+                "OK" :
+                "FAILED")
+          << std::endl;
+
+  // check that restriction is the transpose of prolongation
+  bool transpose_ok = true;
+  for (const auto &transfer : transfers)
+    {
+      VectorType coarse(transfer->partitioner_coarse);
+      VectorType fine(transfer->partitioner_fine);
+      VectorType coarse_result(coarse), fine_result(fine);
+      for (auto &entry : coarse)
+        entry = random_value<double>();
+      for (auto &entry : fine)
+        entry = random_value<double>();
+
+      transfer->prolongate_and_add(fine_result, coarse);
+      transfer->restrict_and_add(coarse_result, fine);
+
+      const double product_fine   = fine_result * fine;
+      const double product_coarse = coarse_result * coarse;
+      if (std::abs(product_fine - product_coarse) >
+          1e-12 * std::abs(product_fine))
+        transpose_ok = false;
+    }
+  deallog << label << "transpose " << (transpose_ok ? "OK" : "FAILED")
+          << std::endl;
+
+  // check the Galerkin product of the Laplace matrix on all levels
+  MGLevelObject<SparsityPattern>      sparsity_patterns(0, n_levels - 1);
+  MGLevelObject<SparseMatrix<Number>> matrices(0, n_levels - 1);
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    sparsity_patterns[n_levels - 1].copy_from(dsp);
+  }
+  matrices[n_levels - 1].reinit(sparsity_patterns[n_levels - 1]);
+  MatrixCreator::create_laplace_matrix(dof_handler,
+                                       QGauss<dim>(fe.degree + 1),
+                                       matrices[n_levels - 1]);
+
+  bool galerkin_ok = true;
+  for (unsigned int l = n_levels - 1; l > 0; --l)
+    {
+      const auto &transfer = *transfers[l - 1];
+      transfer.compute_coarse_matrix(matrices[l],
+                                     sparsity_patterns[l - 1],
+                                     matrices[l - 1]);
+
+      VectorType x(transfer.partitioner_coarse), y(x), ax(x);
+      VectorType px(transfer.partitioner_fine), py(px), apx(px);
+      for (auto &entry : x)
+        entry = random_value<double>();
+      for (auto &entry : y)
+        entry = random_value<double>();
+
+      matrices[l - 1].vmult(ax, x);
+      transfer.prolongate_and_add(px, x);
+      transfer.prolongate_and_add(py, y);
+      matrices[l].vmult(apx, px);
+
+      const double product_fine   = apx * py;
+      const double product_coarse = ax * y;
+      if (std::abs(product_fine - product_coarse) >
+          1e-10 * std::abs(product_fine))
+        galerkin_ok = false;
+    }
+  deallog << label << "Galerkin product "
+          << (galerkin_ok ? "OK" : "FAILED") << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  initlog();
+
+  deallog.push("2d");
+  test<2>(MGTransferGlobalCoarseningTools::AgglomerationBasis::
+            piecewise_constant);
+  test<2>(
+    MGTransferGlobalCoarseningTools::AgglomerationBasis::piecewise_linear);
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>(MGTransferGlobalCoarseningTools::AgglomerationBasis::
+            piecewise_constant);
+  test<3>(
+    MGTransferGlobalCoarseningTools::AgglomerationBasis::piecewise_linear);
+  deallog.pop();
+}
@@ -0,0 +1,157 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test transfer operator for polynomial coarsening in a hp-context, where the
+// degrees on the fine and the coarse level are arbitrary elements of the
+// FECollection {Q2, Q4, Q6, Q8} and not connected by one of the common
+// polynomial coarsening sequences. The prolongation of the interpolant of a
+// quadratic function on the coarse level needs to give the interpolant on
+// the fine level.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/hp/fe_collection.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+class Quadratic : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    double value = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      value += (d + 1.) * p[d] * p[d] - p[d] * p[(d + 1) % dim];
+    return value;
+  }
+};
+
+
+
+template <int dim>
+void
+test(const bool decrease_by_one)
+{
+  using Number     = double;
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::subdivided_hyper_cube(tria, dim == 2 ? 4 : 2);
+
+  hp::FECollection<dim> fe_collection;
+  for (unsigned int degree = 2; degree <= 8; degree += 2)
+    fe_collection.push_back(FE_Q<dim>(degree));
+
+  DoFHandler<dim> dof_handler_fine(tria);
+  DoFHandler<dim> dof_handler_coarse(tria);
+  for (const auto &cell : dof_handler_fine.active_cell_iterators())
+    if (cell->is_locally_owned())
+      cell->set_active_fe_index(cell->active_cell_index() %
+                                fe_collection.size());
+  for (const auto &cell : dof_handler_coarse.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        const unsigned int fe_index_fine =
+          cell->active_cell_index() % fe_collection.size();
+        cell->set_active_fe_index(
+          decrease_by_one ? std::max(fe_index_fine, 1u) - 1 : 0);
+      }
+  dof_handler_fine.distribute_dofs(fe_collection);
+  dof_handler_coarse.distribute_dofs(fe_collection);
+
+  AffineConstraints<Number> constraint_fine(
+    dof_handler_fine.locally_owned_dofs(),
+    DoFTools::extract_locally_relevant_dofs(dof_handler_fine));
+  DoFTools::make_hanging_node_constraints(dof_handler_fine, constraint_fine);
+  constraint_fine.close();
+
+  AffineConstraints<Number> constraint_coarse(
+    dof_handler_coarse.locally_owned_dofs(),
+    DoFTools::extract_locally_relevant_dofs(dof_handler_coarse));
+  DoFTools::make_hanging_node_constraints(dof_handler_coarse,
+                                          constraint_coarse);
+  constraint_coarse.close();
+
+  MGTwoLevelTransfer<dim, VectorType> transfer;
+  transfer.reinit(dof_handler_fine,
+                  dof_handler_coarse,
+                  constraint_fine,
+                  constraint_coarse);
+
+  VectorType src(dof_handler_coarse.locally_owned_dofs(),
+                 DoFTools::extract_locally_relevant_dofs(dof_handler_coarse),
+                 MPI_COMM_WORLD);
+  VectorType dst(dof_handler_fine.locally_owned_dofs(),
+                 DoFTools::extract_locally_relevant_dofs(dof_handler_fine),
+                 MPI_COMM_WORLD);
+  VectorType reference(dst);
+
+  VectorTools::interpolate(dof_handler_coarse, Quadratic<dim>(), src);
+  VectorTools::interpolate(dof_handler_fine, Quadratic<dim>(), reference);
+
+  transfer.prolongate_and_add(dst, src);
+
+  // transfer operator sets only non-constrained dofs -> update the rest
+  // via constraint matrix
+  constraint_fine.distribute(dst);
+
+  dst.add(-1., reference);
+  deallog << (decrease_by_one ? "decrease by one: " : "go to lowest: ")
+          << "prolongation error "
+          << (dst.linfty_norm() < 1e-10 * reference.linfty_norm() ? "OK" :
+                                                                     "FAILED")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  mpi_initlog();
+
+  deallog.push("2d");
+  test<2>(true);
+  test<2>(false);
+  deallog.pop();
+
+  deallog.push("3d");
+  test<3>(true);
+  test<3>(false);
+  deallog.pop();
+}
@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that MGCoarseGridAMG applies the requested number of V-cycles of
+// SparseAMG, i.e., that one cycle equals SparseAMG::vmult() and that the
+// residual of the coarse-grid solution decreases with each additional cycle
+
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+
+#include "../tests.h"
+
+#include "../testmatrix.h"
+
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int size = 48;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  Vector<double> src(dim), dst(dim), reference(dim), residual(dim);
+  for (unsigned int i = 0; i < dim; ++i)
+    src(i) = random_value<double>();
+
+  typename SparseAMG<double>::AdditionalData data;
+  data.max_coarse_size = 50;
+
+  double last_residual = 0.;
+  for (unsigned int n_cycles = 1; n_cycles <= 4; ++n_cycles)
+    {
+      MGCoarseGridAMG<double> coarse;
+      coarse.initialize(A, n_cycles, data);
+      coarse(0, dst, src);
+
+      if (n_cycles == 1)
+        {
+          coarse.get_amg().vmult(reference, src);
+          reference -= dst;
+          deallog << "Difference to vmult: " << reference.l2_norm()
+                  << std::endl;
+        }
+
+      const double residual_norm = A.residual(residual, dst, src);
+      if (n_cycles > 1)
+        deallog << "Cycles: " << n_cycles << " residual "
+                << (residual_norm < 0.7 * last_residual ? "decreased" :
+                                                          "did not decrease")
+                << std::endl;
+      last_residual = residual_norm;
+    }
+}
@@ -0,0 +1,251 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// assemble a matrix and right hand side with hanging node and inhomogeneous
+// boundary constraints through WorkStream::run_without_copier() and
+// AffineConstraints::distribute_local_to_global_concurrently() called from
+// the worker, and compare against the assembly with a serial copier
+
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+struct ScratchData
+{
+  ScratchData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+    : fe_values(fe, quadrature, update_values | update_gradients |
+                                  update_JxW_values)
+    , cell_matrix(fe.n_dofs_per_cell(), fe.n_dofs_per_cell())
+    , cell_rhs(fe.n_dofs_per_cell())
+    , local_dof_indices(fe.n_dofs_per_cell())
+  {}
+
+  ScratchData(const ScratchData &scratch)
+    : fe_values(scratch.fe_values.get_fe(),
+                scratch.fe_values.get_quadrature(),
+                scratch.fe_values.get_update_flags())
+    , cell_matrix(scratch.cell_matrix)
+    , cell_rhs(scratch.cell_rhs)
+    , local_dof_indices(scratch.local_dof_indices)
+  {}
+
+  FEValues<dim>                        fe_values;
+  FullMatrix<double>                   cell_matrix;
+  Vector<double>                       cell_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+};
+
+
+
+template <int dim>
+void
+compute_local(const typename DoFHandler<dim>::active_cell_iterator &cell,
+              ScratchData<dim>                                     &scratch)
+{
+  scratch.fe_values.reinit(cell);
+  scratch.cell_matrix = 0;
+  scratch.cell_rhs    = 0;
+  const unsigned int dofs_per_cell = scratch.cell_matrix.m();
+  for (const unsigned int q : scratch.fe_values.quadrature_point_indices())
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      {
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          scratch.cell_matrix(i, j) +=
+            (scratch.fe_values.shape_grad(i, q) *
+               scratch.fe_values.shape_grad(j, q) +
+             scratch.fe_values.shape_value(i, q) *
+               scratch.fe_values.shape_value(j, q)) *
+            scratch.fe_values.JxW(q);
+        scratch.cell_rhs(i) +=
+          scratch.fe_values.shape_value(i, q) * scratch.fe_values.JxW(q);
+      }
+  cell->get_dof_indices(scratch.local_dof_indices);
+}
+
+
+
+double
+max_difference(const SparseMatrix<double> &a, const SparseMatrix<double> &b)
+{
+  double                               difference = 0;
+  SparseMatrix<double>::const_iterator entry_b    = b.begin();
+  for (const auto &entry_a : a)
+    {
+      difference =
+        std::max(difference, std::abs(entry_a.value() - entry_b->value()));
+      ++entry_b;
+    }
+  return difference;
+}
+
+
+
+template <int dim>
+void
+test(const unsigned int degree)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.refine_global(1);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  std::vector<types::global_dof_index> face_dof_indices(fe.n_dofs_per_face());
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    for (const auto &face : cell->face_iterators())
+      if (face->at_boundary() && face->boundary_id() == 0)
+        {
+          face->get_dof_indices(face_dof_indices);
+          for (const types::global_dof_index i : face_dof_indices)
+            if (!constraints.is_constrained(i))
+              {
+                constraints.add_line(i);
+                constraints.set_inhomogeneity(i, 1.);
+              }
+        }
+  constraints.close();
+
+  DynamicSparsityPattern dsp(dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
+  SparsityPattern sparsity;
+  sparsity.copy_from(dsp);
+
+  SparseMatrix<double> matrix(sparsity), matrix_ref(sparsity);
+  Vector<double>       rhs(dof_handler.n_dofs());
+  Vector<double>       rhs_ref(dof_handler.n_dofs());
+
+  const ScratchData<dim> sample_scratch(fe, QGauss<dim>(degree + 1));
+
+  struct CopyData
+  {
+    FullMatrix<double>                   cell_matrix;
+    Vector<double>                       cell_rhs;
+    std::vector<types::global_dof_index> local_dof_indices;
+  };
+  WorkStream::run(
+    dof_handler.begin_active(),
+    dof_handler.end(),
+    [](const typename DoFHandler<dim>::active_cell_iterator &cell,
+       ScratchData<dim>                                     &scratch,
+       CopyData                                             &copy) {
+      compute_local<dim>(cell, scratch);
+      copy.cell_matrix       = scratch.cell_matrix;
+      copy.cell_rhs          = scratch.cell_rhs;
+      copy.local_dof_indices = scratch.local_dof_indices;
+    },
+    [&](const CopyData &copy) {
+      constraints.distribute_local_to_global(copy.cell_matrix,
+                                             copy.cell_rhs,
+                                             copy.local_dof_indices,
+                                             matrix_ref,
+                                             rhs_ref,
+                                             true);
+    },
+    sample_scratch,
+    CopyData());
+
+  WorkStream::run_without_copier(
+    dof_handler.active_cell_iterators(),
+    [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+        ScratchData<dim>                                     &scratch) {
+      compute_local<dim>(cell, scratch);
+      constraints.distribute_local_to_global_concurrently(
+        scratch.cell_matrix,
+        scratch.cell_rhs,
+        scratch.local_dof_indices,
+        matrix,
+        rhs,
+        true);
+    },
+    sample_scratch,
+    4);
+
+  rhs -= rhs_ref;
+
+  deallog << "dim=" << dim << " degree=" << degree << std::endl;
+  deallog << "Matrix difference below tolerance: "
+          << (max_difference(matrix, matrix_ref) <
+                  1e-12 * matrix_ref.linfty_norm() ?
+                "yes" :
+                "no")
+          << std::endl;
+  deallog << "Vector difference below tolerance: "
+          << (rhs.linfty_norm() < 1e-12 * rhs_ref.linfty_norm() ? "yes" : "no")
+          << std::endl;
+
+  // also check the version for the matrix only
+  matrix = 0;
+  WorkStream::run_without_copier(
+    dof_handler.active_cell_iterators(),
+    [&](const typename DoFHandler<dim>::active_cell_iterator &cell,
+        ScratchData<dim>                                     &scratch) {
+      compute_local<dim>(cell, scratch);
+      constraints.distribute_local_to_global_concurrently(
+        scratch.cell_matrix, scratch.local_dof_indices, matrix);
+    },
+    sample_scratch);
+  deallog << "Matrix-only difference below tolerance: "
+          << (max_difference(matrix, matrix_ref) <
+                  1e-12 * matrix_ref.linfty_norm() ?
+                "yes" :
+                "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  MultithreadInfo::set_thread_limit(4);
+
+  test<2>(1);
+  test<2>(3);
+  test<3>(2);
+}
@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the setup of the constraints of an
+// adaptively refined, fully periodic mesh on a
+// parallel::distributed::Triangulation with FE_Q elements. The hanging-node
+// and periodicity constraints are made consistent among the MPI processes
+// by AffineConstraints::make_consistent_in_parallel() (make_consistent_*)
+// and then closed by AffineConstraints::close() (close_*), for three
+// consecutive levels of global refinement (*_level_0, *_level_1,
+// *_level_2).
+//
+// Status: experimental
+//
+
+#include <deal.II/base/timer.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 3;
+constexpr unsigned int fe_degree = 2;
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"make_consistent_level_0",
+           "make_consistent_level_1",
+           "make_consistent_level_2",
+           "close_level_0",
+           "close_level_1",
+           "close_level_2"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria, 0., 1., true);
+
+  std::vector<
+    GridTools::PeriodicFacePair<typename Triangulation<dim>::cell_iterator>>
+    periodic_faces;
+  for (unsigned int d = 0; d < dim; ++d)
+    GridTools::collect_periodic_faces(
+      tria, 2 * d, 2 * d + 1, d, periodic_faces);
+  tria.add_periodicity(periodic_faces);
+  tria.refine_global(n_refinements);
+
+  const FE_Q<dim> fe(fe_degree);
+  DoFHandler<dim> dof_handler(tria);
+
+  std::vector<double> times_make_consistent, times_close;
+  for (unsigned int level = 0; level < 3; ++level)
+    {
+      if (level > 0)
+        tria.refine_global(1);
+
+      // refine the cells in a ball around the corner of the periodic box,
+      // so that hanging nodes appear on the periodic boundaries
+      for (const auto &cell : tria.active_cell_iterators())
+        if (cell->is_locally_owned() && cell->center().norm() < 0.4)
+          cell->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+
+      dof_handler.distribute_dofs(fe);
+      const IndexSet &locally_owned_dofs = dof_handler.locally_owned_dofs();
+      const IndexSet  locally_relevant_dofs =
+        DoFTools::extract_locally_relevant_dofs(dof_handler);
+
+      AffineConstraints<double> constraints(locally_owned_dofs,
+                                            locally_relevant_dofs);
+      DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+      for (unsigned int d = 0; d < dim; ++d)
+        DoFTools::make_periodicity_constraints(
+          dof_handler, 2 * d, 2 * d + 1, d, constraints);
+
+      Timer time(MPI_COMM_WORLD, true);
+      constraints.make_consistent_in_parallel(locally_owned_dofs,
+                                              locally_relevant_dofs,
+                                              MPI_COMM_WORLD);
+      times_make_consistent.push_back(time.wall_time());
+
+      time.restart();
+      constraints.close();
+      times_close.push_back(time.wall_time());
+    }
+
+  Measurement measurement = {0.};
+  measurement.timing      = times_make_consistent;
+  measurement.timing.insert(measurement.timing.end(),
+                            times_close.begin(),
+                            times_close.end());
+  return measurement;
+}
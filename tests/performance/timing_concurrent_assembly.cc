@@ -0,0 +1,287 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the threaded assembly of the Stokes system of
+// step-22 with Q2-Q1 elements on a 3d mesh with hanging nodes into a single
+// SparseMatrix. The assembly runs once through WorkStream::run() with the
+// local contributions written into the matrix by the serial copier
+// (copier_*), and once through WorkStream::run_without_copier() with the
+// worker calling AffineConstraints::distribute_local_to_global_concurrently()
+// (concurrent_*). Both are timed with one thread, with half of the threads
+// and with all threads, which shows the limit the serial copier puts on the
+// speedup of the assembly.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+
+
+struct ScratchData
+{
+  ScratchData(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+    : fe_values(fe, quadrature, update_values | update_gradients |
+                                  update_JxW_values)
+    , local_matrix(fe.n_dofs_per_cell(), fe.n_dofs_per_cell())
+    , local_rhs(fe.n_dofs_per_cell())
+    , local_dof_indices(fe.n_dofs_per_cell())
+    , symgrad_phi_u(fe.n_dofs_per_cell())
+    , div_phi_u(fe.n_dofs_per_cell())
+    , phi_u(fe.n_dofs_per_cell())
+    , phi_p(fe.n_dofs_per_cell())
+  {}
+
+  ScratchData(const ScratchData &scratch)
+    : ScratchData(scratch.fe_values.get_fe(),
+                  scratch.fe_values.get_quadrature())
+  {}
+
+  FEValues<dim>                        fe_values;
+  FullMatrix<double>                   local_matrix;
+  Vector<double>                       local_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+
+  std::vector<SymmetricTensor<2, dim>> symgrad_phi_u;
+  std::vector<double>                  div_phi_u;
+  std::vector<Tensor<1, dim>>          phi_u;
+  std::vector<double>                  phi_p;
+};
+
+
+
+struct CopyData
+{
+  FullMatrix<double>                   local_matrix;
+  Vector<double>                       local_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+};
+
+
+
+// the local integrals of step-22 for the system matrix, with the right hand
+// side f=(0,...,0,1)
+void
+assemble_local(const DoFHandler<dim>::active_cell_iterator &cell,
+               ScratchData                                 &scratch)
+{
+  FEValues<dim> &fe_values = scratch.fe_values;
+  fe_values.reinit(cell);
+  scratch.local_matrix = 0;
+  scratch.local_rhs    = 0;
+
+  const FEValuesExtractors::Vector velocities(0);
+  const FEValuesExtractors::Scalar pressure(dim);
+  const unsigned int               dofs_per_cell = fe_values.dofs_per_cell;
+
+  for (const unsigned int q : fe_values.quadrature_point_indices())
+    {
+      for (unsigned int k = 0; k < dofs_per_cell; ++k)
+        {
+          scratch.symgrad_phi_u[k] =
+            fe_values[velocities].symmetric_gradient(k, q);
+          scratch.div_phi_u[k] = fe_values[velocities].divergence(k, q);
+          scratch.phi_u[k]     = fe_values[velocities].value(k, q);
+          scratch.phi_p[k]     = fe_values[pressure].value(k, q);
+        }
+
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        {
+          for (unsigned int j = 0; j <= i; ++j)
+            scratch.local_matrix(i, j) +=
+              (2 * (scratch.symgrad_phi_u[i] * scratch.symgrad_phi_u[j]) -
+               scratch.div_phi_u[i] * scratch.phi_p[j] -
+               scratch.phi_p[i] * scratch.div_phi_u[j] +
+               scratch.phi_p[i] * scratch.phi_p[j]) *
+              fe_values.JxW(q);
+          scratch.local_rhs(i) += scratch.phi_u[i][dim - 1] * fe_values.JxW(q);
+        }
+    }
+
+  for (unsigned int i = 0; i < dofs_per_cell; ++i)
+    for (unsigned int j = i + 1; j < dofs_per_cell; ++j)
+      scratch.local_matrix(i, j) = scratch.local_matrix(j, i);
+
+  cell->get_dof_indices(scratch.local_dof_indices);
+}
+
+
+
+std::pair<double, double>
+time_assembly(const DoFHandler<dim>           &dof_handler,
+              const AffineConstraints<double> &constraints,
+              const SparsityPattern           &sparsity_pattern,
+              const unsigned int               n_threads)
+{
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  SparseMatrix<double> system_matrix(sparsity_pattern);
+  Vector<double>       system_rhs(dof_handler.n_dofs());
+
+  const ScratchData sample_scratch(dof_handler.get_fe(),
+                                   QGauss<dim>(dof_handler.get_fe().degree +
+                                               1));
+
+  Timer time;
+  WorkStream::run(
+    dof_handler.begin_active(),
+    dof_handler.end(),
+    [](const DoFHandler<dim>::active_cell_iterator &cell,
+       ScratchData                                 &scratch,
+       CopyData                                    &copy) {
+      assemble_local(cell, scratch);
+      copy.local_matrix      = scratch.local_matrix;
+      copy.local_rhs         = scratch.local_rhs;
+      copy.local_dof_indices = scratch.local_dof_indices;
+    },
+    [&](const CopyData &copy) {
+      constraints.distribute_local_to_global(copy.local_matrix,
+                                             copy.local_rhs,
+                                             copy.local_dof_indices,
+                                             system_matrix,
+                                             system_rhs);
+    },
+    sample_scratch,
+    CopyData());
+  const double time_copier = time.wall_time();
+
+  system_matrix = 0;
+  system_rhs    = 0;
+
+  time.restart();
+  WorkStream::run_without_copier(
+    dof_handler.active_cell_iterators(),
+    [&](const DoFHandler<dim>::active_cell_iterator &cell,
+        ScratchData                                 &scratch) {
+      assemble_local(cell, scratch);
+      constraints.distribute_local_to_global_concurrently(
+        scratch.local_matrix,
+        scratch.local_rhs,
+        scratch.local_dof_indices,
+        system_matrix,
+        system_rhs);
+    },
+    sample_scratch);
+  const double time_concurrent = time.wall_time();
+
+  return {time_copier, time_concurrent};
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"copier_one_thread",
+           "copier_half_threads",
+           "copier_all_threads",
+           "concurrent_one_thread",
+           "concurrent_half_threads",
+           "concurrent_all_threads"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 4;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 5;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.refine_global(n_refinements - 1);
+
+  FESystem<dim>   fe(FE_Q<dim>(2), dim, FE_Q<dim>(1), 1);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  constraints.close();
+
+  DynamicSparsityPattern dsp(dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
+  SparsityPattern sparsity_pattern;
+  sparsity_pattern.copy_from(dsp);
+
+  // query the number of available threads with the default thread limit
+  MultithreadInfo::set_thread_limit();
+  const unsigned int max_threads = MultithreadInfo::n_threads();
+
+  std::vector<double> times_copier, times_concurrent;
+  for (const unsigned int n_threads :
+       {1U, std::max(1U, max_threads / 2), max_threads})
+    {
+      const auto [time_copier, time_concurrent] =
+        time_assembly(dof_handler, constraints, sparsity_pattern, n_threads);
+      times_copier.push_back(time_copier);
+      times_concurrent.push_back(time_concurrent);
+    }
+  MultithreadInfo::set_thread_limit();
+
+  Measurement measurement = {0.};
+  measurement.timing      = times_copier;
+  measurement.timing.insert(measurement.timing.end(),
+                            times_concurrent.begin(),
+                            times_concurrent.end());
+  return measurement;
+}
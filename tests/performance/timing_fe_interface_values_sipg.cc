@@ -0,0 +1,320 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the assembly of the interior face terms of
+// the symmetric interior penalty (SIPG) discretization of the Laplace
+// equation as in step-74, with DGQ2 elements on a 3d mesh with hanging
+// nodes. The face matrices are assembled through MeshWorker::mesh_loop()
+// visiting each interface once (mesh_loop_assembly), and by a loop that
+// visits each interface from both sides in succession and adds half of the
+// face matrix in each visit, with a plain FEInterfaceValues object
+// (both_sides_*) and with one that reuses the data of the face seen from
+// the other side, see FEInterfaceValues::enable_face_data_reuse()
+// (both_sides_reuse_*). For the latter two variants, the time spent in
+// FEInterfaceValues::reinit() (*_reinit) and the time of the complete
+// assembly (*_assembly) are reported.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_interface_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/meshworker/mesh_loop.h>
+#include <deal.II/meshworker/scratch_data.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 3;
+constexpr unsigned int fe_degree = 2;
+
+
+
+struct CopyDataFace
+{
+  FullMatrix<double>                   cell_matrix;
+  std::vector<types::global_dof_index> joint_dof_indices;
+};
+
+
+
+struct CopyData
+{
+  std::vector<CopyDataFace> face_data;
+};
+
+
+
+// The arguments of FEInterfaceValues::reinit() for one side of an interface
+struct InterfaceSide
+{
+  typename DoFHandler<dim>::active_cell_iterator cell;
+  unsigned int                                   face_no;
+  unsigned int                                   sub_face_no;
+};
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          5,
+          {"mesh_loop_assembly",
+           "both_sides_reinit",
+           "both_sides_assembly",
+           "both_sides_reuse_reinit",
+           "both_sides_reuse_assembly"}};
+}
+
+
+
+// Compute the SIPG face matrix on the current interface, scaled by the
+// given factor
+void
+assemble_face_matrix(const FEInterfaceValues<dim> &fe_iv,
+                     const double                  penalty,
+                     const double                  factor,
+                     FullMatrix<double>           &matrix)
+{
+  const unsigned int n_dofs_face = fe_iv.n_current_interface_dofs();
+  matrix.reinit(n_dofs_face, n_dofs_face);
+
+  const std::vector<double>         &JxW     = fe_iv.get_JxW_values();
+  const std::vector<Tensor<1, dim>> &normals = fe_iv.get_normal_vectors();
+
+  for (const unsigned int q : fe_iv.quadrature_point_indices())
+    for (const unsigned int i : fe_iv.dof_indices())
+      {
+        const double jump_i = fe_iv.jump_in_shape_values(i, q);
+        const double average_grad_i =
+          fe_iv.average_of_shape_gradients(i, q) * normals[q];
+        for (const unsigned int j : fe_iv.dof_indices())
+          {
+            const double jump_j = fe_iv.jump_in_shape_values(j, q);
+            matrix(i, j) +=
+              factor *
+              (-jump_i * (fe_iv.average_of_shape_gradients(j, q) * normals[q]) -
+               average_grad_i * jump_j + penalty * jump_i * jump_j) *
+              JxW[q];
+          }
+      }
+}
+
+
+
+template <typename CellIteratorType>
+double
+penalty_parameter(const CellIteratorType &cell,
+                  const unsigned int      face_no,
+                  const CellIteratorType &cell_neighbor,
+                  const unsigned int      face_no_neighbor)
+{
+  const double extent = cell->measure() / cell->face(face_no)->measure();
+  const double extent_neighbor =
+    cell_neighbor->measure() / cell_neighbor->face(face_no_neighbor)->measure();
+  return 2. * fe_degree * (fe_degree + 1) / std::min(extent, extent_neighbor);
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  // refine the left half of the cube once more to get hanging nodes
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_refinements);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FE_DGQ<dim>     fe(fe_degree);
+  const MappingQ<dim>   mapping(1);
+  const QGauss<dim>     quadrature(fe_degree + 1);
+  const QGauss<dim - 1> face_quadrature(fe_degree + 1);
+  DoFHandler<dim>       dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  SparsityPattern sparsity_pattern;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_flux_sparsity_pattern(dof_handler, dsp);
+    sparsity_pattern.copy_from(dsp);
+  }
+  SparseMatrix<double> system_matrix(sparsity_pattern);
+
+  const UpdateFlags face_flags = update_values | update_gradients |
+                                 update_normal_vectors | update_JxW_values;
+
+  using CellIteratorType = decltype(dof_handler.begin_active());
+
+  std::vector<double> results;
+
+  // face terms through mesh_loop, visiting each interface once
+  {
+    // only the face terms are assembled, so the cell worker just resets
+    // the copy data before the faces of the cell are visited
+    const auto cell_worker = [](const CellIteratorType &,
+                                MeshWorker::ScratchData<dim> &,
+                                CopyData &copy_data) {
+      copy_data.face_data.clear();
+    };
+
+    const auto face_worker = [&](const CellIteratorType       &cell,
+                                 const unsigned int            f,
+                                 const unsigned int            sf,
+                                 const CellIteratorType       &ncell,
+                                 const unsigned int            nf,
+                                 const unsigned int            nsf,
+                                 MeshWorker::ScratchData<dim> &scratch_data,
+                                 CopyData                     &copy_data) {
+      const FEInterfaceValues<dim> &fe_iv =
+        scratch_data.reinit(cell, f, sf, ncell, nf, nsf);
+
+      copy_data.face_data.emplace_back();
+      CopyDataFace &copy_data_face     = copy_data.face_data.back();
+      copy_data_face.joint_dof_indices = fe_iv.get_interface_dof_indices();
+      assemble_face_matrix(fe_iv,
+                           penalty_parameter(cell, f, ncell, nf),
+                           1.,
+                           copy_data_face.cell_matrix);
+    };
+
+    const auto copier = [&](const CopyData &copy_data) {
+      for (const CopyDataFace &face : copy_data.face_data)
+        system_matrix.add(face.joint_dof_indices, face.cell_matrix);
+    };
+
+    system_matrix = 0.;
+    Timer time;
+    MeshWorker::mesh_loop(dof_handler.begin_active(),
+                          dof_handler.end(),
+                          cell_worker,
+                          copier,
+                          MeshWorker::ScratchData<dim>(mapping,
+                                                       fe,
+                                                       quadrature,
+                                                       update_default,
+                                                       face_quadrature,
+                                                       face_flags),
+                          CopyData(),
+                          MeshWorker::assemble_own_cells |
+                            MeshWorker::assemble_own_interior_faces_once,
+                          {},
+                          face_worker);
+    results.push_back(time.wall_time());
+  }
+
+  // collect the interfaces with the arguments for both sides, each
+  // interface once and seen from the finer cell at hanging nodes
+  std::vector<std::pair<InterfaceSide, InterfaceSide>> interfaces;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    for (const unsigned int f : cell->face_indices())
+      if (!cell->at_boundary(f))
+        {
+          if (cell->neighbor_is_coarser(f))
+            {
+              const auto face_pair = cell->neighbor_of_coarser_neighbor(f);
+              interfaces.push_back(
+                {{cell, f, numbers::invalid_unsigned_int},
+                 {cell->neighbor(f), face_pair.first, face_pair.second}});
+            }
+          else if (!cell->neighbor(f)->has_children() &&
+                   cell->neighbor(f)->index() > cell->index())
+            interfaces.push_back(
+              {{cell, f, numbers::invalid_unsigned_int},
+               {cell->neighbor(f),
+                cell->neighbor_of_neighbor(f),
+                numbers::invalid_unsigned_int}});
+        }
+
+  // face terms through a loop visiting each interface from both sides
+  for (const bool reuse_face_data : {false, true})
+    {
+      FEInterfaceValues<dim> fe_iv(mapping, fe, face_quadrature, face_flags);
+      if (reuse_face_data)
+        fe_iv.enable_face_data_reuse();
+      FullMatrix<double> face_matrix;
+
+      system_matrix = 0.;
+      Timer  time;
+      double reinit_time = 0.;
+      for (const auto &[side, side_neighbor] : interfaces)
+        for (const bool swap : {false, true})
+          {
+            const InterfaceSide &first  = swap ? side_neighbor : side;
+            const InterfaceSide &second = swap ? side : side_neighbor;
+
+            Timer reinit_timer;
+            fe_iv.reinit(first.cell,
+                         first.face_no,
+                         first.sub_face_no,
+                         second.cell,
+                         second.face_no,
+                         second.sub_face_no);
+            reinit_time += reinit_timer.wall_time();
+
+            assemble_face_matrix(fe_iv,
+                                 penalty_parameter(first.cell,
+                                                   first.face_no,
+                                                   second.cell,
+                                                   second.face_no),
+                                 0.5,
+                                 face_matrix);
+            system_matrix.add(fe_iv.get_interface_dof_indices(), face_matrix);
+          }
+      results.push_back(reinit_time);
+      results.push_back(time.wall_time());
+    }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  return measurement;
+}
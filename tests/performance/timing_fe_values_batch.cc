@@ -0,0 +1,277 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the matrix-based assembly of a
+// convection-diffusion operator, as it appears in the linearized momentum
+// equation of the Navier-Stokes equations, with Q2 elements and a quadratic
+// mapping on a curved 3d mesh. The matrix is assembled through
+// MeshWorker::mesh_loop() with FEValues (fe_values_*) and through
+// MeshWorker::mesh_loop_batched() with FEValuesBatch, which evaluates the
+// mapping and the shape function gradients for several cells at once with
+// SIMD instructions (fe_values_batch_*). The times are split into the
+// evaluation of the cell data (reinit) and the complete assembly.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/meshworker/mesh_loop.h>
+#include <deal.II/meshworker/scratch_data.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 3;
+constexpr unsigned int fe_degree = 2;
+
+
+
+// the convection velocity
+template <typename Number>
+Tensor<1, dim, Number>
+velocity(const Point<dim, Number> &p)
+{
+  Tensor<1, dim, Number> beta;
+  beta[0] = -p[1];
+  beta[1] = p[0];
+  beta[2] = Number(1.);
+  return beta;
+}
+
+
+
+struct CopyData
+{
+  FullMatrix<double>                   cell_matrix;
+  std::vector<types::global_dof_index> dof_indices;
+};
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"fe_values_reinit",
+           "fe_values_assembly",
+           "fe_values_batch_reinit",
+           "fe_values_batch_assembly"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(n_refinements);
+
+  const FE_Q<dim>     fe(fe_degree);
+  const MappingQ<dim> mapping(fe_degree);
+  const QGauss<dim>   quadrature(fe_degree + 1);
+  DoFHandler<dim>     dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  const AffineConstraints<double> constraints;
+
+  SparsityPattern sparsity_pattern;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    sparsity_pattern.copy_from(dsp);
+  }
+  SparseMatrix<double> system_matrix(sparsity_pattern);
+
+  const UpdateFlags flags =
+    update_values | update_gradients | update_quadrature_points |
+    update_JxW_values;
+  const unsigned int dofs_per_cell = fe.n_dofs_per_cell();
+
+  using CellIteratorType = decltype(dof_handler.begin_active());
+
+  const auto copier = [&](const CopyData &copy_data) {
+    constraints.distribute_local_to_global(copy_data.cell_matrix,
+                                           copy_data.dof_indices,
+                                           system_matrix);
+  };
+
+  std::vector<double> results;
+
+  // reinit only, with FEValues
+  {
+    FEValues<dim> fe_values(mapping, fe, quadrature, flags);
+    Timer         time;
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      fe_values.reinit(cell);
+    results.push_back(time.wall_time());
+  }
+
+  // assembly with FEValues
+  {
+    const auto cell_worker = [&](const CellIteratorType       &cell,
+                                 MeshWorker::ScratchData<dim> &scratch_data,
+                                 CopyData                     &copy_data) {
+      const FEValues<dim> &fe_values = scratch_data.reinit(cell);
+      copy_data.cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        {
+          const Tensor<1, dim> beta_JxW =
+            velocity(fe_values.quadrature_point(q)) * fe_values.JxW(q);
+          for (const unsigned int i : fe_values.dof_indices())
+            {
+              const Tensor<1, dim> grad_i_JxW =
+                fe_values.shape_grad(i, q) * fe_values.JxW(q);
+              const double phi_i = fe_values.shape_value(i, q);
+              for (const unsigned int j : fe_values.dof_indices())
+                copy_data.cell_matrix(i, j) +=
+                  grad_i_JxW * fe_values.shape_grad(j, q) +
+                  phi_i * (beta_JxW * fe_values.shape_grad(j, q));
+            }
+        }
+      copy_data.dof_indices.resize(dofs_per_cell);
+      cell->get_dof_indices(copy_data.dof_indices);
+    };
+
+    system_matrix = 0.;
+    Timer time;
+    MeshWorker::mesh_loop(dof_handler.active_cell_iterators(),
+                          cell_worker,
+                          copier,
+                          MeshWorker::ScratchData<dim>(mapping,
+                                                       fe,
+                                                       quadrature,
+                                                       flags),
+                          CopyData(),
+                          MeshWorker::assemble_own_cells);
+    results.push_back(time.wall_time());
+  }
+
+  // reinit only, with FEValuesBatch
+  {
+    std::vector<CellIteratorType> cells;
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      cells.push_back(cell);
+
+    FEValuesBatch<dim> fe_batch(mapping, fe, quadrature, flags);
+    Timer              time;
+    for (unsigned int start = 0; start < cells.size();
+         start += FEValuesBatch<dim>::n_lanes)
+      fe_batch.reinit(ArrayView<const CellIteratorType>(
+        cells.data() + start,
+        std::min<std::size_t>(FEValuesBatch<dim>::n_lanes,
+                              cells.size() - start)));
+    results.push_back(time.wall_time());
+  }
+
+  // assembly with FEValuesBatch
+  {
+    using VectorizedArrayType = VectorizedArray<double>;
+    using CellBatch           = ArrayView<const CellIteratorType>;
+
+    const auto cell_worker = [&](const CellBatch       &cells,
+                                 FEValuesBatch<dim>    &fe_batch,
+                                 std::vector<CopyData> &copy_data) {
+      fe_batch.reinit(cells);
+
+      Table<2, VectorizedArrayType> cell_matrix(dofs_per_cell, dofs_per_cell);
+      for (const unsigned int q : fe_batch.quadrature_point_indices())
+        {
+          const Tensor<1, dim, VectorizedArrayType> beta_JxW =
+            velocity(fe_batch.quadrature_point(q)) * fe_batch.JxW(q);
+          for (const unsigned int i : fe_batch.dof_indices())
+            {
+              const Tensor<1, dim, VectorizedArrayType> grad_i_JxW =
+                fe_batch.shape_grad(i, q) * fe_batch.JxW(q);
+              const VectorizedArrayType phi_i = fe_batch.shape_value(i, q);
+              for (const unsigned int j : fe_batch.dof_indices())
+                cell_matrix(i, j) +=
+                  grad_i_JxW * fe_batch.shape_grad(j, q) +
+                  phi_i * (beta_JxW * fe_batch.shape_grad(j, q));
+            }
+        }
+
+      copy_data.resize(cells.size());
+      for (unsigned int lane = 0; lane < cells.size(); ++lane)
+        {
+          copy_data[lane].cell_matrix.reinit(dofs_per_cell, dofs_per_cell);
+          for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            for (unsigned int j = 0; j < dofs_per_cell; ++j)
+              copy_data[lane].cell_matrix(i, j) = cell_matrix(i, j)[lane];
+          copy_data[lane].dof_indices.resize(dofs_per_cell);
+          cells[lane]->get_dof_indices(copy_data[lane].dof_indices);
+        }
+    };
+
+    const auto batch_copier = [&](const std::vector<CopyData> &copy_data) {
+      for (const CopyData &copy : copy_data)
+        copier(copy);
+    };
+
+    system_matrix = 0.;
+    Timer time;
+    MeshWorker::mesh_loop_batched(dof_handler.active_cell_iterators(),
+                                  cell_worker,
+                                  batch_copier,
+                                  FEValuesBatch<dim>(mapping,
+                                                     fe,
+                                                     quadrature,
+                                                     flags),
+                                  std::vector<CopyData>(),
+                                  FEValuesBatch<dim>::n_lanes);
+    results.push_back(time.wall_time());
+  }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  return measurement;
+}
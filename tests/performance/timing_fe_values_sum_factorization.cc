@@ -0,0 +1,171 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the evaluation of the residual of the minimal
+// surface equation as in step-15, with Q2 and Q4 elements on a 3d mesh. The
+// gradient of the current solution is computed in the quadrature points with
+// FEValues::get_function_gradients(), either from the tabulated shape
+// function gradients (tabulated_*) or with sum factorization as enabled by
+// FEValues::enable_sum_factorization() (sum_factorization_*). For each
+// variant, the time spent in get_function_gradients() (*_evaluate) and the
+// time of the complete residual evaluation (*_residual) are reported.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          8,
+          {"tabulated_p2_evaluate",
+           "tabulated_p2_residual",
+           "sum_factorization_p2_evaluate",
+           "sum_factorization_p2_residual",
+           "tabulated_p4_evaluate",
+           "tabulated_p4_residual",
+           "sum_factorization_p4_evaluate",
+           "sum_factorization_p4_residual"}};
+}
+
+
+
+// Compute the residual of the minimal surface equation and return the time
+// spent in the evaluation of the solution gradients and the total time
+std::pair<double, double>
+compute_residual(const Mapping<dim>    &mapping,
+                 const DoFHandler<dim> &dof_handler,
+                 const Vector<double>  &solution,
+                 const bool             use_sum_factorization,
+                 Vector<double>        &residual)
+{
+  const FiniteElement<dim> &fe = dof_handler.get_fe();
+  const QGauss<dim>         quadrature(fe.degree + 1);
+
+  FEValues<dim> fe_values(mapping,
+                          fe,
+                          quadrature,
+                          update_gradients | update_JxW_values);
+  if (use_sum_factorization)
+    fe_values.enable_sum_factorization();
+
+  std::vector<Tensor<1, dim>>          gradients(quadrature.size());
+  Vector<double>                       cell_residual(fe.n_dofs_per_cell());
+  std::vector<types::global_dof_index> dof_indices(fe.n_dofs_per_cell());
+
+  residual = 0.;
+  Timer  timer;
+  double evaluate_time = 0.;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    {
+      fe_values.reinit(cell);
+
+      Timer evaluate_timer;
+      fe_values.get_function_gradients(solution, gradients);
+      evaluate_time += evaluate_timer.wall_time();
+
+      cell_residual = 0.;
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        {
+          const Tensor<1, dim> flux =
+            gradients[q] / std::sqrt(1. + gradients[q] * gradients[q]) *
+            fe_values.JxW(q);
+          for (const unsigned int i : fe_values.dof_indices())
+            cell_residual(i) += fe_values.shape_grad(i, q) * flux;
+        }
+
+      cell->get_dof_indices(dof_indices);
+      for (unsigned int i = 0; i < dof_indices.size(); ++i)
+        residual(dof_indices[i]) += cell_residual(i);
+    }
+
+  return {evaluate_time, timer.wall_time()};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(n_refinements);
+
+  const MappingQ<dim> mapping(2);
+
+  std::vector<double> results;
+  for (const unsigned int degree : {2, 4})
+    {
+      const FE_Q<dim> fe(degree);
+      DoFHandler<dim> dof_handler(tria);
+      dof_handler.distribute_dofs(fe);
+
+      Vector<double> solution(dof_handler.n_dofs());
+      for (unsigned int i = 0; i < solution.size(); ++i)
+        solution(i) = std::sin(0.1 * i);
+      Vector<double> residual(dof_handler.n_dofs());
+
+      for (const bool use_sum_factorization : {false, true})
+        {
+          const auto [evaluate_time, residual_time] = compute_residual(
+            mapping, dof_handler, solution, use_sum_factorization, residual);
+          results.push_back(evaluate_time);
+          results.push_back(residual_time);
+        }
+    }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  return measurement;
+}
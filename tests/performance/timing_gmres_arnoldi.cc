@@ -0,0 +1,175 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the orthogonalization step of the Arnoldi
+// process in SolverGMRES and SolverFGMRES with
+// LinearAlgebra::distributed::Vector. For Krylov space dimensions of 10, 50,
+// and 100, it measures the time to build a complete Arnoldi basis with a
+// diagonal operator using
+//  - separate scalar products and vector updates per basis vector with the
+//    classical Gram-Schmidt algorithm, i.e., one pass through memory and one
+//    global reduction per basis vector,
+//  - the modified Gram-Schmidt algorithm, and
+//  - the fused classical Gram-Schmidt algorithm that computes all scalar
+//    products and the norm in one pass with a single global reduction.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_gmres.h>
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+
+// Orthogonalize vv against the given basis vectors with one scalar product
+// and one vector update per basis vector, the way the Arnoldi step is done
+// with generic vector interfaces
+double
+separate_gram_schmidt(
+  const internal::SolverGMRESImplementation::TmpVectors<VectorType> &basis,
+  const unsigned int                                                 dim,
+  VectorType                                                        &vv,
+  Vector<double>                                                    &h)
+{
+  for (unsigned int i = 0; i < dim; ++i)
+    h(i) = vv * basis[i];
+  for (unsigned int i = 0; i < dim; ++i)
+    vv.add(-h(i), basis[i]);
+  return vv.l2_norm();
+}
+
+
+
+double
+run_arnoldi(const VectorType  &diagonal,
+            const unsigned int krylov_dimension,
+            const unsigned int variant)
+{
+  GrowingVectorMemory<VectorType>                             memory;
+  internal::SolverGMRESImplementation::TmpVectors<VectorType> basis(
+    krylov_dimension + 2, memory);
+  Vector<double> h(krylov_dimension + 1);
+
+  VectorType &first = basis(0, diagonal);
+  first             = 1.;
+  first /= first.l2_norm();
+
+  Timer time;
+  for (unsigned int dim = 1; dim <= krylov_dimension; ++dim)
+    {
+      VectorType &vv = basis(dim, diagonal);
+      vv             = basis[dim - 1];
+      vv.scale(diagonal);
+
+      double norm             = 0;
+      bool   re_orthogonalize = false;
+      if (variant == 0)
+        norm = separate_gram_schmidt(basis, dim, vv, h);
+      else
+        norm = internal::SolverGMRESImplementation::iterated_gram_schmidt(
+          variant == 1 ?
+            LinearAlgebra::OrthogonalizationStrategy::modified_gram_schmidt :
+            LinearAlgebra::OrthogonalizationStrategy::classical_gram_schmidt,
+          basis,
+          dim,
+          0,
+          vv,
+          h,
+          re_orthogonalize);
+      vv /= norm;
+    }
+  return time.wall_time();
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"separate_10",
+           "mgs_10",
+           "fused_cgs_10",
+           "separate_50",
+           "mgs_50",
+           "fused_cgs_50",
+           "separate_100",
+           "mgs_100",
+           "fused_cgs_100"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int local_size = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        local_size = 200000;
+        break;
+      case TestingEnvironment::medium:
+        local_size = 500000;
+        break;
+      case TestingEnvironment::heavy:
+        local_size = 1000000;
+        break;
+    }
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int n_ranks =
+    Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  IndexSet locally_owned(static_cast<types::global_dof_index>(local_size) *
+                         n_ranks);
+  locally_owned.add_range(static_cast<types::global_dof_index>(local_size) *
+                            my_rank,
+                          static_cast<types::global_dof_index>(local_size) *
+                            (my_rank + 1));
+
+  VectorType diagonal(locally_owned, MPI_COMM_WORLD);
+  for (unsigned int i = 0; i < local_size; ++i)
+    diagonal.local_element(i) = 1. + (my_rank * local_size + i) % 97;
+
+  std::vector<double> timings;
+  for (const unsigned int krylov_dimension : {10U, 50U, 100U})
+    for (unsigned int variant = 0; variant < 3; ++variant)
+      timings.push_back(run_arnoldi(diagonal, krylov_dimension, variant));
+
+  return {timings[0],
+          timings[1],
+          timings[2],
+          timings[3],
+          timings[4],
+          timings[5],
+          timings[6],
+          timings[7],
+          timings[8]};
+}
@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark comparing the setup of the SparsityPattern of a Q1
+// and a Q2 discretization on a 3d mesh with hanging nodes, once through
+// DoFTools::make_sparsity_pattern() on a DynamicSparsityPattern followed by
+// SparsityPattern::copy_from() (dynamic_*), and once through the threaded
+// DoFTools::make_compressed_sparsity_pattern() (direct_*). Reported are the
+// wall times of the setup (time_*) and the increase of the peak resident
+// memory of the process in MB (memory_*) relative to the peak before the
+// setup of the respective degree. As the peak memory can only grow, the
+// direct setup runs first and the value for the dynamic setup is the larger
+// of the two peaks, and the test runs a single repetition.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+
+
+double
+peak_memory_in_mb()
+{
+  Utilities::System::MemoryStats stats;
+  Utilities::System::get_memory_stats(stats);
+  return stats.VmHWM / 1024.;
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  std::vector<std::string> names;
+  for (const std::string degree : {"p1", "p2"})
+    for (const std::string quantity : {"time", "memory"})
+      for (const std::string variant : {"direct", "dynamic"})
+        names.push_back(quantity + "_" + variant + "_" + degree);
+  return {Metric::timing, 1, names};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 4;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 5;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 6;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.refine_global(n_refinements - 1);
+
+  std::vector<double> results;
+  for (const unsigned int degree : {1U, 2U})
+    {
+      FE_Q<dim>       fe(degree);
+      DoFHandler<dim> dof_handler(tria);
+      dof_handler.distribute_dofs(fe);
+      AffineConstraints<double> constraints;
+      DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+      constraints.close();
+
+      const double memory_before = peak_memory_in_mb();
+      double       times[2], memory[2];
+      {
+        Timer           time;
+        SparsityPattern sparsity;
+        DoFTools::make_compressed_sparsity_pattern(dof_handler,
+                                                   sparsity,
+                                                   constraints,
+                                                   false);
+        times[0]  = time.wall_time();
+        memory[0] = peak_memory_in_mb() - memory_before;
+      }
+      {
+        Timer           time;
+        SparsityPattern sparsity;
+        {
+          DynamicSparsityPattern dsp(dof_handler.n_dofs());
+          DoFTools::make_sparsity_pattern(dof_handler,
+                                          dsp,
+                                          constraints,
+                                          false);
+          sparsity.copy_from(dsp);
+        }
+        times[1]  = time.wall_time();
+        memory[1] = peak_memory_in_mb() - memory_before;
+      }
+      results.insert(results.end(),
+                     {times[0], times[1], memory[0], memory[1]});
+    }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  return measurement;
+}
@@ -0,0 +1,248 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the evaluation of MappingQ in FEValues during
+// matrix-based assembly. Two problems are assembled on a refined cube in 3d:
+// the Laplace matrix with Q1 elements as in step-3 (step3_*), and the Stokes
+// matrix with Q2-Q1 Taylor-Hood elements as in step-22 (step22_*). Each
+// problem is assembled on the affine mesh, where MappingQ uses the constant
+// Jacobian of each cell (*_affine), on the affine mesh with the cache of the
+// cell data enabled, timing the second of two assembly sweeps (*_cached), and
+// on a mesh of the same size with slightly perturbed vertices, where the
+// mapping has to be evaluated in every quadrature point (*_non_affine).
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          6,
+          {"step3_affine",
+           "step3_cached",
+           "step3_non_affine",
+           "step22_affine",
+           "step22_cached",
+           "step22_non_affine"}};
+}
+
+
+
+// Assemble the matrix of the given problem n_sweeps times with the same
+// FEValues object and return the wall time of the last sweep
+template <typename LocalAssembler>
+double
+assemble(const Mapping<dim>    &mapping,
+         const DoFHandler<dim> &dof_handler,
+         const UpdateFlags      update_flags,
+         const unsigned int     n_sweeps,
+         const LocalAssembler  &local_assembler)
+{
+  const FiniteElement<dim> &fe = dof_handler.get_fe();
+
+  SparsityPattern sparsity_pattern;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp);
+    sparsity_pattern.copy_from(dsp);
+  }
+  SparseMatrix<double> system_matrix(sparsity_pattern);
+
+  const QGauss<dim>  quadrature(fe.degree + 1);
+  FEValues<dim>      fe_values(mapping, fe, quadrature, update_flags);
+  FullMatrix<double> cell_matrix(fe.n_dofs_per_cell(), fe.n_dofs_per_cell());
+  std::vector<types::global_dof_index> dof_indices(fe.n_dofs_per_cell());
+
+  double time = 0.;
+  for (unsigned int sweep = 0; sweep < n_sweeps; ++sweep)
+    {
+      system_matrix = 0.;
+      Timer timer;
+      for (const auto &cell : dof_handler.active_cell_iterators())
+        {
+          fe_values.reinit(cell);
+          cell_matrix = 0.;
+          local_assembler(fe_values, cell_matrix);
+          cell->get_dof_indices(dof_indices);
+          system_matrix.add(dof_indices, cell_matrix);
+        }
+      time = timer.wall_time();
+    }
+  return time;
+}
+
+
+
+void
+assemble_laplace(const FEValues<dim> &fe_values, FullMatrix<double> &matrix)
+{
+  for (const unsigned int q : fe_values.quadrature_point_indices())
+    for (const unsigned int i : fe_values.dof_indices())
+      for (const unsigned int j : fe_values.dof_indices())
+        matrix(i, j) += fe_values.shape_grad(i, q) *
+                        fe_values.shape_grad(j, q) * fe_values.JxW(q);
+}
+
+
+
+void
+assemble_stokes(const FEValues<dim> &fe_values, FullMatrix<double> &matrix)
+{
+  const FEValuesExtractors::Vector velocities(0);
+  const FEValuesExtractors::Scalar pressure(dim);
+
+  const unsigned int dofs_per_cell = fe_values.dofs_per_cell;
+  std::vector<SymmetricTensor<2, dim>> symgrad_phi_u(dofs_per_cell);
+  std::vector<double>                  div_phi_u(dofs_per_cell);
+  std::vector<double>                  phi_p(dofs_per_cell);
+
+  for (const unsigned int q : fe_values.quadrature_point_indices())
+    {
+      for (const unsigned int k : fe_values.dof_indices())
+        {
+          symgrad_phi_u[k] = fe_values[velocities].symmetric_gradient(k, q);
+          div_phi_u[k]     = fe_values[velocities].divergence(k, q);
+          phi_p[k]         = fe_values[pressure].value(k, q);
+        }
+
+      for (const unsigned int i : fe_values.dof_indices())
+        for (unsigned int j = 0; j <= i; ++j)
+          matrix(i, j) +=
+            (2 * (symgrad_phi_u[i] * symgrad_phi_u[j]) -
+             div_phi_u[i] * phi_p[j] - phi_p[i] * div_phi_u[j] +
+             phi_p[i] * phi_p[j]) *
+            fe_values.JxW(q);
+    }
+
+  for (const unsigned int i : fe_values.dof_indices())
+    for (unsigned int j = i + 1; j < dofs_per_cell; ++j)
+      matrix(i, j) = matrix(j, i);
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 4;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 5;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_refinements);
+
+  // a mesh of the same size where none of the cells is affine
+  Triangulation<dim> tria_non_affine;
+  tria_non_affine.copy_triangulation(tria);
+  GridTools::transform(
+    [](const Point<dim> &p) {
+      Point<dim> q = p;
+      for (unsigned int d = 0; d < dim; ++d)
+        q[d] += 0.01 * std::sin(37. * p[(d + 1) % dim] + 11. * p[d]);
+      return q;
+    },
+    tria_non_affine);
+
+  MappingQ<dim> mapping(1);
+  mapping.enable_affine_fast_path();
+  MappingQ<dim> mapping_cached(1);
+  mapping_cached.enable_affine_fast_path();
+  mapping_cached.enable_cell_data_cache();
+
+  std::vector<double> results;
+
+  // step-3 style Laplace matrix
+  {
+    const FE_Q<dim>   fe(1);
+    const UpdateFlags flags = update_gradients | update_JxW_values;
+
+    DoFHandler<dim> dof_handler(tria);
+    dof_handler.distribute_dofs(fe);
+    DoFHandler<dim> dof_handler_non_affine(tria_non_affine);
+    dof_handler_non_affine.distribute_dofs(fe);
+
+    results.push_back(
+      assemble(mapping, dof_handler, flags, 1, assemble_laplace));
+    results.push_back(
+      assemble(mapping_cached, dof_handler, flags, 2, assemble_laplace));
+    results.push_back(
+      assemble(mapping, dof_handler_non_affine, flags, 1, assemble_laplace));
+  }
+
+  // step-22 style Stokes matrix
+  {
+    const FESystem<dim> fe(FE_Q<dim>(2), dim, FE_Q<dim>(1), 1);
+    const UpdateFlags   flags =
+      update_values | update_gradients | update_JxW_values;
+
+    DoFHandler<dim> dof_handler(tria);
+    dof_handler.distribute_dofs(fe);
+    DoFHandler<dim> dof_handler_non_affine(tria_non_affine);
+    dof_handler_non_affine.distribute_dofs(fe);
+
+    results.push_back(
+      assemble(mapping, dof_handler, flags, 1, assemble_stokes));
+    results.push_back(
+      assemble(mapping_cached, dof_handler, flags, 2, assemble_stokes));
+    results.push_back(
+      assemble(mapping, dof_handler_non_affine, flags, 1, assemble_stokes));
+  }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  return measurement;
+}
@@ -0,0 +1,175 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark comparing the assembly of the sparse matrix of a
+// Laplace operator on a curved 3d mesh with hanging nodes through
+// MatrixFreeTools::compute_matrix() for polynomial degrees 1 to 6, once with
+// the cell operation applied to each unit vector of a cell (cellwise_p*) and
+// once with the batched evaluation and integration of all columns of the
+// cell matrix (batched_p*). The reported timings are the wall times of one
+// matrix assembly, including the zeroing of the matrix.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+using Integrator = FEEvaluation<dim, -1, 0, 1, double>;
+
+
+
+double
+time_matrix_assembly(const unsigned int            degree,
+                     const bool                    batched,
+                     const types::global_dof_index target_n_dofs)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(1);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] > 0)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  while (tria.n_active_cells() * Utilities::pow(degree, dim) < target_n_dofs)
+    tria.refine_global(1);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  constraints.close();
+
+  MatrixFree<dim, double>                          matrix_free;
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags  = update_gradients | update_JxW_values;
+  matrix_free.reinit(MappingQ<dim>(degree),
+                     dof_handler,
+                     constraints,
+                     QGauss<1>(degree + 1),
+                     data);
+
+  DynamicSparsityPattern dsp(dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints);
+  SparsityPattern sparsity_pattern;
+  sparsity_pattern.copy_from(dsp);
+  SparseMatrix<double> matrix(sparsity_pattern);
+
+  const auto quadrature_operation = [](Integrator &phi) {
+    for (const unsigned int q : phi.quadrature_point_indices())
+      phi.submit_gradient(phi.get_gradient(q), q);
+  };
+
+  const auto assemble = [&]() {
+    matrix = 0;
+    if (batched)
+      MatrixFreeTools::
+        compute_matrix<dim, -1, 0, 1, double, VectorizedArray<double>>(
+          matrix_free,
+          constraints,
+          matrix,
+          EvaluationFlags::gradients,
+          EvaluationFlags::gradients,
+          quadrature_operation);
+    else
+      MatrixFreeTools::
+        compute_matrix<dim, -1, 0, 1, double, VectorizedArray<double>>(
+          matrix_free, constraints, matrix, [&](Integrator &phi) {
+            phi.evaluate(EvaluationFlags::gradients);
+            quadrature_operation(phi);
+            phi.integrate(EvaluationFlags::gradients);
+          });
+  };
+
+  // warm up caches before measuring
+  assemble();
+
+  const unsigned int n_repetitions = 3;
+  Timer              time;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    assemble();
+  return time.wall_time() / n_repetitions;
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  std::vector<std::string> names;
+  for (unsigned int degree = 1; degree <= 6; ++degree)
+    {
+      names.push_back("cellwise_p" + std::to_string(degree));
+      names.push_back("batched_p" + std::to_string(degree));
+    }
+  return {Metric::timing, 4, names};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  types::global_dof_index target_n_dofs = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        target_n_dofs = 50000;
+        break;
+      case TestingEnvironment::medium:
+        target_n_dofs = 200000;
+        break;
+      case TestingEnvironment::heavy:
+        target_n_dofs = 1000000;
+        break;
+    }
+
+  std::vector<double> timings;
+  for (unsigned int degree = 1; degree <= 6; ++degree)
+    for (const bool batched : {false, true})
+      timings.push_back(time_matrix_assembly(degree, batched, target_n_dofs));
+
+  Measurement measurement = {0.};
+  measurement.timing      = timings;
+  return measurement;
+}
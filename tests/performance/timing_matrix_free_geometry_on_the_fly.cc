@@ -0,0 +1,165 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark comparing the throughput of a matrix-free Laplace
+// operator on a curved 3d mesh (hyper ball with a MappingQ of the same degree
+// as the finite element) for polynomial degrees 2 to 8, when the geometry is
+// precomputed at all quadrature points (the default) and when it is computed
+// on the fly from the mapping support points in FEEvaluation::reinit() via
+// MatrixFree::AdditionalData::compute_geometry_on_the_fly. The reported
+// timings are the wall times per operator application.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+constexpr unsigned int dim = 3;
+
+
+
+double
+time_operator_application(const unsigned int            degree,
+                          const bool                    on_the_fly,
+                          const types::global_dof_index target_n_dofs)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  while (tria.n_active_cells() * Utilities::pow(degree, dim) < target_n_dofs)
+    tria.refine_global(1);
+
+  FE_Q<dim>       fe(degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  MappingQ<dim> mapping(degree);
+
+  MatrixFree<dim, double>                          matrix_free;
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags  = update_gradients | update_JxW_values;
+  data.compute_geometry_on_the_fly = on_the_fly;
+  matrix_free.reinit(
+    mapping, dof_handler, constraints, QGauss<1>(degree + 1), data);
+
+  VectorType src, dst;
+  matrix_free.initialize_dof_vector(src);
+  matrix_free.initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = std::sin(0.37 * i);
+
+  const auto apply = [&]() {
+    matrix_free.cell_loop<VectorType, VectorType>(
+      [](const MatrixFree<dim, double>               &matrix_free,
+         VectorType                                  &dst,
+         const VectorType                            &src,
+         const std::pair<unsigned int, unsigned int> &cell_range) {
+        FEEvaluation<dim, -1> phi(matrix_free);
+        for (unsigned int cell = cell_range.first; cell < cell_range.second;
+             ++cell)
+          {
+            phi.reinit(cell);
+            phi.gather_evaluate(src, EvaluationFlags::gradients);
+            for (unsigned int q = 0; q < phi.n_q_points; ++q)
+              phi.submit_gradient(phi.get_gradient(q), q);
+            phi.integrate_scatter(EvaluationFlags::gradients, dst);
+          }
+      },
+      dst,
+      src,
+      true);
+  };
+
+  // warm up caches before measuring
+  apply();
+
+  const unsigned int n_repetitions = 20;
+  Timer              time;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    apply();
+  return time.wall_time() / n_repetitions;
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  std::vector<std::string> names;
+  for (unsigned int degree = 2; degree <= 8; ++degree)
+    {
+      names.push_back("stored_p" + std::to_string(degree));
+      names.push_back("on_the_fly_p" + std::to_string(degree));
+    }
+  return {Metric::timing, 4, names};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  types::global_dof_index target_n_dofs = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        target_n_dofs = 200000;
+        break;
+      case TestingEnvironment::medium:
+        target_n_dofs = 1000000;
+        break;
+      case TestingEnvironment::heavy:
+        target_n_dofs = 4000000;
+        break;
+    }
+
+  std::vector<double> timings;
+  for (unsigned int degree = 2; degree <= 8; ++degree)
+    for (const bool on_the_fly : {false, true})
+      timings.push_back(
+        time_operator_application(degree, on_the_fly, target_n_dofs));
+
+  Measurement measurement = {0.};
+  measurement.timing      = timings;
+  return measurement;
+}
@@ -0,0 +1,371 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the Chebyshev smoother of a matrix-free
+// geometric multigrid V-cycle with local smoothing on an adaptively refined
+// mesh, using MatrixFreeOperators::LaplaceOperator on the levels in single
+// precision and a conjugate gradient solver in double precision. The test
+// compares the time per V-cycle for the Chebyshev iteration with vector
+// updates fused into the operations before and after the matrix-vector
+// product of MatrixFree::cell_loop() (vcycle_fused) against the iteration
+// with separate sweeps for the vector updates (vcycle_separate). The time
+// per V-cycle can be compared to the one of the global-coarsening multigrid
+// in timing_mg_glob_coarsen.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 3;
+constexpr unsigned int fe_degree = 4;
+
+using VectorType      = LinearAlgebra::distributed::Vector<double>;
+using LevelVectorType = LinearAlgebra::distributed::Vector<float>;
+
+using SystemMatrixType = MatrixFreeOperators::
+  LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, VectorType>;
+using LevelMatrixType = MatrixFreeOperators::
+  LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, LevelVectorType>;
+
+
+
+// Forwards only the plain vmult() of the level operator, such that
+// PreconditionChebyshev performs its vector updates in separate sweeps
+class PlainLevelMatrix : public Subscriptor
+{
+public:
+  using value_type = float;
+  using size_type  = types::global_dof_index;
+
+  void
+  initialize(const LevelMatrixType &matrix)
+  {
+    this->matrix = &matrix;
+  }
+
+  size_type
+  m() const
+  {
+    return matrix->m();
+  }
+
+  size_type
+  n() const
+  {
+    return matrix->n();
+  }
+
+  float
+  el(const unsigned int row, const unsigned int col) const
+  {
+    return matrix->el(row, col);
+  }
+
+  void
+  vmult(LevelVectorType &dst, const LevelVectorType &src) const
+  {
+    matrix->vmult(dst, src);
+  }
+
+  void
+  Tvmult(LevelVectorType &dst, const LevelVectorType &src) const
+  {
+    matrix->Tvmult(dst, src);
+  }
+
+private:
+  const LevelMatrixType *matrix = nullptr;
+};
+
+
+
+// run n_repeat V-cycles with the given smoother and return the time per
+// V-cycle
+template <typename SmootherType>
+double
+time_vcycle(const DoFHandler<dim>                  &dof_handler,
+            const MGLevelObject<LevelMatrixType>   &mg_matrices,
+            const MGTransferMatrixFree<dim, float> &mg_transfer,
+            SmootherType                           &mg_smoother,
+            const VectorType                       &rhs,
+            VectorType                             &solution)
+{
+  MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+  mg_coarse.initialize(mg_smoother);
+
+  mg::Matrix<LevelVectorType> mg_matrix(mg_matrices);
+
+  MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType>>
+    mg_interface_matrices(mg_matrices.min_level(), mg_matrices.max_level());
+  for (unsigned int level = mg_matrices.min_level();
+       level <= mg_matrices.max_level();
+       ++level)
+    mg_interface_matrices[level].initialize(mg_matrices[level]);
+  mg::Matrix<LevelVectorType> mg_interface(mg_interface_matrices);
+
+  Multigrid<LevelVectorType> mg(
+    mg_matrix, mg_coarse, mg_transfer, mg_smoother, mg_smoother);
+  mg.set_edge_matrices(mg_interface, mg_interface);
+
+  PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim, float>>
+    preconditioner(dof_handler, mg, mg_transfer);
+
+  // warm up caches and MPI buffers
+  preconditioner.vmult(solution, rhs);
+
+  const unsigned int n_repeat = 20;
+  Timer              time;
+  for (unsigned int t = 0; t < n_repeat; ++t)
+    preconditioner.vmult(solution, rhs);
+  time.stop();
+
+  return time.wall_time() / n_repeat;
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"setup", "solve", "vcycle_separate", "vcycle_fused"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  Timer time;
+
+  parallel::distributed::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::limit_level_difference_at_vertices,
+    parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_refinements);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->is_locally_owned() && cell->center().norm() < 0.55)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  const FE_Q<dim> fe(fe_degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  dof_handler.distribute_mg_dofs();
+
+  const MappingQ1<dim> mapping;
+
+  AffineConstraints<double> constraints;
+  constraints.reinit(DoFTools::extract_locally_relevant_dofs(dof_handler));
+  DoFTools::make_hanging_node_constraints(dof_handler, constraints);
+  VectorTools::interpolate_boundary_values(
+    mapping, dof_handler, 0, Functions::ZeroFunction<dim>(), constraints);
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  additional_data.tasks_parallel_scheme =
+    MatrixFree<dim, double>::AdditionalData::none;
+  additional_data.mapping_update_flags =
+    (update_gradients | update_JxW_values | update_quadrature_points);
+  const auto system_mf_storage = std::make_shared<MatrixFree<dim, double>>();
+  system_mf_storage->reinit(mapping,
+                            dof_handler,
+                            constraints,
+                            QGauss<1>(fe_degree + 1),
+                            additional_data);
+  SystemMatrixType system_matrix;
+  system_matrix.initialize(system_mf_storage);
+
+  VectorType solution, rhs;
+  system_matrix.initialize_dof_vector(solution);
+  system_matrix.initialize_dof_vector(rhs);
+  for (unsigned int i = 0; i < rhs.locally_owned_size(); ++i)
+    if (!constraints.is_constrained(
+          rhs.get_partitioner()->local_to_global(i)))
+      rhs.local_element(i) = 1.;
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof_handler);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof_handler, {0});
+
+  const unsigned int             n_levels = tria.n_global_levels();
+  MGLevelObject<LevelMatrixType> mg_matrices(0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      AffineConstraints<double> level_constraints;
+      level_constraints.reinit(
+        DoFTools::extract_locally_relevant_level_dofs(dof_handler, level));
+      level_constraints.add_lines(
+        mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      typename MatrixFree<dim, float>::AdditionalData level_additional_data;
+      level_additional_data.tasks_parallel_scheme =
+        MatrixFree<dim, float>::AdditionalData::none;
+      level_additional_data.mapping_update_flags =
+        (update_gradients | update_JxW_values | update_quadrature_points);
+      level_additional_data.mg_level = level;
+      const auto level_mf_storage = std::make_shared<MatrixFree<dim, float>>();
+      level_mf_storage->reinit(mapping,
+                               dof_handler,
+                               level_constraints,
+                               QGauss<1>(fe_degree + 1),
+                               level_additional_data);
+      mg_matrices[level].initialize(level_mf_storage,
+                                    mg_constrained_dofs,
+                                    level);
+      mg_matrices[level].compute_diagonal();
+    }
+
+  std::vector<std::shared_ptr<const Utilities::MPI::Partitioner>> partitioners;
+  for (unsigned int level = 0; level < n_levels; ++level)
+    partitioners.push_back(
+      mg_matrices[level].get_matrix_free()->get_vector_partitioner());
+  MGTransferMatrixFree<dim, float> mg_transfer(mg_constrained_dofs);
+  mg_transfer.build(dof_handler, partitioners);
+
+  // the Chebyshev smoothers with fused and separate vector updates,
+  // respectively, with the same settings on all levels
+  const auto fill_smoother_data = [&](auto &smoother_data) {
+    smoother_data.resize(0, n_levels - 1);
+    for (unsigned int level = 0; level < n_levels; ++level)
+      {
+        auto &data = smoother_data[level];
+        if (level > 0)
+          {
+            data.smoothing_range     = 15.;
+            data.degree              = 5;
+            data.eig_cg_n_iterations = 10;
+          }
+        else
+          {
+            data.smoothing_range     = 1e-3;
+            data.degree              = numbers::invalid_unsigned_int;
+            data.eig_cg_n_iterations = mg_matrices[0].m();
+          }
+        data.preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
+      }
+  };
+
+  using SmootherType = PreconditionChebyshev<LevelMatrixType, LevelVectorType>;
+  MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
+  fill_smoother_data(smoother_data);
+  mg::SmootherRelaxation<SmootherType, LevelVectorType> mg_smoother;
+  mg_smoother.initialize(mg_matrices, smoother_data);
+
+  MGLevelObject<PlainLevelMatrix> plain_matrices(0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+    plain_matrices[level].initialize(mg_matrices[level]);
+  using PlainSmootherType =
+    PreconditionChebyshev<PlainLevelMatrix, LevelVectorType>;
+  MGLevelObject<typename PlainSmootherType::AdditionalData>
+    plain_smoother_data;
+  fill_smoother_data(plain_smoother_data);
+  mg::SmootherRelaxation<PlainSmootherType, LevelVectorType>
+    plain_mg_smoother;
+  plain_mg_smoother.initialize(plain_matrices, plain_smoother_data);
+
+  time.stop();
+  const double setup_time = time.wall_time();
+
+  // solve with the fused smoother on the float levels and the conjugate
+  // gradient solver in double
+  time.restart();
+  {
+    MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+    mg_coarse.initialize(mg_smoother);
+    mg::Matrix<LevelVectorType> mg_matrix(mg_matrices);
+    MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType>>
+      mg_interface_matrices(0, n_levels - 1);
+    for (unsigned int level = 0; level < n_levels; ++level)
+      mg_interface_matrices[level].initialize(mg_matrices[level]);
+    mg::Matrix<LevelVectorType> mg_interface(mg_interface_matrices);
+
+    Multigrid<LevelVectorType> mg(
+      mg_matrix, mg_coarse, mg_transfer, mg_smoother, mg_smoother);
+    mg.set_edge_matrices(mg_interface, mg_interface);
+    PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim, float>>
+      preconditioner(dof_handler, mg, mg_transfer);
+
+    SolverControl        control(100, 1e-10 * rhs.l2_norm());
+    SolverCG<VectorType> solver(control);
+    solution = 0.;
+    solver.solve(system_matrix, solution, rhs, preconditioner);
+  }
+  time.stop();
+  const double solve_time = time.wall_time();
+
+  const double vcycle_separate = time_vcycle(
+    dof_handler, mg_matrices, mg_transfer, plain_mg_smoother, rhs, solution);
+  const double vcycle_fused = time_vcycle(
+    dof_handler, mg_matrices, mg_transfer, mg_smoother, rhs, solution);
+
+  return {setup_time, solve_time, vcycle_separate, vcycle_fused};
+}
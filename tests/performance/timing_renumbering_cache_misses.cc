@@ -0,0 +1,300 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the effect of the DoF numbering on the
+// matrix-free evaluation of the Laplacian with FE_Q elements on a
+// parallel::distributed::Triangulation. The test compares the numbering
+// after DoFHandler::distribute_dofs() (default_*), the numbering of
+// DoFRenumbering::hierarchical() (hierarchical_*) and the numbering of
+// DoFRenumbering::space_filling_curve_blocks() (sfc_blocks_*). For each
+// numbering, it reports the number of last-level cache misses per operator
+// evaluation as measured by the perf_event interface of the Linux kernel
+// (*_cache_misses, zero if the hardware counter is not available), the
+// number of vector entries imported from other processes (*_import_indices)
+// and the number of contiguous ranges of ghost indices (*_ghost_ranges),
+// each summed over all MPI processes.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_renumbering.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <array>
+#include <cstring>
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 3;
+constexpr unsigned int fe_degree = 3;
+
+
+
+// A thin wrapper around a perf_event file descriptor counting the
+// last-level cache misses of the calling thread in user space. If the
+// counter cannot be opened, e.g. because of the setting of
+// /proc/sys/kernel/perf_event_paranoid or because the code runs in a
+// virtual machine without access to the hardware counters, all counts are
+// reported as zero.
+class CacheMissCounter
+{
+public:
+  CacheMissCounter()
+    : file_descriptor(-1)
+  {
+#ifdef __linux__
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.type           = PERF_TYPE_HARDWARE;
+    attributes.size           = sizeof(attributes);
+    attributes.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled       = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+
+    file_descriptor = static_cast<int>(
+      syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+  }
+
+  ~CacheMissCounter()
+  {
+#ifdef __linux__
+    if (file_descriptor >= 0)
+      close(file_descriptor);
+#endif
+  }
+
+  void
+  start()
+  {
+#ifdef __linux__
+    if (file_descriptor >= 0)
+      {
+        ioctl(file_descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(file_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  std::uint64_t
+  stop()
+  {
+    std::uint64_t count = 0;
+#ifdef __linux__
+    if (file_descriptor >= 0)
+      {
+        ioctl(file_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(file_descriptor, &count, sizeof(count)) != sizeof(count))
+          count = 0;
+      }
+#endif
+    return count;
+  }
+
+private:
+  int file_descriptor;
+};
+
+
+
+template <typename Number>
+class LaplaceOperator
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  void
+  reinit(const DoFHandler<dim> &dof_handler)
+  {
+    typename MatrixFree<dim, Number>::AdditionalData additional_data;
+    additional_data.mapping_update_flags = update_gradients;
+
+    const AffineConstraints<Number> constraints;
+    matrix_free.reinit(MappingQ1<dim>(),
+                       dof_handler,
+                       constraints,
+                       QGauss<1>(fe_degree + 1),
+                       additional_data);
+  }
+
+  void
+  initialize_dof_vector(VectorType &vec) const
+  {
+    matrix_free.initialize_dof_vector(vec);
+  }
+
+  const Utilities::MPI::Partitioner &
+  get_vector_partitioner() const
+  {
+    return *matrix_free.get_vector_partitioner();
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    matrix_free.cell_loop(&LaplaceOperator::local_apply, this, dst, src, true);
+  }
+
+private:
+  void
+  local_apply(const MatrixFree<dim, Number>               &data,
+              VectorType                                  &dst,
+              const VectorType                            &src,
+              const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, EvaluationFlags::gradients);
+        for (const unsigned int q : phi.quadrature_point_indices())
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate_scatter(EvaluationFlags::gradients, dst);
+      }
+  }
+
+  MatrixFree<dim, Number> matrix_free;
+};
+
+
+
+// returns the cache misses per operator evaluation, the number of imported
+// vector entries and the number of ghost ranges for the current numbering
+std::array<std::uint64_t, 3>
+measure(const DoFHandler<dim> &dof_handler)
+{
+  const MPI_Comm comm = dof_handler.get_communicator();
+
+  LaplaceOperator<double> laplace_operator;
+  laplace_operator.reinit(dof_handler);
+
+  LinearAlgebra::distributed::Vector<double> src, dst;
+  laplace_operator.initialize_dof_vector(src);
+  laplace_operator.initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = i % 11;
+
+  // warm up the caches and the MPI buffers
+  for (unsigned int i = 0; i < 5; ++i)
+    laplace_operator.vmult(dst, src);
+
+  constexpr unsigned int n_repetitions = 50;
+  CacheMissCounter       counter;
+  counter.start();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    laplace_operator.vmult(dst, src);
+  const std::uint64_t cache_misses = counter.stop() / n_repetitions;
+
+  const Utilities::MPI::Partitioner &partitioner =
+    laplace_operator.get_vector_partitioner();
+
+  return {{Utilities::MPI::sum(cache_misses, comm),
+           Utilities::MPI::sum<std::uint64_t>(partitioner.n_import_indices(),
+                                              comm),
+           Utilities::MPI::sum<std::uint64_t>(
+             partitioner.ghost_indices().n_intervals(), comm)}};
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::instruction_count,
+          1,
+          {"default_cache_misses",
+           "default_import_indices",
+           "default_ghost_ranges",
+           "hierarchical_cache_misses",
+           "hierarchical_import_indices",
+           "hierarchical_ghost_ranges",
+           "sfc_blocks_cache_misses",
+           "sfc_blocks_import_indices",
+           "sfc_blocks_ghost_ranges"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 4;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 5;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 6;
+        break;
+    }
+
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_refinements);
+
+  const FE_Q<dim> fe(fe_degree);
+  DoFHandler<dim> dof_handler(tria);
+
+  Measurement measurement = {std::uint64_t(0)};
+  measurement.instruction_count.clear();
+  for (unsigned int numbering = 0; numbering < 3; ++numbering)
+    {
+      dof_handler.distribute_dofs(fe);
+      if (numbering == 1)
+        DoFRenumbering::hierarchical(dof_handler);
+      else if (numbering == 2)
+        DoFRenumbering::space_filling_curve_blocks(dof_handler);
+
+      const auto counts = measure(dof_handler);
+      measurement.instruction_count.insert(
+        measurement.instruction_count.end(), counts.begin(), counts.end());
+    }
+
+  return measurement;
+}
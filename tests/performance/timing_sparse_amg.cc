@@ -0,0 +1,302 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for the algebraic multigrid method SparseAMG on
+// the problem of step-16, i.e., the Laplace equation with a discontinuous
+// coefficient discretized with continuous Q2 elements in 2d, solved with the
+// conjugate gradient method to a relative tolerance of 1e-10. The coarse
+// mesh is a circle that is already refined several times, such that the
+// coarse-grid problem of geometric multigrid is of considerable size. The
+// benchmark compares
+//  - CG preconditioned by PreconditionSSOR (ssor_solve),
+//  - CG preconditioned by SparseAMG, split into the setup of the hierarchy
+//    (amg_setup) and the solution (amg_solve),
+//  - CG preconditioned by geometric multigrid with an SOR smoother, as in
+//    step-16, with the coarse-grid problem solved by unpreconditioned CG
+//    through MGCoarseGridIterativeSolver (mg_cg_coarse_solve) and by one
+//    V-cycle of SparseAMG through MGCoarseGridAMG (mg_amg_coarse_setup,
+//    mg_amg_coarse_solve).
+// The number of iterations of each solver is reported as well.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_transfer.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim       = 2;
+constexpr unsigned int fe_degree = 2;
+
+
+
+// assemble the matrix of the Laplacian with the coefficient of step-16 on
+// the given cells, and the right hand side if a vector is given
+template <typename IteratorType>
+void
+assemble(const IteratorRange<IteratorType> &cells,
+         const AffineConstraints<double>   &constraints,
+         SparseMatrix<double>              &matrix,
+         Vector<double>                    *rhs)
+{
+  const FiniteElement<dim> &fe = (*cells.begin())->get_fe();
+  FEValues<dim>             fe_values(fe,
+                          QGauss<dim>(fe_degree + 1),
+                          update_values | update_gradients |
+                            update_quadrature_points | update_JxW_values);
+
+  FullMatrix<double> cell_matrix(fe.n_dofs_per_cell(), fe.n_dofs_per_cell());
+  Vector<double>     cell_rhs(fe.n_dofs_per_cell());
+  std::vector<types::global_dof_index> dof_indices(fe.n_dofs_per_cell());
+  for (const auto &cell : cells)
+    {
+      fe_values.reinit(cell);
+      cell_matrix = 0.;
+      cell_rhs    = 0.;
+      for (const unsigned int q : fe_values.quadrature_point_indices())
+        {
+          const double coefficient =
+            fe_values.quadrature_point(q)[0] < 0. ? 1. : 0.1;
+          for (const unsigned int i : fe_values.dof_indices())
+            {
+              for (const unsigned int j : fe_values.dof_indices())
+                cell_matrix(i, j) += coefficient *
+                                     (fe_values.shape_grad(i, q) *
+                                      fe_values.shape_grad(j, q)) *
+                                     fe_values.JxW(q);
+              cell_rhs(i) += fe_values.shape_value(i, q) * fe_values.JxW(q);
+            }
+        }
+
+      cell->get_active_or_mg_dof_indices(dof_indices);
+      if (rhs != nullptr)
+        constraints.distribute_local_to_global(
+          cell_matrix, cell_rhs, dof_indices, matrix, *rhs);
+      else
+        constraints.distribute_local_to_global(cell_matrix,
+                                               dof_indices,
+                                               matrix);
+    }
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"ssor_solve",
+           "amg_setup",
+           "amg_solve",
+           "mg_cg_coarse_solve",
+           "mg_amg_coarse_setup",
+           "mg_amg_coarse_solve",
+           "ssor_iterations",
+           "amg_iterations",
+           "mg_cg_coarse_iterations",
+           "mg_amg_coarse_iterations"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 2;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 3;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 4;
+        break;
+    }
+
+  // create a coarse mesh that is already fine, as it appears for complex
+  // geometries, by flattening a refined mesh
+  Triangulation<dim> tria;
+  {
+    Triangulation<dim> tria_coarse;
+    GridGenerator::hyper_ball(tria_coarse);
+    tria_coarse.refine_global(4);
+    GridGenerator::flatten_triangulation(tria_coarse, tria);
+  }
+  tria.refine_global(n_refinements);
+
+  const FE_Q<dim> fe(fe_degree);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+  dof_handler.distribute_mg_dofs();
+
+  AffineConstraints<double> constraints;
+  VectorTools::interpolate_boundary_values(dof_handler,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  SparsityPattern sparsity_pattern;
+  {
+    DynamicSparsityPattern dsp(dof_handler.n_dofs());
+    DoFTools::make_sparsity_pattern(dof_handler, dsp, constraints, false);
+    sparsity_pattern.copy_from(dsp);
+  }
+  SparseMatrix<double> system_matrix(sparsity_pattern);
+  Vector<double>       system_rhs(dof_handler.n_dofs());
+  assemble(dof_handler.active_cell_iterators(),
+           constraints,
+           system_matrix,
+           &system_rhs);
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof_handler);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof_handler, {0});
+
+  const unsigned int                  n_levels = tria.n_levels();
+  MGLevelObject<SparsityPattern>      mg_sparsity_patterns(0, n_levels - 1);
+  MGLevelObject<SparseMatrix<double>> mg_matrices(0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      DynamicSparsityPattern dsp(dof_handler.n_dofs(level));
+      MGTools::make_sparsity_pattern(dof_handler, dsp, level);
+      mg_sparsity_patterns[level].copy_from(dsp);
+      mg_matrices[level].reinit(mg_sparsity_patterns[level]);
+
+      AffineConstraints<double> level_constraints;
+      for (const types::global_dof_index dof_index :
+           mg_constrained_dofs.get_boundary_indices(level))
+        level_constraints.constrain_dof_to_zero(dof_index);
+      level_constraints.close();
+      assemble(dof_handler.mg_cell_iterators_on_level(level),
+               level_constraints,
+               mg_matrices[level],
+               nullptr);
+    }
+
+  Vector<double>      solution(dof_handler.n_dofs());
+  std::vector<double> results;
+  std::vector<double> iterations;
+
+  const auto solve = [&](const auto &preconditioner) {
+    solution = 0.;
+    SolverControl            control(10000, 1e-10 * system_rhs.l2_norm());
+    SolverCG<Vector<double>> solver(control);
+    Timer                    time;
+    solver.solve(system_matrix, solution, system_rhs, preconditioner);
+    results.push_back(time.wall_time());
+    iterations.push_back(control.last_step());
+  };
+
+  {
+    PreconditionSSOR<SparseMatrix<double>> ssor;
+    ssor.initialize(system_matrix, 1.2);
+    solve(ssor);
+  }
+
+  {
+    Timer             time;
+    SparseAMG<double> amg;
+    amg.initialize(system_matrix);
+    results.push_back(time.wall_time());
+    solve(amg);
+  }
+
+  MGTransferPrebuilt<Vector<double>> mg_transfer(mg_constrained_dofs);
+  mg_transfer.build(dof_handler);
+
+  mg::SmootherRelaxation<PreconditionSOR<SparseMatrix<double>>, Vector<double>>
+    mg_smoother;
+  mg_smoother.initialize(mg_matrices);
+  mg_smoother.set_steps(2);
+  mg_smoother.set_symmetric(true);
+
+  mg::Matrix<Vector<double>> mg_matrix(mg_matrices);
+
+  const auto solve_with_mg =
+    [&](const MGCoarseGridBase<Vector<double>> &coarse) {
+      Multigrid<Vector<double>> mg(
+        mg_matrix, coarse, mg_transfer, mg_smoother, mg_smoother);
+      PreconditionMG<dim, Vector<double>, MGTransferPrebuilt<Vector<double>>>
+        preconditioner(dof_handler, mg, mg_transfer);
+      solve(preconditioner);
+    };
+
+  {
+    ReductionControl         coarse_control(10000, 1e-14, 1e-10, false, false);
+    SolverCG<Vector<double>> coarse_solver(coarse_control);
+    PreconditionIdentity     identity;
+    MGCoarseGridIterativeSolver<Vector<double>,
+                                SolverCG<Vector<double>>,
+                                SparseMatrix<double>,
+                                PreconditionIdentity>
+      coarse(coarse_solver, mg_matrices[0], identity);
+    solve_with_mg(coarse);
+  }
+
+  {
+    Timer                   time;
+    MGCoarseGridAMG<double> coarse;
+    coarse.initialize(mg_matrices[0]);
+    results.push_back(time.wall_time());
+    solve_with_mg(coarse);
+  }
+
+  Measurement measurement = {0.};
+  measurement.timing      = results;
+  measurement.timing.insert(measurement.timing.end(),
+                            iterations.begin(),
+                            iterations.end());
+  return measurement;
+}
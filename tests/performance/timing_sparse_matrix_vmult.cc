@@ -0,0 +1,153 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark for SparseMatrix::vmult() with the matrix of a
+// continuous Q2 discretization in 3d. The sparsity pattern and the matrix are
+// set up anew for each thread count, such that the first-touch
+// initialization places the memory close to the threads that later run the
+// matrix-vector products. The benchmark runs with one thread, with half of
+// the threads (which corresponds to one socket on a typical dual-socket
+// machine) and with all threads. For each case, the time of one vmult
+// (vmult_*) and the resulting memory throughput in GB/s (bandwidth_*) is
+// reported, where the transferred data is counted as the matrix values, the
+// column indices, the row starts, and one read of the source and one write of
+// the destination vector.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+constexpr unsigned int dim = 3;
+
+
+
+std::pair<double, double>
+time_vmult(const DoFHandler<dim> &dof_handler, const unsigned int n_threads)
+{
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  DynamicSparsityPattern dsp(dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern(dof_handler, dsp);
+  SparsityPattern sparsity_pattern;
+  sparsity_pattern.copy_from(dsp);
+  SparseMatrix<double> matrix(sparsity_pattern);
+  for (auto &entry : matrix)
+    entry.value() = 1. / (1. + entry.row() + entry.column());
+
+  Vector<double> src(dof_handler.n_dofs()), dst(dof_handler.n_dofs());
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src(i) = i % 13;
+
+  // warm up caches before measuring
+  matrix.vmult(dst, src);
+
+  const unsigned int n_repetitions = 50;
+  Timer              time;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    matrix.vmult(dst, src);
+  const double time_per_vmult = time.wall_time() / n_repetitions;
+
+  const double bytes =
+    sparsity_pattern.n_nonzero_elements() *
+      (sizeof(double) + sizeof(SparsityPattern::size_type)) +
+    (sparsity_pattern.n_rows() + 1) * sizeof(std::size_t) +
+    2. * sizeof(double) * dof_handler.n_dofs();
+
+  return {time_per_vmult, 1e-9 * bytes / time_per_vmult};
+}
+
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"vmult_one_thread",
+           "vmult_half_threads",
+           "vmult_all_threads",
+           "bandwidth_one_thread",
+           "bandwidth_half_threads",
+           "bandwidth_all_threads"}};
+}
+
+
+
+Measurement
+perform_single_measurement()
+{
+  unsigned int n_refinements = 0;
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        n_refinements = 4;
+        break;
+      case TestingEnvironment::medium:
+        n_refinements = 5;
+        break;
+      case TestingEnvironment::heavy:
+        n_refinements = 6;
+        break;
+    }
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(n_refinements);
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  // query the number of available threads with the default thread limit
+  MultithreadInfo::set_thread_limit();
+  const unsigned int max_threads = MultithreadInfo::n_threads();
+
+  std::vector<double> timings, bandwidths;
+  for (const unsigned int n_threads :
+       {1U, std::max(1U, max_threads / 2), max_threads})
+    {
+      const auto [time, bandwidth] = time_vmult(dof_handler, n_threads);
+      timings.push_back(time);
+      bandwidths.push_back(bandwidth);
+    }
+  MultithreadInfo::set_thread_limit();
+
+  Measurement measurement = {0.};
+  measurement.timing      = timings;
+  measurement.timing.insert(measurement.timing.end(),
+                            bandwidths.begin(),
+                            bandwidths.end());
+  return measurement;
+}
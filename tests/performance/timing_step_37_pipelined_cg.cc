@@ -0,0 +1,257 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2023 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+//
+// Description:
+//
+// A performance benchmark based on step 37 that compares the time per
+// iteration of SolverCG and SolverPipelinedCG for a matrix-free Laplace
+// operator with a point-Jacobi preconditioner. Since the operator and
+// preconditioner are cheap, the global reductions of the conjugate gradient
+// method make up a large part of the time at scale, which is what the
+// pipelined variant hides behind the matrix-vector product. The problem size
+// is chosen per MPI rank such that the benchmark measures weak scaling when
+// run with an increasing number of ranks.
+//
+// Status: experimental
+//
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_pipelined_cg.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <memory>
+
+#define ENABLE_MPI
+
+#include "performance_test_driver.h"
+
+using namespace dealii;
+
+const unsigned int degree_finite_element = 3;
+
+
+
+template <int dim>
+class LaplaceProblem
+{
+public:
+  LaplaceProblem();
+
+  Measurement
+  run();
+
+private:
+  void
+  setup_system();
+
+  template <typename SolverType>
+  void
+  solve(SolverType &solver);
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+#ifdef DEAL_II_WITH_P4EST
+  parallel::distributed::Triangulation<dim> triangulation;
+#else
+  Triangulation<dim> triangulation;
+#endif
+
+  FE_Q<dim>       fe;
+  DoFHandler<dim> dof_handler;
+
+  MappingQ1<dim> mapping;
+
+  AffineConstraints<double> constraints;
+  MatrixFreeOperators::
+    LaplaceOperator<dim, degree_finite_element, degree_finite_element + 1>
+      system_matrix;
+
+  VectorType solution;
+  VectorType system_rhs;
+};
+
+
+
+template <int dim>
+LaplaceProblem<dim>::LaplaceProblem()
+#ifdef DEAL_II_WITH_P4EST
+  : triangulation(MPI_COMM_WORLD)
+  , fe(degree_finite_element)
+#else
+  : fe(degree_finite_element)
+#endif
+  , dof_handler(triangulation)
+{}
+
+
+
+template <int dim>
+void
+LaplaceProblem<dim>::setup_system()
+{
+  // Choose the mesh such that each MPI rank gets a similar number of cells,
+  // subdividing the cube along the first coordinate direction
+  const unsigned int n_ranks =
+    Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  std::vector<unsigned int> repetitions(dim, 1);
+  repetitions[0] = n_ranks;
+  Point<dim> upper_right;
+  upper_right[0] = n_ranks;
+  for (unsigned int d = 1; d < dim; ++d)
+    upper_right[d] = 1.;
+  GridGenerator::subdivided_hyper_rectangle(triangulation,
+                                            repetitions,
+                                            Point<dim>(),
+                                            upper_right);
+  switch (get_testing_environment())
+    {
+      case TestingEnvironment::light:
+        triangulation.refine_global(3);
+        break;
+      case TestingEnvironment::medium:
+        triangulation.refine_global(4);
+        break;
+      case TestingEnvironment::heavy:
+        triangulation.refine_global(5);
+        break;
+    }
+
+  dof_handler.distribute_dofs(fe);
+
+  const IndexSet locally_relevant_dofs =
+    DoFTools::extract_locally_relevant_dofs(dof_handler);
+
+  constraints.clear();
+  constraints.reinit(locally_relevant_dofs);
+  VectorTools::interpolate_boundary_values(
+    mapping, dof_handler, 0, Functions::ZeroFunction<dim>(), constraints);
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  additional_data.tasks_parallel_scheme =
+    MatrixFree<dim, double>::AdditionalData::none;
+  additional_data.mapping_update_flags =
+    (update_gradients | update_JxW_values | update_quadrature_points);
+  std::shared_ptr<MatrixFree<dim, double>> system_mf_storage(
+    new MatrixFree<dim, double>());
+  system_mf_storage->reinit(mapping,
+                            dof_handler,
+                            constraints,
+                            QGauss<1>(fe.degree + 1),
+                            additional_data);
+  system_matrix.initialize(system_mf_storage);
+  system_matrix.compute_diagonal();
+
+  system_matrix.initialize_dof_vector(solution);
+  system_matrix.initialize_dof_vector(system_rhs);
+  system_rhs = 1.;
+  constraints.set_zero(system_rhs);
+}
+
+
+
+template <int dim>
+template <typename SolverType>
+void
+LaplaceProblem<dim>::solve(SolverType &solver)
+{
+  solution = 0.;
+  solver.solve(system_matrix,
+               solution,
+               system_rhs,
+               *system_matrix.get_matrix_diagonal_inverse());
+}
+
+
+
+template <int dim>
+Measurement
+LaplaceProblem<dim>::run()
+{
+  std::map<std::string, dealii::Timer> timer;
+
+  timer["setup_system"].start();
+  setup_system();
+  timer["setup_system"].stop();
+
+  // Run a fixed number of iterations to compare the cost per iteration of
+  // the two solvers
+  const unsigned int n_iterations = 200;
+
+  {
+    IterationNumberControl control(n_iterations, 1e-20);
+    SolverCG<VectorType>   solver(control);
+    timer["solve_cg"].start();
+    solve(solver);
+    timer["solve_cg"].stop();
+  }
+
+  {
+    IterationNumberControl        control(n_iterations, 1e-20);
+    SolverPipelinedCG<VectorType> solver(control);
+    timer["solve_pipelined_cg"].start();
+    solve(solver);
+    timer["solve_pipelined_cg"].stop();
+  }
+
+  // Measure the matrix-vector product for reference
+  timer["matvec"].start();
+  for (unsigned int t = 0; t < n_iterations; ++t)
+    system_matrix.vmult(system_rhs, solution);
+  timer["matvec"].stop();
+
+  return {timer["setup_system"].wall_time(),
+          timer["solve_cg"].wall_time(),
+          timer["solve_pipelined_cg"].wall_time(),
+          timer["matvec"].wall_time()};
+}
+
+
+std::tuple<Metric, unsigned int, std::vector<std::string>>
+describe_measurements()
+{
+  return {Metric::timing,
+          4,
+          {"setup_system", "solve_cg", "solve_pipelined_cg", "matvec"}};
+}
+
+
+Measurement
+perform_single_measurement()
+{
+  return LaplaceProblem<3>().run();
+}